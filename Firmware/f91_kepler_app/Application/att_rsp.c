@@ -1,135 +0,0 @@
-/******************************************************************************
-
- @file  att_rsp.c
-
- @brief This file contains att response utility functions commonly used by
-        BLE applications for CC26xx with TIRTOS.
-
- Group: WCS, BTS
- Target Device: cc2640r2
-
- ******************************************************************************
- 
- Copyright (c) 2018-2021, Texas Instruments Incorporated
- All rights reserved.
-
- Redistribution and use in source and binary forms, with or without
- modification, are permitted provided that the following conditions
- are met:
-
- *  Redistributions of source code must retain the above copyright
-    notice, this list of conditions and the following disclaimer.
-
- *  Redistributions in binary form must reproduce the above copyright
-    notice, this list of conditions and the following disclaimer in the
-    documentation and/or other materials provided with the distribution.
-
- *  Neither the name of Texas Instruments Incorporated nor the names of
-    its contributors may be used to endorse or promote products derived
-    from this software without specific prior written permission.
-
- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
- THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
- PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
- CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
- EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
- PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
- OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
- WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
- OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
- EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-
- ******************************************************************************
- 
- 
- *****************************************************************************/
-
-/*********************************************************************
- * INCLUDES
- */
-
- #include "att_rsp.h"
- 
- /*********************************************************************
- * TYPEDEFS
- */
- 
-/*********************************************************************
- * LOCAL FUNCTIONS
- */
-
-/*********************************************************************
- * EXTERNAL VARIABLES
- */
-
-/*********************************************************************
- * LOCAL VARIABLES
- */
-
- static gattMsgEvent_t * pAttRsp;
-
-/*********************************************************************
- * PUBLIC FUNCTIONS
- */
-
-uint8_t attRsp_isAttRsp(gattMsgEvent_t * pMsg)
-{
-  // See if GATT server was unable to transmit an ATT response
-  if (pMsg->hdr.status == blePending)
-  {
-
-      // First free any pending response
-      attRsp_freeAttRsp(FAILURE);
-
-      // Hold on to the response message for retransmission
-      pAttRsp = pMsg;
-
-      // There's a message to retransmit
-      return (TRUE);
-  }
-  return (FALSE);
-}
-
-
-bStatus_t attRsp_sendAttRsp(void)
-{
-  // See if there's a pending ATT Response to be transmitted
-  if (pAttRsp != NULL)
-  {
-    uint8_t status;
-
-    // Try to retransmit ATT response till either we're successful or
-    // the ATT Client times out (after 30s) and drops the connection.
-    status = GATT_SendRsp(pAttRsp->connHandle, pAttRsp->method, &(pAttRsp->msg));
-    if ((status != blePending) && (status != MSG_BUFFER_NOT_AVAIL))
-    {
-      // We're done with the response message
-      attRsp_freeAttRsp(status);
-    }
-    return(status);
-  }
-  return(bleMemAllocError);
-}
-
-
-void attRsp_freeAttRsp(uint8_t status)
-{
-  // See if there's a pending ATT response message
-  if (pAttRsp != NULL)
-  {
-    // See if the response was sent out successfully
-    if (status != SUCCESS)
-    {
-      // Free response payload
-      GATT_bm_free(&pAttRsp->msg, pAttRsp->method);
-    }
-    
-    // Free response message
-    ICall_freeMsg(pAttRsp);
-    
-    // Reset our globals
-    pAttRsp = NULL;
-  }
-}
-
@@ -0,0 +1,522 @@
+/******************************************************************************
+
+ @file  f91_alarm.c
+
+ @brief This file contains the F91 Kepler Smart Watch alarms, countdown timer
+        and hourly chime.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/hal/Seconds.h>
+
+#include "ssd1306.h"
+#include "f91_utils.h"
+#include "f91_kepler.h"
+#include "f91_alarm.h"
+#include "f91_timers.h"
+#include "f91_clock.h"
+#include "f91_clock_service.h"
+#include "f91_buttons.h"
+#include "f91_notification.h"
+#include "f91_stopwatch.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define SECONDS_PER_HOUR          3600
+#define SECONDS_PER_DAY           86400
+
+// 01/01/1970 was a Thursday.
+#define EPOCH_WEEKDAY             4
+
+// Label shown in the date field during an alert.
+#define ALERT_LABEL_POS_X         65
+
+// Alert types
+#define ALERT_NONE                0
+#define ALERT_ALARM               1
+#define ALERT_COUNTDOWN           2
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  f91Timer_t timer;
+  uint8_t    enabled;
+  uint8_t    hour;
+  uint8_t    minute;
+  uint8_t    days;     // bit0 Sunday ... bit6 Saturday, 0: once
+} f91Alarm_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static f91Alarm_t alarms[F91_ALARM_COUNT];
+
+static f91Timer_t snoozeTimer;
+static f91Timer_t countdownTimer;
+static f91Timer_t chimeTimer;
+static f91Timer_t alertTimer;
+
+// Configured countdown duration (in sec).
+static uint32_t countdownDuration = 0;
+
+static bool chimeEnabled = false;
+
+static uint8_t alertType = ALERT_NONE;
+
+// Alarm being displayed, the one a snooze rings again for.
+static uint8_t alertAlarm = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint32_t _F91Alarm_nextOccurrence(f91Alarm_t *pAlarm);
+static void _F91Alarm_arm(uint8_t index);
+static void _F91Alarm_armChime( void );
+static void _F91Alarm_publish( void );
+static void _F91Alarm_showAlert(uint8_t type, uint8_t hour, uint8_t minute);
+static void _F91Alarm_alarmExpired(f91Timer_t *pTimer);
+static void _F91Alarm_snoozeExpired(f91Timer_t *pTimer);
+static void _F91Alarm_countdownExpired(f91Timer_t *pTimer);
+static void _F91Alarm_chimeExpired(f91Timer_t *pTimer);
+static void _F91Alarm_alertExpired(f91Timer_t *pTimer);
+
+/*********************************************************************
+ * @fn      _F91Alarm_nextOccurrence
+ *
+ * @brief   Finds the next time an alarm rings, in local time then back to UTC.
+ *
+ * @param   pAlarm - alarm to look at.
+ *
+ * @return  RTC second (UTC) of the next occurrence.
+ */
+static uint32_t _F91Alarm_nextOccurrence(f91Alarm_t *pAlarm)
+{
+  int32_t  offset = F91Clock_getUtcOffset();
+  uint32_t local = Seconds_get() + offset;
+  uint32_t midnight = local - (local % SECONDS_PER_DAY);
+  uint8_t  weekday = ((local / SECONDS_PER_DAY) + EPOCH_WEEKDAY) % 7;
+  uint32_t ring = midnight + (pAlarm->hour * SECONDS_PER_HOUR) + (pAlarm->minute * 60);
+  uint8_t  day;
+
+  // Today's ring time may have passed, so look up to a week ahead.
+  for (day = 0; day <= 7; day++, ring += SECONDS_PER_DAY) {
+    if (ring <= local) {
+      continue;
+    }
+    if ((pAlarm->days == 0) || (pAlarm->days & (1 << ((weekday + day) % 7)))) {
+      break;
+    }
+  }
+
+  return ring - offset;
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_arm
+ *
+ * @brief   Starts or stops an alarm timer to match its configuration.
+ *
+ * @param   index - alarm index.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_arm(uint8_t index)
+{
+  f91Alarm_t *pAlarm = &alarms[index];
+
+  if (pAlarm->enabled) {
+    F91Timers_start(&pAlarm->timer, _F91Alarm_nextOccurrence(pAlarm));
+  } else {
+    F91Timers_stop(&pAlarm->timer);
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_armChime
+ *
+ * @brief   Starts the chime timer for the next full hour, stops it if disabled.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_armChime( void )
+{
+  int32_t  offset = F91Clock_getUtcOffset();
+  uint32_t local = Seconds_get() + offset;
+
+  if (chimeEnabled) {
+    F91Timers_start(&chimeTimer, local - (local % SECONDS_PER_HOUR) + SECONDS_PER_HOUR - offset);
+  } else {
+    F91Timers_stop(&chimeTimer);
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_publish
+ *
+ * @brief   Updates the alarm characteristic with the current configuration.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_publish( void )
+{
+  uint8_t table[F91_ALARM_TABLE_LEN];
+  uint8_t *pRecord = table;
+  uint8_t i;
+
+  for (i = 0; i < F91_ALARM_COUNT; i++, pRecord += F91_ALARM_RECORD_LEN) {
+    pRecord[0] = i;
+    pRecord[1] = alarms[i].enabled ? F91_ALARM_FLAG_ENABLED : 0;
+    pRecord[2] = alarms[i].hour;
+    pRecord[3] = alarms[i].minute;
+    pRecord[4] = alarms[i].days;
+  }
+
+  pRecord[0] = F91_ALARM_ID_COUNTDOWN;
+  pRecord[1] = F91Timers_isActive(&countdownTimer) ? F91_ALARM_FLAG_ENABLED : 0;
+  pRecord[2] = countdownDuration / SECONDS_PER_HOUR;
+  pRecord[3] = (countdownDuration / 60) % 60;
+  pRecord[4] = countdownDuration % 60;
+  pRecord += F91_ALARM_RECORD_LEN;
+
+  pRecord[0] = F91_ALARM_ID_CHIME;
+  pRecord[1] = chimeEnabled ? F91_ALARM_FLAG_ENABLED : 0;
+  pRecord[2] = 0;
+  pRecord[3] = 0;
+  pRecord[4] = 0;
+
+  F91_clock_service_SetParameter(F91_CLOCK_SERVICE_CHAR5, sizeof(table), table);
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_showAlert
+ *
+ * @brief   Takes over the display with a full screen alert until it is
+ *          dismissed, snoozed or F91_ALARM_ALERT_TIMEOUT runs out.
+ *
+ * @param   type - ALERT_ALARM or ALERT_COUNTDOWN.
+ * @param   hour - hour to display (24hr).
+ * @param   minute - minute to display.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_showAlert(uint8_t type, uint8_t hour, uint8_t minute)
+{
+  alertType = type;
+
+  // Cancel the one shot clock of the display if it's already going from a button press.
+  F91Buttons_resetOneShot();
+
+  ssd1306_clear();
+  if (type == ALERT_ALARM) {
+    ssd1306_display_text("ALARM", ALERT_LABEL_POS_X, DATE_POS_Y, false);
+    if (!F91Clock_is24Hour()) {
+      ssd1306_display_pm(PM_POS_X, PM_POS_Y, hour < 12);
+      if (hour == 0) {
+        hour = 12;
+      } else if (hour > 12) {
+        hour -= 12;
+      }
+    }
+  } else {
+    ssd1306_display_text("TIMER", ALERT_LABEL_POS_X, DATE_POS_Y, false);
+  }
+
+  ssd1306_display_number(hour / 10, HR_1_POS_X, HR_MIN_POS_Y, (type == ALERT_ALARM) && (hour < 10));
+  ssd1306_display_number(hour % 10, HR_2_POS_X, HR_MIN_POS_Y, false);
+  ssd1306_display_semicolon(SEM_CLN_POS_X, SEM_CLN_POS_Y, false);
+  ssd1306_display_number(minute / 10, MIN_1_POS_X, HR_MIN_POS_Y, false);
+  ssd1306_display_number(minute % 10, MIN_2_POS_X, HR_MIN_POS_Y, false);
+
+  ssd1306_update();
+  ssd1306_toggle_display(true);
+
+  F91Timers_start(&alertTimer, Seconds_get() + F91_ALARM_ALERT_TIMEOUT);
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_alarmExpired
+ *
+ * @brief   An alarm rings. Repeating alarms are re-armed, single ones disabled.
+ *
+ * @param   pTimer - alarm timer.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_alarmExpired(f91Timer_t *pTimer)
+{
+  uint8_t index = (uint8_t)pTimer->arg;
+  f91Alarm_t *pAlarm = &alarms[index];
+
+  if (pAlarm->days == 0) {
+    pAlarm->enabled = false;
+    _F91Alarm_publish();
+  } else {
+    _F91Alarm_arm(index);
+  }
+
+  // A new alarm replaces any pending snooze.
+  F91Timers_stop(&snoozeTimer);
+  alertAlarm = index;
+
+  Display_print2(F91_LOGGER, 11, 0, "Alarm %d: %d", index, Seconds_get());
+  _F91Alarm_showAlert(ALERT_ALARM, pAlarm->hour, pAlarm->minute);
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_snoozeExpired
+ *
+ * @brief   A snoozed alarm rings again.
+ *
+ * @param   pTimer - snooze timer.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_snoozeExpired(f91Timer_t *pTimer)
+{
+  _F91Alarm_showAlert(ALERT_ALARM, alarms[alertAlarm].hour, alarms[alertAlarm].minute);
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_countdownExpired
+ *
+ * @brief   The countdown timer reached zero.
+ *
+ * @param   pTimer - countdown timer.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_countdownExpired(f91Timer_t *pTimer)
+{
+  _F91Alarm_publish();
+  _F91Alarm_showAlert(ALERT_COUNTDOWN, 0, 0);
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_chimeExpired
+ *
+ * @brief   Hourly chime, shows the time for a moment if the screen is free.
+ *
+ * @param   pTimer - chime timer.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_chimeExpired(f91Timer_t *pTimer)
+{
+  _F91Alarm_armChime();
+
+  if (ssd1306_getState() || (alertType != ALERT_NONE) ||
+      F91Notification_getNotificationState() || F91Stopwatch_isActive()) {
+    return;
+  }
+
+  F91Notification_update(NOTIFICATION_BAR);
+  ssd1306_toggle_display(true);
+  F91Clock_wake();
+  F91Buttons_startDisplayTimeout();
+}
+
+/*********************************************************************
+ * @fn      _F91Alarm_alertExpired
+ *
+ * @brief   Nobody attended the alert, take it down.
+ *
+ * @param   pTimer - alert timer.
+ *
+ * @return  None.
+ */
+static void _F91Alarm_alertExpired(f91Timer_t *pTimer)
+{
+  F91Alarm_dismiss();
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Alarm_init
+ *
+ * @brief   Initialization function for the alarms. Everything starts disabled.
+ *          The timer wheel must be initialized.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Alarm_init( void )
+{
+  uint8_t i;
+
+  for (i = 0; i < F91_ALARM_COUNT; i++) {
+    F91Timers_construct(&alarms[i].timer, _F91Alarm_alarmExpired, i);
+    alarms[i].enabled = false;
+    alarms[i].hour    = 0;
+    alarms[i].minute  = 0;
+    alarms[i].days    = 0;
+  }
+
+  F91Timers_construct(&snoozeTimer, _F91Alarm_snoozeExpired, 0);
+  F91Timers_construct(&countdownTimer, _F91Alarm_countdownExpired, 0);
+  F91Timers_construct(&chimeTimer, _F91Alarm_chimeExpired, 0);
+  F91Timers_construct(&alertTimer, _F91Alarm_alertExpired, 0);
+
+  _F91Alarm_publish();
+}
+
+/*********************************************************************
+ * @fn      F91Alarm_configure
+ *
+ * @brief   Apply an alarm characteristic record. Out of range values are ignored.
+ *
+ * @param   record - F91_ALARM_RECORD_LEN bytes, see f91_alarm.h.
+ *
+ * @return  none
+ */
+void F91Alarm_configure(uint8_t *record)
+{
+  uint8_t id = record[0];
+  bool    enable = (record[1] & F91_ALARM_FLAG_ENABLED) != 0;
+
+  if (id < F91_ALARM_COUNT) {
+    if ((record[2] > 23) || (record[3] > 59) || (record[4] > F91_ALARM_DAYS_ALL)) {
+      return;
+    }
+    alarms[id].enabled = enable;
+    alarms[id].hour    = record[2];
+    alarms[id].minute  = record[3];
+    alarms[id].days    = record[4];
+    _F91Alarm_arm(id);
+  } else if (id == F91_ALARM_ID_COUNTDOWN) {
+    if ((record[2] > 23) || (record[3] > 59) || (record[4] > 59)) {
+      return;
+    }
+    countdownDuration = (record[2] * SECONDS_PER_HOUR) + (record[3] * 60) + record[4];
+    if (enable && countdownDuration) {
+      F91Timers_start(&countdownTimer, Seconds_get() + countdownDuration);
+    } else {
+      F91Timers_stop(&countdownTimer);
+    }
+  } else if (id == F91_ALARM_ID_CHIME) {
+    chimeEnabled = enable;
+    _F91Alarm_armChime();
+  } else {
+    return;
+  }
+
+  _F91Alarm_publish();
+}
+
+/*********************************************************************
+ * @fn      F91Alarm_timeChanged
+ *
+ * @brief   Called once a new time, time zone or dst is in effect. Countdowns
+ *          keep the time they had left, alarms and the chime follow the wall clock.
+ *
+ * @param   delta - seconds the RTC moved by.
+ *
+ * @return  none
+ */
+void F91Alarm_timeChanged(int32_t delta)
+{
+  uint8_t i;
+
+  F91Timers_rebase(delta);
+
+  for (i = 0; i < F91_ALARM_COUNT; i++) {
+    _F91Alarm_arm(i);
+  }
+  _F91Alarm_armChime();
+}
+
+/*********************************************************************
+ * @fn      F91Alarm_isAlerting
+ *
+ * @brief   Alert state to stop the clock from overwriting the buffer.
+ *
+ * @param   none
+ *
+ * @return  true if an alarm or countdown alert is being displayed, false otherwise.
+ */
+bool F91Alarm_isAlerting( void )
+{
+  return (alertType != ALERT_NONE);
+}
+
+/*********************************************************************
+ * @fn      F91Alarm_dismiss
+ *
+ * @brief   Take down the alert and turn the display off.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Alarm_dismiss( void )
+{
+  if (alertType == ALERT_NONE) {
+    return;
+  }
+
+  alertType = ALERT_NONE;
+  F91Timers_stop(&alertTimer);
+
+  ssd1306_toggle_display(false);
+  ssd1306_clear();
+  ssd1306_update();
+}
+
+/*********************************************************************
+ * @fn      F91Alarm_snooze
+ *
+ * @brief   Take down the alert, an alarm rings again after F91_ALARM_SNOOZE_TIME.
+ *          Countdown alerts are simply dismissed.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Alarm_snooze( void )
+{
+  if (alertType == ALERT_ALARM) {
+    F91Timers_start(&snoozeTimer, Seconds_get() + F91_ALARM_SNOOZE_TIME);
+  }
+
+  F91Alarm_dismiss();
+}
+
+/*********************************************************************
+*********************************************************************/
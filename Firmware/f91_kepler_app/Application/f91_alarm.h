@@ -0,0 +1,122 @@
+/******************************************************************************
+
+ @file  f91_alarm.h
+
+ @brief This file contains the F91 Kepler Smart Watch alarms, countdown timer
+        and hourly chime definitions and prototypes.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91ALARM_H
+#define F91ALARM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of alarms that can be configured.
+#define F91_ALARM_COUNT                 4
+
+// Alarm characteristic records are 5 bytes: [id, flags, b0, b1, b2]
+//   id 0..F91_ALARM_COUNT-1: alarm, flags bit0 enabled,
+//                            b0 hour, b1 minute, b2 days (bit0 Sunday ... bit6
+//                            Saturday, 0 rings once)
+//   id F91_ALARM_ID_COUNTDOWN: countdown, flags bit0 running,
+//                            b0 hours, b1 minutes, b2 seconds
+//   id F91_ALARM_ID_CHIME:   hourly chime, flags bit0 enabled
+#define F91_ALARM_RECORD_LEN            5
+#define F91_ALARM_ID_COUNTDOWN          0xFE
+#define F91_ALARM_ID_CHIME              0xFF
+#define F91_ALARM_FLAG_ENABLED          0x01
+#define F91_ALARM_DAYS_ALL              0x7F
+
+// Length of the table read back from the alarm characteristic, one record per
+// alarm followed by the countdown and chime records.
+#define F91_ALARM_TABLE_LEN             ((F91_ALARM_COUNT + 2) * F91_ALARM_RECORD_LEN)
+
+// Snooze duration (in sec).
+#define F91_ALARM_SNOOZE_TIME           300
+
+// How long an alert stays on screen before it dismisses itself (in sec).
+#define F91_ALARM_ALERT_TIMEOUT         60
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize alarm module
+ */
+extern void F91Alarm_init( void );
+
+/*
+ * Apply an alarm characteristic record.
+ */
+extern void F91Alarm_configure(uint8_t *record);
+
+/*
+ * Re-arm alarms and timers after the time, time zone or dst changed.
+ */
+extern void F91Alarm_timeChanged(int32_t delta);
+
+/*
+ * Returns wether a full screen alert is being displayed.
+ */
+extern bool F91Alarm_isAlerting( void );
+
+/*
+ * Dismiss the alert being displayed.
+ */
+extern void F91Alarm_dismiss( void );
+
+/*
+ * Dismiss the alert being displayed and ring again in F91_ALARM_SNOOZE_TIME.
+ */
+extern void F91Alarm_snooze( void );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91ALARM_H */
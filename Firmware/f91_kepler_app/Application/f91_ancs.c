@@ -0,0 +1,892 @@
+/******************************************************************************
+
+ @file  f91_ancs.c
+
+ @brief This file contains the F91 Kepler Smart Watch ANCS client.
+
+        Once the link to an iPhone is encrypted the client finds ANCS, its
+        three characteristics and their CCCDs, then subscribes to the Data
+        Source and the Notification Source. Every new call or message on
+        the Notification Source gets one Control Point request for its app
+        identifier, title and message; the answer streams back over the
+        Data Source and is parsed as it arrives, into fixed size buffers.
+        Category counts drive the notification bar.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+
+#include <icall.h>
+#include "icall_ble_api.h"
+
+#include "bcomdef.h"
+#include "att.h"
+#include "gatt.h"
+#include "gatt_uuid.h"
+
+#include "f91_ancs.h"
+#include "f91_history.h"
+#include "f91_notification.h"
+#include "f91_sync.h"
+#include "ssd1306.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Client states
+#define ANCS_STATE_IDLE             0
+#define ANCS_STATE_DISC_SERVICE     1
+#define ANCS_STATE_DISC_CHARS       2
+#define ANCS_STATE_DISC_DESCS       3
+#define ANCS_STATE_SUBSCRIBE_DATA   4
+#define ANCS_STATE_SUBSCRIBE_NOTIF  5
+#define ANCS_STATE_READY            6
+
+// Data Source parser states
+#define DS_IDLE                     0
+#define DS_COMMAND                  1
+#define DS_UID                      2
+#define DS_ATTR_ID                  3
+#define DS_ATTR_LEN                 4
+#define DS_ATTR_VALUE               5
+
+// Notification Source event length
+#define ANCS_NOTIF_SRC_LEN          8
+
+// Attributes asked for in every Get Notification Attributes command.
+#define ANCS_ATTR_COUNT             3
+
+// Get Notification Attributes: command, UID, app id, title and max length,
+// message and max length.
+#define ANCS_CMD_LEN                (1 + 4 + 1 + 3 + 3)
+
+// Length of a characteristic declaration with a 128-bit UUID, as found by
+// GATT_DiscAllChars: handle, properties, value handle, UUID.
+#define ANCS_CHAR_DECL_LEN          (2 + 1 + 2 + ATT_UUID_SIZE)
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Notification waiting for its attributes.
+typedef struct
+{
+  uint32_t uid;
+  uint8_t  category;
+} f91AncsPending_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// ANCS UUIDs, little endian.
+// 7905F431-B5CE-4E99-A40F-4B1E122D00D0
+static const uint8_t ancsServiceUUID[ATT_UUID_SIZE] =
+{
+  0xD0, 0x00, 0x2D, 0x12, 0x1E, 0x4B, 0x0F, 0xA4, 0x99, 0x4E, 0xCE, 0xB5, 0x31, 0xF4, 0x05, 0x79
+};
+
+// Notification Source 9FBF120D-6301-42D9-8C58-25E699A21DBD
+static const uint8_t ancsNotifSrcUUID[ATT_UUID_SIZE] =
+{
+  0xBD, 0x1D, 0xA2, 0x99, 0xE6, 0x25, 0x58, 0x8C, 0xD9, 0x42, 0x01, 0x63, 0x0D, 0x12, 0xBF, 0x9F
+};
+
+// Control Point 69D1D8F3-45E1-49A8-9821-9BBDFDAAD9D9
+static const uint8_t ancsCtrlPointUUID[ATT_UUID_SIZE] =
+{
+  0xD9, 0xD9, 0xAA, 0xFD, 0xBD, 0x9B, 0x21, 0x98, 0xA8, 0x49, 0xE1, 0x45, 0xF3, 0xD8, 0xD1, 0x69
+};
+
+// Data Source 22EAC6E9-24D6-4BB5-BE44-B36ACE7C7BFB
+static const uint8_t ancsDataSrcUUID[ATT_UUID_SIZE] =
+{
+  0xFB, 0x7B, 0x7C, 0xCE, 0x6A, 0xB3, 0x44, 0xBE, 0xB5, 0x4B, 0xD6, 0x24, 0xE9, 0xC6, 0xEA, 0x22
+};
+
+static uint8_t  ancsTaskId;
+static uint16_t ancsConnHandle;
+static uint8_t  ancsState = ANCS_STATE_IDLE;
+
+// Service range and characteristic handles on the central.
+static uint16_t svcStartHandle;
+static uint16_t svcEndHandle;
+static uint16_t notifSrcHandle;
+static uint16_t notifSrcCccdHandle;
+static uint16_t ctrlPointHandle;
+static uint16_t dataSrcHandle;
+static uint16_t dataSrcCccdHandle;
+
+// Notifications waiting for their attributes, oldest first.
+static f91AncsPending_t pending[F91_ANCS_PENDING_LEN];
+static uint8_t pendingCount;
+
+// A Control Point request is waiting for its Data Source answer.
+static bool requestInFlight;
+
+// Data Source parser
+static struct
+{
+  uint8_t  state;
+  uint8_t  pos;         // byte of the UID or length field
+  uint32_t uid;
+  uint8_t  attrId;
+  uint16_t attrLen;
+  uint16_t valuePos;
+  uint8_t  attrsLeft;
+} dsParser;
+
+static char appId[F91_ANCS_APP_ID_LEN + 1];
+static char title[F91_HISTORY_SENDER_LEN + 1];
+static char message[F91_HISTORY_BODY_LEN + 1];
+
+// Notification bar built from the category counts.
+static uint8_t ancsBar;
+
+// Handed to the notification module.
+static f91SyncState_t ancsUpdate;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static bStatus_t _F91Ancs_write(uint16_t handle, uint8_t *pValue, uint8_t len);
+static void _F91Ancs_subscribe(uint16_t cccdHandle);
+static void _F91Ancs_fail(uint8_t status);
+static void _F91Ancs_processServiceRsp(gattMsgEvent_t *pMsg);
+static void _F91Ancs_processCharsRsp(gattMsgEvent_t *pMsg);
+static void _F91Ancs_processDescsRsp(gattMsgEvent_t *pMsg);
+static void _F91Ancs_processNotifSrc(uint8_t *pValue, uint16_t len);
+static void _F91Ancs_processDataSrc(uint8_t *pValue, uint16_t len);
+static void _F91Ancs_finishAttribute(void);
+static void _F91Ancs_requestNext(void);
+static void _F91Ancs_deliver(uint8_t category);
+static void _F91Ancs_setBar(uint8_t category, uint8_t count);
+
+/*********************************************************************
+ * @fn      _F91Ancs_write
+ *
+ * @brief   Write request to a characteristic on the central.
+ *
+ * @param   handle - attribute handle.
+ * @param   pValue - value.
+ * @param   len - value length.
+ *
+ * @return  SUCCESS or the GATT error.
+ */
+static bStatus_t _F91Ancs_write(uint16_t handle, uint8_t *pValue, uint8_t len)
+{
+  attWriteReq_t req;
+  bStatus_t status;
+
+  req.pValue = GATT_bm_alloc(ancsConnHandle, ATT_WRITE_REQ, len, NULL);
+  if (req.pValue == NULL) {
+    return bleMemAllocError;
+  }
+
+  req.handle = handle;
+  req.len = len;
+  req.sig = FALSE;
+  req.cmd = FALSE;
+  memcpy(req.pValue, pValue, len);
+
+  status = GATT_WriteCharValue(ancsConnHandle, &req, ancsTaskId);
+  if (status != SUCCESS) {
+    GATT_bm_free((gattMsg_t *)&req, ATT_WRITE_REQ);
+  }
+
+  return status;
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_subscribe
+ *
+ * @brief   Enable notifications on a CCCD.
+ *
+ * @param   cccdHandle - descriptor handle.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_subscribe(uint16_t cccdHandle)
+{
+  uint8_t value[2] = { LO_UINT16(GATT_CLIENT_CFG_NOTIFY), HI_UINT16(GATT_CLIENT_CFG_NOTIFY) };
+  bStatus_t status = _F91Ancs_write(cccdHandle, value, sizeof(value));
+
+  if (status != SUCCESS) {
+    _F91Ancs_fail(status);
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_fail
+ *
+ * @brief   Give up on ANCS for this connection.
+ *
+ * @param   status - reason, for the log.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_fail(uint8_t status)
+{
+  Display_print2(F91_LOGGER, 16, 0, "ANCS: failed in state %d (0x%02x)", ancsState, status);
+  F91Ancs_reset();
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_processServiceRsp
+ *
+ * @brief   Primary service discovery by UUID.
+ *
+ * @param   pMsg - GATT message.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_processServiceRsp(gattMsgEvent_t *pMsg)
+{
+  uint8_t *pInfo;
+
+  if ((pMsg->method == ATT_FIND_BY_TYPE_VALUE_RSP) && (pMsg->msg.findByTypeValueRsp.numInfo > 0)) {
+    pInfo = pMsg->msg.findByTypeValueRsp.pHandlesInfo;
+    svcStartHandle = BUILD_UINT16(pInfo[0], pInfo[1]);
+    svcEndHandle   = BUILD_UINT16(pInfo[2], pInfo[3]);
+  }
+
+  if ((pMsg->hdr.status != bleProcedureComplete) && (pMsg->method != ATT_ERROR_RSP)) {
+    return;
+  }
+
+  if (svcStartHandle == 0) {
+    // Not an iPhone, or ANCS is off.
+    Display_print0(F91_LOGGER, 16, 0, "ANCS: not found");
+    F91Ancs_reset();
+    return;
+  }
+
+  ancsState = ANCS_STATE_DISC_CHARS;
+  if (GATT_DiscAllChars(ancsConnHandle, svcStartHandle, svcEndHandle, ancsTaskId) != SUCCESS) {
+    _F91Ancs_fail(FAILURE);
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_processCharsRsp
+ *
+ * @brief   Characteristic discovery within the service.
+ *
+ * @param   pMsg - GATT message.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_processCharsRsp(gattMsgEvent_t *pMsg)
+{
+  attReadByTypeRsp_t *pRsp = &pMsg->msg.readByTypeRsp;
+  uint8_t *pDecl;
+  uint16_t valueHandle;
+  uint16_t i;
+
+  if ((pMsg->method == ATT_READ_BY_TYPE_RSP) && (pRsp->len == ANCS_CHAR_DECL_LEN)) {
+    for (i = 0; i < pRsp->numPairs; i++) {
+      pDecl = &pRsp->pDataList[i * ANCS_CHAR_DECL_LEN];
+      valueHandle = BUILD_UINT16(pDecl[3], pDecl[4]);
+
+      if (memcmp(&pDecl[5], ancsNotifSrcUUID, ATT_UUID_SIZE) == 0) {
+        notifSrcHandle = valueHandle;
+      } else if (memcmp(&pDecl[5], ancsCtrlPointUUID, ATT_UUID_SIZE) == 0) {
+        ctrlPointHandle = valueHandle;
+      } else if (memcmp(&pDecl[5], ancsDataSrcUUID, ATT_UUID_SIZE) == 0) {
+        dataSrcHandle = valueHandle;
+      }
+    }
+  }
+
+  if ((pMsg->hdr.status != bleProcedureComplete) && (pMsg->method != ATT_ERROR_RSP)) {
+    return;
+  }
+
+  if ((notifSrcHandle == 0) || (ctrlPointHandle == 0) || (dataSrcHandle == 0)) {
+    _F91Ancs_fail(ATT_ERR_ATTR_NOT_FOUND);
+    return;
+  }
+
+  ancsState = ANCS_STATE_DISC_DESCS;
+  if (GATT_DiscAllCharDescs(ancsConnHandle, svcStartHandle, svcEndHandle, ancsTaskId) != SUCCESS) {
+    _F91Ancs_fail(FAILURE);
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_processDescsRsp
+ *
+ * @brief   Descriptor discovery within the service. A CCCD belongs to the
+ *          characteristic with the closest value handle before it.
+ *
+ * @param   pMsg - GATT message.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_processDescsRsp(gattMsgEvent_t *pMsg)
+{
+  attFindInfoRsp_t *pRsp = &pMsg->msg.findInfoRsp;
+  uint16_t handle, owner;
+  uint16_t i;
+
+  if ((pMsg->method == ATT_FIND_INFO_RSP) && (pRsp->format == ATT_HANDLE_BT_UUID_TYPE)) {
+    for (i = 0; i < pRsp->numInfo; i++) {
+      handle = BUILD_UINT16(pRsp->pInfo[i * 4], pRsp->pInfo[i * 4 + 1]);
+      if (BUILD_UINT16(pRsp->pInfo[i * 4 + 2], pRsp->pInfo[i * 4 + 3]) != GATT_CLIENT_CHAR_CFG_UUID) {
+        continue;
+      }
+
+      owner = 0;
+      if ((notifSrcHandle < handle) && (notifSrcHandle > owner)) {
+        owner = notifSrcHandle;
+      }
+      if ((ctrlPointHandle < handle) && (ctrlPointHandle > owner)) {
+        owner = ctrlPointHandle;
+      }
+      if ((dataSrcHandle < handle) && (dataSrcHandle > owner)) {
+        owner = dataSrcHandle;
+      }
+
+      if (owner == notifSrcHandle) {
+        notifSrcCccdHandle = handle;
+      } else if (owner == dataSrcHandle) {
+        dataSrcCccdHandle = handle;
+      }
+    }
+  }
+
+  if ((pMsg->hdr.status != bleProcedureComplete) && (pMsg->method != ATT_ERROR_RSP)) {
+    return;
+  }
+
+  if ((notifSrcCccdHandle == 0) || (dataSrcCccdHandle == 0)) {
+    _F91Ancs_fail(ATT_ERR_ATTR_NOT_FOUND);
+    return;
+  }
+
+  // Data Source first, so no answer is missed once notifications flow.
+  ancsState = ANCS_STATE_SUBSCRIBE_DATA;
+  _F91Ancs_subscribe(dataSrcCccdHandle);
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_processNotifSrc
+ *
+ * @brief   Notification Source event. New calls and messages are queued
+ *          for their attributes, notifications the phone already had when
+ *          we subscribed only count towards the bar.
+ *
+ * @param   pValue - event.
+ * @param   len - event length.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_processNotifSrc(uint8_t *pValue, uint16_t len)
+{
+  uint8_t  eventId, flags, category, count;
+  uint32_t uid;
+  uint8_t  i;
+
+  if (len < ANCS_NOTIF_SRC_LEN) {
+    return;
+  }
+
+  eventId  = pValue[0];
+  flags    = pValue[1];
+  category = pValue[2];
+  count    = pValue[3];
+  uid      = BUILD_UINT32(pValue[4], pValue[5], pValue[6], pValue[7]);
+
+  _F91Ancs_setBar(category, count);
+
+  if (eventId == ANCS_EVENT_ADDED) {
+    if ((flags & ANCS_FLAG_PRE_EXISTING) ||
+        ((category != ANCS_CATEGORY_INCOMING_CALL) && (category != ANCS_CATEGORY_SOCIAL))) {
+      return;
+    }
+
+    // Full, the oldest one gives way. Not the one whose attributes were
+    // asked for, it stays first until its answer or error comes back.
+    if (pendingCount == F91_ANCS_PENDING_LEN) {
+      i = requestInFlight ? 1 : 0;
+      pendingCount--;
+      memmove(&pending[i], &pending[i + 1], (pendingCount - i) * sizeof(f91AncsPending_t));
+    }
+    pending[pendingCount].uid = uid;
+    pending[pendingCount].category = category;
+    pendingCount++;
+
+    _F91Ancs_requestNext();
+  } else if (eventId == ANCS_EVENT_REMOVED) {
+    // Gone before we got to it, e.g. a call that was answered.
+    for (i = (requestInFlight ? 1 : 0); i < pendingCount; i++) {
+      if (pending[i].uid == uid) {
+        pendingCount--;
+        memmove(&pending[i], &pending[i + 1], (pendingCount - i) * sizeof(f91AncsPending_t));
+        break;
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_requestNext
+ *
+ * @brief   Ask the Control Point for the attributes of the oldest pending
+ *          notification, all in one command. Retried on the next event if
+ *          there is no buffer for it now.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_requestNext(void)
+{
+  uint8_t cmd[ANCS_CMD_LEN];
+
+  if (requestInFlight || (pendingCount == 0)) {
+    return;
+  }
+
+  cmd[0]  = ANCS_CMD_GET_NOTIF_ATTR;
+  cmd[1]  = BREAK_UINT32(pending[0].uid, 0);
+  cmd[2]  = BREAK_UINT32(pending[0].uid, 1);
+  cmd[3]  = BREAK_UINT32(pending[0].uid, 2);
+  cmd[4]  = BREAK_UINT32(pending[0].uid, 3);
+  cmd[5]  = ANCS_ATTR_APP_ID;
+  cmd[6]  = ANCS_ATTR_TITLE;
+  cmd[7]  = LO_UINT16(F91_HISTORY_SENDER_LEN);
+  cmd[8]  = HI_UINT16(F91_HISTORY_SENDER_LEN);
+  cmd[9]  = ANCS_ATTR_MESSAGE;
+  cmd[10] = LO_UINT16(F91_HISTORY_BODY_LEN);
+  cmd[11] = HI_UINT16(F91_HISTORY_BODY_LEN);
+
+  if (_F91Ancs_write(ctrlPointHandle, cmd, sizeof(cmd)) != SUCCESS) {
+    return;
+  }
+
+  requestInFlight = true;
+
+  memset(appId, 0, sizeof(appId));
+  memset(title, 0, sizeof(title));
+  memset(message, 0, sizeof(message));
+  dsParser.state = DS_COMMAND;
+  dsParser.attrsLeft = ANCS_ATTR_COUNT;
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_processDataSrc
+ *
+ * @brief   Data Source notification, one piece of a Get Notification
+ *          Attributes answer. Parsed a byte at a time so the answer can be
+ *          split anywhere; values longer than their buffer are cut.
+ *
+ * @param   pValue - notification value.
+ * @param   len - value length.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_processDataSrc(uint8_t *pValue, uint16_t len)
+{
+  char *pBuf;
+  uint16_t bufLen;
+  uint16_t i;
+
+  for (i = 0; (i < len) && (dsParser.state != DS_IDLE); i++) {
+    switch (dsParser.state) {
+      case DS_COMMAND:
+        if (pValue[i] != ANCS_CMD_GET_NOTIF_ATTR) {
+          dsParser.state = DS_IDLE;
+          break;
+        }
+        dsParser.uid = 0;
+        dsParser.pos = 0;
+        dsParser.state = DS_UID;
+        break;
+
+      case DS_UID:
+        dsParser.uid |= (uint32_t)pValue[i] << (8 * dsParser.pos);
+        if (++dsParser.pos == sizeof(uint32_t)) {
+          dsParser.state = (dsParser.uid == pending[0].uid) ? DS_ATTR_ID : DS_IDLE;
+        }
+        break;
+
+      case DS_ATTR_ID:
+        dsParser.attrId = pValue[i];
+        dsParser.attrLen = 0;
+        dsParser.pos = 0;
+        dsParser.state = DS_ATTR_LEN;
+        break;
+
+      case DS_ATTR_LEN:
+        dsParser.attrLen |= (uint16_t)pValue[i] << (8 * dsParser.pos);
+        if (++dsParser.pos == sizeof(uint16_t)) {
+          dsParser.valuePos = 0;
+          if (dsParser.attrLen == 0) {
+            _F91Ancs_finishAttribute();
+          } else {
+            dsParser.state = DS_ATTR_VALUE;
+          }
+        }
+        break;
+
+      case DS_ATTR_VALUE:
+        if (dsParser.attrId == ANCS_ATTR_APP_ID) {
+          pBuf = appId;
+          bufLen = F91_ANCS_APP_ID_LEN;
+        } else if (dsParser.attrId == ANCS_ATTR_TITLE) {
+          pBuf = title;
+          bufLen = F91_HISTORY_SENDER_LEN;
+        } else if (dsParser.attrId == ANCS_ATTR_MESSAGE) {
+          pBuf = message;
+          bufLen = F91_HISTORY_BODY_LEN;
+        } else {
+          pBuf = NULL;
+          bufLen = 0;
+        }
+
+        if (dsParser.valuePos < bufLen) {
+          pBuf[dsParser.valuePos] = pValue[i];
+        }
+        if (++dsParser.valuePos == dsParser.attrLen) {
+          _F91Ancs_finishAttribute();
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  if ((dsParser.state == DS_IDLE) && requestInFlight && (dsParser.attrsLeft > 0)) {
+    // Not the answer we asked for, skip this notification.
+    Display_print0(F91_LOGGER, 16, 0, "ANCS: bad attribute answer");
+    requestInFlight = false;
+    pendingCount--;
+    memmove(&pending[0], &pending[1], pendingCount * sizeof(f91AncsPending_t));
+    _F91Ancs_requestNext();
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_finishAttribute
+ *
+ * @brief   One attribute of the answer is in. After the last one the
+ *          notification is handed on and the next one asked for.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_finishAttribute(void)
+{
+  uint8_t category;
+
+  if (--dsParser.attrsLeft > 0) {
+    dsParser.state = DS_ATTR_ID;
+    return;
+  }
+
+  dsParser.state = DS_IDLE;
+  requestInFlight = false;
+
+  category = pending[0].category;
+  pendingCount--;
+  memmove(&pending[0], &pending[1], pendingCount * sizeof(f91AncsPending_t));
+
+  _F91Ancs_deliver(category);
+  _F91Ancs_requestNext();
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_deliver
+ *
+ * @brief   Hand a call or message to the notification module, the same
+ *          way the companion app's state sync does.
+ *
+ * @param   category - ANCS category of the notification.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_deliver(uint8_t category)
+{
+  const char *sender = title;
+  const char *dot;
+
+  // No title, show which app it came from: "com.apple.MobileSMS" -> "MobileSMS".
+  if (sender[0] == '\0') {
+    dot = strrchr(appId, '.');
+    sender = (dot != NULL) ? (dot + 1) : appId;
+  }
+
+  memset(&ancsUpdate, 0, sizeof(ancsUpdate));
+
+  if (category == ANCS_CATEGORY_INCOMING_CALL) {
+    ancsUpdate.present = F91_SYNC_FIELD(F91_SYNC_TAG_CALL);
+    strncpy(ancsUpdate.call, sender, sizeof(ancsUpdate.call) - 1);
+    F91Notification_applySync(&ancsUpdate);
+    F91Notification_post(NOTIFICATION_CALL);
+  } else {
+    ancsUpdate.present = F91_SYNC_FIELD(F91_SYNC_TAG_TEXT) | F91_SYNC_FIELD(F91_SYNC_TAG_BODY);
+    strncpy(ancsUpdate.text, sender, sizeof(ancsUpdate.text) - 1);
+    strncpy(ancsUpdate.body, message, sizeof(ancsUpdate.body) - 1);
+    F91Notification_applySync(&ancsUpdate);
+    F91Notification_post(NOTIFICATION_TEXT);
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Ancs_setBar
+ *
+ * @brief   Update the notification bar from a category count.
+ *
+ * @param   category - ANCS category.
+ * @param   count - notifications of that category on the phone.
+ *
+ * @return  None.
+ */
+static void _F91Ancs_setBar(uint8_t category, uint8_t count)
+{
+  uint8_t bar = ancsBar;
+  uint8_t icon;
+
+  switch (category) {
+    case ANCS_CATEGORY_EMAIL:
+      icon = EMAIL;
+      break;
+    case ANCS_CATEGORY_SOCIAL:
+      icon = TEXT;
+      break;
+    case ANCS_CATEGORY_VOICEMAIL:
+      icon = VOICEMAIL;
+      break;
+    case ANCS_CATEGORY_MISSED_CALL:
+      icon = MISSEDCALL;
+      break;
+    default:
+      return;
+  }
+
+  if (count > 0) {
+    bar |= (1 << icon);
+  } else {
+    bar &= ~(1 << icon);
+  }
+
+  if (bar == ancsBar) {
+    return;
+  }
+  ancsBar = bar;
+
+  memset(&ancsUpdate, 0, sizeof(ancsUpdate));
+  ancsUpdate.present = F91_SYNC_FIELD(F91_SYNC_TAG_BAR);
+  ancsUpdate.bar = ancsBar;
+  F91Notification_applySync(&ancsUpdate);
+  F91Notification_post(NOTIFICATION_BAR);
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Ancs_init
+ *
+ * @brief   Initialization function for the ANCS client.
+ *
+ * @param   taskId - ICall entity of the application task.
+ *
+ * @return  none
+ */
+void F91Ancs_init(uint8_t taskId)
+{
+  ancsTaskId = taskId;
+
+  GATT_InitClient();
+
+  // Notifications from the central come to the application task.
+  GATT_RegisterForInd(taskId);
+
+  F91Ancs_reset();
+}
+
+/*********************************************************************
+ * @fn      F91Ancs_start
+ *
+ * @brief   Start looking for ANCS on the central. ANCS only answers over
+ *          an encrypted link, call once pairing or bonding is done.
+ *
+ * @param   connHandle - connection to the central.
+ *
+ * @return  none
+ */
+void F91Ancs_start(uint16_t connHandle)
+{
+  if (ancsState != ANCS_STATE_IDLE) {
+    return;
+  }
+
+  ancsConnHandle = connHandle;
+  ancsState = ANCS_STATE_DISC_SERVICE;
+
+  if (GATT_DiscPrimaryServiceByUUID(connHandle, (uint8_t *)ancsServiceUUID,
+                                    ATT_UUID_SIZE, ancsTaskId) != SUCCESS) {
+    _F91Ancs_fail(FAILURE);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Ancs_isBusy
+ *
+ * @brief   Discovery and subscription run back to back, and in use every
+ *          notification asked for is answered on the Data Source.
+ *
+ * @param   none
+ *
+ * @return  true while waiting on the central.
+ */
+bool F91Ancs_isBusy(void)
+{
+  if (ancsState == ANCS_STATE_READY) {
+    return requestInFlight;
+  }
+
+  return (ancsState != ANCS_STATE_IDLE);
+}
+
+/*********************************************************************
+ * @fn      F91Ancs_reset
+ *
+ * @brief   Forget the central's handles and anything pending.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Ancs_reset(void)
+{
+  ancsState = ANCS_STATE_IDLE;
+
+  svcStartHandle = 0;
+  svcEndHandle = 0;
+  notifSrcHandle = 0;
+  notifSrcCccdHandle = 0;
+  ctrlPointHandle = 0;
+  dataSrcHandle = 0;
+  dataSrcCccdHandle = 0;
+
+  pendingCount = 0;
+  requestInFlight = false;
+  dsParser.state = DS_IDLE;
+
+  // Rebuilt from the counts sent again on the next subscribe.
+  ancsBar = 0;
+}
+
+/*********************************************************************
+ * @fn      F91Ancs_processGATTMsg
+ *
+ * @brief   GATT client messages: discovery and write responses, and the
+ *          notifications from the central.
+ *
+ * @param   pMsg - GATT message, freed by the caller.
+ *
+ * @return  true if the message was for the ANCS client.
+ */
+bool F91Ancs_processGATTMsg(gattMsgEvent_t *pMsg)
+{
+  if ((ancsState == ANCS_STATE_IDLE) || (pMsg->connHandle != ancsConnHandle)) {
+    return false;
+  }
+
+  if (pMsg->method == ATT_HANDLE_VALUE_NOTI) {
+    if (pMsg->msg.handleValueNoti.handle == notifSrcHandle) {
+      _F91Ancs_processNotifSrc(pMsg->msg.handleValueNoti.pValue, pMsg->msg.handleValueNoti.len);
+    } else if (pMsg->msg.handleValueNoti.handle == dataSrcHandle) {
+      _F91Ancs_processDataSrc(pMsg->msg.handleValueNoti.pValue, pMsg->msg.handleValueNoti.len);
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  switch (ancsState) {
+    case ANCS_STATE_DISC_SERVICE:
+      _F91Ancs_processServiceRsp(pMsg);
+      break;
+
+    case ANCS_STATE_DISC_CHARS:
+      _F91Ancs_processCharsRsp(pMsg);
+      break;
+
+    case ANCS_STATE_DISC_DESCS:
+      _F91Ancs_processDescsRsp(pMsg);
+      break;
+
+    case ANCS_STATE_SUBSCRIBE_DATA:
+    case ANCS_STATE_SUBSCRIBE_NOTIF:
+      if (pMsg->method == ATT_ERROR_RSP) {
+        _F91Ancs_fail(pMsg->msg.errorRsp.errCode);
+      } else if (pMsg->method != ATT_WRITE_RSP) {
+        return false;
+      } else if (ancsState == ANCS_STATE_SUBSCRIBE_DATA) {
+        ancsState = ANCS_STATE_SUBSCRIBE_NOTIF;
+        _F91Ancs_subscribe(notifSrcCccdHandle);
+      } else {
+        ancsState = ANCS_STATE_READY;
+        Display_print0(F91_LOGGER, 16, 0, "ANCS: subscribed");
+      }
+      break;
+
+    case ANCS_STATE_READY:
+      if (pMsg->method == ATT_ERROR_RSP) {
+        // The Control Point refused the request, the notification is gone.
+        if (requestInFlight && (pMsg->msg.errorRsp.handle == ctrlPointHandle)) {
+          requestInFlight = false;
+          dsParser.state = DS_IDLE;
+          pendingCount--;
+          memmove(&pending[0], &pending[1], pendingCount * sizeof(f91AncsPending_t));
+        }
+        _F91Ancs_requestNext();
+      } else if (pMsg->method == ATT_WRITE_RSP) {
+        // The answer follows on the Data Source. A request that found no
+        // buffer earlier is retried now.
+        _F91Ancs_requestNext();
+      } else {
+        return false;
+      }
+      break;
+
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+/*********************************************************************
+*********************************************************************/
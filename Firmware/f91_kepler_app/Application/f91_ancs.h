@@ -0,0 +1,129 @@
+/******************************************************************************
+
+ @file  f91_ancs.h
+
+ @brief This file contains the F91 Kepler Smart Watch Apple Notification
+        Center Service (ANCS) client definitions and prototypes. The watch
+        discovers ANCS on a bonded iPhone, subscribes to it and feeds calls,
+        texts and the notification bar without a companion app.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91ANCS_H
+#define F91ANCS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+#include "gatt.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Notifications waiting for their attributes, one request is in flight at a time.
+#define F91_ANCS_PENDING_LEN            4
+
+// Longest app identifier kept, only used when a notification has no title.
+#define F91_ANCS_APP_ID_LEN             32
+
+// Notification Source event IDs
+#define ANCS_EVENT_ADDED                0
+#define ANCS_EVENT_MODIFIED             1
+#define ANCS_EVENT_REMOVED              2
+
+// Notification Source event flags
+#define ANCS_FLAG_SILENT                (1 << 0)
+#define ANCS_FLAG_IMPORTANT             (1 << 1)
+#define ANCS_FLAG_PRE_EXISTING          (1 << 2)
+
+// Category IDs
+#define ANCS_CATEGORY_OTHER             0
+#define ANCS_CATEGORY_INCOMING_CALL     1
+#define ANCS_CATEGORY_MISSED_CALL       2
+#define ANCS_CATEGORY_VOICEMAIL         3
+#define ANCS_CATEGORY_SOCIAL            4
+#define ANCS_CATEGORY_SCHEDULE          5
+#define ANCS_CATEGORY_EMAIL             6
+
+// Control Point command and notification attribute IDs
+#define ANCS_CMD_GET_NOTIF_ATTR         0
+#define ANCS_ATTR_APP_ID                0
+#define ANCS_ATTR_TITLE                 1
+#define ANCS_ATTR_MESSAGE               3
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the ANCS client, GATT client messages are sent to taskId.
+ */
+extern void F91Ancs_init(uint8_t taskId);
+
+/*
+ * Look for ANCS on the connected central and subscribe to it. Once the link is encrypted.
+ */
+extern void F91Ancs_start(uint16_t connHandle);
+
+/*
+ * Whether a client procedure is waiting on the central.
+ */
+extern bool F91Ancs_isBusy(void);
+
+/*
+ * Forget the central's ANCS, on disconnect.
+ */
+extern void F91Ancs_reset( void );
+
+/*
+ * GATT client responses and notifications. Returns true if it was an ANCS one.
+ */
+extern bool F91Ancs_processGATTMsg(gattMsgEvent_t *pMsg);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91ANCS_H */
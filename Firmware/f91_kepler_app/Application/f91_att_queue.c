@@ -0,0 +1,351 @@
+/******************************************************************************
+
+ @file  f91_att_queue.c
+
+ @brief This file contains the F91 Kepler Smart Watch ATT queue.
+
+        Held entries keep the order they came in. On each connection
+        event they are sent oldest first for as long as the controller
+        takes them; once it turns one down, what follows on the same
+        connection waits for the next event so the phone sees responses
+        and notifications in the order they were made.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+
+#include <icall.h>
+#include "icall_ble_api.h"
+
+#include "bcomdef.h"
+#include "att.h"
+#include "gatt.h"
+
+#include "f91_att_queue.h"
+#include "f91_utils.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+// Controller out of buffers, worth another try on the next event.
+#define F91_ATT_QUEUE_RETRY(status)     (((status) == blePending) || \
+                                         ((status) == MSG_BUFFER_NOT_AVAIL))
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint16_t             connHandle;
+  gattMsgEvent_t       *pRsp;           // held response, NULL for a notification
+  attHandleValueNoti_t noti;            // notification, payload from GATT_bm_alloc
+} f91AttQueueEntry_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static f91AttQueueEntry_t queue[F91_ATT_QUEUE_LEN];
+static uint8_t  queueCount = 0;
+
+// Counters for the log, over all connections.
+static uint32_t retries = 0;
+static uint32_t dropped = 0;
+static uint8_t  highWater = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static bool _F91AttQueue_push(uint16_t connHandle, gattMsgEvent_t *pRsp, attHandleValueNoti_t *pNoti);
+static void _F91AttQueue_remove(uint8_t index);
+static bool _F91AttQueue_isQueued(uint16_t connHandle, uint8_t count);
+static bStatus_t _F91AttQueue_send(f91AttQueueEntry_t *pEntry);
+static void _F91AttQueue_free(f91AttQueueEntry_t *pEntry, bStatus_t status);
+
+/*********************************************************************
+ * @fn      _F91AttQueue_push
+ *
+ * @brief   Add an entry at the back of the queue and ask the F91_Kepler
+ *          task for connection events.
+ *
+ * @param   connHandle - connection handle.
+ * @param   pRsp - response message, or NULL.
+ * @param   pNoti - notification if pRsp is NULL.
+ *
+ * @return  false if the queue is full.
+ */
+static bool _F91AttQueue_push(uint16_t connHandle, gattMsgEvent_t *pRsp, attHandleValueNoti_t *pNoti)
+{
+  f91AttQueueEntry_t *pEntry;
+
+  if (queueCount == F91_ATT_QUEUE_LEN) {
+    dropped++;
+    return false;
+  }
+
+  pEntry = &queue[queueCount++];
+  pEntry->connHandle = connHandle;
+  pEntry->pRsp = pRsp;
+  if (pRsp == NULL) {
+    pEntry->noti = *pNoti;
+  }
+
+  highWater = MAX(highWater, queueCount);
+  F91Kepler_attQueueCB();
+  return true;
+}
+
+/*********************************************************************
+ * @fn      _F91AttQueue_remove
+ *
+ * @brief   Take an entry out, the ones behind it move up.
+ *
+ * @param   index - entry to remove.
+ *
+ * @return  None.
+ */
+static void _F91AttQueue_remove(uint8_t index)
+{
+  queueCount--;
+  memmove(&queue[index], &queue[index + 1], (queueCount - index) * sizeof(f91AttQueueEntry_t));
+}
+
+/*********************************************************************
+ * @fn      _F91AttQueue_isQueued
+ *
+ * @brief   Look for an entry of the connection among the first ones.
+ *
+ * @param   connHandle - connection handle.
+ * @param   count - number of entries to look at.
+ *
+ * @return  true if the connection has something waiting ahead.
+ */
+static bool _F91AttQueue_isQueued(uint16_t connHandle, uint8_t count)
+{
+  uint8_t i;
+
+  for (i = 0; i < count; i++) {
+    if (queue[i].connHandle == connHandle) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*********************************************************************
+ * @fn      _F91AttQueue_send
+ *
+ * @brief   Hand an entry to the stack.
+ *
+ * @param   pEntry - entry to send.
+ *
+ * @return  Status from the stack.
+ */
+static bStatus_t _F91AttQueue_send(f91AttQueueEntry_t *pEntry)
+{
+  if (pEntry->pRsp != NULL) {
+    return GATT_SendRsp(pEntry->connHandle, pEntry->pRsp->method, &pEntry->pRsp->msg);
+  }
+
+  return GATT_Notification(pEntry->connHandle, &pEntry->noti, FALSE);
+}
+
+/*********************************************************************
+ * @fn      _F91AttQueue_free
+ *
+ * @brief   Done with an entry, sent or not. The stack keeps the payload of
+ *          what it sent.
+ *
+ * @param   pEntry - entry to free.
+ * @param   status - status of the last send.
+ *
+ * @return  None.
+ */
+static void _F91AttQueue_free(f91AttQueueEntry_t *pEntry, bStatus_t status)
+{
+  if (pEntry->pRsp != NULL) {
+    if (status != SUCCESS) {
+      GATT_bm_free(&pEntry->pRsp->msg, pEntry->pRsp->method);
+    }
+    ICall_freeMsg(pEntry->pRsp);
+  } else if (status != SUCCESS) {
+    GATT_bm_free((gattMsg_t *)&pEntry->noti, ATT_HANDLE_VALUE_NOTI);
+  }
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91AttQueue_init
+ *
+ * @brief   Initialization function for the ATT queue.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91AttQueue_init(void)
+{
+  queueCount = 0;
+}
+
+/*********************************************************************
+ * @fn      F91AttQueue_holdRsp
+ *
+ * @brief   The GATT server reports an ATT response it had no buffer for
+ *          with blePending. Hold the message to send it again.
+ *
+ * @param   pMsg - GATT message from the stack.
+ *
+ * @return  true if the message is held, it is not to be freed.
+ */
+bool F91AttQueue_holdRsp(gattMsgEvent_t *pMsg)
+{
+  if (pMsg->hdr.status != blePending) {
+    return false;
+  }
+
+  return _F91AttQueue_push(pMsg->connHandle, pMsg, NULL);
+}
+
+/*********************************************************************
+ * @fn      F91AttQueue_sendNoti
+ *
+ * @brief   Send a notification. It waits in the queue if the connection
+ *          already has something there, or if the controller is out of
+ *          buffers.
+ *
+ * @param   connHandle - connection handle.
+ * @param   pNoti - notification, payload from GATT_bm_alloc.
+ *
+ * @return  SUCCESS if sent or queued, otherwise the payload is left to the
+ *          caller to free.
+ */
+bStatus_t F91AttQueue_sendNoti(uint16_t connHandle, attHandleValueNoti_t *pNoti)
+{
+  bStatus_t status = MSG_BUFFER_NOT_AVAIL;
+
+  if (!_F91AttQueue_isQueued(connHandle, queueCount)) {
+    status = GATT_Notification(connHandle, pNoti, FALSE);
+    if (!F91_ATT_QUEUE_RETRY(status)) {
+      return status;
+    }
+  }
+
+  return _F91AttQueue_push(connHandle, NULL, pNoti) ? SUCCESS : status;
+}
+
+/*********************************************************************
+ * @fn      F91AttQueue_process
+ *
+ * @brief   A connection event ended. Send as much as the controller takes,
+ *          a connection stops at its first entry turned down.
+ *
+ * @param   none
+ *
+ * @return  true once the queue is empty.
+ */
+bool F91AttQueue_process(void)
+{
+  bStatus_t status;
+  uint8_t   i = 0;
+
+  while (i < queueCount) {
+    // Something earlier on this connection is still waiting.
+    if (_F91AttQueue_isQueued(queue[i].connHandle, i)) {
+      i++;
+      continue;
+    }
+
+    status = _F91AttQueue_send(&queue[i]);
+    if (F91_ATT_QUEUE_RETRY(status)) {
+      retries++;
+      i++;
+      continue;
+    }
+
+    _F91AttQueue_free(&queue[i], status);
+    _F91AttQueue_remove(i);
+  }
+
+  return (queueCount == 0);
+}
+
+/*********************************************************************
+ * @fn      F91AttQueue_isRspPending
+ *
+ * @brief   The central waits on a held response, where a notification can
+ *          wait for the next event the watch listens on anyway.
+ *
+ * @param   none
+ *
+ * @return  true while an ATT response is held.
+ */
+bool F91AttQueue_isRspPending(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < queueCount; i++) {
+    if (queue[i].pRsp != NULL) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*********************************************************************
+ * @fn      F91AttQueue_reset
+ *
+ * @brief   The connection is gone, so is what was held for it.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91AttQueue_reset(void)
+{
+  dropped += queueCount;
+  while (queueCount > 0) {
+    _F91AttQueue_free(&queue[queueCount - 1], bleNotConnected);
+    queueCount--;
+  }
+
+  Display_print3(F91_LOGGER, F91_ATT_QUEUE_LOG_LINE, 0, "ATT queue: %d retries, %d dropped, %d max",
+                 retries, dropped, highWater);
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,109 @@
+/******************************************************************************
+
+ @file  f91_att_queue.h
+
+ @brief This file contains the F91 Kepler Smart Watch ATT queue definitions
+        and prototypes. ATT responses the stack could not send and
+        notifications the controller had no buffer for are held in order
+        and retried on the following connection events.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91ATTQUEUE_H
+#define F91ATTQUEUE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+
+#include "gatt.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Responses and notifications held at once. A few of each: the client has
+// one request outstanding per bearer, the outbound queue bursts a handful
+// of notifications.
+#define F91_ATT_QUEUE_LEN               6
+
+// Log line of the counters.
+#define F91_ATT_QUEUE_LOG_LINE          30
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the ATT queue.
+ */
+extern void F91AttQueue_init(void);
+
+/*
+ * Hold an ATT response the stack could not send, true if held.
+ */
+extern bool F91AttQueue_holdRsp(gattMsgEvent_t *pMsg);
+
+/*
+ * Send a notification, or queue it behind what the connection already has
+ * waiting. The payload belongs to the queue unless an error is returned.
+ */
+extern bStatus_t F91AttQueue_sendNoti(uint16_t connHandle, attHandleValueNoti_t *pNoti);
+
+/*
+ * Retry what is held, on a connection event. true once the queue is empty.
+ */
+extern bool F91AttQueue_process(void);
+
+/*
+ * true while an ATT response is held.
+ */
+extern bool F91AttQueue_isRspPending(void);
+
+/*
+ * The connection is gone, drop what is held.
+ */
+extern void F91AttQueue_reset(void);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91ATTQUEUE_H */
@@ -0,0 +1,289 @@
+/******************************************************************************
+
+ @file  f91_bulk.c
+
+ @brief This file contains the F91 Kepler Smart Watch bulk channel.
+
+        The stack reassembles each SDU and hands it over in one buffer.
+        The buffer goes straight to the consumer of its type and is freed
+        once the consumer returns, nothing is copied on the way. Credits
+        are handed back in one go when the phone runs low, so it can keep
+        a few PDUs in flight in every connection event.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include <icall.h>
+#include "icall_ble_api.h"
+
+#include "bcomdef.h"
+#include "l2cap.h"
+#include "linkdb.h"
+
+#include "f91_bulk.h"
+#include "f91_link.h"
+#include "f91_utils.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static f91BulkConsumer_t consumers[F91_BULK_TYPES];
+
+// Channel open, 0 if none.
+static uint16_t bulkCID = 0;
+
+// Connection whose link is encrypted and authenticated. Cached from the
+// application task, the security callback runs in the stack's.
+static uint16_t secureConnHandle = INVALID_CONNHANDLE;
+
+// Counters of the channel open, for the log.
+static uint32_t sdus = 0;
+static uint32_t bytes = 0;
+static uint32_t dropped = 0;
+static uint32_t firstTicks;
+static uint32_t lastTicks;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void _F91Bulk_close(void);
+static uint8_t _F91Bulk_verifySecurity(uint16_t connHandle, uint8_t id,
+                                       l2capConnectReq_t *pReq);
+
+/*********************************************************************
+ * @fn      _F91Bulk_close
+ *
+ * @brief   The channel is gone. Log what went through it, the rate from
+ *          the first to the last SDU.
+ *
+ * @return  None.
+ */
+static void _F91Bulk_close(void)
+{
+  uint32_t ms = (lastTicks - firstTicks) / (1000 / Clock_tickPeriod);
+
+  if (bulkCID == 0) {
+    return;
+  }
+
+  Display_print4(F91_LOGGER, F91_BULK_LOG_LINE, 0, "Bulk: %d SDUs, %d bytes, %d dropped, %d B/s",
+                 sdus, bytes, dropped, ms ? (bytes * 1000 / ms) : 0);
+  bulkCID = 0;
+}
+
+/*********************************************************************
+ * @fn      _F91Bulk_verifySecurity
+ *
+ * @brief   Channel request from the phone, called by the stack. The
+ *          objects are texts and OAD blocks, the same as the
+ *          characteristics that need an authenticated link to be written.
+ *
+ * @param   connHandle - connection the request came on.
+ * @param   id - signaling identifier.
+ * @param   pReq - connection request.
+ *
+ * @return  SUCCESS or L2CAP_CONN_INSUFFICIENT_AUTHEN
+ */
+static uint8_t _F91Bulk_verifySecurity(uint16_t connHandle, uint8_t id,
+                                       l2capConnectReq_t *pReq)
+{
+  return (connHandle == secureConnHandle) ? SUCCESS : L2CAP_CONN_INSUFFICIENT_AUTHEN;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Bulk_init
+ *
+ * @brief   Initialization function for the bulk channel.
+ *
+ * @param   taskId - ICall entity the channel events go to.
+ *
+ * @return  none
+ */
+void F91Bulk_init(uint8_t taskId)
+{
+  l2capPsm_t psm;
+
+  psm.psm = F91_BULK_PSM;
+  psm.mtu = F91_BULK_MTU;
+  psm.initPeerCredits = F91_BULK_CREDITS;
+  psm.peerCreditThreshold = F91_BULK_CREDIT_THRESHOLD;
+  psm.maxNumChannels = 1;
+  psm.pfnVerifySecCB = _F91Bulk_verifySecurity;
+  psm.taskId = ICall_getLocalMsgEntityId(ICALL_SERVICE_CLASS_BLE_MSG, taskId);
+
+  L2CAP_RegisterPsm(&psm);
+}
+
+/*********************************************************************
+ * @fn      F91Bulk_register
+ *
+ * @brief   Hand the objects of a type to a consumer. One per type, the
+ *          last one registered wins.
+ *
+ * @param   type - F91_BULK_TYPE_xxx.
+ * @param   pfnConsumer - consumer, NULL to drop the type.
+ *
+ * @return  none
+ */
+void F91Bulk_register(uint8_t type, f91BulkConsumer_t pfnConsumer)
+{
+  if (type < F91_BULK_TYPES) {
+    consumers[type] = pfnConsumer;
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Bulk_updateSecurity
+ *
+ * @brief   Pairing or bonding done, the link is encrypted. The channel
+ *          is only granted if the keys were authenticated.
+ *
+ * @param   connHandle - connection of the link.
+ *
+ * @return  none
+ */
+void F91Bulk_updateSecurity(uint16_t connHandle)
+{
+  if (linkDB_State(connHandle, LINK_ENCRYPTED) &&
+      linkDB_State(connHandle, LINK_AUTHENTICATED)) {
+    secureConnHandle = connHandle;
+  } else {
+    secureConnHandle = INVALID_CONNHANDLE;
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Bulk_reset
+ *
+ * @brief   The connection is gone, the stack dropped the channel.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Bulk_reset(void)
+{
+  secureConnHandle = INVALID_CONNHANDLE;
+  _F91Bulk_close();
+}
+
+/*********************************************************************
+ * @fn      F91Bulk_processSignal
+ *
+ * @brief   Channel opened or closed, and credits running low.
+ *
+ * @param   pMsg - L2CAP signaling event.
+ *
+ * @return  none
+ */
+void F91Bulk_processSignal(l2capSignalEvent_t *pMsg)
+{
+  switch (pMsg->opcode) {
+    case L2CAP_CHANNEL_ESTABLISHED_EVT:
+      if ((pMsg->cmd.channelEstEvt.result == L2CAP_CONN_SUCCESS) &&
+          (pMsg->cmd.channelEstEvt.info.psm == F91_BULK_PSM)) {
+        bulkCID = pMsg->cmd.channelEstEvt.CID;
+        sdus = bytes = dropped = 0;
+        firstTicks = lastTicks = Clock_getTicks();
+      }
+      break;
+
+    case L2CAP_CHANNEL_TERMINATED_EVT:
+      if (pMsg->cmd.channelTermEvt.CID == bulkCID) {
+        _F91Bulk_close();
+      }
+      break;
+
+    case L2CAP_PEER_CREDIT_THRESHOLD_EVT:
+      if (pMsg->cmd.creditEvt.CID == bulkCID) {
+        L2CAP_FlowCtrlCredit(bulkCID, F91_BULK_CREDITS - F91_BULK_CREDIT_THRESHOLD);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Bulk_processData
+ *
+ * @brief   Hand an SDU to the consumer of its type, then free it. The
+ *          link is checked again before the object is handed on.
+ *
+ * @param   pMsg - L2CAP data event.
+ *
+ * @return  none
+ */
+void F91Bulk_processData(l2capDataEvent_t *pMsg)
+{
+  uint8_t  *pSdu = pMsg->pkt.pPayload;
+  uint16_t len = pMsg->pkt.len;
+
+  if ((pMsg->pkt.CID == bulkCID) && (len >= F91_BULK_HDR_LEN) &&
+      (pSdu[0] < F91_BULK_TYPES) && (consumers[pSdu[0]] != NULL) &&
+      linkDB_State(pMsg->connHandle, LINK_ENCRYPTED) &&
+      linkDB_State(pMsg->connHandle, LINK_AUTHENTICATED)) {
+    if (sdus++ == 0) {
+      firstTicks = Clock_getTicks();
+    }
+    lastTicks = Clock_getTicks();
+    bytes += len;
+
+    // Traffic for the link manager, same as the characteristic writes.
+    F91Link_countRx(len);
+
+    consumers[pSdu[0]](&pSdu[F91_BULK_HDR_LEN], len - F91_BULK_HDR_LEN);
+  } else {
+    dropped++;
+  }
+
+  if (pSdu != NULL) {
+    BM_free(pSdu);
+  }
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,129 @@
+/******************************************************************************
+
+ @file  f91_bulk.h
+
+ @brief This file contains the F91 Kepler Smart Watch bulk channel
+        definitions and prototypes. The phone opens an L2CAP connection
+        oriented channel for objects too large for a characteristic write,
+        each SDU carries one typed object.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91BULK_H
+#define F91BULK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+
+#include "l2cap.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// LE PSM the phone connects to, from the dynamic range.
+#define F91_BULK_PSM                    0x0081
+
+// Largest SDU, a text with a full sender and body and the type byte.
+#define F91_BULK_MTU                    300
+
+// Credits (PDUs the phone may send) given when the channel opens. Once the
+// phone is down to the threshold it gets back what it used.
+#define F91_BULK_CREDITS                8
+#define F91_BULK_CREDIT_THRESHOLD       2
+
+// Object types, the first byte of every SDU.
+#define F91_BULK_TYPE_TEXT              0x01  // [sender][0][body][0], a text with its body
+#define F91_BULK_TYPE_OAD_BLOCK         0x02  // [block lo][block hi][data], as the OAD block characteristic
+#define F91_BULK_TYPES                  3
+
+#define F91_BULK_HDR_LEN                1
+
+// Log line of the channel counters.
+#define F91_BULK_LOG_LINE               32
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Takes the object of one SDU, without the type byte. The data is the
+// stack's SDU buffer, only valid during the call.
+typedef void (*f91BulkConsumer_t)( uint8_t *pData, uint16_t len );
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the bulk channel, registers the PSM.
+ */
+extern void F91Bulk_init(uint8_t taskId);
+
+/*
+ * Hand objects of a type to a consumer, at init.
+ */
+extern void F91Bulk_register(uint8_t type, f91BulkConsumer_t pfnConsumer);
+
+/*
+ * The link got encrypted, check if it is secure enough for the channel.
+ */
+extern void F91Bulk_updateSecurity(uint16_t connHandle);
+
+/*
+ * The connection is gone, and the channel with it.
+ */
+extern void F91Bulk_reset(void);
+
+/*
+ * L2CAP signaling events for the channel.
+ */
+extern void F91Bulk_processSignal(l2capSignalEvent_t *pMsg);
+
+/*
+ * An SDU was received.
+ */
+extern void F91Bulk_processData(l2capDataEvent_t *pMsg);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91BULK_H */
@@ -27,6 +27,10 @@
 #include "f91_kepler.h"
 #include "f91_buttons.h"
 #include "f91_notification.h"
+#include "f91_stopwatch.h"
+#include "f91_alarm.h"
+#include "f91_clock.h"
+#include "f91_outbound.h"
 
 #include <ti/display/Display.h>
 #include <ti/sysbios/BIOS.h>
@@ -44,7 +48,6 @@
 /*********************************************************************
  * CONSTANTS
  */
-#define DISPLAY_TIMEOUT 5000 //5 seconds
 
 /*********************************************************************
  * TYPEDEFS
@@ -93,13 +96,17 @@ PIN_Config buttonPinTable[] = {
 static Clock_Struct button0DebounceClock;
 static Clock_Struct button1DebounceClock;
 
-// Clock object used to signal display timeout
+// Clock object used to signal display timeout, shared with the notifications
 static Clock_Struct startDispClock;
 
 // State of the buttons
 static uint8_t button0State = 0;
 static uint8_t button1State = 0;
 
+// Clock ticks when the buttons were pressed, to tell long presses apart
+static uint32_t button0PressTick = 0;
+static uint32_t button1PressTick = 0;
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -107,6 +114,9 @@ static uint8_t button1State = 0;
 static void F91Buttons_buttonCallbackFxn(PIN_Handle handle, PIN_Id pinId);
 static void F91Buttons_buttonDebounceSwiFxn(UArg buttonId);
 static void F91Buttons_clockChangeDisplayCallbackFxn(UArg state);
+static void F91Buttons_processStopwatchPress(button_state_t *buttonInfo);
+static void F91Buttons_processHistoryPress(button_state_t *buttonInfo);
+static void F91Buttons_dismissNotification(button_state_t *buttonInfo);
 
 
 /*********************************************************************
@@ -123,6 +133,7 @@ static void F91Buttons_buttonDebounceSwiFxn(UArg buttonId)
   // Used to send message to app
   button_state_t buttonMsg = { .pinId = buttonId };
   uint8_t        sendMsg   = FALSE;
+  uint32_t       longPressTicks = BUTTON_LONG_PRESS * (1000 / Clock_tickPeriod);
 
   // Get current value of the button pin after the clock timeout
   uint8_t buttonPinVal = PIN_getInputValue(buttonId);
@@ -147,12 +158,14 @@ static void F91Buttons_buttonDebounceSwiFxn(UArg buttonId)
       {
         // Button was released
         buttonMsg.state = button0State = 0;
+        buttonMsg.longPress = (Clock_getTicks() - button0PressTick) >= longPressTicks;
         sendMsg = TRUE;
       }
       else if (!buttonPinVal && !button0State)
       {
         // Button was pressed
         buttonMsg.state = button0State = 1;
+        button0PressTick = Clock_getTicks();
         sendMsg = FALSE;
       }
       break;
@@ -162,12 +175,14 @@ static void F91Buttons_buttonDebounceSwiFxn(UArg buttonId)
       {
         // Button was released
         buttonMsg.state = button1State = 0;
+        buttonMsg.longPress = (Clock_getTicks() - button1PressTick) >= longPressTicks;
         sendMsg = TRUE;
       }
       else if (!buttonPinVal && !button1State)
       {
         // Button was pressed
         buttonMsg.state = button1State = 1;
+        button1PressTick = Clock_getTicks();
         sendMsg = FALSE;
       }
       break;
@@ -233,6 +248,90 @@ static void F91Buttons_clockChangeDisplayCallbackFxn(UArg state)
     F91Kepler_displayStateChangeCB();
 }
 
+/*********************************************************************
+ * @fn      F91Buttons_processStopwatchPress
+ *
+ * @brief   Button handling while the stopwatch face is shown.
+ *          BUTTON_0: start/stop. BUTTON_1: lap/reset, long press back to the time.
+ *
+ * @param buttonInfo pointer to info on what button was pressed and state
+ */
+static void F91Buttons_processStopwatchPress(button_state_t *buttonInfo)
+{
+    // A full screen notification or its timeout took over the display, any press
+    // brings the stopwatch back.
+    if (F91Notification_getNotificationState()) {
+      F91Notification_resetNotificationState();
+      F91Stopwatch_enter();
+      return;
+    }
+    if (!ssd1306_getState()) {
+      F91Stopwatch_enter();
+      return;
+    }
+
+    if (buttonInfo->pinId == BUTTON_0) {
+      F91Stopwatch_startStop();
+    } else if (buttonInfo->pinId == BUTTON_1) {
+      if (buttonInfo->longPress) {
+        F91Stopwatch_exit();
+        F91Notification_update(NOTIFICATION_BAR);
+        F91Clock_wake();
+        F91Buttons_startDisplayTimeout();
+      } else {
+        F91Stopwatch_lapReset();
+      }
+    }
+}
+
+/*********************************************************************
+ * @fn      F91Buttons_processHistoryPress
+ *
+ * @brief   Button handling while the notification history is shown.
+ *          BUTTON_0: older. BUTTON_1: newer. Long press on either back to the time.
+ *
+ * @param buttonInfo pointer to info on what button was pressed and state
+ */
+static void F91Buttons_processHistoryPress(button_state_t *buttonInfo)
+{
+    if (buttonInfo->longPress) {
+      F91Notification_exitHistory();
+      F91Notification_update(NOTIFICATION_BAR);
+      F91Clock_wake();
+      F91Buttons_startDisplayTimeout();
+    } else {
+      F91Notification_browseHistory(buttonInfo->pinId == BUTTON_0);
+    }
+}
+
+/*********************************************************************
+ * @fn      F91Buttons_dismissNotification
+ *
+ * @brief   Button press on a full screen notification. A short press goes to the next
+ *          queued one, a long press drops them all and turns the display off.
+ *          The phone is told: on a call BUTTON_0 declines it and BUTTON_1 silences it.
+ *
+ * @param buttonInfo pointer to info on what button was pressed and state
+ */
+static void F91Buttons_dismissNotification(button_state_t *buttonInfo)
+{
+    uint8_t shown = F91Notification_getShownAlert();
+
+    if (buttonInfo->longPress) {
+      if (F91Notification_getUnreadCount() > 0) {
+        F91Outbound_postEvent(F91_OUTBOUND_ALL_DISMISSED);
+      }
+      F91Notification_resetNotificationState();
+    } else {
+      if (shown == NOTIFICATION_CALL) {
+        F91Outbound_postEvent((buttonInfo->pinId == BUTTON_1) ? F91_OUTBOUND_CALL_MUTED : F91_OUTBOUND_CALL_DISMISSED);
+      } else if (shown == NOTIFICATION_TEXT) {
+        F91Outbound_postEvent(F91_OUTBOUND_TEXT_DISMISSED);
+      }
+      F91Notification_nextNotification();
+    }
+}
+
 /*********************************************************************
  *  EXTERN FUNCTIONS
  */
@@ -287,16 +386,56 @@ void F91Buttons_processButtonPress(button_state_t *buttonInfo)
     Display_print1(F91_LOGGER, 7, 0, "BUTTON: %d", buttonInfo->pinId);
     Display_print1(F91_LOGGER, 8, 0, "STATE: %d", buttonInfo->state);
 
+    // A ringing alarm or countdown takes any press. BUTTON_0: dismiss. BUTTON_1: snooze.
+    if (F91Alarm_isAlerting()) {
+      if (buttonInfo->pinId == BUTTON_1) {
+        F91Alarm_snooze();
+        F91Outbound_postEvent(F91_OUTBOUND_ALARM_SNOOZED);
+      } else {
+        F91Alarm_dismiss();
+        F91Outbound_postEvent(F91_OUTBOUND_ALARM_DISMISSED);
+      }
+      if (F91Stopwatch_isActive()) {
+        F91Stopwatch_enter();
+      }
+      return;
+    }
+
+    if (F91Stopwatch_isActive()) {
+      F91Buttons_processStopwatchPress(buttonInfo);
+      return;
+    }
+
+    // An alert may have turned the display off under the history, then the
+    // press below just clears the notification state.
+    if (F91Notification_isBrowsingHistory() && ssd1306_getState()) {
+      F91Buttons_processHistoryPress(buttonInfo);
+      return;
+    }
+
     //If button_0 is pressed, toggle display ON and start the one-shot clock for 5 seconds.
-    // Unless there is a full screen display. In that case just turn the display off as to clear the notification.
+    // Unless there is a full screen display. In that case move on to the next queued one, or turn the display off
+    // when there are none left. A long press clears them all.
     // This one shot clock then triggers an event to turn display off.
+    //A long press on button_0 opens the notification history instead.
+    //If button_1 is pressed, switch to the stopwatch, which keeps the display on until left.
     if (buttonInfo->pinId == BUTTON_0) {
       if (F91Notification_getNotificationState()) {
-        F91Notification_resetNotificationState();
+        F91Buttons_dismissNotification(buttonInfo);
+      } else if (buttonInfo->longPress) {
+        F91Notification_browseHistory(true);
       } else {
         F91Notification_update(NOTIFICATION_BAR); //Add notifications if any.
         ssd1306_toggle_display(true);
-        Util_restartClock(&startDispClock, DISPLAY_TIMEOUT);
+        F91Clock_wake();
+        F91Buttons_startDisplayTimeout();
+      }
+    } else if (buttonInfo->pinId == BUTTON_1) {
+      if (F91Notification_getNotificationState()) {
+        F91Buttons_dismissNotification(buttonInfo);
+      } else {
+        F91Buttons_resetOneShot();
+        F91Stopwatch_enter();
       }
     }
 }
@@ -313,6 +452,31 @@ void F91Buttons_resetOneShot(void)
   Util_stopClock(&startDispClock);
 }
 
+/*********************************************************************
+ * @fn      F91Buttons_startDisplayTimeout
+ *
+ * @brief   (Re)start the one shot clock that turns the display off after DISPLAY_TIMEOUT.
+ *
+ * @param none
+ */
+void F91Buttons_startDisplayTimeout(void)
+{
+  Util_restartClock(&startDispClock, DISPLAY_TIMEOUT);
+}
+
+/*********************************************************************
+ * @fn      F91Buttons_startIdleTimeout
+ *
+ * @brief   (Re)start the same one shot clock for a face that stays on longer than
+ *          DISPLAY_TIMEOUT, so full screen notifications still override it.
+ *
+ * @param timeout time (in msec) before the display turns off
+ */
+void F91Buttons_startIdleTimeout(uint32_t timeout)
+{
+  Util_restartClock(&startDispClock, timeout);
+}
+
 
 /*********************************************************************
 *********************************************************************/
@@ -50,6 +50,7 @@ typedef struct
 {
     PIN_Id   pinId;
     uint8_t  state;
+    bool     longPress;  // Button was held for at least BUTTON_LONG_PRESS
 } button_state_t;
 
 /*********************************************************************
@@ -60,6 +61,12 @@ typedef struct
  * CONSTANTS
  */
 
+// Hold time (in msec) after which a press counts as a long press.
+#define BUTTON_LONG_PRESS    1000
+
+// Time (in msec) the display stays on after a press or notification.
+#define DISPLAY_TIMEOUT      5000
+
 /*********************************************************************
  * MACROS
  */
@@ -71,6 +78,8 @@ typedef struct
 extern void F91Buttons_init( void );
 extern void F91Buttons_processButtonPress(button_state_t *buttonInfo);
 extern void F91Buttons_resetOneShot( void );
+extern void F91Buttons_startDisplayTimeout( void );
+extern void F91Buttons_startIdleTimeout( uint32_t timeout );
 
 /*********************************************************************
 *********************************************************************/
@@ -31,16 +31,15 @@
 #include <xdc/runtime/System.h>
 #include <xdc/runtime/Error.h>
 
-#include <ti/sysbios/knl/Task.h>
 #include <ti/sysbios/knl/Clock.h>
 #include <ti/sysbios/knl/Event.h>
 #include <ti/sysbios/knl/Queue.h>
 #include <ti/sysbios/knl/Semaphore.h>
-#include <ti/sysbios/knl/Mailbox.h>
 #include <ti/sysbios/BIOS.h>
 #include <ti/display/Display.h>
 #include <time.h>
 #include <ti/sysbios/hal/Seconds.h>
+#include <driverlib/aon_rtc.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -48,7 +47,6 @@
 
 #include <icall.h>
 #include "util.h"
-#include "att_rsp.h"
 
 /* This Header file contains all BLE API and icall structure definition */
 #include "icall_ble_api.h"
@@ -64,60 +62,46 @@
 #include "f91_clock.h"
 #include "f91_clock_service.h"
 #include "f91_notification.h"
+#include "f91_stopwatch.h"
+#include "f91_alarm.h"
+#include "f91_log.h"
+#include "f91_outbound.h"
 
 
 /*********************************************************************
  * CONSTANTS
  */
 
-// Task configuration
-#define F91_CLOCK_TASK_PRIORITY                     1
-
-#ifndef F91_CLOCK_TASK_STACK_SIZE
-#define F91_CLOCK_TASK_STACK_SIZE                   644
-#endif
+// Period of the time display update (in msec).
+#define F91_CLOCK_TICK_PERIOD                 1000
 
+/*********************************************************************
+ * TYPEDEFS
+ */
 
-// Internal Events for RTOS application
-#define F91_ICALL_EVT                         ICALL_MSG_EVENT_ID // Event_Id_31
-#define F91_QUEUE_EVT                         UTIL_QUEUE_EVENT_ID // Event_Id_30
-#define F91_PERIODIC_EVT                      Event_Id_00
+// Clock configuration, written from characteristic changes and read by the
+// per-second tick. Both run on the F91Kepler task.
+typedef struct
+{
+  uint16_t timeZone;    // Seconds west of UTC
+  uint8_t  timeMode;    // 0: 12hr  1: 24hr
+  uint8_t  dst;         // 0: normal  1: dst
+} f91ClockSettings_t;
 
-// Bitwise OR of all events to pend on
-#define F91_ALL_EVENTS                        (F91_ICALL_EVT        | \
-                                               F91_QUEUE_EVT        | \
-                                               F91_PERIODIC_EVT)
 /*********************************************************************
  * LOCAL VARIABLES
  */
 
-// Entity ID globally used to check for source and/or destination of messages
-static ICall_EntityID selfEntity;
-
-static ICall_SyncHandle syncEvent;
-
-// Task configuration
-Task_Struct f91ClockTask;
-Char f91ClockTaskStack[F91_CLOCK_TASK_STACK_SIZE];
-
-// Event globally used to post local events and pend on system and
-// local events.
-static ICall_SyncHandle syncEvent;
-
-// Time Zone
-static uint16_t TimeZone;
+// Clock object used to pace the time updates, only runs while the watch face
+// is on screen.
+static Clock_Struct tickClock;
 
-// For clock (24/12hr mode)
-static bool TimeMode = true;
-
-// Daylight Saving
-static bool Dst = false;
+static f91ClockSettings_t clockSettings;
 
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
-static void _F91Clock_internal_init( void );
-static void _F91Clock_taskFxn(UArg a0, UArg a1);
+static void _F91Clock_tickCallback(UArg arg);
 static void _F91Clock_doTime(void);
 static void _F91Clock_setTime(uint32_t time);
 static void _F91Clock_setTimeZone(uint16_t zone);
@@ -126,88 +110,79 @@ static void _F91Clock_setDst(uint8_t mode);
 static uint16_t _F91Clock_getTimeZone( void );
 static bool _F91Clock_getTimeMode( void );
 static bool _F91Clock_getDst( void );
-static void _F91Clock_checkInbox( void );
 
 
 /*********************************************************************
  * @fn      F91Clock_setTime
  *
- * @brief   Sets time for the clock
+ * @brief   Sets the RTC to a new time and lets the alarms and the watch status
+ *          know how far it moved.
  *
- * @param   time - self explanatory.
+ * @param   time - UTC time in seconds.
  *
  */
 static void _F91Clock_setTime(uint32_t time)
 {
+    int32_t delta = (int32_t)(time - Seconds_get());
+
     Seconds_set(time);
+    F91Alarm_timeChanged(delta);
+    F91Outbound_setDrift(delta);
 }
 
 /*********************************************************************
  * @fn      F91Clock_setTimeZone
  *
- * @brief   Sets time zone for the clock
+ * @brief   Sets the time zone.
  *
- * @param   timezone - self explanatory.
+ * @param   zone - seconds west of UTC.
  *
  */
 static void _F91Clock_setTimeZone(uint16_t zone)
 {
-    TimeZone = zone;
-    F91_clock_service_SetParameter(F91_CLOCK_SERVICE_CHAR2, sizeof(uint16_t), &TimeZone);
+    clockSettings.timeZone = zone;
+    F91Alarm_timeChanged(0);
+
+    F91_clock_service_SetParameter(F91_CLOCK_SERVICE_CHAR2, sizeof(uint16_t), &zone);
 }
 
 /*********************************************************************
  * @fn      F91Clock_setTimeMode
  *
- * @brief   Sets time mode for the clock 
+ * @brief   Sets the time mode.
  *
  * @param   mode - (0: 12hr  1: 24hr).
  *
  */
 static void _F91Clock_setTimeMode(uint8_t mode)
 {
-    switch ( mode )
-    {
-        case 0:
-            TimeMode = false;
-        break;
-        case 1:
-            TimeMode = true;
-        break;
-        default:
-            mode = 0;
-            TimeMode = false;
-        break;
+    if (mode > 1) {
+        mode = 0;
     }
 
+    clockSettings.timeMode = mode;
+
     F91_clock_service_SetParameter(F91_CLOCK_SERVICE_CHAR3, 1, &mode);
 }
 
 /*********************************************************************
- * @fn      F91Clock_setDaylightSavings
+ * @fn      F91Clock_setDst
  *
- * @brief   Sets daylight savings for the clock 
+ * @brief   Sets daylight savings.
  *
- * @param   mode - (0: 12hr  1: 24hr).
+ * @param   mode - (0: normal  1: dst).
  *
  */
 static void _F91Clock_setDst(uint8_t mode)
 {
-    switch ( mode )
-    {
-        case 0:
-            Dst = false;
-        break;
-        case 1:
-            Dst = true;
-        break;
-        default:
-            mode = 0;
-            Dst = false;
-        break;
+    if (mode > 1) {
+        mode = 0;
     }
 
-    F91_clock_service_SetParameter(F91_CLOCK_SERVICE_CHAR3, 1, &mode);
+    clockSettings.dst = mode;
+    F91Alarm_timeChanged(0);
+
+    F91_clock_service_SetParameter(F91_CLOCK_SERVICE_CHAR4, 1, &mode);
 }
 
 /*********************************************************************
@@ -220,7 +195,7 @@ static void _F91Clock_setDst(uint8_t mode)
  */
 static uint16_t _F91Clock_getTimeZone( void )
 {
-    return TimeZone;
+    return clockSettings.timeZone;
 }
 
 /*********************************************************************
@@ -233,7 +208,7 @@ static uint16_t _F91Clock_getTimeZone( void )
  */
 static bool _F91Clock_getTimeMode( void )
 {
-    return TimeMode;
+    return (clockSettings.timeMode != 0);
 }
 
 /*********************************************************************
@@ -246,106 +221,45 @@ static bool _F91Clock_getTimeMode( void )
  */
 static bool _F91Clock_getDst( void )
 {
-    return Dst;
+    return (clockSettings.dst != 0);
 }
 
 /*********************************************************************
- * @fn      F91Clock_checkInbox
+ * @fn      F91Clock_tickCallback
  *
- * @brief   Checks if there has been any messages sent to this task (clock) to update its parameters.
- *          Using a mailbox since there are two tasks at play here. (f91_clock and f91_kepler).
+ * @brief   Callback from the Clock module (Swi context), the update itself
+ *          drives the display over I2C so it runs on the F91Kepler task.
  *
- * @param   none
+ * @param   arg - not used.
  *
  */
-static void _F91Clock_checkInbox( void )
+static void _F91Clock_tickCallback(UArg arg)
 {
-    MsgObj msg;
-    Int i;
-    for (i = 0; i < Mailbox_getNumPendingMsgs(mbxHandle); i++) {
-        Mailbox_pend(mbxHandle, &msg, BIOS_NO_WAIT);
-        switch (msg.id) 
-        {
-            case F91_CLOCK_SERVICE_CHAR1:
-                _F91Clock_setTime(*((uint32_t*)msg.value));
-                break;
-            case F91_CLOCK_SERVICE_CHAR2:
-                _F91Clock_setTimeZone(*((uint16_t*)msg.value));
-                break;
-            case F91_CLOCK_SERVICE_CHAR3:
-                _F91Clock_setTimeMode(*((uint8_t*)msg.value));
-                break;
-            case F91_CLOCK_SERVICE_CHAR4:
-                _F91Clock_setDst(*((uint8_t*)msg.value));
-                break;
-            default:
-                break;
-        }
-    }
-}
-
- /*********************************************************************
- * @fn      F91Clock_createTask
- *
- * @brief   Task creation function for the F91 Kepler Smart Watch clock application.
- *
- * @param   None.
- *
- * @return  None.
- */
-void F91Clock_createTask(void)
-{
-    Task_Params taskParams;
-
-    // Configure task
-    Task_Params_init(&taskParams);
-    taskParams.stack = f91ClockTaskStack;
-    taskParams.stackSize = F91_CLOCK_TASK_STACK_SIZE;
-    taskParams.priority = F91_CLOCK_TASK_PRIORITY;
-
-    Task_construct(&f91ClockTask, _F91Clock_taskFxn, &taskParams, NULL);
+    F91Kepler_clockTickCB();
 }
 
 /*********************************************************************
- * @fn      F91Clock_internal_init
+ * @fn      F91Clock_doTime
  *
- * @brief   Called during initialization and contains application
- *          specific initialization (ie. hardware initialization/setup,
- *          table initialization, power up notification, etc), and
- *          profile initialization/setup.
+ * @brief   Renders the watch face. Nothing is computed unless the display
+ *          is on and not taken by a notification, alert or the stopwatch.
  *
- * @param   None.
- *
- * @return  None.
  */
-static void _F91Clock_internal_init(void)
-{  
-    // Register the current thread as an ICall dispatcher application
-    // so that the application can send and receive messages.
-    ICall_registerApp(&selfEntity, &syncEvent);
-
-    // initialize the SSD1306 display. 
-    ssd1306_init();
-
-    //**************set default time & zone (00:00:00 01/14/1994)(UTC) & PST************
-    _F91Clock_setTime(DEFAULT_TIME);
-    _F91Clock_setTimeZone(TZ_PST);
-    _F91Clock_setTimeMode(0);
-    _F91Clock_setDst(0);
-    //***********************************************************
-}
-
 static void _F91Clock_doTime(void) {
     time_t t1;
     struct tm *ltm;
     bool eraseFirstDigit = false;
     char *dateString;
-    char hour[2];
-    char minute[2];
-    char second[2];
-    char month[2];
-    char day[2];
-    uint32_t timeInSeconds = 0;
+    char hour[3];
+    char minute[3];
+    char second[3];
+    char month[6];
+    char day[3];
+
+    if((!ssd1306_getState()) || (F91Notification_getNotificationState()) ||
+       (F91Alarm_isAlerting()) || (F91Stopwatch_isActive())){
+        return;
+    }
 
     t1 = time(NULL);
     t1 = t1 - _F91Clock_getTimeZone();
@@ -356,67 +270,59 @@ static void _F91Clock_doTime(void) {
     }
 
     ltm = localtime(&t1);
-    
-    //Update service
-    timeInSeconds = Seconds_get();
-    F91_clock_service_SetParameter(F91_CLOCK_SERVICE_CHAR1, sizeof(uint32_t), &timeInSeconds);
-
-    //Only update the time details for the display if the display is on AND
-    // there isn't a full screen notification being displayed.
-    if((ssd1306_getState()) && (!F91Notification_getNotificationState())){
-        //Handle 24hr or 12 hr time.
-        if((!_F91Clock_getTimeMode()) && (ltm->tm_hour>=13)){
-            ltm->tm_hour = ltm->tm_hour - 12;
-            ssd1306_display_pm(PM_POS_X, PM_POS_Y, false);
-        } else if((!_F91Clock_getTimeMode()) && (ltm->tm_hour == 0)){
-            ltm->tm_hour = 12;
-            ssd1306_display_pm(PM_POS_X, PM_POS_Y, true);
-        } else if((!_F91Clock_getTimeMode()) && (ltm->tm_hour == 12)){
-            ssd1306_display_pm(PM_POS_X, PM_POS_Y, false);
-        } else {
-            ssd1306_display_pm(PM_POS_X, PM_POS_Y, true);
-        }
-
-        ltoa(ltm->tm_hour, hour);
-        ltoa(ltm->tm_min, minute);
-        ltoa(ltm->tm_sec, second);
-        ltoa(ltm->tm_mon + 1, month);
-        ltoa(ltm->tm_mday, day);
-
-        dateString = strcat(strcat(month,"/"),day);
-        ssd1306_display_semicolon(SEM_CLN_POS_X, SEM_CLN_POS_Y, false);
-        ssd1306_display_text("000000", DATE_POS_X, DATE_POS_Y, true); // erase all date field first
-        ssd1306_display_text(dateString, 95 - (strlen(dateString)*6), 1, false); // display date, right aligned
-
-        if(ltm->tm_hour<10){
-            hour[1]=hour[0];
-            hour[0]='0';
-            // Don't display the first hour digit.
-            eraseFirstDigit = true;
-        }
-
-        if(ltm->tm_min<10){
-            minute[1]=minute[0];
-            minute[0]='0';
-        }
-
-        if(ltm->tm_sec<10){
-            second[1]=second[0];
-            second[0]='0';
-        }
-        //Hour
-        ssd1306_display_number(hour[0]-'0', HR_1_POS_X, HR_MIN_POS_Y, eraseFirstDigit);
-        ssd1306_display_number(hour[1]-'0', HR_2_POS_X, HR_MIN_POS_Y, false);
-        //Minutes
-        ssd1306_display_number(minute[0]-'0', MIN_1_POS_X, HR_MIN_POS_Y, false);
-        ssd1306_display_number(minute[1]-'0', MIN_2_POS_X, HR_MIN_POS_Y, false);
-        //Seconds
-        ssd1306_display_small_number(second[0]-'0', SEC_1_POS_X, SEC_POS_Y, false);
-        ssd1306_display_small_number(second[1]-'0', SEC_2_POS_X, SEC_POS_Y, false);
-
-        //Update Display
-        ssd1306_update();
+
+    //Handle 24hr or 12 hr time.
+    if((!_F91Clock_getTimeMode()) && (ltm->tm_hour>=13)){
+        ltm->tm_hour = ltm->tm_hour - 12;
+        ssd1306_display_pm(PM_POS_X, PM_POS_Y, false);
+    } else if((!_F91Clock_getTimeMode()) && (ltm->tm_hour == 0)){
+        ltm->tm_hour = 12;
+        ssd1306_display_pm(PM_POS_X, PM_POS_Y, true);
+    } else if((!_F91Clock_getTimeMode()) && (ltm->tm_hour == 12)){
+        ssd1306_display_pm(PM_POS_X, PM_POS_Y, false);
+    } else {
+        ssd1306_display_pm(PM_POS_X, PM_POS_Y, true);
+    }
+
+    ltoa(ltm->tm_hour, hour);
+    ltoa(ltm->tm_min, minute);
+    ltoa(ltm->tm_sec, second);
+    ltoa(ltm->tm_mon + 1, month);
+    ltoa(ltm->tm_mday, day);
+
+    dateString = strcat(strcat(month,"/"),day);
+    ssd1306_display_semicolon(SEM_CLN_POS_X, SEM_CLN_POS_Y, false);
+    ssd1306_display_text("000000", DATE_POS_X, DATE_POS_Y, true); // erase all date field first
+    ssd1306_display_text(dateString, 95 - (strlen(dateString)*6), 1, false); // display date, right aligned
+
+    if(ltm->tm_hour<10){
+        hour[1]=hour[0];
+        hour[0]='0';
+        // Don't display the first hour digit.
+        eraseFirstDigit = true;
+    }
+
+    if(ltm->tm_min<10){
+        minute[1]=minute[0];
+        minute[0]='0';
     }
+
+    if(ltm->tm_sec<10){
+        second[1]=second[0];
+        second[0]='0';
+    }
+    //Hour
+    ssd1306_display_number(hour[0]-'0', HR_1_POS_X, HR_MIN_POS_Y, eraseFirstDigit);
+    ssd1306_display_number(hour[1]-'0', HR_2_POS_X, HR_MIN_POS_Y, false);
+    //Minutes
+    ssd1306_display_number(minute[0]-'0', MIN_1_POS_X, HR_MIN_POS_Y, false);
+    ssd1306_display_number(minute[1]-'0', MIN_2_POS_X, HR_MIN_POS_Y, false);
+    //Seconds
+    ssd1306_display_small_number(second[0]-'0', SEC_1_POS_X, SEC_POS_Y, false);
+    ssd1306_display_small_number(second[1]-'0', SEC_2_POS_X, SEC_POS_Y, false);
+
+    //Update Display
+    ssd1306_update();
 }
 
 /*********************************************************************
@@ -442,49 +348,170 @@ static f91_clock_serviceCBs_t F91Clock_StateChangeCB =
 
 
 /*********************************************************************
- * @fn      F91Clock_taskFxn
+ * @fn      F91Clock_init
  *
- * @brief   Application task entry point for the F91 Clock.
+ * @brief   Initialization function for the clock
  *
- * @param   a0, a1 - not used.
+ * @param   none
  *
- * @return  None.
+ * @return  none
  */
-static void _F91Clock_taskFxn(UArg a0, UArg a1)
+void F91Clock_init(void)
 {
-    // Initialize application
-    _F91Clock_internal_init();
-    // Application main loop
-    for (;;)
-    {   
-        //Update the time.
-        _F91Clock_doTime();
-
-        //Check if there is any messages to update time parameters.
-        _F91Clock_checkInbox();
-
-        //Let the task sleep for a second so other tasks can do there duties.
-        Task_sleep(1000 * (1000 / Clock_tickPeriod));
-    }
+  f91ClockSettings_t saved;
+
+  F91_clock_service_AddService();
+  F91_clock_service_RegisterAppCBs(&F91Clock_StateChangeCB);
+
+  // initialize the SSD1306 display.
+  ssd1306_init();
+
+  //**************set default time & zone (00:00:00 01/14/1994)(UTC) & PST************
+  _F91Clock_setTime(DEFAULT_TIME);
+  _F91Clock_setTimeZone(TZ_PST);
+  _F91Clock_setTimeMode(0);
+  _F91Clock_setDst(0);
+  //***********************************************************
+
+  // Zone, mode and dst survive a reset, the time itself comes from the phone.
+  if (F91Log_loadState(&saved, sizeof(saved))) {
+    _F91Clock_setTimeZone(saved.timeZone);
+    _F91Clock_setTimeMode(saved.timeMode);
+    _F91Clock_setDst(saved.dst);
+  }
+
+  // Dormant until the display is turned on, see F91Clock_wake().
+  Util_constructClock(&tickClock, _F91Clock_tickCallback,
+                      F91_CLOCK_TICK_PERIOD, F91_CLOCK_TICK_PERIOD, false, NULL);
 }
 
+/*********************************************************************
+ * @fn      F91Clock_processEvent
+ *
+ * @brief   Per-second time update, called from the F91Kepler task. The tick
+ *          stops itself once the display has been turned off.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Clock_processEvent(void)
+{
+  if (!ssd1306_getState()) {
+    Util_stopClock(&tickClock);
+    return;
+  }
+
+  _F91Clock_doTime();
+}
 
 /*********************************************************************
- * @fn      F91Clock_init
+ * @fn      F91Clock_wake
  *
- * @brief   Initialization function for the clock
+ * @brief   Renders the watch face right away and starts the per-second
+ *          tick, aligned to the next RTC second so the seconds digits
+ *          change in step with the time characteristic. Call after
+ *          turning the display on.
  *
  * @param   none
  *
  * @return  none
  */
-void F91Clock_init(void)
+void F91Clock_wake(void)
 {
-  F91_clock_service_AddService();
-  F91_clock_service_RegisterAppCBs(&F91Clock_StateChangeCB);
+  uint32_t fraction = (uint32_t)AONRTCCurrent64BitValueGet();
+  uint32_t untilNextSecond = F91_CLOCK_TICK_PERIOD -
+      (uint32_t)(((uint64_t)fraction * F91_CLOCK_TICK_PERIOD) >> 32);
+
+  _F91Clock_doTime();
+
+  Util_restartClock(&tickClock, untilNextSecond);
 }
 
 
+/*********************************************************************
+ * @fn      F91Clock_refresh
+ *
+ * @brief   Redraws the watch face if it is showing, without touching the
+ *          tick.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Clock_refresh(void)
+{
+  _F91Clock_doTime();
+}
+
+/*********************************************************************
+ * @fn      F91Clock_applySync
+ *
+ * @brief   Takes the time and clock settings of a state sync. The settings
+ *          are saved once for the whole sync.
+ *
+ * @param   pSync - decoded sync.
+ *
+ * @return  none
+ */
+void F91Clock_applySync(const f91SyncState_t *pSync)
+{
+  const uint16_t settings = F91_SYNC_FIELD(F91_SYNC_TAG_ZONE) |
+                            F91_SYNC_FIELD(F91_SYNC_TAG_MODE) |
+                            F91_SYNC_FIELD(F91_SYNC_TAG_DST);
+
+  if (pSync->present & F91_SYNC_FIELD(F91_SYNC_TAG_TIME)) {
+    _F91Clock_setTime(pSync->time);
+  }
+  if (pSync->present & F91_SYNC_FIELD(F91_SYNC_TAG_ZONE)) {
+    _F91Clock_setTimeZone(pSync->zone);
+  }
+  if (pSync->present & F91_SYNC_FIELD(F91_SYNC_TAG_MODE)) {
+    _F91Clock_setTimeMode(pSync->mode);
+  }
+  if (pSync->present & F91_SYNC_FIELD(F91_SYNC_TAG_DST)) {
+    _F91Clock_setDst(pSync->dst);
+  }
+
+  if (pSync->present & settings) {
+    F91Log_saveState(&clockSettings, sizeof(clockSettings));
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Clock_getUtcOffset
+ *
+ * @brief   Returns the offset from UTC to local time, dst included.
+ *
+ * @param   none
+ *
+ * @return  seconds to add to UTC to get local time.
+ */
+int32_t F91Clock_getUtcOffset(void)
+{
+  int32_t offset = -(int32_t)clockSettings.timeZone;
+
+  if (clockSettings.dst) {
+    offset += 3600;
+  }
+
+  return offset;
+}
+
+/*********************************************************************
+ * @fn      F91Clock_is24Hour
+ *
+ * @brief   Returns the time mode.
+ *
+ * @param   none
+ *
+ * @return  true for 24hr mode, false for 12hr.
+ */
+bool F91Clock_is24Hour(void)
+{
+  return (clockSettings.timeMode != 0);
+}
+
 /*********************************************************************
  * @fn      F91Clock_processCharChangeEvt
  *
@@ -498,33 +525,32 @@ void F91Clock_processCharChangeEvt(uint8_t paramID)
   uint32_t time;
   uint16_t zone;
   uint8_t  mode;
-  MsgObj msg;
-  
+  uint8_t  record[F91_ALARM_RECORD_LEN];
+
   switch (paramID)
   {
     case F91_CLOCK_SERVICE_CHAR1:
         F91_clock_service_GetParameter(F91_CLOCK_SERVICE_CHAR1, &time);
-        msg.id = F91_CLOCK_SERVICE_CHAR1;
-        msg.value = &time;
-        Mailbox_post(mbxHandle, &msg, BIOS_NO_WAIT);
+        _F91Clock_setTime(time);
       break;
     case F91_CLOCK_SERVICE_CHAR2:
         F91_clock_service_GetParameter(F91_CLOCK_SERVICE_CHAR2, &zone);
-        msg.id = F91_CLOCK_SERVICE_CHAR2;
-        msg.value = &zone;
-        Mailbox_post(mbxHandle, &msg, BIOS_NO_WAIT);
+        _F91Clock_setTimeZone(zone);
+        F91Log_saveState(&clockSettings, sizeof(clockSettings));
       break;
     case F91_CLOCK_SERVICE_CHAR3:
         F91_clock_service_GetParameter(F91_CLOCK_SERVICE_CHAR3, &mode);
-        msg.id = F91_CLOCK_SERVICE_CHAR3;
-        msg.value = &mode;
-        Mailbox_post(mbxHandle, &msg, BIOS_NO_WAIT);
+        _F91Clock_setTimeMode(mode);
+        F91Log_saveState(&clockSettings, sizeof(clockSettings));
       break;
     case F91_CLOCK_SERVICE_CHAR4:
         F91_clock_service_GetParameter(F91_CLOCK_SERVICE_CHAR4, &mode);
-        msg.id = F91_CLOCK_SERVICE_CHAR4;
-        msg.value = &mode;
-        Mailbox_post(mbxHandle, &msg, BIOS_NO_WAIT);
+        _F91Clock_setDst(mode);
+        F91Log_saveState(&clockSettings, sizeof(clockSettings));
+      break;
+    case F91_CLOCK_SERVICE_CHAR5:
+        F91_clock_service_GetParameter(F91_CLOCK_SERVICE_CHAR5, record);
+        F91Alarm_configure(record);
       break;
     default:
       break;
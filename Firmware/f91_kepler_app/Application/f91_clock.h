@@ -38,6 +38,7 @@ extern "C"
  */
 #include "board.h"
 #include "f91_kepler.h"
+#include "f91_sync.h"
 
 /*********************************************************************
 *  EXTERNAL VARIABLES
@@ -65,14 +66,19 @@ extern "C"
  */
 
 /*
- * Task creation function for F91 Kepler Smart Watch.
+ * Initialize clock module
  */
-extern void F91Clock_createTask(void);
+extern void F91Clock_init(void);
 
 /*
- * Initialize clock module
+ * Offset from UTC to local time in seconds.
  */
-extern void F91Clock_init(void);
+extern int32_t F91Clock_getUtcOffset(void);
+
+/*
+ * Returns true when the time is shown in 24hr mode.
+ */
+extern bool F91Clock_is24Hour(void);
 
 /*
  * Task Event Processor for characteristic changes
@@ -80,10 +86,25 @@ extern void F91Clock_init(void);
 void F91Clock_processCharChangeEvt(uint8_t paramID);
 
 /*
- * Task Event Processor for clock module
+ * Task Event Processor for clock module (per-second time update)
  */
 extern void F91Clock_processEvent(void);
 
+/*
+ * Render the watch face and start the per-second tick, after the display is turned on
+ */
+extern void F91Clock_wake(void);
+
+/*
+ * Redraw the watch face, if it is showing
+ */
+extern void F91Clock_refresh(void);
+
+/*
+ * Take the time and clock settings of a state sync
+ */
+extern void F91Clock_applySync(const f91SyncState_t *pSync);
+
 
 /*********************************************************************
 *********************************************************************/
@@ -0,0 +1,252 @@
+/******************************************************************************
+
+ @file  f91_command.c
+
+ @brief This file contains the F91 Kepler Smart Watch command channel.
+
+        Every frame waiting in the service queue is applied before one ack
+        goes back, so frames written in the same connection event share a
+        notification. A frame seen before is acked again but not applied.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+
+#include "bcomdef.h"
+
+#include "f91_command.h"
+#include "f91_sync.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static f91_notification_serviceCommand_t commandFrame;
+
+// Sliding window, bit n of receivedBits is frame highestSeq - n.
+static bool     windowValid = false;
+static uint16_t highestSeq;
+static uint32_t receivedBits;
+
+// Bond the window belongs to, kept while it reconnects.
+static bool     windowBonded = false;
+static uint8_t  windowPeer[B_ADDR_LEN];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static bool _F91Command_track(uint16_t seq);
+static void _F91Command_sendAck(uint8_t flags);
+
+/*********************************************************************
+ * @fn      _F91Command_track
+ *
+ * @brief   Mark a frame as received in the window.
+ *
+ * @param   seq - sequence number of the frame.
+ *
+ * @return  true if the frame is new and should be applied.
+ */
+static bool _F91Command_track(uint16_t seq)
+{
+  int16_t delta;
+
+  if (!windowValid) {
+    windowValid = true;
+    highestSeq = seq;
+    receivedBits = 1;
+    return true;
+  }
+
+  delta = (int16_t)(seq - highestSeq);
+
+  if (delta > 0) {
+    // Slide the window up, frames falling off the end are the phone's to give up on.
+    receivedBits = (delta < F91_COMMAND_WINDOW) ? (receivedBits << delta) : 0;
+    receivedBits |= 1;
+    highestSeq = seq;
+    return true;
+  }
+
+  if ((-delta >= F91_COMMAND_WINDOW) || (receivedBits & ((uint32_t)1 << -delta))) {
+    return false;
+  }
+
+  // A resend of a frame that was dropped.
+  receivedBits |= (uint32_t)1 << -delta;
+  return true;
+}
+
+/*********************************************************************
+ * @fn      _F91Command_sendAck
+ *
+ * @brief   Notify the window to the phone.
+ *
+ * @param   flags - F91_COMMAND_ACK_xxx.
+ *
+ * @return  None.
+ */
+static void _F91Command_sendAck(uint8_t flags)
+{
+  uint8_t ack[COMMAND_ACK_LEN] =
+  {
+    LO_UINT16(highestSeq), HI_UINT16(highestSeq),
+    BREAK_UINT32(receivedBits, 0), BREAK_UINT32(receivedBits, 1),
+    BREAK_UINT32(receivedBits, 2), BREAK_UINT32(receivedBits, 3),
+    flags
+  };
+
+  // Not enabled or no buffer: the phone's retry timer sends the frames again
+  // and gets the ack then.
+  F91_notification_service_SetParameter(F91_NOTIFICATION_SERVICE_CHAR6, COMMAND_ACK_LEN, ack);
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Command_init
+ *
+ * @brief   Initialization function for the command channel.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Command_init( void )
+{
+  F91Command_reset();
+}
+
+/*********************************************************************
+ * @fn      F91Command_reset
+ *
+ * @brief   Forget the sequence window, the next frame starts a new one.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Command_reset( void )
+{
+  windowValid = false;
+  highestSeq = 0;
+  receivedBits = 0;
+}
+
+/*********************************************************************
+ * @fn      F91Command_connect
+ *
+ * @brief   Keep the window for the bond it belongs to, start a new one
+ *          for any other phone.
+ *
+ * @param   pIdentityAddr - identity address of the phone's bond, NULL if
+ *                          it isn't bonded.
+ *
+ * @return  none
+ */
+void F91Command_connect( const uint8_t *pIdentityAddr )
+{
+  if ((pIdentityAddr != NULL) && windowBonded &&
+      (memcmp(windowPeer, pIdentityAddr, B_ADDR_LEN) == 0)) {
+    return;
+  }
+
+  F91Command_reset();
+  F91Command_bonded(pIdentityAddr);
+}
+
+/*********************************************************************
+ * @fn      F91Command_bonded
+ *
+ * @brief   The window started with a new pairing belongs to the bond just
+ *          saved, it is kept when that phone reconnects.
+ *
+ * @param   pIdentityAddr - identity address of the bond, NULL if it
+ *                          can't be found.
+ *
+ * @return  none
+ */
+void F91Command_bonded( const uint8_t *pIdentityAddr )
+{
+  windowBonded = (pIdentityAddr != NULL);
+  if (windowBonded) {
+    memcpy(windowPeer, pIdentityAddr, B_ADDR_LEN);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Command_processCharChangeEvt
+ *
+ * @brief   Apply every queued command frame, then ack them all at once.
+ *          A malformed frame is acked too, sending it again won't help.
+ *          Frames dropped on a full queue get an ack right away, flagged.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Command_processCharChangeEvt( void )
+{
+  bool received = false;
+  bool dropped;
+  uint16_t seq;
+
+  while (F91_notification_service_GetParameter(F91_NOTIFICATION_SERVICE_CHAR6, &commandFrame) == SUCCESS) {
+    received = true;
+    seq = BUILD_UINT16(commandFrame.data[0], commandFrame.data[1]);
+
+    if (!_F91Command_track(seq)) {
+      continue;
+    }
+
+    if (!F91Sync_apply(&commandFrame.data[F91_COMMAND_HDR_LEN], commandFrame.len - F91_COMMAND_HDR_LEN)) {
+      Display_print1(F91_LOGGER, 6, 0, "Command: %d rejected", seq);
+    }
+  }
+
+  F91_notification_service_GetParameter(F91_NOTIFICATION_SERVICE_CHAR6_DROPPED, &dropped);
+
+  if (received || dropped) {
+    _F91Command_sendAck(dropped ? F91_COMMAND_ACK_DROPPED : 0);
+  }
+}
+
+/*********************************************************************
+*********************************************************************/
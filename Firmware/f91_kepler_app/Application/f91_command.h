@@ -0,0 +1,112 @@
+/******************************************************************************
+
+ @file  f91_command.h
+
+ @brief This file contains the F91 Kepler Smart Watch command channel
+        definitions and prototypes. Command frames are written without
+        response and acknowledged in batches with a sliding window bitmap.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91COMMAND_H
+#define F91COMMAND_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+#include "f91_notification_service.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// A frame is [seq lo][seq hi] followed by state sync fields (see
+// f91_sync.h). Sequence numbers go up by one per frame and wrap at 16 bits.
+// The window is kept across a reconnect of the same bond, so a frame sent
+// again after the link dropped is not applied twice: the phone carries on
+// with its sequence numbers. It starts again from the first frame after a
+// new pairing or when another phone connects.
+#define F91_COMMAND_HDR_LEN             2
+
+// An ack is [seq lo][seq hi] of the highest frame received, a uint32
+// bitmap: bit n set when frame seq - n was received, and a flags byte. The
+// phone sends again what is clear, frames older than the window are taken
+// as lost.
+#define F91_COMMAND_WINDOW              32
+
+// Ack flags. Frames were dropped on a full queue since the last ack: what is
+// clear and what came after seq is to be sent again now, not on the retry
+// timer.
+#define F91_COMMAND_ACK_DROPPED         0x01
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the command channel.
+ */
+extern void F91Command_init( void );
+
+/*
+ * Forget the sequence window, on a new pairing.
+ */
+extern void F91Command_reset( void );
+
+/*
+ * A phone connected, identity address of its bond or NULL if it has none.
+ */
+extern void F91Command_connect( const uint8_t *pIdentityAddr );
+
+/*
+ * The connected phone's bond was saved, identity address or NULL.
+ */
+extern void F91Command_bonded( const uint8_t *pIdentityAddr );
+
+/*
+ * Task Event Processor for the command characteristic.
+ */
+extern void F91Command_processCharChangeEvt( void );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91COMMAND_H */
@@ -0,0 +1,221 @@
+/******************************************************************************
+
+ @file  f91_history.c
+
+ @brief This file contains the F91 Kepler Smart Watch notification history.
+
+        Slots come from a static pool of F91_HISTORY_DEPTH entries. Since the
+        slot given out is always the oldest one, the pool is handed out in
+        ring order: adding is a single index increment and a lookup by age is
+        a masked subtraction, no search and no heap.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "f91_history.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define HISTORY_MASK              (F91_HISTORY_DEPTH - 1)
+
+#if (F91_HISTORY_DEPTH & HISTORY_MASK) != 0
+#error "F91_HISTORY_DEPTH must be a power of two"
+#endif
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Slot pool, historyHead is the next slot to be handed out.
+static f91HistoryEntry_t historyPool[F91_HISTORY_DEPTH];
+static uint8_t historyHead;
+static uint8_t historyCount;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void _F91History_copy(char *dst, const char *src, uint8_t maxLen);
+
+/*********************************************************************
+ * @fn      _F91History_copy
+ *
+ * @brief   Bounded string copy, the destination is always terminated and
+ *          never ends in a partial UTF-8 character.
+ *
+ * @param   dst - destination, maxLen + 1 bytes.
+ * @param   src - source string, may be NULL.
+ * @param   maxLen - longest string kept.
+ *
+ * @return  None.
+ */
+static void _F91History_copy(char *dst, const char *src, uint8_t maxLen)
+{
+  uint16_t len = 0;
+
+  if (src != NULL) {
+    // One past maxLen is enough to tell the string is cut.
+    while ((len <= maxLen) && (src[len] != '\0')) {
+      len++;
+    }
+    len = F91History_fitLen(src, len, maxLen);
+    memcpy(dst, src, len);
+  }
+  dst[len] = '\0';
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91History_init
+ *
+ * @brief   Initialization function for the history, all slots free.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91History_init( void )
+{
+  memset(historyPool, 0, sizeof(historyPool));
+  historyHead = 0;
+  historyCount = 0;
+}
+
+/*********************************************************************
+ * @fn      F91History_add
+ *
+ * @brief   Record a notification in the next slot. Once all slots are in use
+ *          the oldest notification is dropped.
+ *
+ * @param   type - NOTIFICATION_CALL or NOTIFICATION_TEXT.
+ * @param   timestamp - UTC seconds of arrival.
+ * @param   sender - contact name.
+ * @param   body - message text, may be NULL.
+ *
+ * @return  the recorded entry.
+ */
+const f91HistoryEntry_t *F91History_add(uint8_t type, uint32_t timestamp,
+                                        const char *sender, const char *body)
+{
+  f91HistoryEntry_t *pEntry = &historyPool[historyHead];
+
+  pEntry->timestamp = timestamp;
+  pEntry->type = type;
+  _F91History_copy(pEntry->sender, sender, F91_HISTORY_SENDER_LEN);
+  _F91History_copy(pEntry->body, body, F91_HISTORY_BODY_LEN);
+
+  historyHead = (historyHead + 1) & HISTORY_MASK;
+  if (historyCount < F91_HISTORY_DEPTH) {
+    historyCount++;
+  }
+
+  return pEntry;
+}
+
+/*********************************************************************
+ * @fn      F91History_get
+ *
+ * @brief   Get a recorded notification.
+ *
+ * @param   index - 0 for the most recent, up to F91History_count() - 1.
+ *
+ * @return  the entry, NULL if there is no such entry.
+ */
+const f91HistoryEntry_t *F91History_get(uint8_t index)
+{
+  if (index >= historyCount) {
+    return NULL;
+  }
+
+  return &historyPool[(historyHead - 1 - index) & HISTORY_MASK];
+}
+
+/*********************************************************************
+ * @fn      F91History_count
+ *
+ * @brief   Number of notifications recorded.
+ *
+ * @param   none
+ *
+ * @return  0 to F91_HISTORY_DEPTH.
+ */
+uint8_t F91History_count( void )
+{
+  return historyCount;
+}
+
+/*********************************************************************
+ * @fn      F91History_fitLen
+ *
+ * @brief   Where to cut a string so it fits, without keeping half of a
+ *          UTF-8 character. For strings that go into the history cut
+ *          somewhere else first, the history would keep the partial
+ *          character as it is.
+ *
+ * @param   str - string, not necessarily terminated.
+ * @param   len - string length.
+ * @param   maxLen - longest string kept.
+ *
+ * @return  len if it fits, otherwise at most maxLen.
+ */
+uint8_t F91History_fitLen(const char *str, uint16_t len, uint8_t maxLen)
+{
+  uint8_t i = maxLen;
+  uint8_t lead, seqLen;
+
+  if (len <= maxLen) {
+    return (uint8_t)len;
+  }
+
+  lead = i;
+  while ((lead > 0) && (((uint8_t)str[lead - 1] & 0xC0) == 0x80)) {
+    lead--;
+  }
+  if ((lead > 0) && ((uint8_t)str[lead - 1] >= 0xC0)) {
+    lead--;
+    seqLen = ((uint8_t)str[lead] >= 0xF0) ? 4 : (((uint8_t)str[lead] >= 0xE0) ? 3 : 2);
+    if (i - lead < seqLen) {
+      i = lead;
+    }
+  }
+
+  return i;
+}
+
+/*********************************************************************
+*********************************************************************/
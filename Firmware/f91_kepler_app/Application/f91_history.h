@@ -0,0 +1,114 @@
+/******************************************************************************
+
+ @file  f91_history.h
+
+ @brief This file contains the F91 Kepler Smart Watch notification history
+        definitions and prototypes. The last F91_HISTORY_DEPTH calls and
+        texts are kept in a fixed pool of slots, the oldest is reused first.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91HISTORY_H
+#define F91HISTORY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of notifications kept, must be a power of two and at most 8 (the
+// history view shows the position as a single digit).
+#define F91_HISTORY_DEPTH               8
+
+// Longest sender (contact name) and body kept, longer ones are cut.
+#define F91_HISTORY_SENDER_LEN          20
+#define F91_HISTORY_BODY_LEN            64
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// One history slot, ~92 bytes. The whole pool is F91_HISTORY_DEPTH slots.
+typedef struct
+{
+  uint32_t timestamp;                           // UTC seconds of arrival
+  uint8_t  type;                                // NOTIFICATION_CALL or NOTIFICATION_TEXT
+  char     sender[F91_HISTORY_SENDER_LEN + 1];  // NUL terminated
+  char     body[F91_HISTORY_BODY_LEN + 1];      // NUL terminated, may be empty
+} f91HistoryEntry_t;
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the history, all slots free.
+ */
+extern void F91History_init( void );
+
+/*
+ * Record a notification, reusing the oldest slot once the pool is full.
+ */
+extern const f91HistoryEntry_t *F91History_add(uint8_t type, uint32_t timestamp,
+                                               const char *sender, const char *body);
+
+/*
+ * Get a recorded notification, index 0 being the most recent. NULL if none.
+ */
+extern const f91HistoryEntry_t *F91History_get(uint8_t index);
+
+/*
+ * Number of notifications recorded, up to F91_HISTORY_DEPTH.
+ */
+extern uint8_t F91History_count( void );
+
+/*
+ * Length of a string cut to at most maxLen bytes on a UTF-8 character boundary.
+ */
+extern uint8_t F91History_fitLen(const char *str, uint16_t len, uint8_t maxLen);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91HISTORY_H */
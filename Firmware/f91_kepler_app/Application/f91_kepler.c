@@ -61,7 +61,6 @@
 
 #include <icall.h>
 #include "util.h"
-#include "att_rsp.h"
 
 /* This Header file contains all BLE API and icall structure definition */
 #include "icall_ble_api.h"
@@ -80,11 +79,25 @@
 #include "board.h"
 
 #include "f91_kepler.h"
+#include "f91_ancs.h"
 #include "f91_notification.h"
 #include "f91_notification_service.h"
 #include "f91_clock.h"
 #include "f91_clock_service.h"
+#include "f91_service.h"
 #include "f91_buttons.h"
+#include "f91_stopwatch.h"
+#include "f91_alarm.h"
+#include "f91_timers.h"
+#include "f91_latency.h"
+#include "f91_link.h"
+#include "f91_outbound.h"
+#include "f91_att_queue.h"
+#include "f91_oad.h"
+#include "f91_bulk.h"
+#include "f91_log.h"
+#include "f91_sync.h"
+#include "f91_command.h"
 #include "f91_utils.h"
 #include "ssd1306.h"
 
@@ -96,23 +109,40 @@
 // Advertising interval when device is discoverable (units of 625us, 160=100ms)
 #define DEFAULT_ADVERTISING_INTERVAL          160
 
+// Radio time of one advertising event on the three channels (in usec), an
+// estimate for the duty cycle on the log
+#define F91_ADV_EVENT_USEC                    2000
+
+// Log line of the advertising duty cycle
+#define F91_ADV_LOG_LINE                      28
+
+// Log line of the time from connection to the first write from the phone
+#define F91_RECONNECT_LOG_LINE                33
+
+// SNV item holding the hash of the services bonded phones were told about,
+// after the log's items.
+#define F91_DB_HASH_NVID                      (F91_LOG_NVID_SEGMENT + F91_LOG_SEGMENT_COUNT)
+
 // General discoverable mode: advertise indefinitely
 #define DEFAULT_DISCOVERABLE_MODE             GAP_ADTYPE_FLAGS_GENERAL
 
+// Desired connection parameters are the link manager's idle profile, the
+// watch has nothing to send most of the time.
+
 // Minimum connection interval (units of 1.25ms, 80=100ms) for automatic
 // parameter update request
-#define DEFAULT_DESIRED_MIN_CONN_INTERVAL     80
+#define DEFAULT_DESIRED_MIN_CONN_INTERVAL     F91_LINK_IDLE_MIN_INTERVAL
 
-// Maximum connection interval (units of 1.25ms, 800=1000ms) for automatic
+// Maximum connection interval (units of 1.25ms, 96=120ms) for automatic
 // parameter update request
-#define DEFAULT_DESIRED_MAX_CONN_INTERVAL     800
+#define DEFAULT_DESIRED_MAX_CONN_INTERVAL     F91_LINK_IDLE_MAX_INTERVAL
 
 // Slave latency to use for automatic parameter update request
-#define DEFAULT_DESIRED_SLAVE_LATENCY         0
+#define DEFAULT_DESIRED_SLAVE_LATENCY         F91_LINK_IDLE_LATENCY
 
-// Supervision timeout value (units of 10ms, 1000=10s) for automatic parameter
+// Supervision timeout value (units of 10ms, 600=6s) for automatic parameter
 // update request
-#define DEFAULT_DESIRED_CONN_TIMEOUT          1000
+#define DEFAULT_DESIRED_CONN_TIMEOUT          F91_LINK_IDLE_TIMEOUT
 
 // After the connection is formed, the peripheral waits until the central
 // device asks for its preferred connection parameters
@@ -130,10 +160,17 @@
 // Task configuration
 #define F91_TASK_PRIORITY                     2
 
+// Worst case 764 bytes from the call graph (make stack in tools/host, which
+// checks this value) plus a quarter for margin. Covers the per-second clock
+// update and the OAD flash writes which run on this task. The peak is also
+// logged at every disconnect, compare it with ROV on the watch.
 #ifndef F91_TASK_STACK_SIZE
-#define F91_TASK_STACK_SIZE                   644
+#define F91_TASK_STACK_SIZE                   960
 #endif
 
+// Log line of the task stack peak.
+#define F91_STACK_LOG_LINE                    34
+
 // Application events
 #define F91_STATE_CHANGE_EVT                  (1 << 0)
 #define F91_NOTIFICATION_CHAR_CHANGE_EVT      (1 << 1)
@@ -143,16 +180,32 @@
 #define F91_CLOCK_CHAR_CHANGE_EVT             (1 << 5)
 #define F91_BUTTON_PRESS_EVT                  (1 << 6)
 #define F91_SSD1306_DISPLAY_EVT               (1 << 7)
+#define F91_PARAM_UPDATE_EVT                  (1 << 8)
+#define F91_OAD_CHAR_CHANGE_EVT               (1 << 9)
 
 // Internal Events for RTOS application
 #define F91_ICALL_EVT                         ICALL_MSG_EVENT_ID // Event_Id_31
 #define F91_QUEUE_EVT                         UTIL_QUEUE_EVENT_ID // Event_Id_30
 #define F91_PERIODIC_EVT                      Event_Id_00
+#define F91_STOPWATCH_EVT                     Event_Id_01
+#define F91_TIMERS_EVT                        Event_Id_02
+#define F91_CLOCK_EVT                         Event_Id_03
+#define F91_NOTIFICATION_EVT                  Event_Id_04
+#define F91_LINK_EVT                          Event_Id_05
+#define F91_OUTBOUND_EVT                      Event_Id_06
+#define F91_ATT_QUEUE_EVT                     Event_Id_07
 
 // Bitwise OR of all events to pend on
 #define F91_ALL_EVENTS                        (F91_ICALL_EVT        | \
                                                F91_QUEUE_EVT        | \
-                                               F91_PERIODIC_EVT)
+                                               F91_PERIODIC_EVT     | \
+                                               F91_STOPWATCH_EVT    | \
+                                               F91_TIMERS_EVT       | \
+                                               F91_CLOCK_EVT        | \
+                                               F91_NOTIFICATION_EVT | \
+                                               F91_LINK_EVT         | \
+                                               F91_OUTBOUND_EVT     | \
+                                               F91_ATT_QUEUE_EVT)
 
 
 // Set the register cause to the registration bit-mask
@@ -173,6 +226,7 @@ typedef struct
 {
   appEvtHdr_t hdr;  // event header.
   uint8_t *pData;  // event data
+  uint32_t timestamp; // Clock ticks when queued
 } f91Evt_t;
 
 /*********************************************************************
@@ -222,7 +276,7 @@ static uint8_t scanRspData[] =
   GAP_ADTYPE_SLAVE_CONN_INTERVAL_RANGE,
   LO_UINT16(DEFAULT_DESIRED_MIN_CONN_INTERVAL),   // 100ms
   HI_UINT16(DEFAULT_DESIRED_MIN_CONN_INTERVAL),
-  LO_UINT16(DEFAULT_DESIRED_MAX_CONN_INTERVAL),   // 1s
+  LO_UINT16(DEFAULT_DESIRED_MAX_CONN_INTERVAL),   // 120ms
   HI_UINT16(DEFAULT_DESIRED_MAX_CONN_INTERVAL),
 
   // Tx power level
@@ -250,10 +304,31 @@ static uint8_t advertData[] =
   HI_UINT16(F91_NOTIFICATION_SERVICE_UUID)
 };
 
+// Advertising schedule: fast after a disconnect or a button press, then
+// slower down to a sparse beacon while the phone is away. Intervals in
+// units of 625us, durations in ms.
+static gapRoleAdvStep_t advSchedule[] =
+{
+  { DEFAULT_ADVERTISING_INTERVAL, 30000 },  // 100ms for 30s
+  { 668, 120000 },                          // 417.5ms for 2min
+  { 1636, 600000 },                         // 1022.5ms for 10min
+  { 3200, 0 }                               // 2s from then on
+};
+
 // GAP GATT Attributes
 static uint8_t attDeviceName[GAP_DEVICE_NAME_LEN_KEPLER] = "F91 Kepler";
 
 
+// Worst case latency (in Clock ticks) seen by the task loop: how long a queued
+// message waited to be processed, and how long the per-second clock update
+// held the task (anything arriving meanwhile waits at least that long).
+static uint32_t maxMsgLatency = 0;
+static uint32_t maxClockUpdate = 0;
+
+// Time of the connection (in Clock ticks), until the phone first writes.
+static uint32_t connectTicks;
+static bool     firstWritePending = false;
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -263,6 +338,9 @@ static void F91Kepler_taskFxn(UArg a0, UArg a1);
 
 static uint8_t F91Kepler_processStackMsg(ICall_Hdr *pMsg);
 static uint8_t F91Kepler_processGATTMsg(gattMsgEvent_t *pMsg);
+static void F91Kepler_linkEncrypted(void);
+static uint8_t *F91Kepler_bondIdentity(uint8_t *pIdentityAddr);
+static void F91Kepler_logStack(void);
 static void F91Kepler_processAppMsg(f91Evt_t *pMsg);
 static void F91Kepler_processStateChangeEvt(gaprole_States_t newState);
 static void F91Kepler_processCharValueChangeEvt(uint8_t serviceID, uint8_t paramID);
@@ -278,9 +356,15 @@ static void F91Kepler_processPairState(uint8_t state, uint8_t status);
 static void F91Kepler_processPasscode(uint8_t uiOutputs);
 
 static void F91Kepler_stateChangeCB(gaprole_States_t newState);
-static uint8_t F91Kepler_enqueueMsg(uint8_t event, uint8_t state,
+static void F91Kepler_paramUpdateCB(uint16_t connInterval,
+                                    uint16_t connSlaveLatency,
+                                    uint16_t connTimeout);
+static uint8_t F91Kepler_enqueueMsg(uint16_t event, uint8_t state,
                                               uint8_t *pData);
 static void F91Kepler_connEvtCB(Gap_ConnEventRpt_t *pReport);
+static void F91Kepler_trackLatency(uint32_t *pMax, uint32_t ticks, uint8_t line, char *format);
+static void F91Kepler_logAdvertising(void);
+static void F91Kepler_checkDatabase(void);
 static void F91Kepler_processConnEvt(Gap_ConnEventRpt_t *pReport);
 
 /*********************************************************************
@@ -298,6 +382,9 @@ static gapRolesCBs_t F91Kepler_gapRoleCBs =
   F91Kepler_stateChangeCB     // GAPRole State Change Callbacks
 };
 
+// Peripheral GAPRole Connection Parameter Update Callback
+static gapRolesParamUpdateCB_t F91Kepler_paramUpdateCBs = F91Kepler_paramUpdateCB;
+
 // GAP Bond Manager Callbacks
 // These are set to NULL since they are not needed. The application
 // is set up to only perform justworks pairing.
@@ -513,6 +600,9 @@ static void F91Kepler_init(void)
     GAP_SetParamValue(TGAP_LIM_DISC_ADV_INT_MAX, advInt);
     GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MIN, advInt);
     GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MAX, advInt);
+
+    // Steps down from the interval above
+    GAPRole_SetParameter(GAPROLE_ADV_SCHEDULE, sizeof(advSchedule), advSchedule);
   }
 
   // Setup the GAP Bond Manager. For more information see the section in the
@@ -534,8 +624,9 @@ static void F91Kepler_init(void)
     // Whether to replace the least recently used entry when bond list is full,
     // and a new device is bonded.
     // Alternative is pairing succeeds but bonding fails, unless application has
-    // manually erased at least one bond.
-    uint8_t replaceBonds = FALSE;
+    // manually erased at least one bond. A phone re-pairing after a reset of
+    // its Bluetooth settings would never bond again once the list is full.
+    uint8_t replaceBonds = TRUE;
 
     GAPBondMgr_SetParameter(GAPBOND_PAIRING_MODE, sizeof(uint8_t), &pairMode);
     GAPBondMgr_SetParameter(GAPBOND_MITM_PROTECTION, sizeof(uint8_t), &mitm);
@@ -544,13 +635,35 @@ static void F91Kepler_init(void)
     GAPBondMgr_SetParameter(GAPBOND_LRU_BOND_REPLACEMENT, sizeof(uint8_t), &replaceBonds);
   }
 
+  // The stack queues 5 prepare writes by default, about 90 bytes at the
+  // default ATT_MTU. A full state sync or message body sent as a long write
+  // would be refused, make room for the longest.
+  {
+    uint8_t numPrepareWrites = F91_NOTIFICATION_SERVICE_PREPARE_WRITES;
+
+    GATTServApp_SetParameter(GATT_PARAM_NUM_PREPARE_WRITES, sizeof(uint8_t), &numPrepareWrites);
+  }
+
   // Initialize GATT attributes
   GGS_AddService(GATT_ALL_SERVICES);           // GAP GATT Service
   GATTServApp_AddService(GATT_ALL_SERVICES);   // GATT Service
   DevInfo_AddService();                        // Device Information Service
 
+  // Timers first, the modules below construct theirs at init.
+  F91Timers_init();
+
+  // The log is read back before the modules that restore from it.
+  F91Log_init();
+
   //Display_print0(F91_LOGGER, 0, 0, "Starting F91 Notification module.");
   F91Notification_init();
+  F91Sync_init();
+  F91Command_init();
+  F91Outbound_init();
+  F91AttQueue_init();
+
+  // Alarms are re-armed by the clock when it sets its defaults.
+  F91Alarm_init();
 
   //Display_print0(F91_LOGGER, 0, 0, "Starting F91 Clock module.");
   F91Clock_init();
@@ -558,16 +671,24 @@ static void F91Kepler_init(void)
   //Setup the buttons
   F91Buttons_init();
 
+  F91Stopwatch_init();
+
+  F91Oad_init();
+
   // Start the Device:
   // Please Notice that in case of wanting to use the GAPRole_SetParameter
   // function with GAPROLE_IRK or GAPROLE_SRK parameter - Perform
   // these function calls before the GAPRole_StartDevice use.
   // (because Both cases are updating the gapRole_IRK & gapRole_SRK variables).
   VOID GAPRole_StartDevice(&F91Kepler_gapRoleCBs);
+  GAPRole_RegisterAppCBs(&F91Kepler_paramUpdateCBs);
 
   // Start Bond Manager and register callback
   VOID GAPBondMgr_Register(&f91Kepler_BondMgrCBs);
 
+  // Bonded phones skip discovery unless the services changed
+  F91Kepler_checkDatabase();
+
   // Register with GAP for HCI/Host messages. This is needed to receive HCI
   // events. For more information, see the section in the User's Guide:
   // http://software-dl.ti.com/lprf/sdg-latest/html
@@ -576,17 +697,15 @@ static void F91Kepler_init(void)
   // Register for GATT local events and ATT Responses pending for transmission
   GATT_RegisterForMsgs(selfEntity);
 
-  //Set default values for Data Length Extension
-  {
-    //Set initial values to maximum, RX is set to max. by default(251 octets, 2120us)
-    #define APP_SUGGESTED_PDU_SIZE 251 //default is 27 octets(TX)
-    #define APP_SUGGESTED_TX_TIME 2120 //default is 328us(TX)
-
-    //This API is documented in hci.h
-    //See the LE Data Length Extension section in the BLE-Stack User's Guide for information on using this command:
-    //http://software-dl.ti.com/lprf/sdg-latest/html/cc2640/index.html
-    //HCI_LE_WriteSuggestedDefaultDataLenCmd(APP_SUGGESTED_PDU_SIZE, APP_SUGGESTED_TX_TIME);
-  }
+  // GATT client for ANCS on the central
+  F91Ancs_init(selfEntity);
+
+  // Connection parameters, data length and MTU follow the traffic. TX data
+  // length stays at the default (27 octets, 328us) until a bulk transfer.
+  F91Link_init(selfEntity);
+
+  // L2CAP channel for objects too large for a characteristic write
+  F91Bulk_init(selfEntity);
 
 #if !defined (USE_LL_CONN_PARAM_UPDATE)
   // Get the currently set local supported LE features
@@ -660,6 +779,9 @@ static void F91Kepler_taskFxn(UArg a0, UArg a1)
           f91Evt_t *pMsg = (f91Evt_t *)Util_dequeueMsg(appMsgQueue);
           if (pMsg)
           {
+            F91Kepler_trackLatency(&maxMsgLatency, Clock_getTicks() - pMsg->timestamp, 12,
+                                   "Max msg latency: %dus");
+
             // Process message.
             F91Kepler_processAppMsg(pMsg);
 
@@ -672,10 +794,51 @@ static void F91Kepler_taskFxn(UArg a0, UArg a1)
       if (events & F91_PERIODIC_EVT)
       {
         Util_startClock(&periodicClock);
+
+        // Picks up the battery, only notified once it moved enough.
+        F91Outbound_statusChanged();
       }
 
-      // Process event if available
-      F91Notification_processEvent();
+      if (events & F91_STOPWATCH_EVT)
+      {
+        F91Stopwatch_processEvent();
+      }
+
+      if (events & F91_TIMERS_EVT)
+      {
+        F91Timers_processEvent();
+      }
+
+      if (events & F91_CLOCK_EVT)
+      {
+        uint32_t start = Clock_getTicks();
+
+        F91Clock_processEvent();
+        F91Kepler_trackLatency(&maxClockUpdate, Clock_getTicks() - start, 13,
+                               "Max clock update: %dus");
+      }
+
+      if (events & F91_NOTIFICATION_EVT)
+      {
+        F91Notification_processEvent();
+      }
+
+      if (events & F91_LINK_EVT)
+      {
+        F91Link_processEvent();
+      }
+
+      if (events & F91_OUTBOUND_EVT)
+      {
+        F91Outbound_processEvent();
+      }
+
+      if (events & F91_ATT_QUEUE_EVT)
+      {
+        // Something is held, retry it at the end of each connection event
+        F91Kepler_RegistertToAllConnectionEvent(FOR_ATT_RSP);
+        F91Link_holdLatency(F91_LINK_HOLD_ATT_RSP, F91AttQueue_isRspPending());
+      }
     }
   }
 }
@@ -766,6 +929,15 @@ static uint8_t F91Kepler_processStackMsg(ICall_Hdr *pMsg)
       }
       break;
 
+    case L2CAP_SIGNAL_EVENT:
+      F91Bulk_processSignal((l2capSignalEvent_t *)pMsg);
+      break;
+
+    case L2CAP_DATA_EVENT:
+      // The SDU is handed on and freed by the bulk channel
+      F91Bulk_processData((l2capDataEvent_t *)pMsg);
+      break;
+
       default:
         // do nothing
         break;
@@ -785,15 +957,11 @@ static uint8_t F91Kepler_processStackMsg(ICall_Hdr *pMsg)
 static uint8_t F91Kepler_processGATTMsg(gattMsgEvent_t *pMsg)
 {
   // See if GATT server was unable to transmit an ATT response
-  if (attRsp_isAttRsp(pMsg))
+  if (F91AttQueue_holdRsp(pMsg))
   {
-    // No HCI buffer was available. Let's try to retransmit the response
-    // on the next connection event.
-    if( F91Kepler_RegistertToAllConnectionEvent(FOR_ATT_RSP) == SUCCESS)
-    {
-      // Don't free the response message yet
-      return (FALSE);
-    }
+    // No HCI buffer was available. The response is retried on the next
+    // connection event, don't free the message yet.
+    return (FALSE);
   }
   else if (pMsg->method == ATT_FLOW_CTRL_VIOLATED_EVENT)
   {
@@ -809,6 +977,12 @@ static uint8_t F91Kepler_processGATTMsg(gattMsgEvent_t *pMsg)
     // MTU size updated
     Display_print1(F91_LOGGER, 5, 0, "MTU Size: %d", pMsg->msg.mtuEvt.MTU);
   }
+  else if (!F91Link_processGATTMsg(pMsg))
+  {
+    // GATT client responses and notifications from the central
+    F91Ancs_processGATTMsg(pMsg);
+    F91Link_holdLatency(F91_LINK_HOLD_CLIENT, F91Ancs_isBusy());
+  }
 
   // Free message payload. Needed only for ATT Protocol messages
   GATT_bm_free(&pMsg->msg, pMsg->method);
@@ -829,16 +1003,16 @@ static void F91Kepler_processConnEvt(Gap_ConnEventRpt_t *pReport)
 
   if( CONNECTION_EVENT_REGISTRATION_CAUSE(FOR_ATT_RSP))
   {
-    // The GATT server might have returned a blePending as it was trying
-    // to process an ATT Response. Now that we finished with this
-    // connection event, let's try sending any remaining ATT Responses
-    // on the next connection event.
-    // Try to retransmit pending ATT Response (if any)
-    if (attRsp_sendAttRsp() == SUCCESS)
+    // The controller has room again after a connection event. Send the
+    // held ATT responses and notifications, as many as it takes.
+    if (F91AttQueue_process())
     {
         // Disable connection event end notice
         F91Kepler_UnRegistertToAllConnectionEvent (FOR_ATT_RSP);
     }
+
+    // Listen on every event while the central waits on a response
+    F91Link_holdLatency(F91_LINK_HOLD_ATT_RSP, F91AttQueue_isRspPending());
   }
 
 }
@@ -865,6 +1039,7 @@ static void F91Kepler_processAppMsg(f91Evt_t *pMsg)
 
     case F91_NOTIFICATION_CHAR_CHANGE_EVT:
       {
+        F91_LATENCY_MARK(F91_LATENCY_DEQUEUED);
         F91Kepler_processCharValueChangeEvt(SERVICE_ID_NOTIFICATION, pMsg->hdr.state);
       }
       break;
@@ -875,21 +1050,35 @@ static void F91Kepler_processAppMsg(f91Evt_t *pMsg)
       }
       break;
 
+    case F91_OAD_CHAR_CHANGE_EVT:
+      {
+        F91Kepler_processCharValueChangeEvt(SERVICE_ID_OAD, pMsg->hdr.state);
+      }
+      break;
+
     case F91_BUTTON_PRESS_EVT:
       {
         F91Buttons_processButtonPress((button_state_t *)(pMsg->pData));
 
+        // The user is at the watch, the phone may be looking for it
+        GAPRole_RestartAdvertSchedule();
+
         ICall_free(pMsg->pData);
         break;
       }
 
     case F91_SSD1306_DISPLAY_EVT:
       {
-        ssd1306_toggle_display(false);
-        ssd1306_clear();
-        ssd1306_update();
+        if (F91Notification_getNotificationState()) {
+          F91Notification_nextNotification();
+        } else {
+          ssd1306_toggle_display(false);
+          ssd1306_clear();
+          ssd1306_update();
+        }
       }
       break;
+
     // Pairing event
     case F91_PAIRING_STATE_EVT:
       {
@@ -916,6 +1105,12 @@ static void F91Kepler_processAppMsg(f91Evt_t *pMsg)
         break;
 	  }
 
+    case F91_PARAM_UPDATE_EVT:
+      {
+        F91Link_processParamUpdate();
+      }
+      break;
+
     default:
       // Do nothing.
       break;
@@ -936,6 +1131,25 @@ static void F91Kepler_stateChangeCB(gaprole_States_t newState)
   F91Kepler_enqueueMsg(F91_STATE_CHANGE_EVT, newState, NULL);
 }
 
+/*********************************************************************
+ * @fn      F91Kepler_paramUpdateCB
+ *
+ * @brief   Callback from GAP Role indicating the connection parameters
+ *          were updated. The link manager reads them back in task context.
+ *
+ * @param   connInterval - new connection interval
+ * @param   connSlaveLatency - new slave latency
+ * @param   connTimeout - new supervision timeout
+ *
+ * @return  None.
+ */
+static void F91Kepler_paramUpdateCB(uint16_t connInterval,
+                                    uint16_t connSlaveLatency,
+                                    uint16_t connTimeout)
+{
+  F91Kepler_enqueueMsg(F91_PARAM_UPDATE_EVT, 0, NULL);
+}
+
 /*********************************************************************
  * @fn      F91Kepler_processStateChangeEvt
  *
@@ -989,7 +1203,7 @@ static void F91Kepler_processStateChangeEvt(gaprole_States_t newState)
       break;
 
     case GAPROLE_ADVERTISING:
-      Display_print0(F91_LOGGER, 2, 0, "Advertising");
+      F91Kepler_logAdvertising();
       break;
 
 #ifdef PLUS_BROADCASTER
@@ -1014,7 +1228,8 @@ static void F91Kepler_processStateChangeEvt(gaprole_States_t newState)
         // Reset flag for next connection.
         firstConnFlag = false;
 
-        attRsp_freeAttRsp(bleNotConnected);
+        F91AttQueue_reset();
+        F91Kepler_UnRegistertToAllConnectionEvent(FOR_ATT_RSP);
       }
       break;
 #endif //PLUS_BROADCASTER
@@ -1023,8 +1238,23 @@ static void F91Kepler_processStateChangeEvt(gaprole_States_t newState)
       {
         linkDBInfo_t linkInfo;
         uint8_t numActive = 0;
+        uint16_t connHandle;
+        uint8_t identityAddr[B_ADDR_LEN];
 
         Util_startClock(&periodicClock);
+        F91Kepler_logAdvertising();
+
+        if (GAPRole_GetParameter(GAPROLE_CONNHANDLE, &connHandle) == SUCCESS)
+        {
+          F91Link_connected(connHandle);
+          F91Outbound_connected(connHandle);
+        }
+
+        // Configurations of a bonded phone are back already
+        F91Service_syncCfg();
+
+        connectTicks = Clock_getTicks();
+        firstWritePending = true;
 
         numActive = linkDB_NumActive();
 
@@ -1045,6 +1275,9 @@ static void F91Kepler_processStateChangeEvt(gaprole_States_t newState)
           Display_print0(F91_LOGGER, 3, 0, Util_convertBdAddr2Str(peerAddress));
         }
 
+        // Frames the same bond sends again are recognised by the window.
+        F91Command_connect(F91Kepler_bondIdentity(identityAddr));
+
         #ifdef PLUS_BROADCASTER
           // Only turn advertising on for this state when we first connect
           // otherwise, when we go from connected_advertising back to this state
@@ -1078,7 +1311,16 @@ static void F91Kepler_processStateChangeEvt(gaprole_States_t newState)
         uint8_t advertReEnable = TRUE;
 
         Util_stopClock(&periodicClock);
-        attRsp_freeAttRsp(bleNotConnected);
+        F91AttQueue_reset();
+        F91Kepler_UnRegistertToAllConnectionEvent(FOR_ATT_RSP);
+        F91Ancs_reset();
+        F91Link_reset();
+        F91Outbound_reset();
+        F91Oad_reset();
+        F91Bulk_reset();
+        F91Service_syncCfg();
+        F91Kepler_logStack();
+        firstWritePending = false;
 
         // Clear remaining lines
         Display_clearLines(F91_LOGGER, 3, 5);
@@ -1089,7 +1331,16 @@ static void F91Kepler_processStateChangeEvt(gaprole_States_t newState)
       break;
 
     case GAPROLE_WAITING_AFTER_TIMEOUT:
-      attRsp_freeAttRsp(bleNotConnected);
+      F91AttQueue_reset();
+      F91Kepler_UnRegistertToAllConnectionEvent(FOR_ATT_RSP);
+      F91Ancs_reset();
+      F91Link_reset();
+      F91Outbound_reset();
+      F91Oad_reset();
+      F91Bulk_reset();
+      F91Service_syncCfg();
+      F91Kepler_logStack();
+      firstWritePending = false;
 
       Display_print0(F91_LOGGER, 2, 0, "Timed Out");
 
@@ -1126,6 +1377,7 @@ static void F91Kepler_processStateChangeEvt(gaprole_States_t newState)
 void F91Kepler_notificationCharValueChangeCB(uint8_t paramID)
 {
   F91Kepler_enqueueMsg(F91_NOTIFICATION_CHAR_CHANGE_EVT, paramID, 0);
+  F91_LATENCY_MARK(F91_LATENCY_QUEUED);
 }
 
 /*********************************************************************
@@ -1143,6 +1395,21 @@ void F91Kepler_clockCharValueChangeCB(uint8_t paramID)
   F91Kepler_enqueueMsg(F91_CLOCK_CHAR_CHANGE_EVT, paramID, 0);
 }
 
+/*********************************************************************
+ * @fn      F91Kepler_oadCharValueChangeCB
+ *
+ * @brief   Callback indicating a characteristic
+ *          value change.
+ *
+ * @param   paramID - parameter ID of the value that was changed.
+ *
+ * @return  None.
+ */
+void F91Kepler_oadCharValueChangeCB(uint8_t paramID)
+{
+  F91Kepler_enqueueMsg(F91_OAD_CHAR_CHANGE_EVT, paramID, 0);
+}
+
 /*********************************************************************
  * @fn      F91Kepler_buttonValueChangeCB
  *
@@ -1172,6 +1439,108 @@ void F91Kepler_displayStateChangeCB( void )
   F91Kepler_enqueueMsg(F91_SSD1306_DISPLAY_EVT, 0, 0);
 }
 
+/*********************************************************************
+ * @fn      F91Kepler_stopwatchRefreshCB
+ *
+ * @brief   Callback indicating the stopwatch display is due for a refresh.
+ *          Posts an event rather than queueing a message since it fires
+ *          many times a second.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+void F91Kepler_stopwatchRefreshCB( void )
+{
+  Event_post(syncEvent, F91_STOPWATCH_EVT);
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_timersWakeupCB
+ *
+ * @brief   Callback indicating a timer wheel deadline has been reached.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+void F91Kepler_timersWakeupCB( void )
+{
+  Event_post(syncEvent, F91_TIMERS_EVT);
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_clockTickCB
+ *
+ * @brief   Callback indicating the time display is due for its update.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+void F91Kepler_clockTickCB( void )
+{
+  Event_post(syncEvent, F91_CLOCK_EVT);
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_notificationFlushCB
+ *
+ * @brief   Callback indicating the notification updates received are due
+ *          to be drawn.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+void F91Kepler_notificationFlushCB( void )
+{
+  Event_post(syncEvent, F91_NOTIFICATION_EVT);
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_linkCB
+ *
+ * @brief   Callback indicating the link manager is due to look at the
+ *          traffic.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+void F91Kepler_linkCB( void )
+{
+  Event_post(syncEvent, F91_LINK_EVT);
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_outboundCB
+ *
+ * @brief   Callback indicating the outbound queue is due to be flushed.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+void F91Kepler_outboundCB( void )
+{
+  Event_post(syncEvent, F91_OUTBOUND_EVT);
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_attQueueCB
+ *
+ * @brief   Callback indicating the ATT queue holds something to retry.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+void F91Kepler_attQueueCB( void )
+{
+  Event_post(syncEvent, F91_ATT_QUEUE_EVT);
+}
+
 /*********************************************************************
  * @fn      F91Kepler_processCharValueChangeEvt
  *
@@ -1184,14 +1553,31 @@ void F91Kepler_displayStateChangeCB( void )
  */
 static void F91Kepler_processCharValueChangeEvt(uint8_t serviceID, uint8_t paramID)
 {
+  // A phone that rediscovers the services only writes once it is done.
+  if (firstWritePending)
+  {
+    firstWritePending = false;
+    Display_print1(F91_LOGGER, F91_RECONNECT_LOG_LINE, 0, "First write %dms after connect",
+                   (Clock_getTicks() - connectTicks) * Clock_tickPeriod / 1000);
+  }
+
   switch (serviceID)
   {
     case SERVICE_ID_NOTIFICATION:
-      F91Notification_processCharChangeEvt(paramID);
+      if (paramID == F91_NOTIFICATION_SERVICE_CHAR5) {
+        F91Sync_processCharChangeEvt();
+      } else if (paramID == F91_NOTIFICATION_SERVICE_CHAR6) {
+        F91Command_processCharChangeEvt();
+      } else {
+        F91Notification_processCharChangeEvt(paramID);
+      }
       break;
     case SERVICE_ID_CLOCK:
       F91Clock_processCharChangeEvt(paramID);
       break;
+    case SERVICE_ID_OAD:
+      F91Oad_processCharChangeEvt(paramID);
+      break;
     default:
       break;
   }
@@ -1220,6 +1606,67 @@ static void F91Kepler_pairStateCB(uint16_t connHandle, uint8_t state,
   }
 }
 
+/*********************************************************************
+ * @fn      F91Kepler_logStack
+ *
+ * @brief   Log the most the task stack was used so far, a connection
+ *          has just gone through all its paths.
+ *
+ * @return  none
+ */
+static void F91Kepler_logStack(void)
+{
+  Task_Stat stat;
+
+  Task_stat(Task_handle(&f91Task), &stat);
+  Display_print2(F91_LOGGER, F91_STACK_LOG_LINE, 0, "Task stack: %d of %d used",
+                 stat.used, stat.stackSize);
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_linkEncrypted
+ *
+ * @brief   The link is encrypted. Open the bulk channel to it if the
+ *          keys are authenticated, and look for ANCS.
+ *
+ * @return  none
+ */
+static void F91Kepler_linkEncrypted(void)
+{
+  uint16_t connHandle;
+
+  if (GAPRole_GetParameter(GAPROLE_CONNHANDLE, &connHandle) == SUCCESS)
+  {
+    F91Bulk_updateSecurity(connHandle);
+    F91Ancs_start(connHandle);
+    F91Link_holdLatency(F91_LINK_HOLD_CLIENT, F91Ancs_isBusy());
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_bondIdentity
+ *
+ * @brief   Identity address of the connected phone's bond, whatever
+ *          private address it connected with.
+ *
+ * @param   pIdentityAddr - B_ADDR_LEN bytes for the address.
+ *
+ * @return  pIdentityAddr, or NULL if the phone isn't bonded.
+ */
+static uint8_t *F91Kepler_bondIdentity(uint8_t *pIdentityAddr)
+{
+  linkDBInfo_t linkInfo;
+  uint8_t numActive = linkDB_NumActive();
+
+  if ((numActive > 0) && (linkDB_GetInfo(numActive - 1, &linkInfo) == SUCCESS) &&
+      (GAPBondMgr_ResolveAddr(linkInfo.addrType, linkInfo.addr, pIdentityAddr) < GAP_BONDINGS_MAX))
+  {
+    return pIdentityAddr;
+  }
+
+  return NULL;
+}
+
 /*********************************************************************
  * @fn      F91Kepler_processPairState
  *
@@ -1229,6 +1676,8 @@ static void F91Kepler_pairStateCB(uint16_t connHandle, uint8_t state,
  */
 static void F91Kepler_processPairState(uint8_t state, uint8_t status)
 {
+  uint8_t identityAddr[B_ADDR_LEN];
+
   if (state == GAPBOND_PAIRING_STATE_STARTED)
   {
     Display_print0(F91_LOGGER, 2, 0, "Pairing started");
@@ -1238,6 +1687,9 @@ static void F91Kepler_processPairState(uint8_t state, uint8_t status)
     if (status == SUCCESS)
     {
       Display_print0(F91_LOGGER, 2, 0, "Pairing success");
+      // New keys, the phone starts its command sequence again.
+      F91Command_reset();
+      F91Kepler_linkEncrypted();
     }
     else
     {
@@ -1249,6 +1701,8 @@ static void F91Kepler_processPairState(uint8_t state, uint8_t status)
     if (status == SUCCESS)
     {
       Display_print0(F91_LOGGER, 2, 0, "Bonding success");
+      F91Service_syncCfg();
+      F91Kepler_linkEncrypted();
     }
   }
   else if (state == GAPBOND_PAIRING_STATE_BOND_SAVED)
@@ -1256,6 +1710,8 @@ static void F91Kepler_processPairState(uint8_t state, uint8_t status)
     if (status == SUCCESS)
     {
       Display_print0(F91_LOGGER, 2, 0, "Bond save success");
+      // The window started at pairing is this bond's from now on.
+      F91Command_bonded(F91Kepler_bondIdentity(identityAddr));
     }
     else
     {
@@ -1347,6 +1803,81 @@ static void F91Kepler_connEvtCB(Gap_ConnEventRpt_t *pReport)
 
 }
 
+/*********************************************************************
+ * @fn      F91Kepler_trackLatency
+ *
+ * @brief   Records a latency sample and logs it if it is a new maximum.
+ *
+ * @param   pMax - maximum to update.
+ * @param   ticks - sample in Clock ticks.
+ * @param   line - log line number.
+ * @param   format - log line, takes the sample in usec.
+ *
+ * @return  None.
+ */
+static void F91Kepler_trackLatency(uint32_t *pMax, uint32_t ticks, uint8_t line, char *format)
+{
+  if (ticks > *pMax)
+  {
+    *pMax = ticks;
+    Display_print1(F91_LOGGER, line, 0, format, ticks * Clock_tickPeriod);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_checkDatabase
+ *
+ * @brief   Compares the services with those of the last boot. A bonded
+ *          phone keeps what it discovered and reuses it on reconnection,
+ *          so after an update that changed them every bond is flagged and
+ *          the bond manager indicates Service Changed once the phone is
+ *          back and encrypted.
+ *
+ * @return  None.
+ */
+static void F91Kepler_checkDatabase(void)
+{
+  uint32_t hash = F91Service_getHash();
+  uint32_t saved;
+
+  if ((osal_snv_read(F91_DB_HASH_NVID, sizeof(saved), &saved) == SUCCESS) &&
+      (saved == hash))
+  {
+    return;
+  }
+
+  GAPBondMgr_ServiceChangeInd(0xFFFF, TRUE);
+  osal_snv_write(F91_DB_HASH_NVID, sizeof(hash), &hash);
+  Display_print1(F91_LOGGER, F91_RECONNECT_LOG_LINE, 0, "Services changed: %x", hash);
+}
+
+/*********************************************************************
+ * @fn      F91Kepler_logAdvertising
+ *
+ * @brief   Logs the advertising step and the duty cycle since boot.
+ *
+ * @return  None.
+ */
+static void F91Kepler_logAdvertising(void)
+{
+  gapRoleAdvStats_t stats;
+  uint8_t step;
+
+  GAPRole_GetParameter(GAPROLE_ADV_STEP, &step);
+  GAPRole_GetParameter(GAPROLE_ADV_STATS, &stats);
+
+  Display_print2(F91_LOGGER, 2, 0, "Advertising %dms (step %d)",
+                 advSchedule[step].advInt * 5 / 8, step);
+
+  if (stats.advTime > 0)
+  {
+    Display_print3(F91_LOGGER, F91_ADV_LOG_LINE, 0, "Adv %ds: %d events, duty %dppm",
+                   stats.advTime / 1000, stats.advEvents,
+                   (uint32_t)((uint64_t)stats.advEvents * F91_ADV_EVENT_USEC * 1000 /
+                              stats.advTime));
+  }
+}
+
 /*********************************************************************
  *
  * @brief   Creates a message and puts the message in RTOS queue.
@@ -1357,7 +1888,7 @@ static void F91Kepler_connEvtCB(Gap_ConnEventRpt_t *pReport)
  *
  * @return  TRUE or FALSE
  */
-static uint8_t F91Kepler_enqueueMsg(uint8_t event, uint8_t state,
+static uint8_t F91Kepler_enqueueMsg(uint16_t event, uint8_t state,
                                            uint8_t *pData)
 {
   f91Evt_t *pMsg = ICall_malloc(sizeof(f91Evt_t));
@@ -1368,6 +1899,7 @@ static uint8_t F91Kepler_enqueueMsg(uint8_t event, uint8_t state,
     pMsg->hdr.event = event;
     pMsg->hdr.state = state;
     pMsg->pData = pData;
+    pMsg->timestamp = Clock_getTicks();
 
     // Enqueue the message.
     return Util_enqueueMsg(appMsgQueue, syncEvent, (uint8_t *)pMsg);
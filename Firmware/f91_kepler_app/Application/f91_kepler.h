@@ -69,6 +69,7 @@ extern "C"
 // Service ID's for internal application use
 #define SERVICE_ID_NOTIFICATION      1
 #define SERVICE_ID_CLOCK             2
+#define SERVICE_ID_OAD               3
 
 
 
@@ -95,6 +96,11 @@ extern void F91Kepler_notificationCharValueChangeCB(uint8_t paramID);
  */
 extern void F91Kepler_clockCharValueChangeCB(uint8_t paramID);
 
+/*
+ * Function to call when a characteristic value has changed
+ */
+extern void F91Kepler_oadCharValueChangeCB(uint8_t paramID);
+
 /*
  * Function to call when a button value has changed
  */
@@ -104,6 +110,41 @@ extern void F91Kepler_buttonValueChangeCB(uint8_t *pData);
  * Function to call when a display state change has been requested.
  */
 extern void F91Kepler_displayStateChangeCB( void );
+
+/*
+ * Function to call when the stopwatch display is due for a refresh.
+ */
+extern void F91Kepler_stopwatchRefreshCB( void );
+
+/*
+ * Function to call when a timer wheel deadline has been reached.
+ */
+extern void F91Kepler_timersWakeupCB( void );
+
+/*
+ * Function to call when the time display is due for its update.
+ */
+extern void F91Kepler_clockTickCB( void );
+
+/*
+ * Function to call when notification updates are due to be drawn.
+ */
+extern void F91Kepler_notificationFlushCB( void );
+
+/*
+ * Function to call when the link manager is due to look at the link.
+ */
+extern void F91Kepler_linkCB( void );
+
+/*
+ * Function to call when the outbound queue is due to be flushed.
+ */
+extern void F91Kepler_outboundCB( void );
+
+/*
+ * Function to call when the ATT queue holds something to retry.
+ */
+extern void F91Kepler_attQueueCB( void );
 /*********************************************************************
 *********************************************************************/
 
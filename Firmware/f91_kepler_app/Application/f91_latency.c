@@ -0,0 +1,201 @@
+/******************************************************************************
+
+ @file  f91_latency.c
+
+ @brief This file contains the F91 Kepler Smart Watch latency trace.
+
+        Each stage keeps its last F91_LATENCY_SAMPLES hops, time from the
+        stage before, plus the total from the write. Every
+        F91_LATENCY_REPORT_EVERY traces the p50 and p99 of each are logged.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "f91_latency.h"
+#include "f91_utils.h"
+
+#ifdef F91_LATENCY_TRACE
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Sample rows: a hop per stage after the write, then the total.
+#define LATENCY_TOTAL             0
+#define LATENCY_ROWS              F91_LATENCY_STAGES
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Row names on the log, the write row holds the total.
+static const char *latencyNames[LATENCY_ROWS] =
+{
+  "total", "queue", "wake", "handle", "coalesce", "render", "panel"
+};
+
+// Clock ticks of each stage of the trace in progress.
+static uint32_t stamps[F91_LATENCY_STAGES];
+
+// Stage expected next, F91_LATENCY_STAGES when no trace is in progress.
+static uint8_t nextStage = F91_LATENCY_STAGES;
+
+// Sample rings in Clock ticks.
+static uint32_t samples[LATENCY_ROWS][F91_LATENCY_SAMPLES];
+static uint8_t  sampleCount = 0;
+static uint8_t  sampleIndex = 0;
+static uint8_t  tracesSinceReport = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void _F91Latency_finish(void);
+static void _F91Latency_report(void);
+static uint32_t _F91Latency_percentile(uint32_t *pSorted, uint8_t count, uint8_t percent);
+
+/*********************************************************************
+ * @fn      _F91Latency_finish
+ *
+ * @brief   Store the hops of a finished trace.
+ *
+ * @return  None.
+ */
+static void _F91Latency_finish(void)
+{
+  uint8_t stage;
+
+  samples[LATENCY_TOTAL][sampleIndex] = stamps[F91_LATENCY_PANEL] - stamps[F91_LATENCY_WRITE];
+  for (stage = F91_LATENCY_QUEUED; stage < F91_LATENCY_STAGES; stage++) {
+    samples[stage][sampleIndex] = stamps[stage] - stamps[stage - 1];
+  }
+
+  sampleIndex = (sampleIndex + 1) % F91_LATENCY_SAMPLES;
+  if (sampleCount < F91_LATENCY_SAMPLES) {
+    sampleCount++;
+  }
+
+  if (++tracesSinceReport >= F91_LATENCY_REPORT_EVERY) {
+    tracesSinceReport = 0;
+    _F91Latency_report();
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Latency_percentile
+ *
+ * @brief   Nearest rank percentile.
+ *
+ * @param   pSorted - samples in ascending order.
+ * @param   count - number of samples, at least one.
+ * @param   percent - percentile.
+ *
+ * @return  The sample at that rank.
+ */
+static uint32_t _F91Latency_percentile(uint32_t *pSorted, uint8_t count, uint8_t percent)
+{
+  uint16_t rank = ((uint16_t)count * percent + 99) / 100;
+
+  return pSorted[(rank > 0) ? (rank - 1) : 0];
+}
+
+/*********************************************************************
+ * @fn      _F91Latency_report
+ *
+ * @brief   Log p50 and p99 of every row, in usec.
+ *
+ * @return  None.
+ */
+static void _F91Latency_report(void)
+{
+  uint32_t sorted[F91_LATENCY_SAMPLES];
+  uint32_t value;
+  uint8_t row, i, j;
+
+  for (row = 0; row < LATENCY_ROWS; row++) {
+    // Insertion sort, the rings are short.
+    for (i = 0; i < sampleCount; i++) {
+      value = samples[row][i];
+      for (j = i; (j > 0) && (sorted[j - 1] > value); j--) {
+        sorted[j] = sorted[j - 1];
+      }
+      sorted[j] = value;
+    }
+
+    Display_print4(F91_LOGGER, F91_LATENCY_LOG_LINE + row, 0, "Lat %s: p50 %dus p99 %dus (%d)",
+                   latencyNames[row],
+                   _F91Latency_percentile(sorted, sampleCount, 50) * Clock_tickPeriod,
+                   _F91Latency_percentile(sorted, sampleCount, 99) * Clock_tickPeriod,
+                   sampleCount);
+  }
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Latency_mark
+ *
+ * @brief   Timestamp a stage. F91_LATENCY_WRITE starts a new trace and
+ *          drops one still in progress, F91_LATENCY_PANEL ends it. Called
+ *          from the stack's write callback as well as the F91Kepler task.
+ *
+ * @param   stage - F91_LATENCY_xxx.
+ *
+ * @return  none
+ */
+void F91Latency_mark(uint8_t stage)
+{
+  if (stage == F91_LATENCY_WRITE) {
+    nextStage = F91_LATENCY_WRITE;
+  }
+
+  if (stage != nextStage) {
+    return;
+  }
+
+  stamps[stage] = Clock_getTicks();
+  nextStage++;
+
+  if (nextStage == F91_LATENCY_STAGES) {
+    _F91Latency_finish();
+  }
+}
+
+#endif // F91_LATENCY_TRACE
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,102 @@
+/******************************************************************************
+
+ @file  f91_latency.h
+
+ @brief This file contains the F91 Kepler Smart Watch latency trace
+        definitions and prototypes. It times an incoming call or text from
+        the GATT write to the pixels on the panel, one stage at a time.
+        tools/host/test_latency.c runs the same marks on the host.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91LATENCY_H
+#define F91LATENCY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Uncomment (or define for the project) to build the trace in. Without it
+// the marks compile to nothing.
+//#define F91_LATENCY_TRACE
+
+// Stages, marked in this order. A write starts a new trace, a mark out of
+// order is ignored so other traffic on the same paths doesn't count.
+#define F91_LATENCY_WRITE           0   // characteristic write callback
+#define F91_LATENCY_QUEUED          1   // message queued to the F91Kepler task
+#define F91_LATENCY_DEQUEUED        2   // task woken, message taken off the queue
+#define F91_LATENCY_HANDLED         3   // recorded and posted to the display
+#define F91_LATENCY_FLUSHED         4   // coalescing window over
+#define F91_LATENCY_RENDERED        5   // drawn into the frame buffer
+#define F91_LATENCY_PANEL           6   // sent to the panel and display on
+#define F91_LATENCY_STAGES          7
+
+// Samples kept per stage for the percentiles.
+#define F91_LATENCY_SAMPLES         32
+
+// Traces between two reports on the log.
+#define F91_LATENCY_REPORT_EVERY    8
+
+// First log line of the report, one line per stage and one for the total.
+#define F91_LATENCY_LOG_LINE        17
+
+/*********************************************************************
+ * MACROS
+ */
+
+#ifdef F91_LATENCY_TRACE
+#define F91_LATENCY_MARK(stage)     F91Latency_mark(stage)
+#else
+#define F91_LATENCY_MARK(stage)
+#endif
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Timestamp a stage of the trace.
+ */
+extern void F91Latency_mark(uint8_t stage);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91LATENCY_H */
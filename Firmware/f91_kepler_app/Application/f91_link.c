@@ -0,0 +1,627 @@
+/******************************************************************************
+
+ @file  f91_link.c
+
+ @brief This file contains the F91 Kepler Smart Watch link manager.
+
+        Writes from the phone are counted as they arrive. A burst moves the
+        link to bulk, quiet moves it back to idle, and requests are spaced
+        by F91_LINK_DWELL_MS. Time, bytes and radio wakes are kept per mode,
+        wakes standing in for the radio's energy.
+
+        Slave latency is overridden, not renegotiated, while the watch waits
+        on the central: the controller then listens on every event until
+        the last hold is released.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include <icall.h>
+#include "icall_ble_api.h"
+
+#include "bcomdef.h"
+#include "att.h"
+#include "gatt.h"
+#include "peripheral.h"
+#include "util.h"
+
+#include "f91_link.h"
+#include "f91_utils.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define LINK_MS_TO_TICKS(ms)      ((ms) * (1000 / Clock_tickPeriod))
+#define LINK_TICKS_TO_MS(ticks)   ((ticks) / (1000 / Clock_tickPeriod))
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// MTU exchange, done once per connection.
+#define LINK_MTU_NONE             0
+#define LINK_MTU_SENT             1
+#define LINK_MTU_DONE             2
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint16_t minInterval;
+  uint16_t maxInterval;
+  uint16_t latency;
+  uint16_t timeout;
+  uint16_t txOctets;
+  uint16_t txTime;
+} f91LinkProfile_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Indexed by F91_LINK_MODE_xxx, nothing is requested for the default.
+static const f91LinkProfile_t linkProfiles[F91_LINK_MODES] =
+{
+  { 0, 0, 0, 0, 0, 0 },
+  { F91_LINK_IDLE_MIN_INTERVAL, F91_LINK_IDLE_MAX_INTERVAL, F91_LINK_IDLE_LATENCY,
+    F91_LINK_IDLE_TIMEOUT, F91_LINK_IDLE_TX_OCTETS, F91_LINK_IDLE_TX_TIME },
+  { F91_LINK_BULK_MIN_INTERVAL, F91_LINK_BULK_MAX_INTERVAL, F91_LINK_BULK_LATENCY,
+    F91_LINK_BULK_TIMEOUT, F91_LINK_BULK_TX_OCTETS, F91_LINK_BULK_TX_TIME }
+};
+
+static const char *linkNames[F91_LINK_MODES] = { "default", "idle", "bulk" };
+
+static uint8_t linkTaskId;
+
+static Clock_Struct linkClock;
+
+static bool     connected = false;
+static uint16_t linkConnHandle;
+// Mode of the parameters the central applied, and the mode last asked for.
+// The traffic is counted against the first, the hysteresis works on the
+// second: the central may turn a request down or apply something else.
+static uint8_t  linkMode = F91_LINK_MODE_DEFAULT;
+static uint8_t  requestedMode = F91_LINK_MODE_DEFAULT;
+static uint32_t lastRequestTicks;
+static uint8_t  mtuState = LINK_MTU_NONE;
+static bool     bulkHint = false;
+static uint8_t  holdMask = 0;
+
+// Written by the stack's write callbacks, read by the F91Kepler task.
+static volatile uint32_t rxBytes = 0;
+static volatile uint32_t lastRxTicks;
+static volatile uint32_t windowTicks;
+static volatile uint16_t windowBytes = 0;
+static volatile bool     evaluatePosted = false;
+
+// Segment in progress, the time since the mode or the parameters changed.
+static uint32_t segmentTicks;
+static uint32_t segmentBytes;
+static uint16_t segmentInterval;
+static uint16_t segmentLatency;
+
+// Totals per mode since boot. Wakes are also counted as they would be
+// without slave latency, to compare against.
+static uint32_t modeMs[F91_LINK_MODES];
+static uint32_t modeBytes[F91_LINK_MODES];
+static uint32_t modeWakes[F91_LINK_MODES];
+static uint32_t modeEvents[F91_LINK_MODES];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void _F91Link_clockCallback(UArg arg);
+static uint8_t _F91Link_target(uint32_t now);
+static bool _F91Link_request(uint8_t mode, uint32_t now);
+static uint8_t _F91Link_appliedMode(void);
+static void _F91Link_startSegment(uint32_t now);
+static void _F91Link_closeSegment(uint32_t now);
+static void _F91Link_report(uint8_t mode);
+
+/*********************************************************************
+ * @fn      _F91Link_clockCallback
+ *
+ * @brief   Time to look at the link again. Runs in Swi context, the rest
+ *          is left to the F91_Kepler task.
+ *
+ * @param   arg - unused.
+ *
+ * @return  None.
+ */
+static void _F91Link_clockCallback(UArg arg)
+{
+  F91Kepler_linkCB();
+}
+
+/*********************************************************************
+ * @fn      _F91Link_target
+ *
+ * @brief   Mode the traffic calls for. A burst over the threshold moves to
+ *          bulk, only quiet moves back out of it.
+ *
+ * @param   now - Clock ticks.
+ *
+ * @return  F91_LINK_MODE_xxx.
+ */
+static uint8_t _F91Link_target(uint32_t now)
+{
+  if (bulkHint) {
+    return F91_LINK_MODE_BULK;
+  }
+
+  if ((requestedMode != F91_LINK_MODE_BULK) && (windowBytes >= F91_LINK_BULK_BYTES) &&
+      (now - windowTicks < LINK_MS_TO_TICKS(F91_LINK_WINDOW_MS))) {
+    return F91_LINK_MODE_BULK;
+  }
+
+  if (now - lastRxTicks >= LINK_MS_TO_TICKS(F91_LINK_QUIET_MS)) {
+    return F91_LINK_MODE_IDLE;
+  }
+
+  return requestedMode;
+}
+
+/*********************************************************************
+ * @fn      _F91Link_request
+ *
+ * @brief   Ask the central for the parameters of a mode and set the data
+ *          length to go with them. The link only counts as in the mode
+ *          once the central applied them, see F91Link_processParamUpdate.
+ *
+ * @param   mode - F91_LINK_MODE_IDLE or F91_LINK_MODE_BULK.
+ * @param   now - Clock ticks.
+ *
+ * @return  true if the request went out.
+ */
+static bool _F91Link_request(uint8_t mode, uint32_t now)
+{
+  const f91LinkProfile_t *pProfile = &linkProfiles[mode];
+  bStatus_t status;
+
+  // The central may turn it down, the next request is still a dwell away.
+  status = GAPRole_SendUpdateParam(pProfile->minInterval, pProfile->maxInterval,
+                                   pProfile->latency, pProfile->timeout,
+                                   GAPROLE_NO_ACTION);
+  if (status != SUCCESS) {
+    Display_print2(F91_LOGGER, F91_LINK_LOG_LINE + F91_LINK_MODES, 0,
+                   "Link %s: request failed %d", linkNames[mode], status);
+    return false;
+  }
+
+  requestedMode = mode;
+  lastRequestTicks = now;
+
+  HCI_LE_SetDataLenCmd(linkConnHandle, pProfile->txOctets, pProfile->txTime);
+
+  if ((mode == F91_LINK_MODE_BULK) && (mtuState == LINK_MTU_NONE)) {
+    attExchangeMTUReq_t req;
+
+    // Busy with another client procedure, tried again on the next burst.
+    req.clientRxMTU = F91_LINK_BULK_MTU;
+    if (GATT_ExchangeMTU(linkConnHandle, &req, linkTaskId) == SUCCESS) {
+      mtuState = LINK_MTU_SENT;
+      F91Link_holdLatency(F91_LINK_HOLD_MTU, true);
+    }
+  }
+
+  return true;
+}
+
+/*********************************************************************
+ * @fn      _F91Link_appliedMode
+ *
+ * @brief   Mode of the parameters in use, whatever was asked for. Bulk is
+ *          a short interval without latency to speak of, idle a radio that
+ *          wakes no more often than the idle interval.
+ *
+ * @return  F91_LINK_MODE_xxx.
+ */
+static uint8_t _F91Link_appliedMode(void)
+{
+  uint16_t interval;
+  uint16_t latency;
+
+  GAPRole_GetParameter(GAPROLE_CONN_INTERVAL, &interval);
+  GAPRole_GetParameter(GAPROLE_CONN_LATENCY, &latency);
+
+  if ((interval <= F91_LINK_BULK_MAX_INTERVAL) && (latency <= F91_LINK_BULK_LATENCY)) {
+    return F91_LINK_MODE_BULK;
+  }
+
+  if ((uint32_t)interval * (latency + 1) >= F91_LINK_IDLE_MIN_INTERVAL) {
+    return F91_LINK_MODE_IDLE;
+  }
+
+  return F91_LINK_MODE_DEFAULT;
+}
+
+/*********************************************************************
+ * @fn      _F91Link_startSegment
+ *
+ * @brief   Start counting against the current mode and parameters.
+ *
+ * @param   now - Clock ticks.
+ *
+ * @return  None.
+ */
+static void _F91Link_startSegment(uint32_t now)
+{
+  segmentTicks = now;
+  segmentBytes = rxBytes;
+  GAPRole_GetParameter(GAPROLE_CONN_INTERVAL, &segmentInterval);
+  GAPRole_GetParameter(GAPROLE_CONN_LATENCY, &segmentLatency);
+
+  // Held, the radio wakes on every event.
+  if (holdMask != 0) {
+    segmentLatency = 0;
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Link_closeSegment
+ *
+ * @brief   Add the segment to its mode's totals. Wakes are worked out from
+ *          the interval and latency, an estimate: the slave also wakes for
+ *          every event it has data for.
+ *
+ * @param   now - Clock ticks.
+ *
+ * @return  None.
+ */
+static void _F91Link_closeSegment(uint32_t now)
+{
+  uint32_t ms = LINK_TICKS_TO_MS(now - segmentTicks);
+  uint32_t events;
+
+  modeMs[linkMode] += ms;
+  modeBytes[linkMode] += rxBytes - segmentBytes;
+  if (segmentInterval > 0) {
+    // Interval in 1.25 ms units.
+    events = (ms * 4) / ((uint32_t)segmentInterval * 5);
+    modeEvents[linkMode] += events;
+    modeWakes[linkMode] += events / (segmentLatency + 1);
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Link_report
+ *
+ * @brief   Log a mode's throughput, and its radio wakes per hour against
+ *          the wakes without slave latency.
+ *
+ * @param   mode - F91_LINK_MODE_xxx.
+ *
+ * @return  None.
+ */
+static void _F91Link_report(uint8_t mode)
+{
+  uint32_t totalMs = modeMs[mode];
+
+  if (totalMs < 1000) {
+    return;
+  }
+
+  Display_print4(F91_LOGGER, F91_LINK_LOG_LINE + mode, 0,
+                 "Link %s: %d B/s, %d wakes/h of %d",
+                 linkNames[mode],
+                 modeBytes[mode] / (totalMs / 1000),
+                 (uint32_t)((uint64_t)modeWakes[mode] * 3600000 / totalMs),
+                 (uint32_t)((uint64_t)modeEvents[mode] * 3600000 / totalMs));
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Link_init
+ *
+ * @brief   Initialization function for the link manager.
+ *
+ * @param   taskId - ICall entity the MTU exchange answers to.
+ *
+ * @return  none
+ */
+void F91Link_init(uint8_t taskId)
+{
+  linkTaskId = taskId;
+  Util_constructClock(&linkClock, _F91Link_clockCallback,
+                      F91_LINK_QUIET_MS, 0, false, 0);
+  memset(modeMs, 0, sizeof(modeMs));
+  memset(modeBytes, 0, sizeof(modeBytes));
+  memset(modeWakes, 0, sizeof(modeWakes));
+  memset(modeEvents, 0, sizeof(modeEvents));
+}
+
+/*********************************************************************
+ * @fn      F91Link_connected
+ *
+ * @brief   Start on the central's parameters, the link goes to idle once
+ *          the phone has been quiet for F91_LINK_QUIET_MS.
+ *
+ * @param   connHandle - connection handle.
+ *
+ * @return  none
+ */
+void F91Link_connected(uint16_t connHandle)
+{
+  uint32_t now = Clock_getTicks();
+
+  connected = true;
+  linkConnHandle = connHandle;
+  linkMode = F91_LINK_MODE_DEFAULT;
+  requestedMode = F91_LINK_MODE_DEFAULT;
+  mtuState = LINK_MTU_NONE;
+  holdMask = 0;
+  lastRxTicks = now;
+  windowTicks = now;
+  windowBytes = 0;
+  // Discovery and encryption settle before the first request.
+  lastRequestTicks = now;
+  _F91Link_startSegment(now);
+
+  Util_restartClock(&linkClock, F91_LINK_QUIET_MS);
+}
+
+/*********************************************************************
+ * @fn      F91Link_reset
+ *
+ * @brief   The connection is gone, close its segment.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Link_reset(void)
+{
+  if (connected) {
+    _F91Link_closeSegment(Clock_getTicks());
+    _F91Link_report(linkMode);
+  }
+
+  // The override isn't tied to the connection, don't carry it to the next.
+  if (holdMask != 0) {
+    HCI_EXT_SetSlaveLatencyOverrideCmd(HCI_EXT_DISABLE_SL_OVERRIDE);
+  }
+
+  connected = false;
+  linkMode = F91_LINK_MODE_DEFAULT;
+  requestedMode = F91_LINK_MODE_DEFAULT;
+  mtuState = LINK_MTU_NONE;
+  holdMask = 0;
+  bulkHint = false;
+  Util_stopClock(&linkClock);
+}
+
+/*********************************************************************
+ * @fn      F91Link_countRx
+ *
+ * @brief   Count bytes written by the phone. Called from the stack's write
+ *          callbacks, the F91Kepler task is only woken when a burst crosses
+ *          the bulk threshold.
+ *
+ * @param   len - bytes written.
+ *
+ * @return  none
+ */
+void F91Link_countRx(uint16_t len)
+{
+  uint32_t now = Clock_getTicks();
+
+  rxBytes += len;
+  lastRxTicks = now;
+
+  if (now - windowTicks >= LINK_MS_TO_TICKS(F91_LINK_WINDOW_MS)) {
+    windowTicks = now;
+    windowBytes = 0;
+  }
+  windowBytes += len;
+
+  if ((requestedMode != F91_LINK_MODE_BULK) && (windowBytes >= F91_LINK_BULK_BYTES) &&
+      !evaluatePosted) {
+    evaluatePosted = true;
+    F91Kepler_linkCB();
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Link_setBulkHint
+ *
+ * @brief   Hold the link in bulk for a transfer known to be coming, or let
+ *          it go back to idle when the phone goes quiet.
+ *
+ * @param   bulk - true to hold the link in bulk.
+ *
+ * @return  none
+ */
+void F91Link_setBulkHint(bool bulk)
+{
+  bulkHint = bulk;
+  F91Kepler_linkCB();
+}
+
+/*********************************************************************
+ * @fn      F91Link_holdLatency
+ *
+ * @brief   Listen on every connection event while any reason holds, so an
+ *          answer from the central isn't left waiting up to latency + 1
+ *          intervals. Only the first hold and the last release go to the
+ *          controller.
+ *
+ * @param   reason - F91_LINK_HOLD_xxx.
+ * @param   hold - true to hold, false to release.
+ *
+ * @return  none
+ */
+void F91Link_holdLatency(uint8_t reason, bool hold)
+{
+  uint8_t mask = hold ? (holdMask | reason) : (holdMask & ~reason);
+  uint32_t now;
+
+  if (!connected) {
+    return;
+  }
+
+  if ((mask != 0) == (holdMask != 0)) {
+    holdMask = mask;
+    return;
+  }
+
+  now = Clock_getTicks();
+  _F91Link_closeSegment(now);
+  holdMask = mask;
+  HCI_EXT_SetSlaveLatencyOverrideCmd((holdMask != 0) ? HCI_EXT_ENABLE_SL_OVERRIDE :
+                                                       HCI_EXT_DISABLE_SL_OVERRIDE);
+  _F91Link_startSegment(now);
+}
+
+/*********************************************************************
+ * @fn      F91Link_processEvent
+ *
+ * @brief   Move the link to the mode the traffic calls for, and set the
+ *          clock for the next look.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Link_processEvent(void)
+{
+  uint32_t now = Clock_getTicks();
+  uint32_t dwellTicks = LINK_MS_TO_TICKS(F91_LINK_DWELL_MS);
+  uint32_t waitMs = 0;
+  uint8_t target;
+
+  evaluatePosted = false;
+
+  if (!connected) {
+    return;
+  }
+
+  target = _F91Link_target(now);
+
+  if (target != requestedMode) {
+    if (now - lastRequestTicks < dwellTicks) {
+      waitMs = LINK_TICKS_TO_MS(dwellTicks - (now - lastRequestTicks)) + 1;
+    } else if (!_F91Link_request(target, now)) {
+      waitMs = F91_LINK_DWELL_MS;
+    }
+  }
+
+  // Idle is left by a burst and a held bulk by the hint, anything else by
+  // the quiet running out.
+  if ((waitMs == 0) && (requestedMode != F91_LINK_MODE_IDLE) &&
+      !(bulkHint && (requestedMode == F91_LINK_MODE_BULK))) {
+    uint32_t quiet = now - lastRxTicks;
+    uint32_t quietTicks = LINK_MS_TO_TICKS(F91_LINK_QUIET_MS);
+
+    waitMs = (quiet < quietTicks) ? LINK_TICKS_TO_MS(quietTicks - quiet) + 1 : F91_LINK_DWELL_MS;
+  }
+
+  if (waitMs > 0) {
+    Util_restartClock(&linkClock, waitMs);
+  } else {
+    Util_stopClock(&linkClock);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Link_processParamUpdate
+ *
+ * @brief   The central applied new parameters, the events from here on are
+ *          counted at the new rate and against the mode they amount to.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Link_processParamUpdate(void)
+{
+  uint32_t now = Clock_getTicks();
+
+  if (!connected) {
+    return;
+  }
+
+  _F91Link_closeSegment(now);
+  _F91Link_report(linkMode);
+  linkMode = _F91Link_appliedMode();
+  _F91Link_startSegment(now);
+
+  Display_print4(F91_LOGGER, F91_LINK_LOG_LINE + F91_LINK_MODES, 0,
+                 "Link %s (asked %s): interval %d latency %d",
+                 linkNames[linkMode], linkNames[requestedMode], segmentInterval, segmentLatency);
+}
+
+/*********************************************************************
+ * @fn      F91Link_processGATTMsg
+ *
+ * @brief   Take the answer to the MTU exchange, so it isn't taken for an
+ *          answer to another client procedure.
+ *
+ * @param   pMsg - GATT message.
+ *
+ * @return  true if the message was the MTU exchange's.
+ */
+bool F91Link_processGATTMsg(gattMsgEvent_t *pMsg)
+{
+  if (mtuState != LINK_MTU_SENT) {
+    return false;
+  }
+
+  if ((pMsg->method == ATT_EXCHANGE_MTU_RSP) ||
+      ((pMsg->method == ATT_ERROR_RSP) &&
+       (pMsg->msg.errorRsp.reqOpcode == ATT_EXCHANGE_MTU_REQ))) {
+    // Not tried again on error, the central has said what it takes.
+    mtuState = LINK_MTU_DONE;
+    F91Link_holdLatency(F91_LINK_HOLD_MTU, false);
+    return true;
+  }
+
+  return false;
+}
+
+/*********************************************************************
+ * @fn      F91Link_getMode
+ *
+ * @brief   Current link mode.
+ *
+ * @param   none
+ *
+ * @return  F91_LINK_MODE_xxx.
+ */
+uint8_t F91Link_getMode(void)
+{
+  return linkMode;
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,174 @@
+/******************************************************************************
+
+ @file  f91_link.h
+
+ @brief This file contains the F91 Kepler Smart Watch link manager
+        definitions and prototypes. The connection runs on a long interval
+        with slave latency while idle and is moved to a short interval with
+        long data packets and a large MTU while the phone sends in bulk.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91LINK_H
+#define F91LINK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+
+#include "gatt.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Link modes. Default is whatever the central set up on connection.
+#define F91_LINK_MODE_DEFAULT           0
+#define F91_LINK_MODE_IDLE              1
+#define F91_LINK_MODE_BULK              2
+#define F91_LINK_MODES                  3
+
+// Idle: 100-120 ms interval (units of 1.25ms), 15 events may be skipped,
+// 6 s supervision timeout (units of 10ms). The phone still reaches the
+// watch within an interval, the watch listens every 1.9 s at most. Within
+// the iOS accessory limits: max interval x (latency + 1) under 2 s and
+// under a third of the timeout.
+#define F91_LINK_IDLE_MIN_INTERVAL      80
+#define F91_LINK_IDLE_MAX_INTERVAL      96
+#define F91_LINK_IDLE_LATENCY           15
+#define F91_LINK_IDLE_TIMEOUT           600
+
+// Bulk: 15-30 ms interval, no latency, 5 s supervision timeout.
+#define F91_LINK_BULK_MIN_INTERVAL      12
+#define F91_LINK_BULK_MAX_INTERVAL      24
+#define F91_LINK_BULK_LATENCY           0
+#define F91_LINK_BULK_TIMEOUT           500
+
+// Link layer payload (octets) and air time (usec) in each mode. Bulk is the
+// most the controller takes, idle the Bluetooth 4.0 packet.
+#define F91_LINK_BULK_TX_OCTETS         251
+#define F91_LINK_BULK_TX_TIME           2120
+#define F91_LINK_IDLE_TX_OCTETS         27
+#define F91_LINK_IDLE_TX_TIME           328
+
+// ATT MTU asked for on the first move to bulk, a full link layer payload
+// less the L2CAP header.
+#define F91_LINK_BULK_MTU               (F91_LINK_BULK_TX_OCTETS - 4)
+
+// Bytes received within F91_LINK_WINDOW_MS that move the link to bulk.
+#define F91_LINK_BULK_BYTES             160
+#define F91_LINK_WINDOW_MS              1000
+
+// Quiet time (in ms) before the link goes back to idle.
+#define F91_LINK_QUIET_MS               4000
+
+// Least time (in ms) between two parameter requests, so a link on the
+// threshold doesn't flap.
+#define F91_LINK_DWELL_MS               2000
+
+// Reasons to listen on every connection event whatever the slave latency,
+// while the watch waits on the central. Outgoing packets need no hold, the
+// controller wakes for an event when it has something queued.
+#define F91_LINK_HOLD_ATT_RSP           0x01  // ATT response waiting for a buffer
+#define F91_LINK_HOLD_CLIENT            0x02  // GATT client procedure outstanding
+#define F91_LINK_HOLD_MTU               0x04  // MTU exchange outstanding
+
+// First log line of the report, one line per mode and one for the requests.
+#define F91_LINK_LOG_LINE               24
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the link manager.
+ */
+extern void F91Link_init(uint8_t taskId);
+
+/*
+ * A connection is up.
+ */
+extern void F91Link_connected(uint16_t connHandle);
+
+/*
+ * The connection is gone.
+ */
+extern void F91Link_reset(void);
+
+/*
+ * Count bytes received from the phone, from the stack's write callbacks.
+ */
+extern void F91Link_countRx(uint16_t len);
+
+/*
+ * Hold the link in bulk mode for a transfer, or let it go back.
+ */
+extern void F91Link_setBulkHint(bool bulk);
+
+/*
+ * Listen on every connection event while a F91_LINK_HOLD_xxx reason holds.
+ */
+extern void F91Link_holdLatency(uint8_t reason, bool hold);
+
+/*
+ * Task Event Processor for the link manager.
+ */
+extern void F91Link_processEvent(void);
+
+/*
+ * The central applied new connection parameters.
+ */
+extern void F91Link_processParamUpdate(void);
+
+/*
+ * GATT messages for the MTU exchange, true if consumed.
+ */
+extern bool F91Link_processGATTMsg(gattMsgEvent_t *pMsg);
+
+/*
+ * Current link mode, F91_LINK_MODE_xxx.
+ */
+extern uint8_t F91Link_getMode(void);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91LINK_H */
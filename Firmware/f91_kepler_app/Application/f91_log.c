@@ -0,0 +1,464 @@
+/******************************************************************************
+
+ @file  f91_log.c
+
+ @brief This file contains the F91 Kepler Smart Watch persistent log.
+
+        Records are collected in a RAM segment and programmed as one SNV item
+        once F91_LOG_BATCH records are waiting, the segment is full or
+        F91_LOG_FLUSH_DELAY has passed. Each flush goes to the next of
+        F91_LOG_SEGMENT_COUNT items with the next sequence number, the oldest
+        segment being overwritten, so programming is spread over all of them
+        (SNV itself levels the page wear). A segment is only ever written
+        whole, with a CRC over its header and records, so a segment is either
+        there completely or ignored.
+
+        The checkpoint item holds the newest segment at the time it was written
+        and the settings block. At boot the log starts there and rolls forward
+        over segments carrying the following sequence numbers, at most
+        F91_LOG_CHECKPOINT_INTERVAL reads in normal operation. Without a
+        checkpoint every segment is read.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <stddef.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Seconds.h>
+#include <ti/display/Display.h>
+
+#include "bcomdef.h"
+#include "osal_snv.h"
+
+#include "f91_utils.h"
+#include "f91_log.h"
+#include "f91_timers.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define LOG_CHECKPOINT_MAGIC      0xF91C
+
+// Segment header: seq, crc, len, count.
+#define LOG_SEGMENT_HDR_LEN       8
+
+// Record header: type, len.
+#define LOG_RECORD_HDR_LEN        2
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint32_t seq;     // Sequence number, one more for every flush, 0 is never used
+  uint16_t crc;     // CRC-16 over seq, len, count and the records
+  uint8_t  len;     // Bytes of data in use
+  uint8_t  count;   // Number of records
+  uint8_t  data[F91_LOG_SEGMENT_LEN - LOG_SEGMENT_HDR_LEN];
+} f91LogSegment_t;
+
+typedef struct
+{
+  uint16_t magic;
+  uint8_t  headSlot;    // Segment last programmed
+  uint8_t  stateValid;
+  uint32_t headSeq;     // Its sequence number, 0 while the log is empty
+  uint8_t  state[F91_LOG_STATE_LEN];
+  uint16_t crc;         // CRC-16 over everything above
+  uint16_t reserved;
+} f91LogCheckpoint_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Segment being filled, also the read buffer for the boot scan and replay.
+static f91LogSegment_t segment;
+
+static f91LogCheckpoint_t checkpoint;
+
+// Newest segment in flash.
+static uint8_t  headSlot;
+static uint32_t headSeq;
+
+static uint8_t  flushesSinceCheckpoint;
+
+// Programs a partly filled segment after F91_LOG_FLUSH_DELAY.
+static f91Timer_t flushTimer;
+
+// Flash statistics since boot, flashBytes / recordBytes is the write amplification.
+static struct {
+  uint32_t writes;
+  uint32_t flashBytes;
+  uint32_t recordBytes;
+} stats;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint16_t _F91Log_crc16(uint16_t crc, const uint8_t *pData, uint16_t len);
+static uint16_t _F91Log_segmentCrc( void );
+static bool _F91Log_readSegment(uint8_t slot);
+static void _F91Log_writeCheckpoint( void );
+static void _F91Log_flushExpired(f91Timer_t *pTimer);
+
+/*********************************************************************
+ * @fn      _F91Log_crc16
+ *
+ * @brief   CRC-16/CCITT, bitwise to keep the flash footprint small.
+ *
+ * @param   crc - initial value, 0xFFFF for a new CRC.
+ * @param   pData - data.
+ * @param   len - length of data.
+ *
+ * @return  updated CRC.
+ */
+static uint16_t _F91Log_crc16(uint16_t crc, const uint8_t *pData, uint16_t len)
+{
+  uint8_t i;
+
+  while (len--) {
+    crc ^= (uint16_t)(*pData++) << 8;
+    for (i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+    }
+  }
+
+  return crc;
+}
+
+/*********************************************************************
+ * @fn      _F91Log_segmentCrc
+ *
+ * @brief   CRC of the segment buffer, len must have been checked.
+ *
+ * @param   none
+ *
+ * @return  CRC.
+ */
+static uint16_t _F91Log_segmentCrc( void )
+{
+  uint16_t crc;
+
+  crc = _F91Log_crc16(0xFFFF, (uint8_t *)&segment.seq, sizeof(segment.seq));
+  crc = _F91Log_crc16(crc, &segment.len, 2);
+  return _F91Log_crc16(crc, segment.data, segment.len);
+}
+
+/*********************************************************************
+ * @fn      _F91Log_readSegment
+ *
+ * @brief   Read a segment into the segment buffer and check it.
+ *
+ * @param   slot - segment to read.
+ *
+ * @return  true if the segment is valid.
+ */
+static bool _F91Log_readSegment(uint8_t slot)
+{
+  if (osal_snv_read(F91_LOG_NVID_SEGMENT + slot, sizeof(segment), &segment) != SUCCESS) {
+    return false;
+  }
+
+  return (segment.seq != 0) && (segment.len <= sizeof(segment.data)) &&
+         (segment.crc == _F91Log_segmentCrc());
+}
+
+/*********************************************************************
+ * @fn      _F91Log_writeCheckpoint
+ *
+ * @brief   Record the newest segment and the settings block.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void _F91Log_writeCheckpoint( void )
+{
+  checkpoint.magic    = LOG_CHECKPOINT_MAGIC;
+  checkpoint.headSlot = headSlot;
+  checkpoint.headSeq  = headSeq;
+  checkpoint.crc      = _F91Log_crc16(0xFFFF, (uint8_t *)&checkpoint,
+                                      offsetof(f91LogCheckpoint_t, crc));
+
+  if (osal_snv_write(F91_LOG_NVID_CHECKPOINT, sizeof(checkpoint), &checkpoint) != SUCCESS) {
+    Display_print0(F91_LOGGER, 15, 0, "Log: checkpoint write failed");
+    return;
+  }
+
+  flushesSinceCheckpoint = 0;
+  stats.writes++;
+  stats.flashBytes += sizeof(checkpoint);
+}
+
+/*********************************************************************
+ * @fn      _F91Log_flushExpired
+ *
+ * @brief   Records waited long enough, program them.
+ *
+ * @param   pTimer - flush timer.
+ *
+ * @return  None.
+ */
+static void _F91Log_flushExpired(f91Timer_t *pTimer)
+{
+  F91Log_flush();
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Log_init
+ *
+ * @brief   Initialization function for the log. Finds the newest segment,
+ *          appending continues after it. The timer wheel must be initialized.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Log_init( void )
+{
+  uint32_t start = Clock_getTicks();
+  uint8_t  reads = 0;
+  uint8_t  slot;
+  uint8_t  i;
+
+  F91Timers_construct(&flushTimer, _F91Log_flushExpired, 0);
+
+  headSlot = F91_LOG_SEGMENT_COUNT - 1;
+  headSeq  = 0;
+  flushesSinceCheckpoint = 0;
+
+  if ((osal_snv_read(F91_LOG_NVID_CHECKPOINT, sizeof(checkpoint), &checkpoint) == SUCCESS) &&
+      (checkpoint.magic == LOG_CHECKPOINT_MAGIC) &&
+      (checkpoint.headSlot < F91_LOG_SEGMENT_COUNT) &&
+      (checkpoint.crc == _F91Log_crc16(0xFFFF, (uint8_t *)&checkpoint,
+                                       offsetof(f91LogCheckpoint_t, crc)))) {
+    headSlot = checkpoint.headSlot;
+    headSeq  = checkpoint.headSeq;
+
+    // Roll forward over segments programmed after the checkpoint.
+    for (i = 0; i < F91_LOG_SEGMENT_COUNT - 1; i++) {
+      slot = (headSlot + 1) % F91_LOG_SEGMENT_COUNT;
+      reads++;
+      if (!_F91Log_readSegment(slot) || (segment.seq != headSeq + 1)) {
+        break;
+      }
+      headSlot = slot;
+      headSeq  = segment.seq;
+    }
+  } else {
+    memset(&checkpoint, 0, sizeof(checkpoint));
+
+    // No checkpoint, the newest valid segment is the head.
+    for (slot = 0; slot < F91_LOG_SEGMENT_COUNT; slot++) {
+      reads++;
+      if (_F91Log_readSegment(slot) && ((int32_t)(segment.seq - headSeq) > 0)) {
+        headSlot = slot;
+        headSeq  = segment.seq;
+      }
+    }
+  }
+
+  memset(&segment, 0, sizeof(segment));
+
+  Display_print3(F91_LOGGER, 14, 0, "Log: seq %d, %d reads, %d ticks",
+                 headSeq, reads, Clock_getTicks() - start);
+}
+
+/*********************************************************************
+ * @fn      F91Log_replay
+ *
+ * @brief   Hand every record still in flash to a callback, oldest first.
+ *          Uses the segment buffer, so only before anything is appended.
+ *
+ * @param   pfnRecord - called for each record.
+ *
+ * @return  none
+ */
+void F91Log_replay(f91LogReplayCB_t pfnRecord)
+{
+  uint16_t pos;
+  uint8_t  len;
+  uint8_t  slot;
+  uint8_t  i;
+
+  if ((segment.count != 0) || (headSeq == 0)) {
+    return;
+  }
+
+  for (i = 1; i <= F91_LOG_SEGMENT_COUNT; i++) {
+    slot = (headSlot + i) % F91_LOG_SEGMENT_COUNT;
+
+    // Skip segments newer than the head, left over from an older log.
+    if (!_F91Log_readSegment(slot) || ((headSeq - segment.seq) >= F91_LOG_SEGMENT_COUNT)) {
+      continue;
+    }
+
+    for (pos = 0; pos + LOG_RECORD_HDR_LEN <= segment.len; pos += LOG_RECORD_HDR_LEN + len) {
+      len = segment.data[pos + 1];
+      if (pos + LOG_RECORD_HDR_LEN + len > segment.len) {
+        break;
+      }
+      pfnRecord(segment.data[pos], &segment.data[pos + LOG_RECORD_HDR_LEN], len);
+    }
+  }
+
+  memset(&segment, 0, sizeof(segment));
+}
+
+/*********************************************************************
+ * @fn      F91Log_append
+ *
+ * @brief   Buffer a record. The segment is programmed once F91_LOG_BATCH
+ *          records are waiting, when the next record doesn't fit or after
+ *          F91_LOG_FLUSH_DELAY.
+ *
+ * @param   type - record type.
+ * @param   pData - payload.
+ * @param   len - payload length, up to F91_LOG_RECORD_MAX.
+ *
+ * @return  none
+ */
+void F91Log_append(uint8_t type, const void *pData, uint8_t len)
+{
+  if (len > F91_LOG_RECORD_MAX) {
+    return;
+  }
+
+  if (segment.len + LOG_RECORD_HDR_LEN + len > sizeof(segment.data)) {
+    F91Log_flush();
+  }
+
+  segment.data[segment.len]     = type;
+  segment.data[segment.len + 1] = len;
+  memcpy(&segment.data[segment.len + LOG_RECORD_HDR_LEN], pData, len);
+  segment.len += LOG_RECORD_HDR_LEN + len;
+  segment.count++;
+
+  stats.recordBytes += len;
+
+  if (segment.count >= F91_LOG_BATCH) {
+    F91Log_flush();
+  } else if (!F91Timers_isActive(&flushTimer)) {
+    F91Timers_start(&flushTimer, Seconds_get() + F91_LOG_FLUSH_DELAY);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Log_flush
+ *
+ * @brief   Program the buffered records into the next segment.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Log_flush( void )
+{
+  uint8_t slot = (headSlot + 1) % F91_LOG_SEGMENT_COUNT;
+
+  F91Timers_stop(&flushTimer);
+
+  if (segment.count == 0) {
+    return;
+  }
+
+  segment.seq = headSeq + 1;
+  segment.crc = _F91Log_segmentCrc();
+
+  if (osal_snv_write(F91_LOG_NVID_SEGMENT + slot, sizeof(segment), &segment) == SUCCESS) {
+    headSlot = slot;
+    headSeq  = segment.seq;
+    stats.writes++;
+    stats.flashBytes += sizeof(segment);
+
+    if (++flushesSinceCheckpoint >= F91_LOG_CHECKPOINT_INTERVAL) {
+      _F91Log_writeCheckpoint();
+    }
+  } else {
+    Display_print0(F91_LOGGER, 15, 0, "Log: segment write failed");
+  }
+
+  // A batch that couldn't be programmed is dropped, the log carries on.
+  memset(&segment, 0, sizeof(segment));
+
+  Display_print3(F91_LOGGER, 15, 0, "Log: %d writes, %d/%d bytes",
+                 stats.writes, stats.flashBytes, stats.recordBytes);
+}
+
+/*********************************************************************
+ * @fn      F91Log_saveState
+ *
+ * @brief   Store the settings block. Written with the checkpoint right
+ *          away, settings change rarely and shouldn't wait for a flush.
+ *
+ * @param   pState - settings.
+ * @param   len - length, up to F91_LOG_STATE_LEN.
+ *
+ * @return  none
+ */
+void F91Log_saveState(const void *pState, uint8_t len)
+{
+  if (len > F91_LOG_STATE_LEN) {
+    return;
+  }
+
+  memcpy(checkpoint.state, pState, len);
+  checkpoint.stateValid = 1;
+  _F91Log_writeCheckpoint();
+}
+
+/*********************************************************************
+ * @fn      F91Log_loadState
+ *
+ * @brief   Get the settings block stored with the checkpoint.
+ *
+ * @param   pState - filled with the settings.
+ * @param   len - length, up to F91_LOG_STATE_LEN.
+ *
+ * @return  true if settings were stored, false otherwise.
+ */
+bool F91Log_loadState(void *pState, uint8_t len)
+{
+  if (!checkpoint.stateValid || (len > F91_LOG_STATE_LEN)) {
+    return false;
+  }
+
+  memcpy(pState, checkpoint.state, len);
+  return true;
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,134 @@
+/******************************************************************************
+
+ @file  f91_log.h
+
+ @brief This file contains the F91 Kepler Smart Watch persistent log
+        definitions and prototypes. Records are appended in batches to a
+        rotating set of SNV items, a checkpoint item points at the newest
+        one and carries a small block of settings.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91LOG_H
+#define F91LOG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// SNV items used, taken from the customer range (BLE_NVID_CUST_START..END).
+#define F91_LOG_NVID_CHECKPOINT         BLE_NVID_CUST_START
+#define F91_LOG_NVID_SEGMENT            (BLE_NVID_CUST_START + 1)
+
+// Number of segments the log rotates through, and their size (in bytes,
+// header included). Every flush programs one whole segment.
+#define F91_LOG_SEGMENT_COUNT           6
+#define F91_LOG_SEGMENT_LEN             160
+
+// Largest record payload, must fit in a segment with its 2 byte header.
+#define F91_LOG_RECORD_MAX              (F91_LOG_SEGMENT_LEN - 8 - 2)
+
+// Records buffered before the segment is programmed.
+#define F91_LOG_BATCH                   4
+
+// Longest a record stays buffered in RAM (in sec).
+#define F91_LOG_FLUSH_DELAY             60
+
+// The checkpoint is rewritten every F91_LOG_CHECKPOINT_INTERVAL flushes,
+// which bounds how many segments the boot scan has to roll forward.
+#define F91_LOG_CHECKPOINT_INTERVAL     4
+
+// Size of the settings block kept in the checkpoint.
+#define F91_LOG_STATE_LEN               8
+
+// Record types
+#define F91_LOG_NOTIFICATION            0x01
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Called for every record found by F91Log_replay, oldest first.
+typedef void (*f91LogReplayCB_t)( uint8_t type, uint8_t *pData, uint8_t len );
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the log, finds the newest segment from the checkpoint.
+ */
+extern void F91Log_init( void );
+
+/*
+ * Hand every record still in flash to a callback, oldest first. Only
+ * before anything is appended.
+ */
+extern void F91Log_replay(f91LogReplayCB_t pfnRecord);
+
+/*
+ * Buffer a record, flushed after F91_LOG_BATCH records or F91_LOG_FLUSH_DELAY.
+ */
+extern void F91Log_append(uint8_t type, const void *pData, uint8_t len);
+
+/*
+ * Program the buffered records now.
+ */
+extern void F91Log_flush( void );
+
+/*
+ * Store the settings block, written straight away with the checkpoint.
+ */
+extern void F91Log_saveState(const void *pState, uint8_t len);
+
+/*
+ * Get the settings block, false if there is none.
+ */
+extern bool F91Log_loadState(void *pState, uint8_t len);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91LOG_H */
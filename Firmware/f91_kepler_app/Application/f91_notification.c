@@ -22,11 +22,20 @@
 
 #include "f91_notification.h"
 #include "f91_notification_service.h"
+#include "f91_alarm.h"
+#include "f91_bulk.h"
 #include "f91_buttons.h"
+#include "f91_clock.h"
+#include "f91_history.h"
+#include "f91_latency.h"
+#include "f91_log.h"
+#include "f91_outbound.h"
+#include "f91_stopwatch.h"
 #include "ssd1306.h"
 
 #include <ti/display/Display.h>
 #include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Seconds.h>
 
 /*********************************************************************
  * MACROS
@@ -36,11 +45,37 @@
  * CONSTANTS  
  */
 
-#define DISPLAY_TIMEOUT 5000 //5 seconds 
+// A body the characteristic takes is kept whole by the history.
+#if MESSAGE_STREAM_LEN != F91_HISTORY_BODY_LEN
+#error "MESSAGE_STREAM_LEN must match F91_HISTORY_BODY_LEN"
+#endif
+
+// Display wakes banked up to the per minute budget.
+#define WAKE_INTERVAL_MS          (60000 / F91_NOTIFICATION_WAKES_PER_MIN)
+
+// History view text lines, 16 characters of the 5x7 font fit across.
+#define HISTORY_LINE_CHARS        16
+#define HISTORY_HEADER_POS_Y      1
+#define HISTORY_SENDER_POS_Y      11
+#define HISTORY_BODY_POS_Y        21
+#define HISTORY_BODY_LINES        2
+#define HISTORY_LINE_HEIGHT       9
+
+// Full screen alerts waiting for the one shown to time out or be dismissed.
+#define ALERT_QUEUE_LEN           4
 
 /*********************************************************************
  * TYPEDEFS
  */
+
+// A full screen call or text alert.
+typedef struct
+{
+  uint8_t type;                                 // NOTIFICATION_CALL or NOTIFICATION_TEXT
+  uint8_t count;                                // alerts from the same sender folded into this one
+  char    sender[F91_HISTORY_SENDER_LEN + 1];
+} f91Alert_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -72,15 +107,40 @@ static struct {
   bool text;
   bool voicemail;
   bool missedcall;
-  char * incoming_call;
-  char * incoming_text;
 } current_notifications;
 
-// Clock object used to signal display timeout
-static Clock_Struct startDispClock;
-
 static bool displayingFullNotification = false;
 
+// Pending alerts, calls ahead of texts and in arrival order within each.
+static f91Alert_t alertQueue[ALERT_QUEUE_LEN];
+static uint8_t    alertCount = 0;
+
+// Alert on the display, valid while displayingFullNotification and not browsing.
+static f91Alert_t currentAlert;
+
+// Another alert was folded into the one on the display, it needs a redraw.
+static bool currentAlertChanged = false;
+
+// History browser, shown as a full screen notification.
+static bool    browsingHistory = false;
+static uint8_t historyIndex = 0;
+
+// Updates posted since the last flush, NOTIFICATION_xxx bits.
+static uint8_t pendingUpdates = 0;
+
+// Bar as of the last flush, identical bar updates are not drawn again.
+static uint8_t flushedBar = 0;
+
+// Ends the coalescing window, or the wait for a display wake.
+static Clock_Struct flushClock;
+
+// Waiting for the wake budget rather than the coalescing window.
+static bool wakeDeferred = false;
+
+// Display wake budget, refilled one every WAKE_INTERVAL_MS.
+static uint8_t  wakeTokens = F91_NOTIFICATION_WAKES_PER_MIN;
+static uint32_t wakeRefillTicks;
+
 /*********************************************************************
  * PROFILE CALLBACKS
  */
@@ -95,24 +155,70 @@ static bool displayingFullNotification = false;
 static void _F91Notification_reset(void);
 
 /*
- * Set specific notification
+ * Bar bits of the current notifications.
  */
-static void _F91Notification_setNotification(uint8_t type, uint8_t notification);
+static uint8_t _F91Notification_barBits(void);
+
+/*
+ * Coalescing window callback.
+ */
+static void _F91Notification_flushCallback(UArg arg);
+
+/*
+ * Whether the time face is on the display.
+ */
+static bool _F91Notification_faceShowing(void);
+
+/*
+ * Take a display wake from the budget.
+ */
+static bool _F91Notification_takeWake(bool call, uint32_t *pWaitMs);
 
 /*
  * Set specific notification
  */
-static void _F91Notification_setFullNotification(uint8_t type, char* notification);
+static void _F91Notification_setNotification(uint8_t type, uint8_t notification);
 
 /*
  * Display a full notifcation
  */
-static void _F91Notification_displayFullNotification(uint8_t type);
+static void _F91Notification_displayFullNotification(void);
 
 /*
- * Callback for one-shot clock used for full screen notifications.
+ * Queue a full screen alert
  */
-static void _F91Notification_oneShotCallback(UArg a1);
+static void _F91Notification_queueAlert(uint8_t type, const char *sender);
+
+/*
+ * Put an alert in the queue by priority
+ */
+static void _F91Notification_insertAlert(const f91Alert_t *pAlert, bool ahead);
+
+/*
+ * Take the next alert off the queue and display it
+ */
+static void _F91Notification_showNextAlert(void);
+
+/*
+ * Draw one clipped line of the history view
+ */
+static const char *_F91Notification_displayLine(const char *text, uint8_t y);
+
+/*
+ * Display a notification from the history
+ */
+static void _F91Notification_displayHistoryEntry(uint8_t index);
+
+/*
+ * Record a call or text in the history and the log
+ */
+static void _F91Notification_record(uint8_t type, const char *sender, const char *body);
+static void _F91Notification_receiveText(uint8_t *pData, uint16_t len);
+
+/*
+ * Restore the history from the log at boot
+ */
+static void _F91Notification_replayRecord(uint8_t type, uint8_t *pData, uint8_t len);
 
 /*********************************************************************
  * @fn      _F91Notification_reset
@@ -129,8 +235,6 @@ static void _F91Notification_reset(void)
   current_notifications.text          = false;
   current_notifications.voicemail     = false;
   current_notifications.missedcall    = false;
-  current_notifications.incoming_call = "";
-  current_notifications.incoming_text = "";
 }
 
 /*********************************************************************
@@ -167,59 +271,400 @@ static void _F91Notification_setNotification(uint8_t type, uint8_t notification)
 }
 
 /*********************************************************************
- * @fn      _F91Notification_setFullNotification
+ * @fn      _F91Notification_barBits
  *
- * @brief   Updates current notifcations for full screen notifications (call/text).
+ * @brief   Notification bar as the bits written by the phone.
+ *
+ * @return  (1<<EMAIL) | (1<<TEXT) | ... for the icons shown.
+ */
+static uint8_t _F91Notification_barBits(void)
+{
+  return (current_notifications.email      ? (1<<EMAIL)      : 0) |
+         (current_notifications.text       ? (1<<TEXT)       : 0) |
+         (current_notifications.voicemail  ? (1<<VOICEMAIL)  : 0) |
+         (current_notifications.missedcall ? (1<<MISSEDCALL) : 0);
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_flushCallback
+ *
+ * @brief   Coalescing window is over. Runs in Swi context, the drawing is
+ *          left to the F91_Kepler task.
+ *
+ * @param   arg - unused.
  *
  * @return  None.
  */
-static void _F91Notification_setFullNotification(uint8_t type, char* notification)
+static void _F91Notification_flushCallback(UArg arg)
 {
-  if ( type == NOTIFICATION_CALL ) {
-    current_notifications.incoming_call = notification;
-  } else if ( type == NOTIFICATION_TEXT ) {
-    current_notifications.incoming_text = notification;
+  F91Kepler_notificationFlushCB();
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_faceShowing
+ *
+ * @brief   The bar is part of the time face, it is only drawn when the
+ *          face is on the display.
+ *
+ * @return  true if the display is on and showing the time.
+ */
+static bool _F91Notification_faceShowing(void)
+{
+  return ssd1306_getState() && !displayingFullNotification &&
+         !F91Alarm_isAlerting() && !F91Stopwatch_isActive();
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_takeWake
+ *
+ * @brief   Takes a display wake from the per minute budget. A call gets
+ *          one even when the budget is spent.
+ *
+ * @param   call - the wake is for an incoming call.
+ * @param   pWaitMs - set to the time until the next wake when refused.
+ *
+ * @return  true if the display may be woken.
+ */
+static bool _F91Notification_takeWake(bool call, uint32_t *pWaitMs)
+{
+  uint32_t intervalTicks = WAKE_INTERVAL_MS * (1000 / Clock_tickPeriod);
+  uint32_t elapsed;
+
+  elapsed = Clock_getTicks() - wakeRefillTicks;
+  if (wakeTokens >= F91_NOTIFICATION_WAKES_PER_MIN) {
+    wakeRefillTicks += elapsed;
+  } else {
+    while ((elapsed >= intervalTicks) && (wakeTokens < F91_NOTIFICATION_WAKES_PER_MIN)) {
+      wakeTokens++;
+      wakeRefillTicks += intervalTicks;
+      elapsed -= intervalTicks;
+    }
   }
+
+  if (wakeTokens > 0) {
+    wakeTokens--;
+    return true;
+  }
+
+  *pWaitMs = (intervalTicks - elapsed) / (1000 / Clock_tickPeriod) + 1;
+  return call;
 }
 
 /*********************************************************************
  * @fn      _F91Notification_displayFullNotification
  *
- * @brief   Sets up a one-shot to display a full notification for 5 seconds.
+ * @brief   Draws the current alert and (re)starts the display timeout.
+ *          The display is only turned on if it was off, going from one
+ *          queued alert to the next keeps it on.
  *
  * @return  None.
  */
-static void _F91Notification_displayFullNotification(uint8_t type)
+static void _F91Notification_displayFullNotification(void)
 {    
-  if ( type == NOTIFICATION_CALL ) {
-    displayingFullNotification = true;
-    ssd1306_clear();
-    ssd1306_display_full_notification(INCOMING_CALL, current_notifications.incoming_call);
-  } else if ( type == NOTIFICATION_TEXT ) {
-    displayingFullNotification = true;
-    ssd1306_clear();
-    ssd1306_display_full_notification(INCOMING_TEXT, current_notifications.incoming_text);
+  char sender[F91_HISTORY_SENDER_LEN + 1];
+  char count[2];
+
+  // The display cuts long names in place, hand it a copy.
+  strcpy(sender, currentAlert.sender);
+  browsingHistory = false;
+  displayingFullNotification = true;
+  currentAlertChanged = false;
+
+  ssd1306_clear();
+  if ( currentAlert.type == NOTIFICATION_CALL ) {
+    ssd1306_display_full_notification(INCOMING_CALL, sender);
+  } else {
+    ssd1306_display_full_notification(INCOMING_TEXT, sender);
+  }
+
+  if ( currentAlert.count > 1 ) {
+    count[0] = (currentAlert.count > 9) ? '+' : ('0' + currentAlert.count);
+    count[1] = '\0';
+    ssd1306_display_text(count, ALERT_COUNT_POS_X, ALERT_COUNT_POS_Y, false);
   }
+  F91_LATENCY_MARK(F91_LATENCY_RENDERED);
   
-  // Cancel the one shot clock of the display if it's already going from a button press;
-  F91Buttons_resetOneShot();
+  ssd1306_update();
+  if ( !ssd1306_getState() ) {
+    ssd1306_toggle_display(true);
+  }
+  F91_LATENCY_MARK(F91_LATENCY_PANEL);
+
+  // Restarts the display one shot if it's already going from a button press.
+  F91Buttons_startDisplayTimeout();
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_queueAlert
+ *
+ * @brief   Adds a call or text to the full screen alerts. An alert from the
+ *          same sender as one shown or waiting is folded into it.
+ *
+ * @param   type - NOTIFICATION_CALL or NOTIFICATION_TEXT.
+ * @param   sender - contact name.
+ *
+ * @return  None.
+ */
+static void _F91Notification_queueAlert(uint8_t type, const char *sender)
+{
+  f91Alert_t alert;
+  uint8_t i;
+
+  if (displayingFullNotification && !browsingHistory &&
+      (currentAlert.type == type) && (strcmp(currentAlert.sender, sender) == 0)) {
+    if (currentAlert.count < 0xFF) {
+      currentAlert.count++;
+    }
+    currentAlertChanged = true;
+    return;
+  }
+
+  for (i = 0; i < alertCount; i++) {
+    if ((alertQueue[i].type == type) && (strcmp(alertQueue[i].sender, sender) == 0)) {
+      if (alertQueue[i].count < 0xFF) {
+        alertQueue[i].count++;
+      }
+      return;
+    }
+  }
+
+  alert.type = type;
+  alert.count = 1;
+  strncpy(alert.sender, sender, F91_HISTORY_SENDER_LEN);
+  alert.sender[F91_HISTORY_SENDER_LEN] = '\0';
+
+  _F91Notification_insertAlert(&alert, false);
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_insertAlert
+ *
+ * @brief   Puts an alert in the queue, calls ahead of texts. When the queue
+ *          is full the last alert is dropped, or the new one if it ranks
+ *          lower. Dropped alerts are still in the history.
+ *
+ * @param   pAlert - alert to add.
+ * @param   ahead - true to go ahead of alerts of the same type, for an alert
+ *          that was on the display and got preempted.
+ *
+ * @return  None.
+ */
+static void _F91Notification_insertAlert(const f91Alert_t *pAlert, bool ahead)
+{
+  bool isCall = (pAlert->type == NOTIFICATION_CALL);
+  uint8_t pos;
+
+  if (alertCount == ALERT_QUEUE_LEN) {
+    if (!isCall && (alertQueue[alertCount - 1].type == NOTIFICATION_CALL)) {
+      return;
+    }
+    alertCount--;
+  }
+
+  pos = alertCount;
+  while ((pos > 0) &&
+         ((isCall && (alertQueue[pos - 1].type != NOTIFICATION_CALL)) ||
+          (ahead && (alertQueue[pos - 1].type == pAlert->type)))) {
+    alertQueue[pos] = alertQueue[pos - 1];
+    pos--;
+  }
+
+  alertQueue[pos] = *pAlert;
+  alertCount++;
+  F91Outbound_statusChanged();
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_showNextAlert
+ *
+ * @brief   Takes the first alert off the queue and displays it.
+ *
+ * @return  None.
+ */
+static void _F91Notification_showNextAlert(void)
+{
+  currentAlert = alertQueue[0];
+  alertCount--;
+  memmove(&alertQueue[0], &alertQueue[1], alertCount * sizeof(f91Alert_t));
+
+  _F91Notification_displayFullNotification();
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_displayLine
+ *
+ * @brief   Adds a line of text to the buffer, cut to the display width.
+ *
+ * @param   text - UTF-8 string to display.
+ * @param   y - position in the y-plane.
+ *
+ * @return  the rest of the string that didn't fit.
+ */
+static const char *_F91Notification_displayLine(const char *text, uint8_t y)
+{
+  return ssd1306_display_text_clipped(text, HISTORY_LINE_CHARS, 0, y, false);
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_displayHistoryEntry
+ *
+ * @brief   Shows a notification from the history: type, local time of
+ *          arrival and position on the first line, then the sender and
+ *          the start of the body.
+ *
+ * @param   index - history entry, 0 being the most recent.
+ *
+ * @return  None.
+ */
+static void _F91Notification_displayHistoryEntry(uint8_t index)
+{
+  const f91HistoryEntry_t *pEntry = F91History_get(index);
+  char header[HISTORY_LINE_CHARS + 1];
+  uint32_t local;
+  uint8_t hour, minute, line;
+  const char *body;
+
+  ssd1306_clear();
+
+  if (pEntry == NULL) {
+    _F91Notification_displayLine("NO NOTIFICATIONS", HISTORY_SENDER_POS_Y);
+    ssd1306_update();
+    return;
+  }
+
+  local = pEntry->timestamp + F91Clock_getUtcOffset();
+  hour = (local / 3600) % 24;
+  minute = (local / 60) % 60;
+  if (!F91Clock_is24Hour()) {
+    hour = (hour % 12 == 0) ? 12 : (hour % 12);
+  }
+
+  // "CALL hh:mm i/n", history depth is single digit.
+  strcpy(header, (pEntry->type == NOTIFICATION_CALL) ? "CALL " : "TEXT ");
+  header[5]  = (hour < 10) ? ' ' : ('0' + hour / 10);
+  header[6]  = '0' + hour % 10;
+  header[7]  = ':';
+  header[8]  = '0' + minute / 10;
+  header[9]  = '0' + minute % 10;
+  header[10] = ' ';
+  header[11] = '1' + index;
+  header[12] = '/';
+  header[13] = '0' + F91History_count();
+  header[14] = '\0';
+  _F91Notification_displayLine(header, HISTORY_HEADER_POS_Y);
+  _F91Notification_displayLine(pEntry->sender, HISTORY_SENDER_POS_Y);
+
+  body = pEntry->body;
+  for (line = 0; (line < HISTORY_BODY_LINES) && (*body != '\0'); line++) {
+    body = _F91Notification_displayLine(body, HISTORY_BODY_POS_Y + line * HISTORY_LINE_HEIGHT);
+  }
 
   ssd1306_update();
-  ssd1306_toggle_display(true);
-  Util_restartClock(&startDispClock, DISPLAY_TIMEOUT);
 }
 
 /*********************************************************************
- * @fn      _F91Notification_oneShotCallback
+ * @fn      _F91Notification_record
  *
- * @brief   Sets up a one-shot to display a full notification for 5 seconds.
+ * @brief   Adds a call or text to the history and logs it so it survives a
+ *          reset, and queues its full screen alert. Log record: type, timestamp, sender and body, both NUL
+ *          terminated.
+ *
+ * @param   type - NOTIFICATION_CALL or NOTIFICATION_TEXT.
+ * @param   sender - contact name.
+ * @param   body - message text, may be NULL.
  *
  * @return  None.
  */
-static void _F91Notification_oneShotCallback(UArg a1)
-{  
-  displayingFullNotification = false;
-  F91Kepler_displayStateChangeCB();
+static void _F91Notification_record(uint8_t type, const char *sender, const char *body)
+{
+  static uint8_t record[1 + sizeof(uint32_t) + F91_HISTORY_SENDER_LEN + 1 + F91_HISTORY_BODY_LEN + 1];
+  const f91HistoryEntry_t *pEntry;
+  uint8_t senderLen, bodyLen;
+
+  pEntry = F91History_add(type, Seconds_get(), sender, body);
+  _F91Notification_queueAlert(type, pEntry->sender);
+
+  senderLen = strlen(pEntry->sender) + 1;
+  bodyLen = strlen(pEntry->body) + 1;
+
+  record[0] = pEntry->type;
+  memcpy(&record[1], &pEntry->timestamp, sizeof(uint32_t));
+  memcpy(&record[5], pEntry->sender, senderLen);
+  memcpy(&record[5 + senderLen], pEntry->body, bodyLen);
+
+  F91Log_append(F91_LOG_NOTIFICATION, record, 5 + senderLen + bodyLen);
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_replayRecord
+ *
+ * @brief   Puts a logged call or text back in the history.
+ *
+ * @param   type - log record type.
+ * @param   pData - record.
+ * @param   len - record length.
+ *
+ * @return  None.
+ */
+static void _F91Notification_replayRecord(uint8_t type, uint8_t *pData, uint8_t len)
+{
+  uint32_t timestamp;
+  uint8_t *pSender = &pData[5];
+  uint8_t *pBody;
+  uint8_t *pEnd = pData + len;
+
+  if ((type != F91_LOG_NOTIFICATION) || (len < 7)) {
+    return;
+  }
+
+  // Only what _F91Notification_record writes, anything else is not ours.
+  if ((pData[0] != NOTIFICATION_CALL) && (pData[0] != NOTIFICATION_TEXT)) {
+    return;
+  }
+
+  // Both strings have to be terminated inside the record.
+  pBody = memchr(pSender, 0, pEnd - pSender);
+  if (pBody == NULL) {
+    return;
+  }
+  pBody++;
+  if (memchr(pBody, 0, pEnd - pBody) == NULL) {
+    return;
+  }
+
+  memcpy(&timestamp, &pData[1], sizeof(uint32_t));
+  F91History_add(pData[0], timestamp, (char *)pSender, (char *)pBody);
+}
+
+/*********************************************************************
+ * @fn      _F91Notification_receiveText
+ *
+ * @brief   A text with its body from the bulk channel, in one object
+ *          instead of a write for each half. The strings are taken where
+ *          they are in the SDU, the history keeps its own copy.
+ *
+ * @param   pData - sender and body, both NUL terminated.
+ * @param   len - object length.
+ *
+ * @return  None.
+ */
+static void _F91Notification_receiveText(uint8_t *pData, uint16_t len)
+{
+  uint8_t *pBody;
+  uint8_t *pEnd = pData + len;
+
+  // Both strings have to be terminated inside the object.
+  pBody = memchr(pData, 0, len);
+  if (pBody == NULL) {
+    return;
+  }
+  pBody++;
+  if (memchr(pBody, 0, pEnd - pBody) == NULL) {
+    return;
+  }
+
+  _F91Notification_record(NOTIFICATION_TEXT, (char *)pData, (*pBody != 0) ? (char *)pBody : NULL);
+  F91Notification_post(NOTIFICATION_TEXT);
 }
 
 /*********************************************************************
@@ -240,10 +685,12 @@ void F91Notification_init(void)
   F91_notification_service_AddService();
   F91_notification_service_RegisterAppCBs(&F91Notification_StateChangeCB);
   _F91Notification_reset();
-
-  //Setup one-shot clock to turn off display after set time.
-  Util_constructClock(&startDispClock, _F91Notification_oneShotCallback,
-                  0, 0, false, NULL);
+  Util_constructClock(&flushClock, _F91Notification_flushCallback,
+                      F91_NOTIFICATION_COALESCE_MS, 0, false, 0);
+  wakeRefillTicks = Clock_getTicks();
+  F91History_init();
+  F91Log_replay(_F91Notification_replayRecord);
+  F91Bulk_register(F91_BULK_TYPE_TEXT, _F91Notification_receiveText);
 }
 
 /*********************************************************************
@@ -256,34 +703,89 @@ void F91Notification_init(void)
  */
 void F91Notification_processCharChangeEvt(uint8_t paramID)
 {
-  static uint8_t received_string[CONTACT_STREAM_LEN] = {0};
+  // One more byte so a full length name stays terminated.
+  static uint8_t received_string[CONTACT_STREAM_LEN + 1] = {0};
+  // Sender and body as paired by the service, too big for the task stack.
+  static f91_notification_serviceText_t text;
   uint8_t incoming_notifications;
   switch (paramID)
   {
     case F91_NOTIFICATION_SERVICE_CHAR1:
       F91_notification_service_GetParameter(F91_NOTIFICATION_SERVICE_CHAR1, &incoming_notifications);
       _F91Notification_setNotification(NOTIFICATION_BAR, incoming_notifications);
-      F91Notification_update(NOTIFICATION_BAR);
+      F91Notification_post(NOTIFICATION_BAR);
       break;
     case F91_NOTIFICATION_SERVICE_CHAR2:
       F91_notification_service_GetParameter(F91_NOTIFICATION_SERVICE_CHAR2, &received_string);
-      _F91Notification_setFullNotification(NOTIFICATION_CALL, (char*) received_string);
-      F91Notification_update(NOTIFICATION_CALL);
+      _F91Notification_record(NOTIFICATION_CALL, (char*) received_string, NULL);
+      F91Notification_post(NOTIFICATION_CALL);
+      F91_LATENCY_MARK(F91_LATENCY_HANDLED);
     
       memset(received_string, 0, CONTACT_STREAM_LEN); //reset the string array.
       break;
     case F91_NOTIFICATION_SERVICE_CHAR3:
-      F91_notification_service_GetParameter(F91_NOTIFICATION_SERVICE_CHAR3, &received_string);
-      _F91Notification_setFullNotification(NOTIFICATION_TEXT, (char*) received_string);
-      F91Notification_update(NOTIFICATION_TEXT);
-
-      memset(received_string, 0, CONTACT_STREAM_LEN); //reset the string array.
+      // Every text queued since the last event, each with its own body.
+      while (F91_notification_service_GetParameter(F91_NOTIFICATION_SERVICE_CHAR3, &text) == SUCCESS) {
+        _F91Notification_record(NOTIFICATION_TEXT, text.sender, (text.body[0] != '\0') ? text.body : NULL);
+        F91Notification_post(NOTIFICATION_TEXT);
+        F91_LATENCY_MARK(F91_LATENCY_HANDLED);
+      }
       break;
     default:
       break;
   }
 }
 
+/*********************************************************************
+ * @fn      F91Notification_applySync
+ *
+ * @brief   Takes the notification fields of a state sync. The display is
+ *          left to the caller.
+ *
+ * @param   pSync - decoded sync.
+ *
+ * @return  None.
+ */
+void F91Notification_applySync(const f91SyncState_t *pSync)
+{
+  if (pSync->present & F91_SYNC_FIELD(F91_SYNC_TAG_BAR)) {
+    _F91Notification_setNotification(NOTIFICATION_BAR, pSync->bar);
+  }
+
+  if (pSync->present & F91_SYNC_FIELD(F91_SYNC_TAG_TEXT)) {
+    _F91Notification_record(NOTIFICATION_TEXT, pSync->text,
+                            (pSync->present & F91_SYNC_FIELD(F91_SYNC_TAG_BODY)) ? pSync->body : NULL);
+  }
+
+  // Recorded last so the call is the newest history entry.
+  if (pSync->present & F91_SYNC_FIELD(F91_SYNC_TAG_CALL)) {
+    _F91Notification_record(NOTIFICATION_CALL, pSync->call, NULL);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Notification_post
+ *
+ * @brief   Coalescing stage in front of F91Notification_update for updates
+ *          from the phone. Everything posted within the window is drawn
+ *          once when it ends, by F91Notification_processEvent.
+ *
+ * @param   type - NOTIFICATION_BAR, NOTIFICATION_CALL, NOTIFICATION_TEXT
+ *                 or NOTIFICATION_FACE, or several of them.
+ *
+ * @return  None.
+ */
+void F91Notification_post(uint8_t type)
+{
+  pendingUpdates |= type;
+
+  // A new update cuts short a wait for the wake budget, it may be a call.
+  if (!Util_isActive(&flushClock) || wakeDeferred) {
+    wakeDeferred = false;
+    Util_restartClock(&flushClock, F91_NOTIFICATION_COALESCE_MS);
+  }
+}
+
 /*********************************************************************
  * @fn      F91Notification_update
  *
@@ -316,14 +818,31 @@ void F91Notification_update(uint8_t type)
     }
   } 
   else if ((type == NOTIFICATION_CALL) || (type == NOTIFICATION_TEXT)) {
-    _F91Notification_displayFullNotification(type);
+    if (!displayingFullNotification || browsingHistory) {
+      if (alertCount > 0) {
+        _F91Notification_showNextAlert();
+      }
+    } else if ((alertCount > 0) && (alertQueue[0].type == NOTIFICATION_CALL) &&
+               (currentAlert.type != NOTIFICATION_CALL)) {
+      // A call preempts the text on the display, the text is shown after it.
+      _F91Notification_insertAlert(&currentAlert, true);
+      _F91Notification_showNextAlert();
+    } else if (currentAlertChanged) {
+      _F91Notification_displayFullNotification();
+    }
+    // Otherwise it waits for the alert on the display to time out.
   }
 }
 
 /*********************************************************************
  * @fn      F91Notification_processEvent
  *
- * @brief   Notification event processor.
+ * @brief   Notification event processor, the end of the coalescing window.
+ *          The time face is redrawn once, if the bar changed or a time
+ *          setting did, and only if it is up and no alert is about to
+ *          cover it. With the display off it is drawn when the display
+ *          is woken.
+ *          Waking the display for an alert takes from the wake budget.
  *
  * @param   none
  *
@@ -331,7 +850,44 @@ void F91Notification_update(uint8_t type)
  */
 void F91Notification_processEvent(void)
 {
+  uint8_t updates = pendingUpdates;
+  uint8_t bar = _F91Notification_barBits();
+  uint32_t waitMs;
 
+  pendingUpdates = 0;
+  wakeDeferred = false;
+
+  if (updates & (NOTIFICATION_CALL | NOTIFICATION_TEXT)) {
+    F91_LATENCY_MARK(F91_LATENCY_FLUSHED);
+  }
+
+  if ((updates & NOTIFICATION_BAR) && (bar != flushedBar)) {
+    flushedBar = bar;
+    updates |= NOTIFICATION_FACE;
+  }
+
+  // An alert about to take the screen covers the face, which is drawn
+  // again when the display is next woken.
+  if ((updates & NOTIFICATION_FACE) && _F91Notification_faceShowing() &&
+      !((updates & (NOTIFICATION_CALL | NOTIFICATION_TEXT)) && (alertCount > 0))) {
+    F91Notification_update(NOTIFICATION_BAR);
+    F91Clock_refresh();
+  }
+
+  if (!(updates & (NOTIFICATION_CALL | NOTIFICATION_TEXT)) || (alertCount == 0)) {
+    return;
+  }
+
+  if (!ssd1306_getState() &&
+      !_F91Notification_takeWake(alertQueue[0].type == NOTIFICATION_CALL, &waitMs)) {
+    // Try again once the budget allows another wake.
+    pendingUpdates |= (updates & (NOTIFICATION_CALL | NOTIFICATION_TEXT));
+    wakeDeferred = true;
+    Util_restartClock(&flushClock, waitMs);
+    return;
+  }
+
+  F91Notification_update((updates & NOTIFICATION_CALL) ? NOTIFICATION_CALL : NOTIFICATION_TEXT);
 }
 
 /*********************************************************************
@@ -360,11 +916,128 @@ bool F91Notification_getNotificationState(void)
  */
 void F91Notification_resetNotificationState(void)
 {
-  Util_stopClock(&startDispClock);
+  F91Buttons_resetOneShot();
   ssd1306_toggle_display(false);
   ssd1306_clear();
   ssd1306_update();
   displayingFullNotification = false;
+  browsingHistory = false;
+  alertCount = 0;
+  F91Outbound_statusChanged();
+}
+
+/*********************************************************************
+ * @fn      F91Notification_nextNotification
+ *
+ * @brief   Done with the full screen notification: shows the next queued
+ *          alert, the display staying on, or turns the display off when
+ *          there are none left.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Notification_nextNotification(void)
+{
+  if (alertCount > 0) {
+    _F91Notification_showNextAlert();
+    F91Outbound_statusChanged();
+  } else {
+    F91Notification_resetNotificationState();
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Notification_getShownAlert
+ *
+ * @brief   Type of the alert on the display, the history doesn't count.
+ *
+ * @param   none
+ *
+ * @return  NOTIFICATION_CALL, NOTIFICATION_TEXT or 0 if none is shown.
+ */
+uint8_t F91Notification_getShownAlert(void)
+{
+  if (!displayingFullNotification || browsingHistory) {
+    return 0;
+  }
+
+  return currentAlert.type;
+}
+
+/*********************************************************************
+ * @fn      F91Notification_getUnreadCount
+ *
+ * @brief   Alerts not dismissed yet, the one on the display and the queued ones.
+ *
+ * @param   none
+ *
+ * @return  number of alerts.
+ */
+uint8_t F91Notification_getUnreadCount(void)
+{
+  return alertCount + ((F91Notification_getShownAlert() != 0) ? 1 : 0);
+}
+
+/*********************************************************************
+ * @fn      F91Notification_browseHistory
+ *
+ * @brief   Opens the history on the most recent notification, or steps
+ *          through it if already open. Wraps around at both ends.
+ *
+ * @param   older - true to go to the previous notification, false to the next one.
+ *
+ * @return  none
+ */
+void F91Notification_browseHistory(bool older)
+{
+  uint8_t count = F91History_count();
+
+  if (!browsingHistory) {
+    browsingHistory = true;
+    displayingFullNotification = true;
+    historyIndex = 0;
+  } else if (count > 0) {
+    if (older) {
+      historyIndex = (historyIndex + 1) % count;
+    } else {
+      historyIndex = (historyIndex + count - 1) % count;
+    }
+  }
+
+  _F91Notification_displayHistoryEntry(historyIndex);
+  ssd1306_toggle_display(true);
+  F91Buttons_startDisplayTimeout();
+}
+
+/*********************************************************************
+ * @fn      F91Notification_exitHistory
+ *
+ * @brief   Close the history browser, the caller brings back the time face.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Notification_exitHistory(void)
+{
+  browsingHistory = false;
+  displayingFullNotification = false;
+  ssd1306_clear();
+}
+
+/*********************************************************************
+ * @fn      F91Notification_isBrowsingHistory
+ *
+ * @brief   History browser state, it also counts as a full screen notification.
+ *
+ * @param   none
+ *
+ * @return  true if the history is being shown, false otherwise.
+ */
+bool F91Notification_isBrowsingHistory(void)
+{
+  return browsingHistory;
 }
 
 /*********************************************************************
@@ -24,6 +24,7 @@ extern "C"
  */
 #include "board.h"
 #include "f91_kepler.h"
+#include "f91_sync.h"
 #include <ti/display/Display.h>
 
 /*********************************************************************
@@ -33,7 +34,16 @@ extern "C"
 #define NOTIFICATION_BAR   0x01
 #define NOTIFICATION_CALL  0x02
 #define NOTIFICATION_TEXT  0x04
+#define NOTIFICATION_FACE  0x08   // only posted, the time face settings changed
 
+// Updates from the phone arriving within this window (in ms) are drawn
+// together, the window is not extended by later ones.
+#define F91_NOTIFICATION_COALESCE_MS      250
+
+// Display wakes allowed per minute for texts, at least 1. Texts over
+// the budget wait in the alert queue for the next wake. Incoming calls
+// always wake the display but count against the budget.
+#define F91_NOTIFICATION_WAKES_PER_MIN    4
 
 /*********************************************************************
  * MACROS
@@ -48,6 +58,11 @@ extern "C"
  */
 extern void F91Notification_init(void);
 
+/*
+ * Queue a display update from the phone, drawn once the coalescing window ends.
+ */
+extern void F91Notification_post(uint8_t type);
+
 /*
  * Task Event Processor for characteristic changes
  */
@@ -73,6 +88,41 @@ extern bool F91Notification_getNotificationState( void );
  */
 extern void F91Notification_resetNotificationState( void );
 
+/*
+ * Show the next queued full screen notification, or reset if there is none.
+ */
+extern void F91Notification_nextNotification( void );
+
+/*
+ * Returns the type of the full screen notification shown, 0 if none.
+ */
+extern uint8_t F91Notification_getShownAlert( void );
+
+/*
+ * Returns the number of alerts not dismissed yet.
+ */
+extern uint8_t F91Notification_getUnreadCount( void );
+
+/*
+ * Open the notification history, or step through it if open.
+ */
+extern void F91Notification_browseHistory( bool older );
+
+/*
+ * Close the notification history.
+ */
+extern void F91Notification_exitHistory( void );
+
+/*
+ * Returns wether the notification history is being shown.
+ */
+extern bool F91Notification_isBrowsingHistory( void );
+
+/*
+ * Take the bar, call and text fields of a state sync.
+ */
+extern void F91Notification_applySync(const f91SyncState_t *pSync);
+
 /*********************************************************************
 *********************************************************************/
 
@@ -0,0 +1,519 @@
+/******************************************************************************
+
+ @file  f91_oad.c
+
+ @brief This file contains the F91 Kepler Smart Watch over the air update.
+
+        Nothing of the image is held in RAM. Each block is programmed as
+        soon as the application task takes it off the service queue, the
+        page it starts is erased first, and the CRC-32 runs over the blocks
+        as they go in. The phone learns where to go on after every page and
+        whenever a block comes out of order, so a dropped block costs a
+        resend from that point. The transfer state stays across a
+        disconnect: a start for the same image picks up at the next block.
+        There is no boot image manager yet, so by default there is no
+        slot either and start is refused (see f91_oad.h). With a slot
+        configured, a received image stays there with its header until
+        something boots it.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <driverlib/flash.h>
+#include <driverlib/vims.h>
+
+#include "bcomdef.h"
+
+#include "f91_oad.h"
+#include "f91_oad_service.h"
+#include "f91_bulk.h"
+#include "f91_link.h"
+#include "f91_utils.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Transfer states
+#define F91_OAD_IDLE                    0
+#define F91_OAD_RECEIVING               1
+#define F91_OAD_RECEIVED                2
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8_t  oadState = F91_OAD_IDLE;
+
+// Image being received, as announced by the start command.
+static f91OadHeader_t image;
+
+// Next block wanted and the CRC of the blocks before it.
+static uint16_t nextBlock = 0;
+static uint32_t crc;
+
+// The phone was told where to pick up, blocks are ignored until it does.
+static bool     resync = false;
+
+// Transfer time, for the log.
+static uint32_t startTicks;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void _F91Oad_respond(uint8_t op, uint8_t status);
+static uint32_t _F91Oad_crc32(uint32_t crc, const uint8_t *pData, uint16_t len);
+static uint8_t _F91Oad_cacheOff(void);
+static void _F91Oad_cacheOn(uint8_t mode);
+static bool _F91Oad_erase(uint32_t addr);
+static bool _F91Oad_program(uint8_t *pData, uint32_t addr, uint32_t len);
+static void _F91Oad_start(uint8_t *pData, uint8_t len);
+static void _F91Oad_finish(void);
+static void _F91Oad_drop(void);
+static void _F91Oad_processControl(void);
+static void _F91Oad_processBlock(uint8_t *pBlock, uint16_t blockLen);
+
+/*********************************************************************
+ * @fn      _F91Oad_respond
+ *
+ * @brief   Notify [op][status][next block] on the control characteristic.
+ *
+ * @param   op - F91_OAD_CMD_xxx answered, or F91_OAD_RSP_xxx.
+ * @param   status - F91_OAD_SUCCESS or F91_OAD_ERR_xxx.
+ *
+ * @return  None.
+ */
+static void _F91Oad_respond(uint8_t op, uint8_t status)
+{
+  uint8_t rsp[OAD_RSP_LEN];
+
+  rsp[0] = op;
+  rsp[1] = status;
+  rsp[2] = LO_UINT16(nextBlock);
+  rsp[3] = HI_UINT16(nextBlock);
+
+  F91_oad_service_SetParameter(F91_OAD_SERVICE_CHAR1, OAD_RSP_LEN, rsp);
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_crc32
+ *
+ * @brief   CRC-32 (IEEE 802.3) without the final inversion, bitwise to keep
+ *          the flash footprint small. Start with 0xFFFFFFFF and invert the
+ *          result once the last block is in.
+ *
+ * @param   crc - CRC so far.
+ * @param   pData - bytes to add.
+ * @param   len - number of bytes.
+ *
+ * @return  The CRC with the bytes added.
+ */
+static uint32_t _F91Oad_crc32(uint32_t crc, const uint8_t *pData, uint16_t len)
+{
+  uint8_t bit;
+
+  while (len--) {
+    crc ^= *pData++;
+    for (bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+    }
+  }
+
+  return crc;
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_cacheOff
+ *
+ * @brief   The flash can't be programmed with the VIMS cache on.
+ *
+ * @return  Cache mode to go back to.
+ */
+static uint8_t _F91Oad_cacheOff(void)
+{
+  uint8_t mode = VIMSModeGet(VIMS_BASE);
+
+  VIMSLineBufDisable(VIMS_BASE);
+  if (mode != VIMS_MODE_DISABLED) {
+    VIMSModeSet(VIMS_BASE, VIMS_MODE_DISABLED);
+    while (VIMSModeGet(VIMS_BASE) != VIMS_MODE_DISABLED);
+  }
+
+  return mode;
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_cacheOn
+ *
+ * @brief   Back to the cache mode before programming.
+ *
+ * @param   mode - from _F91Oad_cacheOff.
+ *
+ * @return  None.
+ */
+static void _F91Oad_cacheOn(uint8_t mode)
+{
+  if (mode != VIMS_MODE_DISABLED) {
+    VIMSModeSet(VIMS_BASE, VIMS_MODE_ENABLED);
+  }
+  VIMSLineBufEnable(VIMS_BASE);
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_erase
+ *
+ * @brief   Erase a page of the image region.
+ *
+ * @param   addr - address in the page.
+ *
+ * @return  true on success.
+ */
+static bool _F91Oad_erase(uint32_t addr)
+{
+  uint8_t  mode = _F91Oad_cacheOff();
+  uint32_t status = FlashSectorErase(addr);
+
+  _F91Oad_cacheOn(mode);
+  return (status == FAPI_STATUS_SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_program
+ *
+ * @brief   Program bytes into an erased part of the image region.
+ *
+ * @param   pData - bytes to program.
+ * @param   addr - flash address.
+ * @param   len - number of bytes.
+ *
+ * @return  true on success.
+ */
+static bool _F91Oad_program(uint8_t *pData, uint32_t addr, uint32_t len)
+{
+  uint8_t  mode = _F91Oad_cacheOff();
+  uint32_t status = FlashProgram(pData, addr, len);
+
+  _F91Oad_cacheOn(mode);
+  return (status == FAPI_STATUS_SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_start
+ *
+ * @brief   Start command. The image being received, or already received,
+ *          carries on where it got to. Anything else starts over: the
+ *          header page is erased so no half written image can boot.
+ *          Without an image slot nothing is touched.
+ *
+ * @param   pData - command, [op][version 2][length 4][crc 4].
+ * @param   len - command length.
+ *
+ * @return  None.
+ */
+static void _F91Oad_start(uint8_t *pData, uint8_t len)
+{
+  uint16_t version;
+  uint32_t imageLen;
+  uint32_t imageCrc;
+
+  if (F91_OAD_IMAGE_MAX == 0) {
+    _F91Oad_respond(F91_OAD_CMD_START, F91_OAD_ERR_NO_SLOT);
+    return;
+  }
+
+  if (len != OAD_CONTROL_LEN) {
+    _F91Oad_respond(F91_OAD_CMD_START, F91_OAD_ERR_LENGTH);
+    return;
+  }
+
+  version = BUILD_UINT16(pData[1], pData[2]);
+  imageLen = BUILD_UINT32(pData[3], pData[4], pData[5], pData[6]);
+  imageCrc = BUILD_UINT32(pData[7], pData[8], pData[9], pData[10]);
+
+  if ((imageLen == 0) || (imageLen > F91_OAD_IMAGE_MAX)) {
+    _F91Oad_respond(F91_OAD_CMD_START, F91_OAD_ERR_LENGTH);
+    return;
+  }
+
+  if ((oadState == F91_OAD_IDLE) || (version != image.version) ||
+      (imageLen != image.len) || (imageCrc != image.crc)) {
+    if (!_F91Oad_erase(F91_OAD_HDR_ADDR)) {
+      _F91Oad_drop();
+      _F91Oad_respond(F91_OAD_CMD_START, F91_OAD_ERR_FLASH);
+      return;
+    }
+
+    image.magic = F91_OAD_MAGIC;
+    image.version = version;
+    image.state = F91_OAD_STATE_RECEIVED;
+    image.len = imageLen;
+    image.crc = imageCrc;
+    nextBlock = 0;
+    crc = 0xFFFFFFFF;
+    oadState = F91_OAD_RECEIVING;
+    startTicks = Clock_getTicks();
+  }
+
+  resync = false;
+  F91Link_setBulkHint(oadState == F91_OAD_RECEIVING);
+  _F91Oad_respond(F91_OAD_CMD_START, F91_OAD_SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_finish
+ *
+ * @brief   Every block is in. Check the CRC and program the boot header.
+ *
+ * @return  None.
+ */
+static void _F91Oad_finish(void)
+{
+  uint32_t ms = (Clock_getTicks() - startTicks) / (1000 / Clock_tickPeriod);
+
+  F91Link_setBulkHint(false);
+
+  if (~crc != image.crc) {
+    _F91Oad_drop();
+    _F91Oad_respond(F91_OAD_RSP_COMPLETE, F91_OAD_ERR_CRC);
+    return;
+  }
+
+  if (!_F91Oad_program((uint8_t *)&image, F91_OAD_HDR_ADDR, sizeof(image))) {
+    _F91Oad_drop();
+    _F91Oad_respond(F91_OAD_RSP_COMPLETE, F91_OAD_ERR_FLASH);
+    return;
+  }
+
+  oadState = F91_OAD_RECEIVED;
+  Display_print3(F91_LOGGER, F91_OAD_LOG_LINE, 0, "OAD: v%d, %d bytes in %d ms",
+                 image.version, image.len, ms);
+  _F91Oad_respond(F91_OAD_RSP_COMPLETE, F91_OAD_SUCCESS);
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_drop
+ *
+ * @brief   Forget the image, the next start begins from block 0.
+ *
+ * @return  None.
+ */
+static void _F91Oad_drop(void)
+{
+  oadState = F91_OAD_IDLE;
+  nextBlock = 0;
+  resync = false;
+  F91Link_setBulkHint(false);
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_processControl
+ *
+ * @brief   Run a command from the control characteristic.
+ *
+ * @return  None.
+ */
+static void _F91Oad_processControl(void)
+{
+  f91_oad_serviceControl_t control;
+
+  F91_oad_service_GetParameter(F91_OAD_SERVICE_CHAR1, &control);
+
+  switch (control.data[0]) {
+    case F91_OAD_CMD_START:
+      _F91Oad_start(control.data, control.len);
+      break;
+
+    case F91_OAD_CMD_STATUS:
+      _F91Oad_respond(F91_OAD_CMD_STATUS,
+                      (oadState == F91_OAD_IDLE) ? F91_OAD_ERR_STATE : F91_OAD_SUCCESS);
+      break;
+
+    case F91_OAD_CMD_ABORT:
+      // A received image must not be taken by a boot image manager later.
+      if (oadState == F91_OAD_RECEIVED) {
+        _F91Oad_erase(F91_OAD_HDR_ADDR);
+      }
+      _F91Oad_drop();
+      _F91Oad_respond(F91_OAD_CMD_ABORT, F91_OAD_SUCCESS);
+      break;
+
+    default:
+      _F91Oad_respond(control.data[0], F91_OAD_ERR_STATE);
+      break;
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Oad_processBlock
+ *
+ * @brief   Program the next block. A page is erased when its first block
+ *          comes in. Blocks out of order are dropped and the phone is told
+ *          once where to pick up. Blocks come from the service queue or
+ *          straight from an SDU of the bulk channel, same layout.
+ *
+ * @param   pBlock - block number and data.
+ * @param   blockLen - block length, with the block number.
+ *
+ * @return  None.
+ */
+static void _F91Oad_processBlock(uint8_t *pBlock, uint16_t blockLen)
+{
+  uint16_t block;
+  uint8_t  *pData = &pBlock[OAD_BLOCK_HDR_LEN];
+  uint16_t len = blockLen - OAD_BLOCK_HDR_LEN;
+  uint32_t offset = (uint32_t)nextBlock * OAD_BLOCK_LEN;
+
+  if ((oadState != F91_OAD_RECEIVING) ||
+      (blockLen <= OAD_BLOCK_HDR_LEN) || (blockLen > OAD_BLOCK_HDR_LEN + OAD_BLOCK_LEN)) {
+    return;
+  }
+
+  block = BUILD_UINT16(pBlock[0], pBlock[1]);
+
+  if (block != nextBlock) {
+    if (!resync) {
+      resync = true;
+      _F91Oad_respond(F91_OAD_RSP_BLOCK, F91_OAD_ERR_SEQUENCE);
+    }
+    return;
+  }
+  resync = false;
+
+  // Every block is full but the last.
+  if (len != MIN(OAD_BLOCK_LEN, image.len - offset)) {
+    _F91Oad_respond(F91_OAD_RSP_BLOCK, F91_OAD_ERR_LENGTH);
+    return;
+  }
+
+  if ((((offset % F91_OAD_PAGE_SIZE) == 0) && !_F91Oad_erase(F91_OAD_IMAGE_ADDR + offset)) ||
+      !_F91Oad_program(pData, F91_OAD_IMAGE_ADDR + offset, len)) {
+    _F91Oad_drop();
+    _F91Oad_respond(F91_OAD_RSP_BLOCK, F91_OAD_ERR_FLASH);
+    return;
+  }
+
+  crc = _F91Oad_crc32(crc, pData, len);
+  nextBlock++;
+  offset += len;
+
+  if (offset == image.len) {
+    _F91Oad_finish();
+  } else if ((offset % F91_OAD_PAGE_SIZE) == 0) {
+    _F91Oad_respond(F91_OAD_RSP_BLOCK, F91_OAD_SUCCESS);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Oad_StateChangeCB
+ *
+ * @brief   Callback function to be called when an update characteristic
+ *          is written.
+ *
+ * @return  None.
+ */
+static f91_oad_serviceCBs_t F91Oad_StateChangeCB =
+{
+  F91Kepler_oadCharValueChangeCB
+};
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Oad_init
+ *
+ * @brief   Initialization function for the update service.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Oad_init(void)
+{
+  F91_oad_service_AddService();
+  F91_oad_service_RegisterAppCBs(&F91Oad_StateChangeCB);
+  F91Bulk_register(F91_BULK_TYPE_OAD_BLOCK, _F91Oad_processBlock);
+}
+
+/*********************************************************************
+ * @fn      F91Oad_reset
+ *
+ * @brief   The connection is gone. The image is kept so far, the phone
+ *          starts it again on the next connection and goes on from the
+ *          next block.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Oad_reset(void)
+{
+  f91_oad_serviceBlock_t *pBlock;
+
+  // Blocks still queued belong to the connection that's gone.
+  while (F91_oad_service_GetParameter(F91_OAD_SERVICE_CHAR2, &pBlock) == SUCCESS) {
+    F91_oad_service_ReleaseBlock();
+  }
+
+  resync = false;
+}
+
+/*********************************************************************
+ * @fn      F91Oad_processCharChangeEvt
+ *
+ * @brief   An update characteristic was written.
+ *
+ * @param   paramID - F91_OAD_SERVICE_CHARx.
+ *
+ * @return  none
+ */
+void F91Oad_processCharChangeEvt(uint8_t paramID)
+{
+  f91_oad_serviceBlock_t *pBlock;
+
+  if (paramID == F91_OAD_SERVICE_CHAR1) {
+    _F91Oad_processControl();
+  } else if (paramID == F91_OAD_SERVICE_CHAR2) {
+    // Programmed from the queue slot, released once done.
+    while (F91_oad_service_GetParameter(F91_OAD_SERVICE_CHAR2, &pBlock) == SUCCESS) {
+      _F91Oad_processBlock(pBlock->data, pBlock->len);
+      F91_oad_service_ReleaseBlock();
+    }
+  }
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,148 @@
+/******************************************************************************
+
+ @file  f91_oad.h
+
+ @brief This file contains the F91 Kepler Smart Watch over the air update
+        definitions and prototypes. The phone streams a new image in
+        blocks, each block is programmed into the image region as it
+        arrives and a boot header marks the image once it checked out.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91OAD_H
+#define F91OAD_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+#include "f91_oad_service.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Control operations, written as [op] followed by the arguments, answered
+// with a notification [op][status][next block lo][next block hi]. 0x03 is
+// kept for an enable command, once there is a boot image manager to run it.
+#define F91_OAD_CMD_START               0x01  // [version 2][length 4][crc 4], the same image resumes
+#define F91_OAD_CMD_STATUS              0x02  // where to pick up
+#define F91_OAD_CMD_ABORT               0x04  // drop the image
+
+// Notified without a command.
+#define F91_OAD_RSP_BLOCK               0x10  // a page is programmed, or a block was out of order
+#define F91_OAD_RSP_COMPLETE            0x11  // every block is in, status is the image check
+
+// Status
+#define F91_OAD_SUCCESS                 0x00
+#define F91_OAD_ERR_STATE               0x01  // nothing to do that with
+#define F91_OAD_ERR_LENGTH              0x02  // bad command, or the image doesn't fit
+#define F91_OAD_ERR_SEQUENCE            0x03  // block out of order, pick up at next block
+#define F91_OAD_ERR_FLASH               0x04  // erase or program failed, the image is dropped
+#define F91_OAD_ERR_CRC                 0x05  // CRC-32 of the image doesn't match
+#define F91_OAD_ERR_NO_SLOT             0x06  // this build has no image slot
+
+// Image slot. The application and stack link from 0 up to the SNV page
+// (cc26xx_app.cmd) and there is no boot image manager to copy an image
+// down, so by default there is no slot: start is refused with
+// F91_OAD_ERR_NO_SLOT and nothing is erased. A build that keeps pages free
+// for an image, and has something to boot it, defines both for the
+// project. The boot header takes the last bytes of the last page.
+#ifndef F91_OAD_IMAGE_ADDR
+#define F91_OAD_IMAGE_ADDR              0
+#endif
+#ifndef F91_OAD_IMAGE_PAGES
+#define F91_OAD_IMAGE_PAGES             0
+#endif
+#define F91_OAD_PAGE_SIZE               4096
+#if F91_OAD_IMAGE_PAGES > 0
+#define F91_OAD_HDR_ADDR                (F91_OAD_IMAGE_ADDR + F91_OAD_IMAGE_PAGES * F91_OAD_PAGE_SIZE - \
+                                         sizeof(f91OadHeader_t))
+#define F91_OAD_IMAGE_MAX               (F91_OAD_IMAGE_PAGES * F91_OAD_PAGE_SIZE - sizeof(f91OadHeader_t))
+#else
+#define F91_OAD_HDR_ADDR                F91_OAD_IMAGE_ADDR
+#define F91_OAD_IMAGE_MAX               0
+#endif
+
+// Boot header, programmed once every block is in and the CRC matches. The
+// state is left erased so the boot image manager of such a build can mark
+// the image to boot by only clearing bits, without a page erase.
+#define F91_OAD_MAGIC                   0x4B313946  // "F91K"
+#define F91_OAD_STATE_RECEIVED          0xFFFF
+
+// Log line of the transfer.
+#define F91_OAD_LOG_LINE                31
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t state;                       // F91_OAD_STATE_xxx
+  uint32_t len;                         // image bytes
+  uint32_t crc;                         // CRC-32 of the image
+} f91OadHeader_t;
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the update service.
+ */
+extern void F91Oad_init(void);
+
+/*
+ * The connection is gone, the transfer resumes on the next one.
+ */
+extern void F91Oad_reset(void);
+
+/*
+ * Task Event Processor for the update characteristics.
+ */
+extern void F91Oad_processCharChangeEvt(uint8_t paramID);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91OAD_H */
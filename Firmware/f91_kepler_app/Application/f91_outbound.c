@@ -0,0 +1,393 @@
+/******************************************************************************
+
+ @file  f91_outbound.c
+
+ @brief This file contains the F91 Kepler Smart Watch outbound queue.
+
+        Events are queued as they happen and the status is only marked
+        dirty. Both are held for F91_OUTBOUND_COALESCE_MS, then the events
+        are packed into as few notifications as the MTU allows and queued
+        to the stack back to back, followed by the status if it changed.
+        When the stack is out of buffers what is left goes out on a retry.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <driverlib/aon_batmon.h>
+
+#include <icall.h>
+#include "icall_ble_api.h"
+
+#include "bcomdef.h"
+#include "att.h"
+#include "util.h"
+
+#include "f91_outbound.h"
+#include "f91_notification.h"
+#include "f91_notification_service.h"
+#include "f91_utils.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static Clock_Struct outboundClock;
+
+static bool     connected = false;
+static uint16_t outboundConnHandle;
+
+// Events waiting to be notified, [seq][event] each.
+static uint8_t  eventQueue[F91_OUTBOUND_QUEUE_LEN][EVENT_RECORD_LEN];
+static uint8_t  eventHead = 0;
+static uint8_t  eventTail = 0;
+static uint8_t  eventSeq = 0;
+
+// Status to look at on the next flush, and the last one notified.
+static bool     statusDirty = false;
+static bool     statusSent = false;
+static uint16_t sentBatteryMv;
+static uint8_t  sentUnread;
+static int16_t  sentDrift;
+
+// Drift measured when the phone last set the clock.
+static int16_t  drift = 0;
+
+// Counters for the log, over all connections.
+static uint32_t eventsSent = 0;
+static uint32_t eventsDropped = 0;
+static uint32_t notificationsSent = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void _F91Outbound_clockCallback(UArg arg);
+static void _F91Outbound_schedule(uint32_t waitMs);
+static uint8_t _F91Outbound_sendEvents(void);
+static bool _F91Outbound_sendStatus(void);
+static uint16_t _F91Outbound_batteryMv(void);
+
+/*********************************************************************
+ * @fn      _F91Outbound_clockCallback
+ *
+ * @brief   Time to flush. Runs in Swi context, the rest is left to the
+ *          F91_Kepler task.
+ *
+ * @param   arg - unused.
+ *
+ * @return  None.
+ */
+static void _F91Outbound_clockCallback(UArg arg)
+{
+  F91Kepler_outboundCB();
+}
+
+/*********************************************************************
+ * @fn      _F91Outbound_schedule
+ *
+ * @brief   Flush in waitMs unless a flush is already on its way, so the
+ *          first event of a batch sets the window.
+ *
+ * @param   waitMs - time to wait in ms.
+ *
+ * @return  None.
+ */
+static void _F91Outbound_schedule(uint32_t waitMs)
+{
+  if (!Util_isActive(&outboundClock)) {
+    Util_restartClock(&outboundClock, waitMs);
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Outbound_sendEvents
+ *
+ * @brief   Notify the queued events, as many records per notification as
+ *          fit in ATT_MTU - 3, up to F91_OUTBOUND_BURST notifications.
+ *
+ * @return  Number of notifications queued to the stack.
+ */
+static uint8_t _F91Outbound_sendEvents(void)
+{
+  uint8_t  batch[EVENT_BATCH_LEN];
+  uint16_t batchMax;
+  uint8_t  len;
+  uint8_t  next;
+  uint8_t  sent = 0;
+
+  batchMax = MIN(EVENT_BATCH_LEN, ATT_GetMTU(outboundConnHandle) - 3);
+  batchMax -= batchMax % EVENT_RECORD_LEN;
+
+  while ((eventHead != eventTail) && (sent < F91_OUTBOUND_BURST)) {
+    len = 0;
+    for (next = eventHead; (next != eventTail) && (len + EVENT_RECORD_LEN <= batchMax); next++) {
+      memcpy(&batch[len], eventQueue[next & (F91_OUTBOUND_QUEUE_LEN - 1)], EVENT_RECORD_LEN);
+      len += EVENT_RECORD_LEN;
+    }
+
+    // Out of buffers, the records stay queued for the retry.
+    if (F91_notification_service_SetParameter(F91_NOTIFICATION_SERVICE_CHAR7, len, batch) != SUCCESS) {
+      break;
+    }
+
+    eventsSent += (uint8_t)(next - eventHead);
+    eventHead = next;
+    sent++;
+  }
+
+  return sent;
+}
+
+/*********************************************************************
+ * @fn      _F91Outbound_sendStatus
+ *
+ * @brief   Notify the status if it moved since the last one, the battery
+ *          only once it moved by F91_OUTBOUND_BATTERY_STEP_MV.
+ *
+ * @return  false if the stack was out of buffers.
+ */
+static bool _F91Outbound_sendStatus(void)
+{
+  uint16_t batteryMv = _F91Outbound_batteryMv();
+  uint8_t  unread = F91Notification_getUnreadCount();
+  uint16_t batteryStep = (batteryMv > sentBatteryMv) ? (batteryMv - sentBatteryMv) : (sentBatteryMv - batteryMv);
+  uint8_t  status[STATUS_LEN];
+
+  if (statusSent && (unread == sentUnread) && (drift == sentDrift) &&
+      (batteryStep < F91_OUTBOUND_BATTERY_STEP_MV)) {
+    return true;
+  }
+
+  status[0] = LO_UINT16(batteryMv);
+  status[1] = HI_UINT16(batteryMv);
+  status[2] = unread;
+  status[3] = LO_UINT16(drift);
+  status[4] = HI_UINT16(drift);
+
+  if (F91_notification_service_SetParameter(F91_NOTIFICATION_SERVICE_CHAR8, STATUS_LEN, status) != SUCCESS) {
+    return false;
+  }
+
+  statusSent = true;
+  sentBatteryMv = batteryMv;
+  sentUnread = unread;
+  sentDrift = drift;
+  notificationsSent++;
+  return true;
+}
+
+/*********************************************************************
+ * @fn      _F91Outbound_batteryMv
+ *
+ * @brief   Supply voltage from the battery monitor.
+ *
+ * @return  Battery voltage in mV.
+ */
+static uint16_t _F91Outbound_batteryMv(void)
+{
+  // 3.8 fixed point volts.
+  return (uint16_t)((AONBatMonBatteryVoltageGet() * 1000) >> 8);
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Outbound_init
+ *
+ * @brief   Initialization function for the outbound queue.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Outbound_init(void)
+{
+  Util_constructClock(&outboundClock, _F91Outbound_clockCallback,
+                      F91_OUTBOUND_COALESCE_MS, 0, false, 0);
+  AONBatMonEnable();
+}
+
+/*********************************************************************
+ * @fn      F91Outbound_connected
+ *
+ * @brief   Start a connection with an empty queue, the status goes out on
+ *          the first flush.
+ *
+ * @param   connHandle - connection handle.
+ *
+ * @return  none
+ */
+void F91Outbound_connected(uint16_t connHandle)
+{
+  connected = true;
+  outboundConnHandle = connHandle;
+  eventHead = eventTail = 0;
+  statusSent = false;
+  statusDirty = true;
+  _F91Outbound_schedule(F91_OUTBOUND_COALESCE_MS);
+}
+
+/*********************************************************************
+ * @fn      F91Outbound_reset
+ *
+ * @brief   The connection is gone, so are the events for it.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Outbound_reset(void)
+{
+  if (connected) {
+    eventsDropped += (uint8_t)(eventTail - eventHead);
+    Display_print3(F91_LOGGER, F91_OUTBOUND_LOG_LINE, 0, "Outbound: %d events, %d dropped, %d notifications",
+                   eventsSent, eventsDropped, notificationsSent);
+  }
+
+  connected = false;
+  eventHead = eventTail = 0;
+  statusDirty = false;
+  Util_stopClock(&outboundClock);
+}
+
+/*********************************************************************
+ * @fn      F91Outbound_postEvent
+ *
+ * @brief   Queue an event for the phone. Nothing is kept while there is
+ *          no connection, the phone has no use for it later.
+ *
+ * @param   event - F91_OUTBOUND_xxx.
+ *
+ * @return  none
+ */
+void F91Outbound_postEvent(uint8_t event)
+{
+  uint8_t *pRecord;
+
+  if (!connected) {
+    return;
+  }
+
+  // The sequence number moves on either way, the phone sees the gap.
+  if ((uint8_t)(eventTail - eventHead) == F91_OUTBOUND_QUEUE_LEN) {
+    eventSeq++;
+    eventsDropped++;
+    return;
+  }
+
+  pRecord = eventQueue[eventTail & (F91_OUTBOUND_QUEUE_LEN - 1)];
+  pRecord[0] = eventSeq++;
+  pRecord[1] = event;
+  eventTail++;
+
+  _F91Outbound_schedule(F91_OUTBOUND_COALESCE_MS);
+}
+
+/*********************************************************************
+ * @fn      F91Outbound_statusChanged
+ *
+ * @brief   Look at the status on the next flush, it is only notified if
+ *          it changed.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Outbound_statusChanged(void)
+{
+  if (!connected) {
+    return;
+  }
+
+  statusDirty = true;
+  _F91Outbound_schedule(F91_OUTBOUND_COALESCE_MS);
+}
+
+/*********************************************************************
+ * @fn      F91Outbound_setDrift
+ *
+ * @brief   The clock was set. Only the phone sets it while connected, the
+ *          default time set on boot is no drift.
+ *
+ * @param   delta - seconds the clock moved, positive if the watch was slow.
+ *
+ * @return  none
+ */
+void F91Outbound_setDrift(int32_t delta)
+{
+  if (!connected) {
+    return;
+  }
+
+  drift = (int16_t)MAX(MIN(delta, INT16_MAX), INT16_MIN);
+  F91Outbound_statusChanged();
+}
+
+/*********************************************************************
+ * @fn      F91Outbound_processEvent
+ *
+ * @brief   Flush the events, then the status.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Outbound_processEvent(void)
+{
+  uint8_t sent;
+
+  if (!connected) {
+    return;
+  }
+
+  sent = _F91Outbound_sendEvents();
+  notificationsSent += sent;
+
+  if (statusDirty && (eventHead == eventTail) && (sent < F91_OUTBOUND_BURST)) {
+    statusDirty = !_F91Outbound_sendStatus();
+  }
+
+  if ((eventHead != eventTail) || statusDirty) {
+    Util_restartClock(&outboundClock, F91_OUTBOUND_RETRY_MS);
+  }
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,132 @@
+/******************************************************************************
+
+ @file  f91_outbound.h
+
+ @brief This file contains the F91 Kepler Smart Watch outbound queue
+        definitions and prototypes. Button events and the watch status are
+        notified to the phone, batched so a few notifications go out in one
+        connection event.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91OUTBOUND_H
+#define F91OUTBOUND_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Events notified on the events characteristic, one record each:
+// [seq][event]. seq counts every event posted while connected, a gap
+// means records were dropped.
+#define F91_OUTBOUND_CALL_DISMISSED       0x01  // incoming call declined
+#define F91_OUTBOUND_CALL_MUTED           0x02  // incoming call silenced
+#define F91_OUTBOUND_TEXT_DISMISSED       0x03  // text read and dismissed
+#define F91_OUTBOUND_ALL_DISMISSED        0x04  // every queued alert dropped
+#define F91_OUTBOUND_ALARM_DISMISSED      0x05  // ringing alarm or countdown stopped
+#define F91_OUTBOUND_ALARM_SNOOZED        0x06  // ringing alarm snoozed
+
+// Records waiting to be notified, a record posted to a full queue is dropped.
+#define F91_OUTBOUND_QUEUE_LEN            16    // power of 2
+
+// Time (in ms) events and status changes are held to go out together.
+#define F91_OUTBOUND_COALESCE_MS          40
+
+// Notifications queued to the stack per flush. They fit the stack's buffers
+// and go out in the same connection event.
+#define F91_OUTBOUND_BURST                4
+
+// Time (in ms) before trying again when the stack is out of buffers.
+#define F91_OUTBOUND_RETRY_MS             100
+
+// Battery change (in mV) worth a status notification on its own.
+#define F91_OUTBOUND_BATTERY_STEP_MV      50
+
+// Log line of the counters.
+#define F91_OUTBOUND_LOG_LINE             29
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the outbound queue.
+ */
+extern void F91Outbound_init(void);
+
+/*
+ * A connection is up.
+ */
+extern void F91Outbound_connected(uint16_t connHandle);
+
+/*
+ * The connection is gone.
+ */
+extern void F91Outbound_reset(void);
+
+/*
+ * Queue an event for the phone, F91_OUTBOUND_xxx.
+ */
+extern void F91Outbound_postEvent(uint8_t event);
+
+/*
+ * Something in the status may have changed.
+ */
+extern void F91Outbound_statusChanged(void);
+
+/*
+ * The clock was set, the watch had drifted by delta seconds.
+ */
+extern void F91Outbound_setDrift(int32_t delta);
+
+/*
+ * Task Event Processor for the outbound queue.
+ */
+extern void F91Outbound_processEvent(void);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91OUTBOUND_H */
@@ -0,0 +1,412 @@
+/******************************************************************************
+
+ @file  f91_stopwatch.c
+
+ @brief This file contains the F91 Kepler Smart Watch stopwatch (chronograph).
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/display/Display.h>
+#include <driverlib/aon_rtc.h>
+
+#include "util.h"
+#include "ssd1306.h"
+#include "f91_utils.h"
+#include "f91_kepler.h"
+#include "f91_stopwatch.h"
+#include "f91_notification.h"
+#include "f91_buttons.h"
+#include "f91_alarm.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+// Converts a 32.32 fixed point RTC delta to 1/100 s.
+#define RTC_TO_CENTISECONDS(rtc)  ((uint32_t)(((rtc) * 100) >> 32))
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Label shown in the date field.
+#define STOPWATCH_LABEL_POS_X     83
+
+// Hundredths region, both small digits.
+#define HUNDREDTHS_POS_X          SEC_1_POS_X
+#define HUNDREDTHS_WIDTH          ((SEC_2_POS_X + 9) - SEC_1_POS_X)
+#define HUNDREDTHS_PAGE           (SEC_POS_Y / 8)
+#define HUNDREDTHS_PAGES          2
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Clock object used to pace display refreshes while running.
+static Clock_Struct refreshClock;
+
+static bool     stopwatchActive  = false;
+static bool     stopwatchRunning = false;
+
+// RTC value (32.32 seconds) when the stopwatch was last started.
+static uint64_t startStamp;
+
+// Time accumulated over previous start/stop cycles in 1/100 s.
+static uint32_t accumulated;
+
+// Lap ring, lapHead is the next slot to be written.
+static uint32_t laps[F91_STOPWATCH_LAP_COUNT];
+static uint8_t  lapHead;
+static uint8_t  lapCount;
+
+// RTC value until which the last lap stays frozen on the display.
+static uint64_t lapHoldUntil;
+
+// Seconds value of the last full face render, used to limit full updates.
+static uint32_t lastDrawnSeconds = 0xFFFFFFFF;
+
+// Refresh statistics of the current run, reset on every start.
+static struct {
+  uint32_t frames;
+  uint32_t fullFrames;
+  uint32_t totalTicks;
+  uint32_t maxTicks;
+} stats;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint32_t _F91Stopwatch_elapsed( void );
+static void _F91Stopwatch_render(uint32_t centiseconds, bool full);
+static void _F91Stopwatch_refreshCallback(UArg arg);
+static void _F91Stopwatch_logStats(uint32_t runTime);
+
+/*********************************************************************
+ * @fn      _F91Stopwatch_elapsed
+ *
+ * @brief   Elapsed stopwatch time, taken from the RTC sub-second counter.
+ *
+ * @return  Elapsed time in 1/100 s.
+ */
+static uint32_t _F91Stopwatch_elapsed( void )
+{
+  if (!stopwatchRunning) {
+    return accumulated;
+  }
+
+  return accumulated + RTC_TO_CENTISECONDS(AONRTCCurrent64BitValueGet() - startStamp);
+}
+
+/*********************************************************************
+ * @fn      _F91Stopwatch_render
+ *
+ * @brief   Draws the stopwatch face (MM:SS and hundredths). Only the hundredths are
+ *          sent to the display unless full is set or the seconds changed.
+ *
+ * @param   centiseconds - time to display in 1/100 s.
+ * @param   full - force a full display update.
+ *
+ * @return  None.
+ */
+static void _F91Stopwatch_render(uint32_t centiseconds, bool full)
+{
+  uint32_t start = Clock_getTicks();
+  uint32_t seconds = centiseconds / 100;
+  uint8_t  hundredths = centiseconds % 100;
+  uint32_t ticks;
+
+  if (full || (seconds != lastDrawnSeconds)) {
+    uint8_t minutes = (seconds / 60) % 60;
+
+    ssd1306_display_text("000", STOPWATCH_LABEL_POS_X - 6, DATE_POS_Y, true);
+    ssd1306_display_text("ST", STOPWATCH_LABEL_POS_X, DATE_POS_Y, false);
+    ssd1306_display_pm(PM_POS_X, PM_POS_Y, true);
+    ssd1306_display_semicolon(SEM_CLN_POS_X, SEM_CLN_POS_Y, false);
+    ssd1306_display_number(minutes / 10, HR_1_POS_X, HR_MIN_POS_Y, false);
+    ssd1306_display_number(minutes % 10, HR_2_POS_X, HR_MIN_POS_Y, false);
+    ssd1306_display_number((seconds % 60) / 10, MIN_1_POS_X, HR_MIN_POS_Y, false);
+    ssd1306_display_number(seconds % 10, MIN_2_POS_X, HR_MIN_POS_Y, false);
+    ssd1306_display_small_number(hundredths / 10, SEC_1_POS_X, SEC_POS_Y, false);
+    ssd1306_display_small_number(hundredths % 10, SEC_2_POS_X, SEC_POS_Y, false);
+    ssd1306_update();
+
+    lastDrawnSeconds = seconds;
+    stats.fullFrames++;
+  } else {
+    ssd1306_display_small_number(hundredths / 10, SEC_1_POS_X, SEC_POS_Y, false);
+    ssd1306_display_small_number(hundredths % 10, SEC_2_POS_X, SEC_POS_Y, false);
+    ssd1306_update_region(HUNDREDTHS_POS_X, HUNDREDTHS_WIDTH, HUNDREDTHS_PAGE, HUNDREDTHS_PAGES);
+  }
+
+  ticks = Clock_getTicks() - start;
+  stats.frames++;
+  stats.totalTicks += ticks;
+  if (ticks > stats.maxTicks) {
+    stats.maxTicks = ticks;
+  }
+}
+
+/*********************************************************************
+ * @fn      _F91Stopwatch_refreshCallback
+ *
+ * @brief   Refresh clock expiry, runs in Swi context so only wake the app task.
+ *
+ * @param   arg - not used.
+ *
+ * @return  None.
+ */
+static void _F91Stopwatch_refreshCallback(UArg arg)
+{
+  F91Kepler_stopwatchRefreshCB();
+}
+
+/*********************************************************************
+ * @fn      _F91Stopwatch_logStats
+ *
+ * @brief   Logs the refresh rate and display bus time per minute of running.
+ *
+ * @param   runTime - duration of the run the stats were taken over, in 1/100 s.
+ *
+ * @return  None.
+ */
+static void _F91Stopwatch_logStats(uint32_t runTime)
+{
+  uint32_t busTime;
+
+  if ((stats.frames == 0) || (runTime == 0)) {
+    return;
+  }
+
+  // Time spent driving the display, in msec per minute of running.
+  busTime = (uint32_t)(((uint64_t)stats.totalTicks * Clock_tickPeriod * 60) / (runTime * 10));
+
+  Display_print3(F91_LOGGER, 9, 0, "SW fps x10: %d full: %d bus ms/min: %d",
+                 (stats.frames * 1000) / runTime, stats.fullFrames, busTime);
+  Display_print2(F91_LOGGER, 10, 0, "SW frame avg: %dus max: %dus",
+                 (stats.totalTicks / stats.frames) * Clock_tickPeriod,
+                 stats.maxTicks * Clock_tickPeriod);
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Stopwatch_init
+ *
+ * @brief   Initialization function for the stopwatch
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Stopwatch_init( void )
+{
+  Util_constructClock(&refreshClock, _F91Stopwatch_refreshCallback,
+                      F91_STOPWATCH_REFRESH_PERIOD, F91_STOPWATCH_REFRESH_PERIOD,
+                      false, NULL);
+}
+
+/*********************************************************************
+ * @fn      F91Stopwatch_enter
+ *
+ * @brief   Show the stopwatch face. The display stays on while it runs, and
+ *          for F91_STOPWATCH_IDLE_TIMEOUT after the last press while stopped.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Stopwatch_enter( void )
+{
+  stopwatchActive = true;
+
+  ssd1306_clear();
+  F91Notification_update(NOTIFICATION_BAR);
+  _F91Stopwatch_render(_F91Stopwatch_elapsed(), true);
+  ssd1306_toggle_display(true);
+
+  if (stopwatchRunning) {
+    F91Buttons_resetOneShot();
+    Util_startClock(&refreshClock);
+  } else {
+    F91Buttons_startIdleTimeout(F91_STOPWATCH_IDLE_TIMEOUT);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Stopwatch_exit
+ *
+ * @brief   Leave the stopwatch face. Refreshes stop but the time keeps counting.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Stopwatch_exit( void )
+{
+  stopwatchActive = false;
+  lastDrawnSeconds = 0xFFFFFFFF;
+  Util_stopClock(&refreshClock);
+  ssd1306_clear();
+}
+
+/*********************************************************************
+ * @fn      F91Stopwatch_isActive
+ *
+ * @brief   Stopwatch state to stop the clock from overwriting the buffer.
+ *
+ * @param   none
+ *
+ * @return  true if the stopwatch face is being shown, false otherwise.
+ */
+bool F91Stopwatch_isActive( void )
+{
+  return stopwatchActive;
+}
+
+/*********************************************************************
+ * @fn      F91Stopwatch_startStop
+ *
+ * @brief   Start the stopwatch if stopped, stop it if running.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Stopwatch_startStop( void )
+{
+  if (stopwatchRunning) {
+    uint32_t runTime = RTC_TO_CENTISECONDS(AONRTCCurrent64BitValueGet() - startStamp);
+
+    accumulated += runTime;
+    stopwatchRunning = false;
+    Util_stopClock(&refreshClock);
+    lapHoldUntil = 0;
+
+    _F91Stopwatch_render(accumulated, true);
+    _F91Stopwatch_logStats(runTime);
+    if (stopwatchActive) {
+      F91Buttons_startIdleTimeout(F91_STOPWATCH_IDLE_TIMEOUT);
+    }
+  } else {
+    memset(&stats, 0, sizeof(stats));
+    startStamp = AONRTCCurrent64BitValueGet();
+    stopwatchRunning = true;
+
+    if (stopwatchActive) {
+      F91Buttons_resetOneShot();
+      Util_startClock(&refreshClock);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Stopwatch_lapReset
+ *
+ * @brief   While running, record a lap and freeze it on the display for a while.
+ *          While stopped, clear the time and the lap ring.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Stopwatch_lapReset( void )
+{
+  if (stopwatchRunning) {
+    uint64_t now = AONRTCCurrent64BitValueGet();
+    uint32_t lap = accumulated + RTC_TO_CENTISECONDS(now - startStamp);
+
+    laps[lapHead] = lap;
+    lapHead = (lapHead + 1) % F91_STOPWATCH_LAP_COUNT;
+    if (lapCount < F91_STOPWATCH_LAP_COUNT) {
+      lapCount++;
+    }
+
+    lapHoldUntil = now + (((uint64_t)F91_STOPWATCH_LAP_HOLD << 32) / 1000);
+    _F91Stopwatch_render(lap, true);
+  } else {
+    accumulated = 0;
+    lapHead = 0;
+    lapCount = 0;
+    _F91Stopwatch_render(0, true);
+    F91Buttons_startIdleTimeout(F91_STOPWATCH_IDLE_TIMEOUT);
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Stopwatch_getLap
+ *
+ * @brief   Get a recorded lap time.
+ *
+ * @param   index - 0 for the most recent lap.
+ * @param   centiseconds - lap time in 1/100 s.
+ *
+ * @return  true if the lap exists, false otherwise.
+ */
+bool F91Stopwatch_getLap(uint8_t index, uint32_t *centiseconds)
+{
+  if (index >= lapCount) {
+    return false;
+  }
+
+  *centiseconds = laps[(lapHead + F91_STOPWATCH_LAP_COUNT - 1 - index) % F91_STOPWATCH_LAP_COUNT];
+  return true;
+}
+
+/*********************************************************************
+ * @fn      F91Stopwatch_processEvent
+ *
+ * @brief   Stopwatch refresh, called from the app task on every refresh tick.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Stopwatch_processEvent( void )
+{
+  if (!stopwatchActive || !stopwatchRunning) {
+    return;
+  }
+
+  // Leave the buffer alone while a full screen notification, alert or lap is shown.
+  if (!ssd1306_getState() || F91Notification_getNotificationState() ||
+      F91Alarm_isAlerting()) {
+    return;
+  }
+  if (AONRTCCurrent64BitValueGet() < lapHoldUntil) {
+    return;
+  }
+
+  _F91Stopwatch_render(_F91Stopwatch_elapsed(), false);
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,125 @@
+/******************************************************************************
+
+ @file  f91_stopwatch.h
+
+ @brief This file contains the F91 Kepler Smart Watch stopwatch (chronograph)
+        definitions and prototypes.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91STOPWATCH_H
+#define F91STOPWATCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of lap (split) times kept, oldest is overwritten first.
+#define F91_STOPWATCH_LAP_COUNT         8
+
+// Display refresh period while running (in msec). Each refresh only sends
+// the hundredths digits (2 pages x 19 columns, ~70 bytes on the I2C bus or
+// ~1.6ms at 400kHz), the full face is sent once per second (~11ms). At 50ms
+// that keeps the bus busy for roughly 4% of the time; a full update at the
+// same rate would need over 20%.
+#ifndef F91_STOPWATCH_REFRESH_PERIOD
+#define F91_STOPWATCH_REFRESH_PERIOD    50
+#endif
+
+// How long a lap time stays frozen on the display (in msec).
+#define F91_STOPWATCH_LAP_HOLD          2000
+
+// Time (in msec) the stopped stopwatch stays on the display without a press.
+// A running one stays on until left.
+#define F91_STOPWATCH_IDLE_TIMEOUT      30000
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize stopwatch module
+ */
+extern void F91Stopwatch_init( void );
+
+/*
+ * Show the stopwatch face, returns to the time face with F91Stopwatch_exit.
+ */
+extern void F91Stopwatch_enter( void );
+
+/*
+ * Leave the stopwatch face, the stopwatch keeps running if it was.
+ */
+extern void F91Stopwatch_exit( void );
+
+/*
+ * Returns wether the stopwatch face is being shown.
+ */
+extern bool F91Stopwatch_isActive( void );
+
+/*
+ * Start the stopwatch if stopped, stop it if running.
+ */
+extern void F91Stopwatch_startStop( void );
+
+/*
+ * Record a lap if running, reset if stopped.
+ */
+extern void F91Stopwatch_lapReset( void );
+
+/*
+ * Get a recorded lap time in 1/100 s, index 0 being the most recent.
+ */
+extern bool F91Stopwatch_getLap(uint8_t index, uint32_t *centiseconds);
+
+/*
+ * Task Event Processor for stopwatch module (display refresh).
+ */
+extern void F91Stopwatch_processEvent( void );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91STOPWATCH_H */
@@ -0,0 +1,283 @@
+/******************************************************************************
+
+ @file  f91_sync.c
+
+ @brief This file contains the F91 Kepler Smart Watch state sync.
+
+        The whole sync is checked before anything is applied, a malformed
+        field rejects all of it. The clock and notification modules then take
+        their fields and the display is refreshed once.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/display/Display.h>
+
+#include "bcomdef.h"
+
+#include "f91_sync.h"
+#include "f91_clock.h"
+#include "f91_history.h"
+#include "f91_notification.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Time face settings, the bar is posted on its own.
+#define SYNC_TIME_FACE_FIELDS   (F91_SYNC_FIELD(F91_SYNC_TAG_TIME) | \
+                                 F91_SYNC_FIELD(F91_SYNC_TAG_ZONE) | \
+                                 F91_SYNC_FIELD(F91_SYNC_TAG_MODE) | \
+                                 F91_SYNC_FIELD(F91_SYNC_TAG_DST))
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static f91_notification_serviceSync_t syncStream;
+
+static f91SyncState_t syncState;
+
+// Sequence number of the last sync applied, 0 until the first one.
+static uint16_t lastSeq = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static bool _F91Sync_decode(uint8_t *pData, uint16_t len);
+static void _F91Sync_publishStatus( void );
+
+/*********************************************************************
+ * @fn      _F91Sync_decode
+ *
+ * @brief   Check and decode the fields of a sync into syncState.
+ *
+ * @param   pData - fields, after the header.
+ * @param   len - length of the fields.
+ *
+ * @return  true if every field is well formed.
+ */
+static bool _F91Sync_decode(uint8_t *pData, uint16_t len)
+{
+  uint16_t pos = 0;
+  uint8_t  tag;
+  uint8_t  fieldLen;
+  uint8_t *pField;
+
+  memset(&syncState, 0, sizeof(syncState));
+
+  while (pos < len) {
+    if (pos + 2 > len) {
+      return false;
+    }
+
+    tag      = pData[pos];
+    fieldLen = pData[pos + 1];
+    pField   = &pData[pos + 2];
+    pos     += 2 + fieldLen;
+
+    if (pos > len) {
+      return false;
+    }
+
+    switch (tag) {
+      case F91_SYNC_TAG_BAR:
+        if (fieldLen != 1) {
+          return false;
+        }
+        syncState.bar = pField[0];
+        break;
+      case F91_SYNC_TAG_CALL:
+        if (fieldLen > CONTACT_STREAM_LEN) {
+          return false;
+        }
+        memcpy(syncState.call, pField, fieldLen);
+        break;
+      case F91_SYNC_TAG_TEXT:
+        if (fieldLen > CONTACT_STREAM_LEN) {
+          return false;
+        }
+        memcpy(syncState.text, pField, fieldLen);
+        break;
+      case F91_SYNC_TAG_BODY:
+        // The history doesn't keep more than this anyway, cut on a
+        // character boundary.
+        fieldLen = F91History_fitLen((char *)pField, fieldLen, F91_HISTORY_BODY_LEN);
+        memcpy(syncState.body, pField, fieldLen);
+        break;
+      case F91_SYNC_TAG_TIME:
+        if (fieldLen != sizeof(uint32_t)) {
+          return false;
+        }
+        syncState.time = BUILD_UINT32(pField[0], pField[1], pField[2], pField[3]);
+        break;
+      case F91_SYNC_TAG_ZONE:
+        if (fieldLen != sizeof(uint16_t)) {
+          return false;
+        }
+        syncState.zone = BUILD_UINT16(pField[0], pField[1]);
+        break;
+      case F91_SYNC_TAG_MODE:
+        if (fieldLen != 1) {
+          return false;
+        }
+        syncState.mode = pField[0];
+        break;
+      case F91_SYNC_TAG_DST:
+        if (fieldLen != 1) {
+          return false;
+        }
+        syncState.dst = pField[0];
+        break;
+      default:
+        // Field from a newer version of the phone app.
+        continue;
+    }
+
+    syncState.present |= F91_SYNC_FIELD(tag);
+  }
+
+  return true;
+}
+
+/*********************************************************************
+ * @fn      _F91Sync_publishStatus
+ *
+ * @brief   Let the phone read back which sync was applied last.
+ *
+ * @param   none
+ *
+ * @return  None.
+ */
+static void _F91Sync_publishStatus( void )
+{
+  uint8_t status[SYNC_STATUS_LEN] = { F91_SYNC_VERSION, LO_UINT16(lastSeq), HI_UINT16(lastSeq) };
+
+  F91_notification_service_SetParameter(F91_NOTIFICATION_SERVICE_CHAR5, SYNC_STATUS_LEN, status);
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Sync_init
+ *
+ * @brief   Initialization function for the state sync.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Sync_init( void )
+{
+  lastSeq = 0;
+  _F91Sync_publishStatus();
+}
+
+/*********************************************************************
+ * @fn      F91Sync_processCharChangeEvt
+ *
+ * @brief   Apply a state sync. A sync with the sequence number already
+ *          applied is a retry and ignored.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Sync_processCharChangeEvt( void )
+{
+  uint16_t seq;
+
+  F91_notification_service_GetParameter(F91_NOTIFICATION_SERVICE_CHAR5, &syncStream);
+
+  if ((syncStream.len < F91_SYNC_HDR_LEN) || (syncStream.data[0] != F91_SYNC_VERSION)) {
+    Display_print1(F91_LOGGER, 6, 0, "Sync: bad header, %d bytes", syncStream.len);
+    return;
+  }
+
+  seq = BUILD_UINT16(syncStream.data[1], syncStream.data[2]);
+  if ((seq == lastSeq) && (seq != 0)) {
+    return;
+  }
+
+  if (!F91Sync_apply(&syncStream.data[F91_SYNC_HDR_LEN], syncStream.len - F91_SYNC_HDR_LEN)) {
+    Display_print1(F91_LOGGER, 6, 0, "Sync: %d rejected", seq);
+    return;
+  }
+
+  lastSeq = seq;
+  _F91Sync_publishStatus();
+}
+
+/*********************************************************************
+ * @fn      F91Sync_apply
+ *
+ * @brief   Check and apply the fields of a sync or command frame. Nothing
+ *          is applied if any field is malformed.
+ *
+ * @param   pFields - fields, after the header.
+ * @param   len - length of the fields.
+ *
+ * @return  true if the fields were applied.
+ */
+bool F91Sync_apply(uint8_t *pFields, uint16_t len)
+{
+  if (!_F91Sync_decode(pFields, len)) {
+    return false;
+  }
+
+  F91Clock_applySync(&syncState);
+  F91Notification_applySync(&syncState);
+
+  // Everything is posted, the display is refreshed once when the
+  // coalescing window ends. The bar is posted whenever it is in the sync so
+  // the flushed bar follows it, even under a call or text. A call or text
+  // takes the full screen, a call first as it is the most urgent.
+  if (syncState.present & F91_SYNC_FIELD(F91_SYNC_TAG_BAR)) {
+    F91Notification_post(NOTIFICATION_BAR);
+  }
+
+  if (syncState.present & F91_SYNC_FIELD(F91_SYNC_TAG_CALL)) {
+    F91Notification_post(NOTIFICATION_CALL);
+  } else if (syncState.present & F91_SYNC_FIELD(F91_SYNC_TAG_TEXT)) {
+    F91Notification_post(NOTIFICATION_TEXT);
+  } else if (syncState.present & SYNC_TIME_FACE_FIELDS) {
+    F91Notification_post(NOTIFICATION_FACE);
+  }
+
+  return true;
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,122 @@
+/******************************************************************************
+
+ @file  f91_sync.h
+
+ @brief This file contains the F91 Kepler Smart Watch state sync definitions
+        and prototypes. A state sync carries any subset of the notification
+        and clock fields in a single write.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91SYNC_H
+#define F91SYNC_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "board.h"
+#include "f91_kepler.h"
+#include "f91_history.h"
+#include "f91_notification_service.h"
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// A sync is [version][seq lo][seq hi] followed by fields, each one
+// [tag][len][value]. Fields left out keep their value, so the phone only
+// has to send what changed since the sequence number it reads back. A
+// sequence number of 0 on read means nothing was synced since boot.
+#define F91_SYNC_VERSION                1
+#define F91_SYNC_HDR_LEN                3
+
+// Field tags. Tags this version doesn't know are skipped.
+#define F91_SYNC_TAG_BAR                0x01  // uint8, notification bar bits
+#define F91_SYNC_TAG_CALL               0x02  // incoming call, contact name
+#define F91_SYNC_TAG_TEXT               0x03  // incoming text, contact name
+#define F91_SYNC_TAG_BODY               0x04  // body of the text in the same sync
+#define F91_SYNC_TAG_TIME               0x05  // uint32, UTC seconds
+#define F91_SYNC_TAG_ZONE               0x06  // uint16, seconds west of UTC
+#define F91_SYNC_TAG_MODE               0x07  // uint8, 0: 12hr  1: 24hr
+#define F91_SYNC_TAG_DST                0x08  // uint8, 0: normal  1: dst
+
+/*********************************************************************
+ * MACROS
+ */
+
+// Bit of a field in f91SyncState_t.present
+#define F91_SYNC_FIELD(tag)             (1 << (tag))
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// A sync checked and decoded, numbers in host order and names terminated.
+typedef struct
+{
+  uint16_t present;                           // F91_SYNC_FIELD bits
+  uint32_t time;
+  uint16_t zone;
+  uint8_t  mode;
+  uint8_t  dst;
+  uint8_t  bar;
+  char     call[CONTACT_STREAM_LEN + 1];
+  char     text[CONTACT_STREAM_LEN + 1];
+  char     body[F91_HISTORY_BODY_LEN + 1];
+} f91SyncState_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the state sync.
+ */
+extern void F91Sync_init( void );
+
+/*
+ * Task Event Processor for the state sync characteristic.
+ */
+extern void F91Sync_processCharChangeEvt( void );
+
+/*
+ * Check and apply sync fields, without a header. Returns false if any is malformed.
+ */
+extern bool F91Sync_apply(uint8_t *pFields, uint16_t len);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91SYNC_H */
@@ -0,0 +1,508 @@
+/******************************************************************************
+
+ @file  f91_timers.c
+
+ @brief This file contains the F91 Kepler Smart Watch timer wheel. Alarms,
+        countdowns and the hourly chime all hang off this wheel instead of
+        owning a Clock object each.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/hal/Seconds.h>
+
+#include "util.h"
+#include "f91_kepler.h"
+#include "f91_timers.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define LEVEL_SHIFT(level)      ((level) * F91_TIMERS_SLOT_BITS)
+#define LEVEL_SPAN(level)       (1UL << LEVEL_SHIFT((level) + 1))
+#define LEVEL_INDEX(t, level)   (((t) >> LEVEL_SHIFT(level)) & SLOT_MASK)
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define SLOT_COUNT              (1 << F91_TIMERS_SLOT_BITS)
+#define SLOT_MASK               (SLOT_COUNT - 1)
+
+// Furthest a timer can be filed from the wheel time.
+#define WHEEL_HORIZON           (LEVEL_SPAN(F91_TIMERS_LEVELS - 1) - 1)
+
+// Returned by _F91Timers_nextEvent when the wheel is empty.
+#define NO_EVENT                0xFFFFFFFF
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Clock object used as the single hardware wakeup for the wheel.
+static Clock_Struct wakeClock;
+
+static f91Timer_t *wheel[F91_TIMERS_LEVELS][SLOT_COUNT];
+
+// One bit per non empty slot, lets the next deadline be found without
+// walking the lists.
+static uint32_t occupied[F91_TIMERS_LEVELS];
+
+// RTC second the wheel has been processed up to.
+static uint32_t wheelNow;
+
+// Set while expiring timers, defers rescheduling to the end of the pass.
+static bool processing = false;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static uint8_t _F91Timers_firstSlot(uint32_t bits);
+static void _F91Timers_file(f91Timer_t *pTimer);
+static void _F91Timers_unlink(f91Timer_t *pTimer);
+static f91Timer_t *_F91Timers_detachSlot(uint8_t level, uint8_t slot);
+static uint32_t _F91Timers_nextEvent( void );
+static void _F91Timers_advance(uint32_t target);
+static void _F91Timers_schedule( void );
+static void _F91Timers_wakeupCallback(UArg arg);
+
+/*********************************************************************
+ * @fn      _F91Timers_firstSlot
+ *
+ * @brief   Index of the lowest set bit.
+ *
+ * @param   bits - slot bitmap, must not be 0.
+ *
+ * @return  Slot index.
+ */
+static uint8_t _F91Timers_firstSlot(uint32_t bits)
+{
+  uint8_t slot = 0;
+
+  while (!(bits & 1)) {
+    bits >>= 1;
+    slot++;
+  }
+
+  return slot;
+}
+
+/*********************************************************************
+ * @fn      _F91Timers_file
+ *
+ * @brief   Links a timer in the slot matching its distance from the wheel time.
+ *          A timer due now goes in the current level 0 slot so that the pass
+ *          in progress expires it.
+ *
+ * @param   pTimer - timer to file, must not be pending.
+ *
+ * @return  None.
+ */
+static void _F91Timers_file(f91Timer_t *pTimer)
+{
+  uint32_t fileTime = pTimer->expires;
+  uint8_t  level = 0;
+
+  if ((int32_t)(fileTime - wheelNow) < 0) {
+    fileTime = wheelNow;
+  } else if (fileTime - wheelNow > WHEEL_HORIZON) {
+    fileTime = wheelNow + WHEEL_HORIZON;
+  }
+
+  while ((level < F91_TIMERS_LEVELS - 1) &&
+         ((fileTime - wheelNow) >= (1UL << LEVEL_SHIFT(level + 1)))) {
+    level++;
+  }
+
+  pTimer->level = level;
+  pTimer->slot  = LEVEL_INDEX(fileTime, level);
+
+  pTimer->next  = wheel[level][pTimer->slot];
+  pTimer->pprev = &wheel[level][pTimer->slot];
+  if (pTimer->next) {
+    pTimer->next->pprev = &pTimer->next;
+  }
+  wheel[level][pTimer->slot] = pTimer;
+  occupied[level] |= (1UL << pTimer->slot);
+}
+
+/*********************************************************************
+ * @fn      _F91Timers_unlink
+ *
+ * @brief   Removes a pending timer from its list.
+ *
+ * @param   pTimer - timer to remove.
+ *
+ * @return  None.
+ */
+static void _F91Timers_unlink(f91Timer_t *pTimer)
+{
+  *pTimer->pprev = pTimer->next;
+  if (pTimer->next) {
+    pTimer->next->pprev = pTimer->pprev;
+  }
+
+  if (wheel[pTimer->level][pTimer->slot] == NULL) {
+    occupied[pTimer->level] &= ~(1UL << pTimer->slot);
+  }
+
+  pTimer->next  = NULL;
+  pTimer->pprev = NULL;
+}
+
+/*********************************************************************
+ * @fn      _F91Timers_detachSlot
+ *
+ * @brief   Empties a slot, the timers stay linked to each other and can
+ *          still be stopped while the caller walks them.
+ *
+ * @param   level - wheel level.
+ * @param   slot - slot index.
+ *
+ * @return  First timer of the detached list.
+ */
+static f91Timer_t *_F91Timers_detachSlot(uint8_t level, uint8_t slot)
+{
+  f91Timer_t *pList = wheel[level][slot];
+
+  wheel[level][slot] = NULL;
+  occupied[level] &= ~(1UL << slot);
+
+  return pList;
+}
+
+/*********************************************************************
+ * @fn      _F91Timers_nextEvent
+ *
+ * @brief   Finds the next second at which a slot has to be cascaded or expired.
+ *
+ * @return  RTC second of the next event, NO_EVENT if the wheel is empty.
+ */
+static uint32_t _F91Timers_nextEvent( void )
+{
+  uint32_t next = NO_EVENT;
+  uint8_t  level;
+
+  for (level = 0; level < F91_TIMERS_LEVELS; level++) {
+    uint32_t rotation = wheelNow & ~(LEVEL_SPAN(level) - 1);
+    uint32_t ahead;
+    uint32_t event;
+
+    if (!occupied[level]) {
+      continue;
+    }
+
+    // Slots past the current index come up in this rotation, the others
+    // (current one included) in the next.
+    ahead = occupied[level] & ~((2UL << LEVEL_INDEX(wheelNow, level)) - 1);
+    if (ahead) {
+      event = rotation + ((uint32_t)_F91Timers_firstSlot(ahead) << LEVEL_SHIFT(level));
+    } else {
+      event = rotation + LEVEL_SPAN(level) +
+              ((uint32_t)_F91Timers_firstSlot(occupied[level]) << LEVEL_SHIFT(level));
+    }
+
+    if (event < next) {
+      next = event;
+    }
+  }
+
+  return next;
+}
+
+/*********************************************************************
+ * @fn      _F91Timers_advance
+ *
+ * @brief   Moves the wheel time forward, jumping straight from one event to
+ *          the next. Higher levels are cascaded before level 0 slots expire.
+ *
+ * @param   target - RTC second to advance to.
+ *
+ * @return  None.
+ */
+static void _F91Timers_advance(uint32_t target)
+{
+  f91Timer_t *pList;
+  f91Timer_t *pTimer;
+  uint32_t    next;
+  uint8_t     level;
+
+  processing = true;
+
+  while (((next = _F91Timers_nextEvent()) != NO_EVENT) && (next <= target)) {
+    wheelNow = next;
+
+    for (level = F91_TIMERS_LEVELS - 1; level > 0; level--) {
+      if (wheelNow & ((1UL << LEVEL_SHIFT(level)) - 1)) {
+        continue;
+      }
+
+      pList = _F91Timers_detachSlot(level, LEVEL_INDEX(wheelNow, level));
+      if (pList) {
+        pList->pprev = &pList;
+      }
+      while ((pTimer = pList) != NULL) {
+        _F91Timers_unlink(pTimer);
+        _F91Timers_file(pTimer);
+      }
+    }
+
+    pList = _F91Timers_detachSlot(0, LEVEL_INDEX(wheelNow, 0));
+    if (pList) {
+      pList->pprev = &pList;
+    }
+    while ((pTimer = pList) != NULL) {
+      _F91Timers_unlink(pTimer);
+
+      if ((int32_t)(pTimer->expires - wheelNow) > 0) {
+        // Was parked past the horizon, file it again.
+        _F91Timers_file(pTimer);
+      } else if (pTimer->pfnExpire) {
+        pTimer->pfnExpire(pTimer);
+      }
+    }
+  }
+
+  if ((int32_t)(target - wheelNow) > 0) {
+    wheelNow = target;
+  }
+
+  processing = false;
+}
+
+/*********************************************************************
+ * @fn      _F91Timers_schedule
+ *
+ * @brief   Arms the hardware wakeup for the nearest event, stops it if the
+ *          wheel is empty.
+ *
+ * @return  None.
+ */
+static void _F91Timers_schedule( void )
+{
+  uint32_t next;
+  uint32_t now;
+
+  if (processing) {
+    return;
+  }
+
+  next = _F91Timers_nextEvent();
+  now = Seconds_get();
+
+  if (next == NO_EVENT) {
+    Util_stopClock(&wakeClock);
+    return;
+  }
+
+  if ((int32_t)(next - now) <= 0) {
+    // Already due, let the task pick it up on its next pass.
+    Util_stopClock(&wakeClock);
+    F91Kepler_timersWakeupCB();
+    return;
+  }
+
+  if (next - now > F91_TIMERS_MAX_SLEEP) {
+    next = now + F91_TIMERS_MAX_SLEEP;
+  }
+
+  Util_restartClock(&wakeClock, (next - now) * 1000);
+}
+
+/*********************************************************************
+ * @fn      _F91Timers_wakeupCallback
+ *
+ * @brief   Callback from the Clock module (Swi context).
+ *
+ * @return  None.
+ */
+static void _F91Timers_wakeupCallback(UArg arg)
+{
+  F91Kepler_timersWakeupCB();
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Timers_init
+ *
+ * @brief   Initialization function for the timer wheel
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Timers_init( void )
+{
+  wheelNow = Seconds_get();
+
+  Util_constructClock(&wakeClock, _F91Timers_wakeupCallback,
+                      0, 0, false, NULL);
+}
+
+/*********************************************************************
+ * @fn      F91Timers_construct
+ *
+ * @brief   Setup a timer entry.
+ *
+ * @param   pTimer - timer to setup.
+ * @param   pfnExpire - called when the timer expires.
+ * @param   arg - user argument, available as pTimer->arg in the callback.
+ *
+ * @return  none
+ */
+void F91Timers_construct(f91Timer_t *pTimer, f91TimerCB_t pfnExpire, UArg arg)
+{
+  pTimer->next      = NULL;
+  pTimer->pprev     = NULL;
+  pTimer->expires   = 0;
+  pTimer->pfnExpire = pfnExpire;
+  pTimer->arg       = arg;
+}
+
+/*********************************************************************
+ * @fn      F91Timers_start
+ *
+ * @brief   Start a timer, restarts it if already pending. A deadline that
+ *          already passed expires on the next second.
+ *
+ * @param   pTimer - timer to start.
+ * @param   expires - RTC second (UTC) to expire at.
+ *
+ * @return  none
+ */
+void F91Timers_start(f91Timer_t *pTimer, uint32_t expires)
+{
+  if (pTimer->pprev) {
+    _F91Timers_unlink(pTimer);
+  }
+
+  if ((int32_t)(expires - wheelNow) <= 0) {
+    expires = wheelNow + 1;
+  }
+
+  pTimer->expires = expires;
+  _F91Timers_file(pTimer);
+  _F91Timers_schedule();
+}
+
+/*********************************************************************
+ * @fn      F91Timers_stop
+ *
+ * @brief   Stop a timer.
+ *
+ * @param   pTimer - timer to stop.
+ *
+ * @return  none
+ */
+void F91Timers_stop(f91Timer_t *pTimer)
+{
+  if (pTimer->pprev) {
+    _F91Timers_unlink(pTimer);
+    _F91Timers_schedule();
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Timers_isActive
+ *
+ * @brief   Returns wether a timer is pending.
+ *
+ * @param   pTimer - timer to check.
+ *
+ * @return  true if pending, false otherwise.
+ */
+bool F91Timers_isActive(f91Timer_t *pTimer)
+{
+  return (pTimer->pprev != NULL);
+}
+
+/*********************************************************************
+ * @fn      F91Timers_rebase
+ *
+ * @brief   Called after the RTC was set. Every pending timer keeps the time it
+ *          had left and is re-filed around the new wheel time. Wall clock
+ *          timers (alarms) are expected to be restarted by their owner.
+ *
+ * @param   delta - seconds the RTC moved by.
+ *
+ * @return  none
+ */
+void F91Timers_rebase(int32_t delta)
+{
+  f91Timer_t *pList = NULL;
+  f91Timer_t *pTimer;
+  f91Timer_t *pNext;
+  uint8_t     level;
+  uint8_t     slot;
+
+  // Pull every timer off the wheel onto a single list.
+  for (level = 0; level < F91_TIMERS_LEVELS; level++) {
+    for (slot = 0; slot < SLOT_COUNT; slot++) {
+      for (pTimer = _F91Timers_detachSlot(level, slot); pTimer; pTimer = pNext) {
+        pNext = pTimer->next;
+        pTimer->next = pList;
+        pList = pTimer;
+      }
+    }
+  }
+
+  wheelNow = Seconds_get();
+
+  processing = true;
+  while ((pTimer = pList) != NULL) {
+    pList = pTimer->next;
+    pTimer->pprev = NULL;
+    F91Timers_start(pTimer, pTimer->expires + delta);
+  }
+  processing = false;
+
+  _F91Timers_schedule();
+}
+
+/*********************************************************************
+ * @fn      F91Timers_processEvent
+ *
+ * @brief   Expires every timer due by now and re-arms the hardware wakeup.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Timers_processEvent( void )
+{
+  _F91Timers_advance(Seconds_get());
+  _F91Timers_schedule();
+}
+
+/*********************************************************************
+*********************************************************************/
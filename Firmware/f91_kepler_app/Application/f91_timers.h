@@ -0,0 +1,136 @@
+/******************************************************************************
+
+ @file  f91_timers.h
+
+ @brief This file contains the F91 Kepler Smart Watch timer wheel definitions
+        and prototypes. Timers are kept on the RTC seconds time base and share
+        a single hardware wakeup for the nearest deadline.
+
+ Target Device: cc2640r2
+
+ ******************************************************************************
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+
+
+ *****************************************************************************/
+
+#ifndef F91TIMERS_H
+#define F91TIMERS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <xdc/std.h>
+
+/*********************************************************************
+*  EXTERNAL VARIABLES
+*/
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Wheel geometry, 4 levels of 32 slots with 1 s resolution. Level n slots
+// are 32^n seconds wide, so the wheel spans 2^20 s (~12 days) which covers
+// a weekly alarm. Timers further out are parked on the last level and
+// re-filed when they come around.
+#define F91_TIMERS_LEVELS           4
+#define F91_TIMERS_SLOT_BITS        5
+
+// Longest the hardware wakeup is armed for (in sec), keeps the tick count
+// passed to the Clock module well within 32 bits.
+#define F91_TIMERS_MAX_SLEEP        3600
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct f91Timer f91Timer_t;
+
+// Called from the F91Kepler task when a timer expires. The timer is no
+// longer pending and may be started again from the callback.
+typedef void (*f91TimerCB_t)( f91Timer_t *pTimer );
+
+// Timer entry, owned by the caller and linked into the wheel while pending.
+struct f91Timer
+{
+  f91Timer_t   *next;
+  f91Timer_t  **pprev;   // NULL while not pending
+  uint32_t      expires; // RTC seconds (UTC)
+  f91TimerCB_t  pfnExpire;
+  UArg          arg;
+  uint8_t       level;
+  uint8_t       slot;
+};
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Initialize the timer wheel
+ */
+extern void F91Timers_init( void );
+
+/*
+ * Setup a timer entry, must be called once before it is started.
+ */
+extern void F91Timers_construct(f91Timer_t *pTimer, f91TimerCB_t pfnExpire, UArg arg);
+
+/*
+ * Start (or move) a timer to expire at the given RTC second.
+ */
+extern void F91Timers_start(f91Timer_t *pTimer, uint32_t expires);
+
+/*
+ * Stop a timer, does nothing if it is not pending.
+ */
+extern void F91Timers_stop(f91Timer_t *pTimer);
+
+/*
+ * Returns wether a timer is pending.
+ */
+extern bool F91Timers_isActive(f91Timer_t *pTimer);
+
+/*
+ * Shift all pending timers by delta seconds after the RTC was set.
+ */
+extern void F91Timers_rebase(int32_t delta);
+
+/*
+ * Task Event Processor for the timer wheel (hardware wakeup).
+ */
+extern void F91Timers_processEvent( void );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* F91TIMERS_H */
@@ -49,49 +49,15 @@
 #include "gatt.h"
 #include <ti/display/Display.h>
 #include <ti/sysbios/knl/Semaphore.h>
-#include <ti/sysbios/knl/Mailbox.h>
 
 #define IS_DEV_BOARD
 
-/*********************************************************************
- * CONSTANTS
- */
-#define NUMMSGS         5
-
-
-/*********************************************************************
- * TYPEDEFS
- */
-/*
- * This type is accessed by the application. When changing the data members of
- * this structure, considerations should be made for padding and data alignment.
- */
-typedef struct MsgObj {
-   uint8_t    id;
-   void       *value;
-} MsgObj;
-
-/*
- * Mailbox messages are stored in a queue that requires a header in front of
- * each message. Mailbox_MbxElem is defined such that the header and its size
- * are factored into the total data size requirement for a mailbox instance.
- * Because Mailbox_MbxElem contains Int data types, padding may be added to
- * this struct depending on the data members defined in MsgObj.
- */
-typedef struct MailboxMsgObj {
-    Mailbox_MbxElem  elem;      /* Mailbox header        */
-    MsgObj           obj;       /* Application's mailbox */
-} MailboxMsgObj;
-
 /*********************************************************************
  * GLOBALS
  */
 
 extern Display_Handle F91_LOGGER;
 
-extern Mailbox_Struct mbxStruct;
-extern Mailbox_Handle mbxHandle;
-
 extern Semaphore_Struct semStruct;
 extern Semaphore_Handle semHandle;
 /*********************************************************************
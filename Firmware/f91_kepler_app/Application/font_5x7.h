@@ -100,6 +100,377 @@ const unsigned char font_5x7[96][5] = {{0x00, 0x00, 0x00, 0x00, 0x00},  // space
                                        {0x44, 0x28, 0x10, 0x28, 0x44},  // x
                                        {0x0C, 0x50, 0x50, 0x50, 0x3C},  // y
                                        {0x44, 0x64, 0x54, 0x4C, 0x44},  // z
+                                       {0x00, 0x08, 0x36, 0x41, 0x00},  // {
+                                       {0x00, 0x00, 0x7F, 0x00, 0x00},  // |
+                                       {0x00, 0x41, 0x36, 0x08, 0x00},  // }
+                                       {0x08, 0x04, 0x08, 0x10, 0x08},  // ~
+                                       {0x7F, 0x41, 0x41, 0x41, 0x7F},  // fallback, in place of DEL
+};
+
+/*
+ * Glyph codes. 0x20 to 0x7E are the ASCII characters above, codes from
+ * 0x80 index font_5x7_extra.
+ */
+#define FONT_5X7_NONE             0x00  // zero width, nothing is drawn
+#define FONT_5X7_FALLBACK         0x7F  // box for characters without a glyph
+#define FONT_5X7_EXTRA            0x80
+
+#define FONT_5X7_EXCLAM_INV       0x80
+#define FONT_5X7_CENT             0x81
+#define FONT_5X7_POUND            0x82
+#define FONT_5X7_EURO             0x83
+#define FONT_5X7_DEGREE           0x84
+#define FONT_5X7_PLUS_MINUS       0x85
+#define FONT_5X7_MICRO            0x86
+#define FONT_5X7_GUILLEMET_L      0x87
+#define FONT_5X7_GUILLEMET_R      0x88
+#define FONT_5X7_QUESTION_INV     0x89
+#define FONT_5X7_MULTIPLY         0x8A
+#define FONT_5X7_DIVIDE           0x8B
+#define FONT_5X7_SHARP_S          0x8C
+#define FONT_5X7_AE_SMALL         0x8D
+#define FONT_5X7_AE               0x8E
+#define FONT_5X7_O_STROKE_SMALL   0x8F
+#define FONT_5X7_O_STROKE         0x90
+#define FONT_5X7_OE_SMALL         0x91
+#define FONT_5X7_OE               0x92
+#define FONT_5X7_DOTLESS_I        0x93
+#define FONT_5X7_SECTION          0x94
+#define FONT_5X7_COPYRIGHT        0x95
+#define FONT_5X7_REGISTERED       0x96
+#define FONT_5X7_NOT              0x97
+#define FONT_5X7_BULLET           0x98
+#define FONT_5X7_ELLIPSIS         0x99
+
+const unsigned char font_5x7_extra[][5] = {{0x00, 0x00, 0x79, 0x00, 0x00},  // inverted !
+                                           {0x18, 0x24, 0x7E, 0x24, 0x00},  // cent
+                                           {0x48, 0x7E, 0x49, 0x41, 0x42},  // pound
+                                           {0x14, 0x3E, 0x55, 0x41, 0x22},  // euro
+                                           {0x00, 0x06, 0x09, 0x09, 0x06},  // degree
+                                           {0x44, 0x44, 0x5F, 0x44, 0x44},  // plus-minus
+                                           {0x7E, 0x20, 0x20, 0x10, 0x3E},  // micro
+                                           {0x08, 0x14, 0x2A, 0x14, 0x22},  // <<
+                                           {0x22, 0x14, 0x2A, 0x14, 0x08},  // >>
+                                           {0x30, 0x48, 0x45, 0x40, 0x20},  // inverted ?
+                                           {0x22, 0x14, 0x08, 0x14, 0x22},  // multiply
+                                           {0x08, 0x08, 0x2A, 0x08, 0x08},  // divide
+                                           {0x7E, 0x01, 0x49, 0x56, 0x20},  // sharp s
+                                           {0x20, 0x54, 0x78, 0x54, 0x58},  // ae
+                                           {0x7E, 0x09, 0x7F, 0x49, 0x41},  // AE
+                                           {0x58, 0x24, 0x54, 0x48, 0x34},  // o stroke
+                                           {0x5E, 0x31, 0x49, 0x46, 0x3D},  // O stroke
+                                           {0x38, 0x44, 0x38, 0x54, 0x58},  // oe
+                                           {0x3E, 0x41, 0x7F, 0x49, 0x41},  // OE
+                                           {0x00, 0x44, 0x7C, 0x40, 0x00},  // dotless i
+                                           {0x0A, 0x55, 0x55, 0x55, 0x28},  // section
+                                           {0x3E, 0x49, 0x55, 0x55, 0x3E},  // copyright
+                                           {0x3E, 0x7D, 0x55, 0x69, 0x3E},  // registered
+                                           {0x08, 0x08, 0x08, 0x08, 0x38},  // not
+                                           {0x00, 0x1C, 0x1C, 0x1C, 0x00},  // bullet
+                                           {0x40, 0x00, 0x40, 0x00, 0x40},  // ellipsis
+};
+
+/*
+ * Accents, or'ed onto a lowercase glyph. Marks above use the two rows over
+ * the x-height, marks below the row under the baseline.
+ */
+#define FONT_5X7_MARK_NONE          0
+#define FONT_5X7_MARK_GRAVE         1
+#define FONT_5X7_MARK_ACUTE         2
+#define FONT_5X7_MARK_CIRCUMFLEX    3
+#define FONT_5X7_MARK_TILDE         4
+#define FONT_5X7_MARK_DIAERESIS     5
+#define FONT_5X7_MARK_RING          6
+#define FONT_5X7_MARK_MACRON        7
+#define FONT_5X7_MARK_BREVE         8
+#define FONT_5X7_MARK_CARON         9
+#define FONT_5X7_MARK_DOT           10
+#define FONT_5X7_MARK_DOUBLE_ACUTE  11
+#define FONT_5X7_MARK_CEDILLA       12
+#define FONT_5X7_MARK_OGONEK        13
+
+const unsigned char font_5x7_marks[][5] = {{0x00, 0x00, 0x00, 0x00, 0x00},  // none
+                                           {0x00, 0x01, 0x02, 0x00, 0x00},  // grave
+                                           {0x00, 0x00, 0x02, 0x01, 0x00},  // acute
+                                           {0x00, 0x02, 0x01, 0x02, 0x00},  // circumflex
+                                           {0x00, 0x02, 0x01, 0x02, 0x01},  // tilde
+                                           {0x00, 0x02, 0x00, 0x02, 0x00},  // diaeresis
+                                           {0x00, 0x03, 0x01, 0x03, 0x00},  // ring
+                                           {0x00, 0x02, 0x02, 0x02, 0x00},  // macron
+                                           {0x01, 0x02, 0x02, 0x02, 0x01},  // breve
+                                           {0x00, 0x01, 0x02, 0x01, 0x00},  // caron
+                                           {0x00, 0x00, 0x02, 0x00, 0x00},  // dot
+                                           {0x02, 0x01, 0x00, 0x02, 0x01},  // double acute
+                                           {0x00, 0x00, 0x80, 0x80, 0x00},  // cedilla
+                                           {0x00, 0x00, 0x00, 0x80, 0x80},  // ogonek
+};
+
+/*
+ * Latin-1 Supplement and Latin Extended-A, indexed by code point: glyph code
+ * and accent. Capitals have no room for an accent and are drawn plain.
+ */
+#define FONT_5X7_LATIN_FIRST      0x00A0
+#define FONT_5X7_LATIN_LAST       0x017F
+
+const unsigned char font_5x7_latin[FONT_5X7_LATIN_LAST - FONT_5X7_LATIN_FIRST + 1][2] = {
+    {' ',                     FONT_5X7_MARK_NONE        }, // U+00A0 no-break space
+    {FONT_5X7_EXCLAM_INV,     FONT_5X7_MARK_NONE        }, // U+00A1 inverted exclamation mark
+    {FONT_5X7_CENT,           FONT_5X7_MARK_NONE        }, // U+00A2 cent sign
+    {FONT_5X7_POUND,          FONT_5X7_MARK_NONE        }, // U+00A3 pound sign
+    {FONT_5X7_FALLBACK,       FONT_5X7_MARK_NONE        }, // U+00A4 currency sign
+    {'Y',                     FONT_5X7_MARK_NONE        }, // U+00A5 yen sign
+    {'|',                     FONT_5X7_MARK_NONE        }, // U+00A6 broken bar
+    {FONT_5X7_SECTION,        FONT_5X7_MARK_NONE        }, // U+00A7 section sign
+    {'"',                     FONT_5X7_MARK_NONE        }, // U+00A8 diaeresis
+    {FONT_5X7_COPYRIGHT,      FONT_5X7_MARK_NONE        }, // U+00A9 copyright sign
+    {'a',                     FONT_5X7_MARK_NONE        }, // U+00AA feminine ordinal indicator
+    {FONT_5X7_GUILLEMET_L,    FONT_5X7_MARK_NONE        }, // U+00AB left-pointing double angle quotation mark
+    {FONT_5X7_NOT,            FONT_5X7_MARK_NONE        }, // U+00AC not sign
+    {'-',                     FONT_5X7_MARK_NONE        }, // U+00AD soft hyphen
+    {FONT_5X7_REGISTERED,     FONT_5X7_MARK_NONE        }, // U+00AE registered sign
+    {'-',                     FONT_5X7_MARK_NONE        }, // U+00AF macron
+    {FONT_5X7_DEGREE,         FONT_5X7_MARK_NONE        }, // U+00B0 degree sign
+    {FONT_5X7_PLUS_MINUS,     FONT_5X7_MARK_NONE        }, // U+00B1 plus-minus sign
+    {'2',                     FONT_5X7_MARK_NONE        }, // U+00B2 superscript two
+    {'3',                     FONT_5X7_MARK_NONE        }, // U+00B3 superscript three
+    {'\'',                    FONT_5X7_MARK_NONE        }, // U+00B4 acute accent
+    {FONT_5X7_MICRO,          FONT_5X7_MARK_NONE        }, // U+00B5 micro sign
+    {FONT_5X7_FALLBACK,       FONT_5X7_MARK_NONE        }, // U+00B6 pilcrow sign
+    {'.',                     FONT_5X7_MARK_NONE        }, // U+00B7 middle dot
+    {',',                     FONT_5X7_MARK_NONE        }, // U+00B8 cedilla
+    {'1',                     FONT_5X7_MARK_NONE        }, // U+00B9 superscript one
+    {'o',                     FONT_5X7_MARK_NONE        }, // U+00BA masculine ordinal indicator
+    {FONT_5X7_GUILLEMET_R,    FONT_5X7_MARK_NONE        }, // U+00BB right-pointing double angle quotation mark
+    {FONT_5X7_FALLBACK,       FONT_5X7_MARK_NONE        }, // U+00BC vulgar fraction one quarter
+    {FONT_5X7_FALLBACK,       FONT_5X7_MARK_NONE        }, // U+00BD vulgar fraction one half
+    {FONT_5X7_FALLBACK,       FONT_5X7_MARK_NONE        }, // U+00BE vulgar fraction three quarters
+    {FONT_5X7_QUESTION_INV,   FONT_5X7_MARK_NONE        }, // U+00BF inverted question mark
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+00C0 latin capital letter a with grave
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+00C1 latin capital letter a with acute
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+00C2 latin capital letter a with circumflex
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+00C3 latin capital letter a with tilde
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+00C4 latin capital letter a with diaeresis
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+00C5 latin capital letter a with ring above
+    {FONT_5X7_AE,             FONT_5X7_MARK_NONE        }, // U+00C6 latin capital letter ae
+    {'C',                     FONT_5X7_MARK_NONE        }, // U+00C7 latin capital letter c with cedilla
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+00C8 latin capital letter e with grave
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+00C9 latin capital letter e with acute
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+00CA latin capital letter e with circumflex
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+00CB latin capital letter e with diaeresis
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+00CC latin capital letter i with grave
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+00CD latin capital letter i with acute
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+00CE latin capital letter i with circumflex
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+00CF latin capital letter i with diaeresis
+    {'D',                     FONT_5X7_MARK_NONE        }, // U+00D0 latin capital letter eth
+    {'N',                     FONT_5X7_MARK_NONE        }, // U+00D1 latin capital letter n with tilde
+    {'O',                     FONT_5X7_MARK_NONE        }, // U+00D2 latin capital letter o with grave
+    {'O',                     FONT_5X7_MARK_NONE        }, // U+00D3 latin capital letter o with acute
+    {'O',                     FONT_5X7_MARK_NONE        }, // U+00D4 latin capital letter o with circumflex
+    {'O',                     FONT_5X7_MARK_NONE        }, // U+00D5 latin capital letter o with tilde
+    {'O',                     FONT_5X7_MARK_NONE        }, // U+00D6 latin capital letter o with diaeresis
+    {FONT_5X7_MULTIPLY,       FONT_5X7_MARK_NONE        }, // U+00D7 multiplication sign
+    {FONT_5X7_O_STROKE,       FONT_5X7_MARK_NONE        }, // U+00D8 latin capital letter o with stroke
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+00D9 latin capital letter u with grave
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+00DA latin capital letter u with acute
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+00DB latin capital letter u with circumflex
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+00DC latin capital letter u with diaeresis
+    {'Y',                     FONT_5X7_MARK_NONE        }, // U+00DD latin capital letter y with acute
+    {'P',                     FONT_5X7_MARK_NONE        }, // U+00DE latin capital letter thorn
+    {FONT_5X7_SHARP_S,        FONT_5X7_MARK_NONE        }, // U+00DF latin small letter sharp s
+    {'a',                     FONT_5X7_MARK_GRAVE       }, // U+00E0 latin small letter a with grave
+    {'a',                     FONT_5X7_MARK_ACUTE       }, // U+00E1 latin small letter a with acute
+    {'a',                     FONT_5X7_MARK_CIRCUMFLEX  }, // U+00E2 latin small letter a with circumflex
+    {'a',                     FONT_5X7_MARK_TILDE       }, // U+00E3 latin small letter a with tilde
+    {'a',                     FONT_5X7_MARK_DIAERESIS   }, // U+00E4 latin small letter a with diaeresis
+    {'a',                     FONT_5X7_MARK_RING        }, // U+00E5 latin small letter a with ring above
+    {FONT_5X7_AE_SMALL,       FONT_5X7_MARK_NONE        }, // U+00E6 latin small letter ae
+    {'c',                     FONT_5X7_MARK_CEDILLA     }, // U+00E7 latin small letter c with cedilla
+    {'e',                     FONT_5X7_MARK_GRAVE       }, // U+00E8 latin small letter e with grave
+    {'e',                     FONT_5X7_MARK_ACUTE       }, // U+00E9 latin small letter e with acute
+    {'e',                     FONT_5X7_MARK_CIRCUMFLEX  }, // U+00EA latin small letter e with circumflex
+    {'e',                     FONT_5X7_MARK_DIAERESIS   }, // U+00EB latin small letter e with diaeresis
+    {FONT_5X7_DOTLESS_I,      FONT_5X7_MARK_GRAVE       }, // U+00EC latin small letter i with grave
+    {FONT_5X7_DOTLESS_I,      FONT_5X7_MARK_ACUTE       }, // U+00ED latin small letter i with acute
+    {FONT_5X7_DOTLESS_I,      FONT_5X7_MARK_CIRCUMFLEX  }, // U+00EE latin small letter i with circumflex
+    {FONT_5X7_DOTLESS_I,      FONT_5X7_MARK_DIAERESIS   }, // U+00EF latin small letter i with diaeresis
+    {'d',                     FONT_5X7_MARK_NONE        }, // U+00F0 latin small letter eth
+    {'n',                     FONT_5X7_MARK_TILDE       }, // U+00F1 latin small letter n with tilde
+    {'o',                     FONT_5X7_MARK_GRAVE       }, // U+00F2 latin small letter o with grave
+    {'o',                     FONT_5X7_MARK_ACUTE       }, // U+00F3 latin small letter o with acute
+    {'o',                     FONT_5X7_MARK_CIRCUMFLEX  }, // U+00F4 latin small letter o with circumflex
+    {'o',                     FONT_5X7_MARK_TILDE       }, // U+00F5 latin small letter o with tilde
+    {'o',                     FONT_5X7_MARK_DIAERESIS   }, // U+00F6 latin small letter o with diaeresis
+    {FONT_5X7_DIVIDE,         FONT_5X7_MARK_NONE        }, // U+00F7 division sign
+    {FONT_5X7_O_STROKE_SMALL, FONT_5X7_MARK_NONE        }, // U+00F8 latin small letter o with stroke
+    {'u',                     FONT_5X7_MARK_GRAVE       }, // U+00F9 latin small letter u with grave
+    {'u',                     FONT_5X7_MARK_ACUTE       }, // U+00FA latin small letter u with acute
+    {'u',                     FONT_5X7_MARK_CIRCUMFLEX  }, // U+00FB latin small letter u with circumflex
+    {'u',                     FONT_5X7_MARK_DIAERESIS   }, // U+00FC latin small letter u with diaeresis
+    {'y',                     FONT_5X7_MARK_ACUTE       }, // U+00FD latin small letter y with acute
+    {'p',                     FONT_5X7_MARK_NONE        }, // U+00FE latin small letter thorn
+    {'y',                     FONT_5X7_MARK_DIAERESIS   }, // U+00FF latin small letter y with diaeresis
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+0100 latin capital letter a with macron
+    {'a',                     FONT_5X7_MARK_MACRON      }, // U+0101 latin small letter a with macron
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+0102 latin capital letter a with breve
+    {'a',                     FONT_5X7_MARK_BREVE       }, // U+0103 latin small letter a with breve
+    {'A',                     FONT_5X7_MARK_NONE        }, // U+0104 latin capital letter a with ogonek
+    {'a',                     FONT_5X7_MARK_OGONEK      }, // U+0105 latin small letter a with ogonek
+    {'C',                     FONT_5X7_MARK_NONE        }, // U+0106 latin capital letter c with acute
+    {'c',                     FONT_5X7_MARK_ACUTE       }, // U+0107 latin small letter c with acute
+    {'C',                     FONT_5X7_MARK_NONE        }, // U+0108 latin capital letter c with circumflex
+    {'c',                     FONT_5X7_MARK_CIRCUMFLEX  }, // U+0109 latin small letter c with circumflex
+    {'C',                     FONT_5X7_MARK_NONE        }, // U+010A latin capital letter c with dot above
+    {'c',                     FONT_5X7_MARK_DOT         }, // U+010B latin small letter c with dot above
+    {'C',                     FONT_5X7_MARK_NONE        }, // U+010C latin capital letter c with caron
+    {'c',                     FONT_5X7_MARK_CARON       }, // U+010D latin small letter c with caron
+    {'D',                     FONT_5X7_MARK_NONE        }, // U+010E latin capital letter d with caron
+    {'d',                     FONT_5X7_MARK_NONE        }, // U+010F latin small letter d with caron
+    {'D',                     FONT_5X7_MARK_NONE        }, // U+0110 latin capital letter d with stroke
+    {'d',                     FONT_5X7_MARK_NONE        }, // U+0111 latin small letter d with stroke
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+0112 latin capital letter e with macron
+    {'e',                     FONT_5X7_MARK_MACRON      }, // U+0113 latin small letter e with macron
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+0114 latin capital letter e with breve
+    {'e',                     FONT_5X7_MARK_BREVE       }, // U+0115 latin small letter e with breve
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+0116 latin capital letter e with dot above
+    {'e',                     FONT_5X7_MARK_DOT         }, // U+0117 latin small letter e with dot above
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+0118 latin capital letter e with ogonek
+    {'e',                     FONT_5X7_MARK_OGONEK      }, // U+0119 latin small letter e with ogonek
+    {'E',                     FONT_5X7_MARK_NONE        }, // U+011A latin capital letter e with caron
+    {'e',                     FONT_5X7_MARK_CARON       }, // U+011B latin small letter e with caron
+    {'G',                     FONT_5X7_MARK_NONE        }, // U+011C latin capital letter g with circumflex
+    {'g',                     FONT_5X7_MARK_NONE        }, // U+011D latin small letter g with circumflex
+    {'G',                     FONT_5X7_MARK_NONE        }, // U+011E latin capital letter g with breve
+    {'g',                     FONT_5X7_MARK_NONE        }, // U+011F latin small letter g with breve
+    {'G',                     FONT_5X7_MARK_NONE        }, // U+0120 latin capital letter g with dot above
+    {'g',                     FONT_5X7_MARK_NONE        }, // U+0121 latin small letter g with dot above
+    {'G',                     FONT_5X7_MARK_NONE        }, // U+0122 latin capital letter g with cedilla
+    {'g',                     FONT_5X7_MARK_CEDILLA     }, // U+0123 latin small letter g with cedilla
+    {'H',                     FONT_5X7_MARK_NONE        }, // U+0124 latin capital letter h with circumflex
+    {'h',                     FONT_5X7_MARK_NONE        }, // U+0125 latin small letter h with circumflex
+    {'H',                     FONT_5X7_MARK_NONE        }, // U+0126 latin capital letter h with stroke
+    {'h',                     FONT_5X7_MARK_NONE        }, // U+0127 latin small letter h with stroke
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+0128 latin capital letter i with tilde
+    {FONT_5X7_DOTLESS_I,      FONT_5X7_MARK_TILDE       }, // U+0129 latin small letter i with tilde
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+012A latin capital letter i with macron
+    {FONT_5X7_DOTLESS_I,      FONT_5X7_MARK_MACRON      }, // U+012B latin small letter i with macron
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+012C latin capital letter i with breve
+    {FONT_5X7_DOTLESS_I,      FONT_5X7_MARK_BREVE       }, // U+012D latin small letter i with breve
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+012E latin capital letter i with ogonek
+    {'i',                     FONT_5X7_MARK_OGONEK      }, // U+012F latin small letter i with ogonek
+    {'I',                     FONT_5X7_MARK_NONE        }, // U+0130 latin capital letter i with dot above
+    {FONT_5X7_DOTLESS_I,      FONT_5X7_MARK_NONE        }, // U+0131 latin small letter dotless i
+    {'J',                     FONT_5X7_MARK_NONE        }, // U+0132 latin capital ligature ij
+    {'j',                     FONT_5X7_MARK_NONE        }, // U+0133 latin small ligature ij
+    {'J',                     FONT_5X7_MARK_NONE        }, // U+0134 latin capital letter j with circumflex
+    {'j',                     FONT_5X7_MARK_NONE        }, // U+0135 latin small letter j with circumflex
+    {'K',                     FONT_5X7_MARK_NONE        }, // U+0136 latin capital letter k with cedilla
+    {'k',                     FONT_5X7_MARK_CEDILLA     }, // U+0137 latin small letter k with cedilla
+    {'k',                     FONT_5X7_MARK_NONE        }, // U+0138 latin small letter kra
+    {'L',                     FONT_5X7_MARK_NONE        }, // U+0139 latin capital letter l with acute
+    {'l',                     FONT_5X7_MARK_NONE        }, // U+013A latin small letter l with acute
+    {'L',                     FONT_5X7_MARK_NONE        }, // U+013B latin capital letter l with cedilla
+    {'l',                     FONT_5X7_MARK_CEDILLA     }, // U+013C latin small letter l with cedilla
+    {'L',                     FONT_5X7_MARK_NONE        }, // U+013D latin capital letter l with caron
+    {'l',                     FONT_5X7_MARK_NONE        }, // U+013E latin small letter l with caron
+    {'L',                     FONT_5X7_MARK_NONE        }, // U+013F latin capital letter l with middle dot
+    {'l',                     FONT_5X7_MARK_NONE        }, // U+0140 latin small letter l with middle dot
+    {'L',                     FONT_5X7_MARK_NONE        }, // U+0141 latin capital letter l with stroke
+    {'l',                     FONT_5X7_MARK_NONE        }, // U+0142 latin small letter l with stroke
+    {'N',                     FONT_5X7_MARK_NONE        }, // U+0143 latin capital letter n with acute
+    {'n',                     FONT_5X7_MARK_ACUTE       }, // U+0144 latin small letter n with acute
+    {'N',                     FONT_5X7_MARK_NONE        }, // U+0145 latin capital letter n with cedilla
+    {'n',                     FONT_5X7_MARK_CEDILLA     }, // U+0146 latin small letter n with cedilla
+    {'N',                     FONT_5X7_MARK_NONE        }, // U+0147 latin capital letter n with caron
+    {'n',                     FONT_5X7_MARK_CARON       }, // U+0148 latin small letter n with caron
+    {'n',                     FONT_5X7_MARK_NONE        }, // U+0149 latin small letter n preceded by apostrophe
+    {'N',                     FONT_5X7_MARK_NONE        }, // U+014A latin capital letter eng
+    {'n',                     FONT_5X7_MARK_NONE        }, // U+014B latin small letter eng
+    {'O',                     FONT_5X7_MARK_NONE        }, // U+014C latin capital letter o with macron
+    {'o',                     FONT_5X7_MARK_MACRON      }, // U+014D latin small letter o with macron
+    {'O',                     FONT_5X7_MARK_NONE        }, // U+014E latin capital letter o with breve
+    {'o',                     FONT_5X7_MARK_BREVE       }, // U+014F latin small letter o with breve
+    {'O',                     FONT_5X7_MARK_NONE        }, // U+0150 latin capital letter o with double acute
+    {'o',                     FONT_5X7_MARK_DOUBLE_ACUTE}, // U+0151 latin small letter o with double acute
+    {FONT_5X7_OE,             FONT_5X7_MARK_NONE        }, // U+0152 latin capital ligature oe
+    {FONT_5X7_OE_SMALL,       FONT_5X7_MARK_NONE        }, // U+0153 latin small ligature oe
+    {'R',                     FONT_5X7_MARK_NONE        }, // U+0154 latin capital letter r with acute
+    {'r',                     FONT_5X7_MARK_ACUTE       }, // U+0155 latin small letter r with acute
+    {'R',                     FONT_5X7_MARK_NONE        }, // U+0156 latin capital letter r with cedilla
+    {'r',                     FONT_5X7_MARK_CEDILLA     }, // U+0157 latin small letter r with cedilla
+    {'R',                     FONT_5X7_MARK_NONE        }, // U+0158 latin capital letter r with caron
+    {'r',                     FONT_5X7_MARK_CARON       }, // U+0159 latin small letter r with caron
+    {'S',                     FONT_5X7_MARK_NONE        }, // U+015A latin capital letter s with acute
+    {'s',                     FONT_5X7_MARK_ACUTE       }, // U+015B latin small letter s with acute
+    {'S',                     FONT_5X7_MARK_NONE        }, // U+015C latin capital letter s with circumflex
+    {'s',                     FONT_5X7_MARK_CIRCUMFLEX  }, // U+015D latin small letter s with circumflex
+    {'S',                     FONT_5X7_MARK_NONE        }, // U+015E latin capital letter s with cedilla
+    {'s',                     FONT_5X7_MARK_CEDILLA     }, // U+015F latin small letter s with cedilla
+    {'S',                     FONT_5X7_MARK_NONE        }, // U+0160 latin capital letter s with caron
+    {'s',                     FONT_5X7_MARK_CARON       }, // U+0161 latin small letter s with caron
+    {'T',                     FONT_5X7_MARK_NONE        }, // U+0162 latin capital letter t with cedilla
+    {'t',                     FONT_5X7_MARK_CEDILLA     }, // U+0163 latin small letter t with cedilla
+    {'T',                     FONT_5X7_MARK_NONE        }, // U+0164 latin capital letter t with caron
+    {'t',                     FONT_5X7_MARK_NONE        }, // U+0165 latin small letter t with caron
+    {'T',                     FONT_5X7_MARK_NONE        }, // U+0166 latin capital letter t with stroke
+    {'t',                     FONT_5X7_MARK_NONE        }, // U+0167 latin small letter t with stroke
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+0168 latin capital letter u with tilde
+    {'u',                     FONT_5X7_MARK_TILDE       }, // U+0169 latin small letter u with tilde
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+016A latin capital letter u with macron
+    {'u',                     FONT_5X7_MARK_MACRON      }, // U+016B latin small letter u with macron
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+016C latin capital letter u with breve
+    {'u',                     FONT_5X7_MARK_BREVE       }, // U+016D latin small letter u with breve
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+016E latin capital letter u with ring above
+    {'u',                     FONT_5X7_MARK_RING        }, // U+016F latin small letter u with ring above
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+0170 latin capital letter u with double acute
+    {'u',                     FONT_5X7_MARK_DOUBLE_ACUTE}, // U+0171 latin small letter u with double acute
+    {'U',                     FONT_5X7_MARK_NONE        }, // U+0172 latin capital letter u with ogonek
+    {'u',                     FONT_5X7_MARK_OGONEK      }, // U+0173 latin small letter u with ogonek
+    {'W',                     FONT_5X7_MARK_NONE        }, // U+0174 latin capital letter w with circumflex
+    {'w',                     FONT_5X7_MARK_CIRCUMFLEX  }, // U+0175 latin small letter w with circumflex
+    {'Y',                     FONT_5X7_MARK_NONE        }, // U+0176 latin capital letter y with circumflex
+    {'y',                     FONT_5X7_MARK_CIRCUMFLEX  }, // U+0177 latin small letter y with circumflex
+    {'Y',                     FONT_5X7_MARK_NONE        }, // U+0178 latin capital letter y with diaeresis
+    {'Z',                     FONT_5X7_MARK_NONE        }, // U+0179 latin capital letter z with acute
+    {'z',                     FONT_5X7_MARK_ACUTE       }, // U+017A latin small letter z with acute
+    {'Z',                     FONT_5X7_MARK_NONE        }, // U+017B latin capital letter z with dot above
+    {'z',                     FONT_5X7_MARK_DOT         }, // U+017C latin small letter z with dot above
+    {'Z',                     FONT_5X7_MARK_NONE        }, // U+017D latin capital letter z with caron
+    {'z',                     FONT_5X7_MARK_CARON       }, // U+017E latin small letter z with caron
+    {'f',                     FONT_5X7_MARK_NONE        }  // U+017F latin small letter long s
+};
+
+/*
+ * Other code points with a glyph, sorted. Anything not found here is drawn as
+ * FONT_5X7_FALLBACK.
+ */
+typedef struct
+{
+  uint32_t first;
+  uint32_t last;
+  unsigned char glyph;
+} font_5x7_range_t;
+
+const font_5x7_range_t font_5x7_ranges[] = {{0x002BC, 0x002BC, '\''},                // modifier apostrophe
+                                            {0x00300, 0x0036F, FONT_5X7_NONE},       // combining accents
+                                            {0x02000, 0x0200A, ' '},                 // spaces
+                                            {0x0200B, 0x0200F, FONT_5X7_NONE},       // zero width, direction marks
+                                            {0x02010, 0x02015, '-'},                 // hyphens and dashes
+                                            {0x02018, 0x0201B, '\''},                // single quotes
+                                            {0x0201C, 0x0201F, '"'},                 // double quotes
+                                            {0x02022, 0x02022, FONT_5X7_BULLET},
+                                            {0x02024, 0x02024, '.'},
+                                            {0x02026, 0x02026, FONT_5X7_ELLIPSIS},
+                                            {0x0202F, 0x0202F, ' '},                 // narrow no-break space
+                                            {0x02032, 0x02032, '\''},                // prime
+                                            {0x02033, 0x02033, '"'},                 // double prime
+                                            {0x02039, 0x02039, '<'},
+                                            {0x0203A, 0x0203A, '>'},
+                                            {0x02060, 0x02064, FONT_5X7_NONE},       // word joiner, invisible operators
+                                            {0x020AC, 0x020AC, FONT_5X7_EURO},
+                                            {0x0FE00, 0x0FE0F, FONT_5X7_NONE},       // variation selectors
+                                            {0x0FEFF, 0x0FEFF, FONT_5X7_NONE},       // byte order mark
+                                            {0x1F3FB, 0x1F3FF, FONT_5X7_NONE},       // emoji skin tones
+                                            {0xE0020, 0xE007F, FONT_5X7_NONE},       // emoji tags
 };
 
 #endif /* FONT_5X7_H_ */
@@ -75,6 +75,10 @@
 #define SET_VCOM_DESEL      0xdb
 #define SET_CHARGE_PUMP     0x8d
 
+// Text
+#define GLYPH_WIDTH         6       // 5 pixel glyph and a space
+#define UTF8_INVALID        0xFFFD  // replacement character, for malformed UTF-8
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -107,6 +111,11 @@ void ssd1306_clear_buffer(uint8_t *buffer, int size);
 void ssd1306_send_buffer(uint8_t *buffer, int size);
 void ssd1306_draw_pixel(uint8_t x, uint8_t y, bool erase);
 void ssd1306_set_position(uint8_t, uint8_t);
+static uint32_t ssd1306_utf8_next(const char **ppText);
+static uint8_t ssd1306_glyph_lookup(uint32_t codepoint, uint8_t *pMark);
+static void ssd1306_draw_glyph(uint8_t glyph, uint8_t mark, uint8_t x, uint8_t y, bool erase);
+static uint8_t ssd1306_text_length(const char *text);
+static const char *ssd1306_text_skip(const char *text, uint8_t count);
 
 /*********************************************************************
  * @fn      ssd1306_command()
@@ -224,6 +233,195 @@ void ssd1306_set_position(uint8_t column, uint8_t page) {
 * PUBLIC FUNCTIONS
 */
 
+/*********************************************************************
+ * @fn      ssd1306_utf8_next()
+ *
+ * @brief   Decodes the next UTF-8 character and moves past it. Malformed
+ *          sequences, overlong forms and surrogates give UTF8_INVALID and
+ *          skip only the bytes read, never past the terminator.
+ *
+ * @param ppText pointer to the string position, must not be at the terminator.
+ *
+ * @return the code point.
+ *
+ */
+static uint32_t ssd1306_utf8_next(const char **ppText) {
+    static const uint32_t minCodepoint[4] = {0x00, 0x80, 0x800, 0x10000};
+    const uint8_t *p = (const uint8_t *)*ppText;
+    uint32_t codepoint;
+    uint8_t extra, i;
+
+    if (p[0] < 0x80) {
+        codepoint = p[0];
+        extra = 0;
+    } else if ((p[0] & 0xE0) == 0xC0) {
+        codepoint = p[0] & 0x1F;
+        extra = 1;
+    } else if ((p[0] & 0xF0) == 0xE0) {
+        codepoint = p[0] & 0x0F;
+        extra = 2;
+    } else if ((p[0] & 0xF8) == 0xF0) {
+        codepoint = p[0] & 0x07;
+        extra = 3;
+    } else {
+        (*ppText)++;
+        return UTF8_INVALID;
+    }
+
+    for (i = 1; i <= extra; i++) {
+        // A terminator isn't a continuation byte, so this stops there too.
+        if ((p[i] & 0xC0) != 0x80) {
+            *ppText += i;
+            return UTF8_INVALID;
+        }
+        codepoint = (codepoint << 6) | (p[i] & 0x3F);
+    }
+    *ppText += extra + 1;
+
+    if ((codepoint < minCodepoint[extra]) || (codepoint > 0x10FFFF) ||
+        ((codepoint >= 0xD800) && (codepoint <= 0xDFFF))) {
+        return UTF8_INVALID;
+    }
+
+    return codepoint;
+}
+
+/*********************************************************************
+ * @fn      ssd1306_glyph_lookup()
+ *
+ * @brief   Finds the glyph for a code point. ASCII and the Latin block are
+ *          direct table lookups, other code points a binary search of the
+ *          sorted font_5x7_ranges.
+ *
+ * @param codepoint the character.
+ * @param pMark returns the accent to draw over the glyph.
+ *
+ * @return glyph code, FONT_5X7_NONE for zero width characters.
+ *
+ */
+static uint8_t ssd1306_glyph_lookup(uint32_t codepoint, uint8_t *pMark) {
+    uint8_t low, high, mid;
+
+    *pMark = FONT_5X7_MARK_NONE;
+
+    if (codepoint < ' ') {
+        // Tabs and line breaks in message bodies.
+        return ' ';
+    }
+    if (codepoint < 0x7F) {
+        return codepoint;
+    }
+    if (codepoint < FONT_5X7_LATIN_FIRST) {
+        // DEL and C1 controls.
+        return FONT_5X7_NONE;
+    }
+    if (codepoint <= FONT_5X7_LATIN_LAST) {
+        *pMark = font_5x7_latin[codepoint - FONT_5X7_LATIN_FIRST][1];
+        return font_5x7_latin[codepoint - FONT_5X7_LATIN_FIRST][0];
+    }
+
+    low = 0;
+    high = sizeof(font_5x7_ranges) / sizeof(font_5x7_ranges[0]);
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (codepoint < font_5x7_ranges[mid].first) {
+            high = mid;
+        } else if (codepoint > font_5x7_ranges[mid].last) {
+            low = mid + 1;
+        } else {
+            return font_5x7_ranges[mid].glyph;
+        }
+    }
+
+    return FONT_5X7_FALLBACK;
+}
+
+/*********************************************************************
+ * @fn      ssd1306_draw_glyph()
+ *
+ * @brief   Adds a glyph and its accent to the buffer.
+ *
+ * @param glyph glyph code from ssd1306_glyph_lookup.
+ * @param mark accent to draw over the glyph.
+ * @param x position in the x-plane.
+ * @param y poisition in the y-plane.
+ * @param erase represents wether to erase (true) or write (false) the glyph.
+ *
+ * @return None.
+ *
+ */
+static void ssd1306_draw_glyph(uint8_t glyph, uint8_t mark, uint8_t x, uint8_t y, bool erase) {
+    const unsigned char *columns;
+    uint8_t b_x, b_y, dataByte;
+
+    if (glyph >= FONT_5X7_EXTRA) {
+        columns = font_5x7_extra[glyph - FONT_5X7_EXTRA];
+    } else {
+        columns = font_5x7[glyph - ' '];
+    }
+
+    for(b_x = 0; b_x<=4; b_x++) {
+        dataByte = columns[b_x] | font_5x7_marks[mark][b_x];
+        for(b_y=0; b_y<=8; b_y++){
+            if(((dataByte & 0x01) == 0x01) && !erase) {
+                ssd1306_draw_pixel(x + b_x, y + (b_y), false);
+            } else {
+                ssd1306_draw_pixel(x + b_x, y + (b_y), true);
+            }
+            dataByte>>=1; // Shift.
+        }
+    }
+}
+
+/*********************************************************************
+ * @fn      ssd1306_text_length()
+ *
+ * @brief   Counts the glyphs a UTF-8 string takes on the display.
+ *
+ * @param text pointer to the string.
+ *
+ * @return number of glyphs.
+ *
+ */
+static uint8_t ssd1306_text_length(const char *text) {
+    uint8_t length = 0;
+    uint8_t mark;
+
+    while (*text != '\0') {
+        if (ssd1306_glyph_lookup(ssd1306_utf8_next(&text), &mark) != FONT_5X7_NONE) {
+            length++;
+        }
+    }
+
+    return length;
+}
+
+/*********************************************************************
+ * @fn      ssd1306_text_skip()
+ *
+ * @brief   Moves past a number of glyphs of a UTF-8 string.
+ *
+ * @param text pointer to the string.
+ * @param count glyphs to move past.
+ *
+ * @return pointer to the character after them, or to the terminator.
+ *
+ */
+static const char *ssd1306_text_skip(const char *text, uint8_t count) {
+    const char *next;
+    uint8_t mark;
+
+    while ((*text != '\0') && (count > 0)) {
+        next = text;
+        if (ssd1306_glyph_lookup(ssd1306_utf8_next(&next), &mark) != FONT_5X7_NONE) {
+            count--;
+        }
+        text = next;
+    }
+
+    return text;
+}
+
 /*********************************************************************
  * @fn      ssd1306_init()
  *
@@ -331,10 +529,56 @@ void ssd1306_init(void) {//Init Sequence
  */
 void ssd1306_update( void ) {
     Semaphore_pend(semHandle, BIOS_WAIT_FOREVER);
+    ssd1306_set_position(0, 0); // A region update may have narrowed the window.
     ssd1306_send_buffer(ssd1306_display_buffer, sizeof(ssd1306_display_buffer));
     Semaphore_post(semHandle);
 }
 
+/*********************************************************************
+ * @fn      ssd1306_update_region()
+ *
+ * @brief   Sends only a rectangular part of the display buffer, one page at a time.
+ *          Costs 12 command bytes plus width + 1 data bytes per page instead of the
+ *          481 bytes of a full update.
+ *
+ * @param x first column of the region.
+ * @param width number of columns in the region.
+ * @param page first page (8 pixel row) of the region.
+ * @param pages number of pages in the region.
+ *
+ * @return  None.
+ *
+ */
+void ssd1306_update_region(uint8_t x, uint8_t width, uint8_t page, uint8_t pages) {
+    uint8_t  p;
+    uint8_t  saved;
+    uint16_t start;
+
+    if ((x + width > DISPLAY_WIDTH) || (page + pages > 5) || (width == 0)) {
+        return;
+    }
+
+    Semaphore_pend(semHandle, BIOS_WAIT_FOREVER);
+    for (p = page; p < page + pages; p++) {
+        ssd1306_command(SET_COL_ADDR);
+        ssd1306_command(x);
+        ssd1306_command(x + width - 1);
+
+        ssd1306_command(SET_PAGE_ADDR);
+        ssd1306_command(p);
+        ssd1306_command(p);
+
+        // Borrow the byte in front of the slice for the data control byte so
+        // the slice can be sent straight out of the display buffer.
+        start = x + (p * DISPLAY_WIDTH);
+        saved = ssd1306_display_buffer[start];
+        ssd1306_display_buffer[start] = 0x40;
+        ssd1306_send_buffer(&ssd1306_display_buffer[start], width + 1);
+        ssd1306_display_buffer[start] = saved;
+    }
+    Semaphore_post(semHandle);
+}
+
 /*********************************************************************
  * @fn      ssd1306_clear()
  *
@@ -355,7 +599,7 @@ void ssd1306_clear( void ) {
  *
  * @brief   Adds plain text to the buffer to be displayed.
  *
- * @param text pointer to the string to be displayed.
+ * @param text pointer to the UTF-8 string to be displayed.
  * @param x position in the x-plane to display the text.
  * @param y poisition in the y-plane to display the text.
  * @param erase represents wether to erase (true) or write (false) the text.
@@ -363,28 +607,46 @@ void ssd1306_clear( void ) {
  * @return None.
  *
  */
-void ssd1306_display_text(char *text, uint8_t x, uint8_t y, bool erase) {
+void ssd1306_display_text(const char *text, uint8_t x, uint8_t y, bool erase) {
+    ssd1306_display_text_clipped(text, 0xFF, x, y, erase);
+}
+
+/*********************************************************************
+ * @fn      ssd1306_display_text_clipped()
+ *
+ * @brief   Adds plain text to the buffer to be displayed, up to a number of
+ *          glyphs.
+ *
+ * @param text pointer to the UTF-8 string to be displayed.
+ * @param maxGlyphs most glyphs to display.
+ * @param x position in the x-plane to display the text.
+ * @param y poisition in the y-plane to display the text.
+ * @param erase represents wether to erase (true) or write (false) the text.
+ *
+ * @return pointer to the rest of the string, or to the terminator.
+ *
+ */
+const char *ssd1306_display_text_clipped(const char *text, uint8_t maxGlyphs, uint8_t x, uint8_t y, bool erase) {
+    const char *next;
+    uint8_t glyph, mark;
+
     Semaphore_pend(semHandle, BIOS_WAIT_FOREVER);
 
     ssd1306_set_position(0, 0);
-    while (*text != '\0') {
-        uint8_t b_x, b_y, dataByte;
-        for(b_x = 0; b_x<=4; b_x++) {
-            dataByte = font_5x7[*text - ' '][b_x];
-            for(b_y=0; b_y<=8; b_y++){
-                if(((dataByte & 0x01) == 0x01) && !erase) {
-                    ssd1306_draw_pixel(x + b_x, y + (b_y), false);
-                } else {
-                    ssd1306_draw_pixel(x + b_x, y + (b_y), true);
-                }
-                dataByte>>=1; // Shift.
-            }
+    while ((*text != '\0') && (maxGlyphs > 0)) {
+        next = text;
+        glyph = ssd1306_glyph_lookup(ssd1306_utf8_next(&next), &mark);
+        if (glyph != FONT_5X7_NONE) {
+            ssd1306_draw_glyph(glyph, mark, x, y, erase);
+            x += GLYPH_WIDTH;
+            maxGlyphs--;
         }
-        text++;
-        x+=6;
+        text = next;
     }
 
     Semaphore_post(semHandle);
+
+    return text;
 }
 
 /*********************************************************************
@@ -593,11 +855,14 @@ void ssd1306_display_full_notification(uint8_t type, char *text) {
     // center within the available 69 pixels.  :|
     // each character is 6 pixels (+1 for whitespace after character)
     // If the text is 12 characters or greater, drop the 11th character then add an ellipsis.
-    if(strlen(text)>= 12) {
-        text[11] = 0;
+    // Characters are counted as glyphs, a name can have multi-byte UTF-8.
+    uint8_t length = ssd1306_text_length(text);
+    if(length >= 12) {
+        text[ssd1306_text_skip(text, 11) - text] = 0;
+        length = 11;
         needEllipsis = true;
     }
-    double centerPadding = 12 - strlen(text);
+    double centerPadding = 12 - length;
     centerPadding = ((centerPadding/2)*6)+25;
     int space = (int)centerPadding;
     ssd1306_display_text(text, space, CONTACT_NAME_POS_Y, false);
@@ -81,6 +81,9 @@ extern "C"
 
 #define CONTACT_NAME_POS_Y   21
 
+#define ALERT_COUNT_POS_X    87
+#define ALERT_COUNT_POS_Y    9
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -99,8 +102,10 @@ extern "C"
 
 extern void ssd1306_init( void );
 extern void ssd1306_update( void );
+extern void ssd1306_update_region(uint8_t x, uint8_t width, uint8_t page, uint8_t pages);
 extern void ssd1306_clear( void );
-extern void ssd1306_display_text(char *text, uint8_t x, uint8_t y, bool erase);
+extern void ssd1306_display_text(const char *text, uint8_t x, uint8_t y, bool erase);
+extern const char *ssd1306_display_text_clipped(const char *text, uint8_t maxGlyphs, uint8_t x, uint8_t y, bool erase);
 extern void ssd1306_display_number(uint8_t number, uint8_t x, uint8_t y, bool erase);
 extern void ssd1306_display_semicolon( uint8_t x, uint8_t y, bool erase);
 extern void ssd1306_display_pm( uint8_t x, uint8_t y, bool erase);
@@ -41,6 +41,7 @@
  */
 #include <string.h>
 #include <ti/display/Display.h>
+#include <ti/sysbios/hal/Seconds.h>
 
 #include "bcomdef.h"
 #include "OSAL.h"
@@ -51,8 +52,10 @@
 #include "gattservapp.h"
 #include "gapbondmgr.h"
 #include "f91_utils.h"
+#include "f91_link.h"
 
 #include "f91_clock_service.h"
+#include "f91_service.h"
 
 /*********************************************************************
  * MACROS
@@ -62,8 +65,6 @@
  * CONSTANTS
  */
 
-#define SERVAPP_NUM_ATTR_SUPPORTED       13
-
 /*********************************************************************
  * TYPEDEFS
  */
@@ -101,6 +102,12 @@ CONST uint8_t f91_clock_serviceChar4UUID[ATT_UUID_SIZE] =
 {
  F91_BASE_UUID_128(F91_CLOCK_SERVICE_CHAR4_UUID)
 };
+
+// Characteristic 5 UUID: 0xB2F5
+CONST uint8_t f91_clock_serviceChar5UUID[ATT_UUID_SIZE] =
+{
+ F91_BASE_UUID_128(F91_CLOCK_SERVICE_CHAR5_UUID)
+};
 /*********************************************************************
  * LOCAL VARIABLES
  */
@@ -150,108 +157,17 @@ static uint8_t f91ClockServiceChar4 = 0;
 // F91 Characteristic 4 User Description
 static uint8_t f91ClockServiceUserDesp4[8] = "F91 DST";
 
-/*********************************************************************
-* Profile Attributes - Table
-*/
+// F91 Clock Characteristic 5 Properties
+static uint8_t f91ClockServiceChar5Props = GATT_PROP_READ | GATT_PROP_WRITE;
 
-static gattAttribute_t f91_clock_serviceAttrTbl[SERVAPP_NUM_ATTR_SUPPORTED] =
-{
-  // f91_clock_service Service Declaration
-  {
-    { ATT_BT_UUID_SIZE, primaryServiceUUID },
-    GATT_PERMIT_READ,
-    0,
-    (uint8_t *)&f91ClockServiceDecl
-  },
+// Characteristic 5 Value, the alarm table for reads.
+static uint8_t f91ClockServiceChar5[F91_CLOCK_SERVICE_CHAR5_LEN] = {0};
 
-  // Characteristic 1 Declaration
-  {
-    { ATT_BT_UUID_SIZE, characterUUID },
-    GATT_PERMIT_READ,
-    0,
-    &f91ClockServiceChar1Props
-  },
-      // Characteristic Value 1
-      {
-        { ATT_UUID_SIZE, f91_clock_serviceChar1UUID },
-        GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE,
-        0,
-         (uint8_t *)&f91ClockServiceChar1
-      },
-      // Characteristic 1 User Description
-      {
-        { ATT_BT_UUID_SIZE, charUserDescUUID },
-        GATT_PERMIT_READ,
-        0,
-        f91ClockServiceUserDesp1
-      },
-  
-  // Characteristic 2 Declaration
-  {
-    { ATT_BT_UUID_SIZE, characterUUID },
-    GATT_PERMIT_READ,
-    0,
-    &f91ClockServiceChar2Props
-  },
-      // Characteristic Value 2
-      {
-        { ATT_UUID_SIZE, f91_clock_serviceChar2UUID },
-        GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE,
-        0,
-         (uint8_t *)&f91ClockServiceChar2
-      },
-      // Characteristic 2 User Description
-      {
-        { ATT_BT_UUID_SIZE, charUserDescUUID },
-        GATT_PERMIT_READ,
-        0,
-        f91ClockServiceUserDesp2
-      },
-  
-  // Characteristic 3 Declaration
-  {
-    { ATT_BT_UUID_SIZE, characterUUID },
-    GATT_PERMIT_READ,
-    0,
-    &f91ClockServiceChar3Props
-  },
-      // Characteristic Value 3
-      {
-        { ATT_UUID_SIZE, f91_clock_serviceChar3UUID },
-        GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE,
-        0,
-        &f91ClockServiceChar3
-      },
-      // Characteristic 3 User Description
-      {
-        { ATT_BT_UUID_SIZE, charUserDescUUID },
-        GATT_PERMIT_READ,
-        0,
-        f91ClockServiceUserDesp3
-      },
-
-  // Characteristic 4 Declaration
-  {
-    { ATT_BT_UUID_SIZE, characterUUID },
-    GATT_PERMIT_READ,
-    0,
-    &f91ClockServiceChar4Props
-  },
-      // Characteristic Value 4
-      {
-        { ATT_UUID_SIZE, f91_clock_serviceChar4UUID },
-        GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE,
-        0,
-        &f91ClockServiceChar4
-      },
-      // Characteristic 4 User Description
-      {
-        { ATT_BT_UUID_SIZE, charUserDescUUID },
-        GATT_PERMIT_READ,
-        0,
-        f91ClockServiceUserDesp4
-      },
-};
+// Last record written to characteristic 5.
+static uint8_t f91ClockServiceChar5Record[F91_CLOCK_SERVICE_CHAR5_RECORD_LEN] = {0};
+
+// F91 Characteristic 5 User Description
+static uint8_t f91ClockServiceUserDesp5[11] = "F91 Alarms";
 
 /*********************************************************************
  * LOCAL FUNCTIONS
@@ -262,6 +178,43 @@ static bStatus_t f91_clock_service_ReadAttrCB( uint16 connHandle, gattAttribute_
 static bStatus_t f91_clock_service_WriteAttrCB( uint16 connHandle, gattAttribute_t *pAttr,
                                             uint8_t *pValue, uint16 len, uint16 offset,
                                             uint8_t method );
+static bStatus_t f91_clock_service_ReadTime( uint8_t *pValue, uint16_t *pLen, uint16_t offset,
+                                            uint16_t maxLen );
+static bStatus_t f91_clock_service_WriteAlarm( uint8_t *pValue, uint16_t len, uint16_t offset,
+                                            bool *pNotify );
+
+/*********************************************************************
+* Profile Characteristics - Table
+*/
+
+// Indexed by F91_CLOCK_SERVICE_CHARx, the attribute table is built from it.
+static const f91ServiceChar_t f91_clock_serviceChars[] =
+{
+  // Time, read from the RTC
+  { &f91ClockServiceChar1Props, f91_clock_serviceChar1UUID,
+    GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE, f91ClockServiceUserDesp1,
+    (uint8_t *)&f91ClockServiceChar1, NULL, 0, sizeof(uint32_t), 0, NULL,
+    f91_clock_service_ReadTime, NULL },
+  // Time zone
+  { &f91ClockServiceChar2Props, f91_clock_serviceChar2UUID,
+    GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE, f91ClockServiceUserDesp2,
+    (uint8_t *)&f91ClockServiceChar2, NULL, 0, sizeof(uint16_t), 0, NULL, NULL, NULL },
+  // Time mode
+  { &f91ClockServiceChar3Props, f91_clock_serviceChar3UUID,
+    GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE, f91ClockServiceUserDesp3,
+    &f91ClockServiceChar3, NULL, 0, sizeof(uint8_t), 0, NULL, NULL, NULL },
+  // Daylight savings
+  { &f91ClockServiceChar4Props, f91_clock_serviceChar4UUID,
+    GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE, f91ClockServiceUserDesp4,
+    &f91ClockServiceChar4, NULL, 0, sizeof(uint8_t), 0, NULL, NULL, NULL },
+  // Alarms, the table is read past the MTU, records are written one at a time
+  { &f91ClockServiceChar5Props, f91_clock_serviceChar5UUID,
+    GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE, f91ClockServiceUserDesp5,
+    f91ClockServiceChar5, NULL, 0, F91_CLOCK_SERVICE_CHAR5_LEN, F91_SERVICE_LONG, NULL,
+    NULL, f91_clock_service_WriteAlarm },
+};
+
+static f91ServiceIndex_t f91_clock_serviceIndex[sizeof( f91_clock_serviceChars ) / sizeof( f91ServiceChar_t )];
 
 /*********************************************************************
  * PROFILE CALLBACKS
@@ -274,6 +227,15 @@ CONST gattServiceCBs_t f91_clock_serviceCBs =
   NULL                       // Authorization callback function pointer
 };
 
+static f91Service_t f91_clock_service =
+{
+  &f91ClockServiceDecl,
+  f91_clock_serviceChars,
+  sizeof( f91_clock_serviceChars ) / sizeof( f91ServiceChar_t ),
+  f91_clock_serviceIndex,
+  &f91_clock_serviceCBs
+};
+
 /*********************************************************************
 * PUBLIC FUNCTIONS
 */
@@ -285,14 +247,7 @@ CONST gattServiceCBs_t f91_clock_serviceCBs =
  */
 bStatus_t F91_clock_service_AddService(void)
 {
-  uint8_t status;
-  // Register GATT attribute list and CBs with GATT Server App
-  status = GATTServApp_RegisterService( f91_clock_serviceAttrTbl,
-                                        GATT_NUM_ATTRS( f91_clock_serviceAttrTbl ),
-                                        GATT_MAX_ENCRYPT_KEY_SIZE,
-                                        &f91_clock_serviceCBs );
-
-  return ( status );
+  return F91Service_init( &f91_clock_service );
 }
 
 /*
@@ -327,55 +282,7 @@ bStatus_t F91_clock_service_RegisterAppCBs( f91_clock_serviceCBs_t *appCallbacks
  */
 bStatus_t F91_clock_service_SetParameter( uint8_t param, uint16_t len, void *value )
 {
-  bStatus_t ret = SUCCESS;
-
-  switch ( param )
-  {
-    case F91_CLOCK_SERVICE_CHAR1:
-      if ( len == sizeof ( uint32_t ) )
-      {
-        f91ClockServiceChar1 = *((uint32_t*)value);
-      }
-      else
-      {
-        ret = bleInvalidRange;
-      }
-      break;
-    case F91_CLOCK_SERVICE_CHAR2:
-      if ( len == sizeof ( uint16_t ) )
-      {
-        f91ClockServiceChar2 = *((uint16_t*)value);
-      }
-      else
-      {
-        ret = bleInvalidRange;
-      }
-      break;
-    case F91_CLOCK_SERVICE_CHAR3:
-      if ( len == sizeof ( uint8_t ) )
-      {
-        f91ClockServiceChar3 = *((uint8_t*)value);
-      }
-      else
-      {
-        ret = bleInvalidRange;
-      }
-      break;
-    case F91_CLOCK_SERVICE_CHAR4:
-      if ( len == sizeof ( uint8_t ) )
-      {
-        f91ClockServiceChar4 = *((uint8_t*)value);
-      }
-      else
-      {
-        ret = bleInvalidRange;
-      }
-      break;
-    default:
-      ret = INVALIDPARAMETER;
-      break;
-  }
-  return ret;
+  return F91Service_setValue( &f91_clock_service, param, len, value );
 }
 
 
@@ -390,26 +297,14 @@ bStatus_t F91_clock_service_SetParameter( uint8_t param, uint16_t len, void *val
  */
 bStatus_t F91_clock_service_GetParameter( uint8_t param, void *value )
 {
-  bStatus_t ret = SUCCESS;
-  switch ( param )
+  // The last record written, not the table.
+  if ( param == F91_CLOCK_SERVICE_CHAR5 )
   {
-    case F91_CLOCK_SERVICE_CHAR1:
-        *((uint32_t*)value) = f91ClockServiceChar1;
-      break;
-    case F91_CLOCK_SERVICE_CHAR2:
-        *((uint16_t*)value) = f91ClockServiceChar2;
-      break;
-    case F91_CLOCK_SERVICE_CHAR3:
-        *((uint8_t*)value) = f91ClockServiceChar3;
-      break;
-    case F91_CLOCK_SERVICE_CHAR4:
-        *((uint8_t*)value) = f91ClockServiceChar4;
-      break;
-    default:
-      ret = INVALIDPARAMETER;
-      break;
+    memcpy(value, f91ClockServiceChar5Record, F91_CLOCK_SERVICE_CHAR5_RECORD_LEN);
+    return ( SUCCESS );
   }
-  return ret;
+
+  return F91Service_getValue( &f91_clock_service, param, value );
 }
 
 /*********************************************************************
@@ -431,37 +326,58 @@ static bStatus_t f91_clock_service_ReadAttrCB( uint16_t connHandle, gattAttribut
                                        uint8_t *pValue, uint16_t *pLen, uint16_t offset,
                                        uint16_t maxLen, uint8_t method )
 {
-  bStatus_t status = SUCCESS;
+  return F91Service_read( &f91_clock_service, pAttr, pValue, pLen, offset, maxLen );
+}
 
-  // Make sure it's not a blob operation (no attributes in the profile are long)
-  if ( offset > 0 )
-  {
-    return ( ATT_ERR_ATTR_NOT_LONG );
-  }
+/*********************************************************************
+ * @fn      f91_clock_service_ReadTime
+ *
+ * @brief   Read the time. It is not pushed every second, it is read from
+ *          the RTC on demand.
+ *
+ * @param   pValue - pointer to data to be read
+ * @param   pLen - length of data to be read
+ * @param   offset - offset of the first octet to be read, 0
+ * @param   maxLen - maximum length of data to be read
+ *
+ * @return  SUCCESS
+ */
+static bStatus_t f91_clock_service_ReadTime( uint8_t *pValue, uint16_t *pLen, uint16_t offset,
+                                            uint16_t maxLen )
+{
+  f91ClockServiceChar1 = Seconds_get();
+  *pLen = sizeof(uint32_t);
+  memcpy(pValue, &f91ClockServiceChar1, *pLen);
+
+  return ( SUCCESS );
+}
 
-  if ( pAttr->type.len == ATT_UUID_SIZE ) {
-        // 128-bit UUID
-    if (!memcmp(pAttr->type.uuid, f91_clock_serviceChar1UUID, ATT_UUID_SIZE)) {
-      *pLen = sizeof(uint32_t);
-      memcpy(pValue, pAttr->pValue + offset, *pLen);
-      
-    } else if (!memcmp(pAttr->type.uuid, f91_clock_serviceChar2UUID, ATT_UUID_SIZE)) {
-      *pLen = sizeof(uint16_t);
-      memcpy(pValue, pAttr->pValue + offset, *pLen);
-    } else if (!memcmp(pAttr->type.uuid, f91_clock_serviceChar3UUID, ATT_UUID_SIZE)) {
-      *pLen = 1;
-      pValue[0] = *pAttr->pValue;
-    } else if (!memcmp(pAttr->type.uuid, f91_clock_serviceChar4UUID, ATT_UUID_SIZE)) {
-      *pLen = 1;
-      pValue[0] = *pAttr->pValue;
-    } 
+/*********************************************************************
+ * @fn      f91_clock_service_WriteAlarm
+ *
+ * @brief   Write an alarm record. Writes carry a single record, the table
+ *          is only updated by the app.
+ *
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   offset - offset of the first octet to be written
+ * @param   pNotify - set to tell the application
+ *
+ * @return  SUCCESS or ATT_ERR_INVALID_VALUE_SIZE
+ */
+static bStatus_t f91_clock_service_WriteAlarm( uint8_t *pValue, uint16_t len, uint16_t offset,
+                                            bool *pNotify )
+{
+  if ( (offset != 0) || (len != F91_CLOCK_SERVICE_CHAR5_RECORD_LEN) ) {
+    return ( ATT_ERR_INVALID_VALUE_SIZE );
   }
 
+  memcpy(f91ClockServiceChar5Record, pValue, len);
+  *pNotify = true;
 
-  return status;
+  return ( SUCCESS );
 }
 
-
 /*********************************************************************
  * @fn      f91_clock_service_WriteAttrCB
  *
@@ -480,36 +396,13 @@ static bStatus_t f91_clock_service_WriteAttrCB( uint16_t connHandle, gattAttribu
                                         uint8_t *pValue, uint16_t len, uint16_t offset,
                                         uint8_t method )
 {
-  bStatus_t status = SUCCESS;
-  uint8_t notifyApp = 0xFF;
-  if ( pAttr->type.len == ATT_UUID_SIZE ) {
-      // 128-bit UUID
-      if (!memcmp(pAttr->type.uuid, f91_clock_serviceChar1UUID, ATT_UUID_SIZE)) {
-          memcpy(pAttr->pValue + offset, pValue, len);
-          notifyApp = F91_CLOCK_SERVICE_CHAR1;
-      } else if(!memcmp(pAttr->type.uuid, f91_clock_serviceChar2UUID, ATT_UUID_SIZE)) {
-          memcpy(pAttr->pValue + offset, pValue, len);
-          notifyApp = F91_CLOCK_SERVICE_CHAR2;
-      } else if(!memcmp(pAttr->type.uuid, f91_clock_serviceChar3UUID, ATT_UUID_SIZE)) {
-          uint8_t *pCurValue = (uint8_t *)pAttr->pValue;
-          *pCurValue = pValue[0];
-          if( pAttr->pValue == &f91ClockServiceChar3 ) {
-            notifyApp = F91_CLOCK_SERVICE_CHAR3;
-          }
-      } else if(!memcmp(pAttr->type.uuid, f91_clock_serviceChar4UUID, ATT_UUID_SIZE)) {
-          uint8_t *pCurValue = (uint8_t *)pAttr->pValue;
-          *pCurValue = pValue[0];
-          if( pAttr->pValue == &f91ClockServiceChar4 ) {
-            notifyApp = F91_CLOCK_SERVICE_CHAR4;
-          }
-      } else {
-          status = ATT_ERR_INVALID_HANDLE;
-      }
-  } else {
-    // 128-bit UUID
-    status = ATT_ERR_INVALID_HANDLE;
-  }
+  bStatus_t status;
+  uint8_t notifyApp;
+
+  // Traffic for the link manager.
+  F91Link_countRx(len);
 
+  status = F91Service_write( &f91_clock_service, connHandle, pAttr, pValue, len, offset, &notifyApp );
 
   // If a characteristic value changed then callback function to notify application of change
   if ( (notifyApp != 0xFF ) && pClocksAppCBs && pClocksAppCBs->pfnClockChangeCb ) {
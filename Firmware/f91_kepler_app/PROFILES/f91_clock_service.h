@@ -62,6 +62,12 @@ extern "C"
 #define F91_CLOCK_SERVICE_CHAR2                 1  // RW uint8 - Profile Characteristic 2 value (Time zone)
 #define F91_CLOCK_SERVICE_CHAR3                 2  // RW uint8 - Profile Characteristic 3 value (Time mode)
 #define F91_CLOCK_SERVICE_CHAR4                 3  // RW uint8 - Profile Characteristic 4 value (Daylight savings)
+#define F91_CLOCK_SERVICE_CHAR5                 4  // RW uint8[5] - Profile Characteristic 5 value (Alarms)
+
+// Alarm characteristic sizes, writes are a single record, reads return the
+// whole table (4 alarms, countdown and chime). See f91_alarm.h.
+#define F91_CLOCK_SERVICE_CHAR5_RECORD_LEN      5
+#define F91_CLOCK_SERVICE_CHAR5_LEN             30
 
 // Service UUID
 #define F91_CLOCK_SERVICE_UUID                  0xB2F0
@@ -71,6 +77,7 @@ extern "C"
 #define F91_CLOCK_SERVICE_CHAR2_UUID            0xB2F2
 #define F91_CLOCK_SERVICE_CHAR3_UUID            0xB2F3
 #define F91_CLOCK_SERVICE_CHAR4_UUID            0xB2F4
+#define F91_CLOCK_SERVICE_CHAR5_UUID            0xB2F5
 
 /*********************************************************************
  * TYPEDEFS
@@ -50,9 +50,13 @@
 #include "gatt_uuid.h"
 #include "gattservapp.h"
 #include "gapbondmgr.h"
+#include "icall.h"
 #include "f91_utils.h"
+#include "f91_latency.h"
+#include "f91_link.h"
 
 #include "f91_notification_service.h"
+#include "f91_service.h"
 
 /*********************************************************************
  * MACROS
@@ -62,8 +66,6 @@
  * CONSTANTS
  */
 
-#define SERVAPP_NUM_ATTR_SUPPORTED       10
-
 /*********************************************************************
  * TYPEDEFS
  */
@@ -95,6 +97,36 @@ CONST uint8_t f91_notification_serviceChar3UUID[ATT_UUID_SIZE] =
 {
  F91_BASE_UUID_128(F91_NOTIFICATION_SERVICE_CHAR3_UUID)
 };
+
+// Characteristic 4 UUID: 0xA2F4
+CONST uint8_t f91_notification_serviceChar4UUID[ATT_UUID_SIZE] =
+{
+ F91_BASE_UUID_128(F91_NOTIFICATION_SERVICE_CHAR4_UUID)
+};
+
+// Characteristic 5 UUID: 0xA2F5
+CONST uint8_t f91_notification_serviceChar5UUID[ATT_UUID_SIZE] =
+{
+ F91_BASE_UUID_128(F91_NOTIFICATION_SERVICE_CHAR5_UUID)
+};
+
+// Characteristic 6 UUID: 0xA2F6
+CONST uint8_t f91_notification_serviceChar6UUID[ATT_UUID_SIZE] =
+{
+ F91_BASE_UUID_128(F91_NOTIFICATION_SERVICE_CHAR6_UUID)
+};
+
+// Characteristic 7 UUID: 0xA2F7
+CONST uint8_t f91_notification_serviceChar7UUID[ATT_UUID_SIZE] =
+{
+ F91_BASE_UUID_128(F91_NOTIFICATION_SERVICE_CHAR7_UUID)
+};
+
+// Characteristic 8 UUID: 0xA2F8
+CONST uint8_t f91_notification_serviceChar8UUID[ATT_UUID_SIZE] =
+{
+ F91_BASE_UUID_128(F91_NOTIFICATION_SERVICE_CHAR8_UUID)
+};
 /*********************************************************************
  * LOCAL VARIABLES
  */
@@ -141,86 +173,99 @@ static uint16_t f91NotificationServiceChar3Len = CONTACT_STREAM_LEN_MIN;
 // F91 Characteristic 3 User Description
 static uint8_t f91NotificationServiceUserDesp3[18] = "F91 Incoming Text";
 
+// F91 Notification Characteristic 4 Properties
+static uint8_t f91NotificationServiceChar4Props = GATT_PROP_WRITE;
 
+// Characteristic 4 Value, reassembly buffer for long writes. One more byte to
+// terminate the body in place.
+static uint8_t f91NotificationServiceChar4[MESSAGE_STREAM_LEN + 1] = {0};
+
+// Length of the body received so far, fragments are only accepted at this offset.
+static uint16_t f91NotificationServiceChar4Len = 0;
+
+// A complete body waits for the text it belongs to.
+static bool f91NotificationServiceChar4Pending = false;
+
+// Texts with their body, queued by the stack's write callback and taken by
+// the application task like the command frames.
+static f91_notification_serviceText_t f91NotificationServiceChar3Queue[TEXT_QUEUE_LEN];
+static volatile uint8_t f91NotificationServiceChar3Head = 0;
+static volatile uint8_t f91NotificationServiceChar3Tail = 0;
+static volatile bool f91NotificationServiceChar3Pending = false;
+
+// F91 Characteristic 4 User Description
+static uint8_t f91NotificationServiceUserDesp4[17] = "F91 Message Body";
+
+// F91 Notification Characteristic 5 Properties
+static uint8_t f91NotificationServiceChar5Props = GATT_PROP_READ | GATT_PROP_WRITE;
+
+// Characteristic 5 Value, reassembly buffer for long writes
+static uint8_t f91NotificationServiceChar5[SYNC_STREAM_LEN] = {0};
+
+// Length of the sync received so far, fragments are only accepted at this offset.
+static uint16_t f91NotificationServiceChar5Len = 0;
+
+// Version and sequence number of the last sync applied, returned on read.
+static uint8_t f91NotificationServiceChar5Status[SYNC_STATUS_LEN] = {0};
+
+// F91 Characteristic 5 User Description
+static uint8_t f91NotificationServiceUserDesp5[15] = "F91 State Sync";
+
+// F91 Notification Characteristic 6 Properties
+static uint8_t f91NotificationServiceChar6Props = GATT_PROP_WRITE_NO_RSP | GATT_PROP_NOTIFY;
+
+// Characteristic 6 Value, the last ack notified
+static uint8_t f91NotificationServiceChar6[COMMAND_ACK_LEN] = {0};
+
+// Characteristic 6 Configuration, one per connection
+static gattCharCfg_t *f91NotificationServiceChar6Config;
+
+// Frames written and not yet taken by the application. Written from the
+// stack's write callback and read from the application task: only the
+// callback moves the tail and only GetParameter moves the head.
+static f91_notification_serviceCommand_t f91NotificationServiceChar6Queue[COMMAND_QUEUE_LEN];
+static volatile uint8_t f91NotificationServiceChar6Head = 0;
+static volatile uint8_t f91NotificationServiceChar6Tail = 0;
+
+// The application was told about frames it hasn't drained yet.
+static volatile bool f91NotificationServiceChar6Pending = false;
+
+// A frame was dropped on a full queue. The queue being full, the application
+// has an event coming and reads this once it drained the queue.
+static volatile bool f91NotificationServiceChar6Dropped = false;
+
+// F91 Characteristic 6 User Description
+static uint8_t f91NotificationServiceUserDesp6[12] = "F91 Command";
+
+// F91 Notification Characteristic 7 Properties
+static uint8_t f91NotificationServiceChar7Props = GATT_PROP_NOTIFY;
+
+// Characteristic 7 Value, the batch being notified
+static uint8_t f91NotificationServiceChar7[EVENT_BATCH_LEN] = {0};
+
+// Length of the batch being notified.
+static uint16_t f91NotificationServiceChar7Len = 0;
+
+// Characteristic 7 Configuration, one per connection
+static gattCharCfg_t *f91NotificationServiceChar7Config;
+
+// F91 Characteristic 7 User Description
+static uint8_t f91NotificationServiceUserDesp7[11] = "F91 Events";
+
+// F91 Notification Characteristic 8 Properties
+static uint8_t f91NotificationServiceChar8Props = GATT_PROP_READ | GATT_PROP_NOTIFY;
+
+// Characteristic 8 Value
+static uint8_t f91NotificationServiceChar8[STATUS_LEN] = {0};
+
+// Characteristic 8 Configuration, one per connection
+static gattCharCfg_t *f91NotificationServiceChar8Config;
+
+// F91 Characteristic 8 User Description
+static uint8_t f91NotificationServiceUserDesp8[11] = "F91 Status";
 
 
-/*********************************************************************
-* Profile Attributes - Table
-*/
 
-static gattAttribute_t f91_notification_serviceAttrTbl[SERVAPP_NUM_ATTR_SUPPORTED] =
-{
-  // f91_notification_service Service Declaration
-  {
-    { ATT_BT_UUID_SIZE, primaryServiceUUID },
-    GATT_PERMIT_READ,
-    0,
-    (uint8_t *)&f91NotificationServiceDecl
-  },
-  // Characteristic 1 Declaration
-  {
-    { ATT_BT_UUID_SIZE, characterUUID },
-    GATT_PERMIT_READ,
-    0,
-    &f91NotificationServiceChar1Props
-  },
-      // Characteristic Value 1
-      {
-        { ATT_UUID_SIZE, f91_notification_serviceChar1UUID },
-        GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_WRITE,
-        0,
-        &f91NotificationServiceChar1
-      },
-      // Characteristic 1 User Description
-      {
-        { ATT_BT_UUID_SIZE, charUserDescUUID },
-        GATT_PERMIT_READ,
-        0,
-        f91NotificationServiceUserDesp1
-      },
-    // Characteristic 2 Declaration
-  {
-    { ATT_BT_UUID_SIZE, characterUUID },
-    GATT_PERMIT_READ,
-    0,
-    &f91NotificationServiceChar2Props
-  },
-      // Characteristic Value 2
-      {
-        { ATT_UUID_SIZE, f91_notification_serviceChar2UUID },
-        GATT_PERMIT_AUTHEN_WRITE,
-        0,
-        f91NotificationServiceChar2
-      },
-      // Characteristic 2 User Description
-      {
-        { ATT_BT_UUID_SIZE, charUserDescUUID },
-        GATT_PERMIT_READ,
-        0,
-        f91NotificationServiceUserDesp2
-      },
-    // Characteristic 3 Declaration
-  {
-    { ATT_BT_UUID_SIZE, characterUUID },
-    GATT_PERMIT_READ,
-    0,
-    &f91NotificationServiceChar3Props
-  },
-      // Characteristic Value 3
-      {
-        { ATT_UUID_SIZE, f91_notification_serviceChar3UUID },
-        GATT_PERMIT_AUTHEN_WRITE,
-        0,
-        f91NotificationServiceChar3
-      },
-      // Characteristic 3 User Description
-      {
-        { ATT_BT_UUID_SIZE, charUserDescUUID },
-        GATT_PERMIT_READ,
-        0,
-        f91NotificationServiceUserDesp3
-      },
-};
 
 /*********************************************************************
  * LOCAL FUNCTIONS
@@ -231,6 +276,66 @@ static bStatus_t f91_notification_service_ReadAttrCB( uint16 connHandle, gattAtt
 static bStatus_t f91_notification_service_WriteAttrCB( uint16 connHandle, gattAttribute_t *pAttr,
                                             uint8_t *pValue, uint16 len, uint16 offset,
                                             uint8_t method );
+static bStatus_t f91_notification_service_ReadSyncStatus( uint8_t *pValue, uint16_t *pLen,
+                                            uint16_t offset, uint16_t maxLen );
+static bStatus_t f91_notification_service_ReadEvents( uint8_t *pValue, uint16_t *pLen,
+                                            uint16_t offset, uint16_t maxLen );
+static bStatus_t f91_notification_service_QueueCommand( uint8_t *pValue, uint16_t len,
+                                            uint16_t offset, bool *pNotify );
+static bStatus_t f91_notification_service_QueueText( uint8_t *pValue, uint16_t len,
+                                            uint16_t offset, bool *pNotify );
+
+/*********************************************************************
+* Profile Characteristics - Table
+*/
+
+// Indexed by F91_NOTIFICATION_SERVICE_CHARx, the attribute table is built from it.
+static const f91ServiceChar_t f91_notification_serviceChars[] =
+{
+  // Notification Bar
+  { &f91NotificationServiceChar1Props, f91_notification_serviceChar1UUID,
+    GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_WRITE, f91NotificationServiceUserDesp1,
+    &f91NotificationServiceChar1, NULL, 0, sizeof(uint8_t), 0, NULL, NULL, NULL },
+  // Incoming Call
+  { &f91NotificationServiceChar2Props, f91_notification_serviceChar2UUID,
+    GATT_PERMIT_AUTHEN_WRITE, f91NotificationServiceUserDesp2,
+    f91NotificationServiceChar2, &f91NotificationServiceChar2Len,
+    CONTACT_STREAM_LEN_MIN, CONTACT_STREAM_LEN, 0, NULL, NULL, NULL },
+  // Incoming Text, queued with its body
+  { &f91NotificationServiceChar3Props, f91_notification_serviceChar3UUID,
+    GATT_PERMIT_AUTHEN_WRITE, f91NotificationServiceUserDesp3,
+    f91NotificationServiceChar3, &f91NotificationServiceChar3Len,
+    CONTACT_STREAM_LEN_MIN, CONTACT_STREAM_LEN, 0, NULL, NULL, f91_notification_service_QueueText },
+  // Message Body
+  { &f91NotificationServiceChar4Props, f91_notification_serviceChar4UUID,
+    GATT_PERMIT_AUTHEN_WRITE, f91NotificationServiceUserDesp4,
+    f91NotificationServiceChar4, &f91NotificationServiceChar4Len,
+    0, MESSAGE_STREAM_LEN, F91_SERVICE_LONG_WRITE, NULL, NULL, NULL },
+  // State Sync, reads return the last sync applied
+  { &f91NotificationServiceChar5Props, f91_notification_serviceChar5UUID,
+    GATT_PERMIT_AUTHEN_READ | GATT_PERMIT_AUTHEN_WRITE, f91NotificationServiceUserDesp5,
+    f91NotificationServiceChar5, &f91NotificationServiceChar5Len,
+    0, SYNC_STREAM_LEN, F91_SERVICE_LONG_WRITE, NULL,
+    f91_notification_service_ReadSyncStatus, NULL },
+  // Command, frames are queued and the ack notified
+  { &f91NotificationServiceChar6Props, f91_notification_serviceChar6UUID,
+    GATT_PERMIT_AUTHEN_WRITE, f91NotificationServiceUserDesp6,
+    f91NotificationServiceChar6, NULL, 0, COMMAND_ACK_LEN, 0, &f91NotificationServiceChar6Config,
+    NULL, f91_notification_service_QueueCommand },
+  // Events, a batch of whole records
+  { &f91NotificationServiceChar7Props, f91_notification_serviceChar7UUID,
+    0, f91NotificationServiceUserDesp7,
+    f91NotificationServiceChar7, &f91NotificationServiceChar7Len,
+    EVENT_RECORD_LEN, EVENT_BATCH_LEN, 0, &f91NotificationServiceChar7Config,
+    f91_notification_service_ReadEvents, NULL },
+  // Status
+  { &f91NotificationServiceChar8Props, f91_notification_serviceChar8UUID,
+    GATT_PERMIT_AUTHEN_READ, f91NotificationServiceUserDesp8,
+    f91NotificationServiceChar8, NULL, 0, STATUS_LEN, 0, &f91NotificationServiceChar8Config,
+    NULL, NULL },
+};
+
+static f91ServiceIndex_t f91_notification_serviceIndex[sizeof( f91_notification_serviceChars ) / sizeof( f91ServiceChar_t )];
 
 /*********************************************************************
  * PROFILE CALLBACKS
@@ -243,6 +348,15 @@ CONST gattServiceCBs_t f91_notification_serviceCBs =
   NULL                       // Authorization callback function pointer
 };
 
+static f91Service_t f91_notification_service =
+{
+  &f91NotificationServiceDecl,
+  f91_notification_serviceChars,
+  sizeof( f91_notification_serviceChars ) / sizeof( f91ServiceChar_t ),
+  f91_notification_serviceIndex,
+  &f91_notification_serviceCBs
+};
+
 /*********************************************************************
 * PUBLIC FUNCTIONS
 */
@@ -254,14 +368,9 @@ CONST gattServiceCBs_t f91_notification_serviceCBs =
  */
 bStatus_t F91_notification_service_AddService(void)
 {
-  uint8_t status;
-  // Register GATT attribute list and CBs with GATT Server App
-  status = GATTServApp_RegisterService( f91_notification_serviceAttrTbl,
-                                        GATT_NUM_ATTRS( f91_notification_serviceAttrTbl ),
-                                        GATT_MAX_ENCRYPT_KEY_SIZE,
-                                        &f91_notification_serviceCBs );
-
-  return ( status );
+  // The configurations of characteristics 6, 7 and 8 are allocated with
+  // the attribute table.
+  return F91Service_init( &f91_notification_service );
 }
 
 /*
@@ -296,50 +405,29 @@ bStatus_t F91_notification_service_RegisterAppCBs( f91_notification_serviceCBs_t
  */
 bStatus_t F91_notification_service_SetParameter( uint8_t param, uint16_t len, void *value )
 {
-  bStatus_t ret = SUCCESS;
-  uint8_t  *pAttrVal;
-  uint16_t *pValLen;
-  uint16_t valMinLen;
-  uint16_t valMaxLen;
   switch ( param )
   {
-    case F91_NOTIFICATION_SERVICE_CHAR1:
-      if ( len == sizeof ( uint8_t ) )
+    case F91_NOTIFICATION_SERVICE_CHAR5:
+      // The status returned on read, not the value being written.
+      if ( len != SYNC_STATUS_LEN )
       {
-        f91NotificationServiceChar1 = *((uint8_t*)value);
+        return ( bleInvalidRange );
       }
-      else
+      memcpy(f91NotificationServiceChar5Status, value, SYNC_STATUS_LEN);
+      return ( SUCCESS );
+    case F91_NOTIFICATION_SERVICE_CHAR7:
+      // One batch of records, the caller keeps it while this fails.
+      if ( (len % EVENT_RECORD_LEN) != 0 )
       {
-        ret = bleInvalidRange;
+        return ( bleInvalidRange );
       }
       break;
-    case F91_NOTIFICATION_SERVICE_CHAR2:
-      pAttrVal  =  f91NotificationServiceChar2;
-      pValLen   = &f91NotificationServiceChar2Len;
-      valMinLen =  CONTACT_STREAM_LEN_MIN;
-      valMaxLen =  CONTACT_STREAM_LEN;
-        if ( len <= valMaxLen && len >= valMinLen )
-        {
-          memcpy(pAttrVal, value, len);
-          *pValLen = len; // Update length for read and get.
-        }
-      break;
-    case F91_NOTIFICATION_SERVICE_CHAR3:
-      pAttrVal  =  f91NotificationServiceChar3;
-      pValLen   = &f91NotificationServiceChar3Len;
-      valMinLen =  CONTACT_STREAM_LEN_MIN;
-      valMaxLen =  CONTACT_STREAM_LEN;
-        if ( len <= valMaxLen && len >= valMinLen )
-        {
-          memcpy(pAttrVal, value, len);
-          *pValLen = len; // Update length for read and get.
-        }
-      break;
     default:
-      ret = INVALIDPARAMETER;
       break;
   }
-  return ret;
+
+  // Characteristics that notify are notified to every client that enabled it.
+  return F91Service_setValue( &f91_notification_service, param, len, value );
 }
 
 
@@ -357,17 +445,53 @@ bStatus_t F91_notification_service_GetParameter( uint8_t param, void *value )
   bStatus_t ret = SUCCESS;
   switch ( param )
   {
-    case F91_NOTIFICATION_SERVICE_CHAR1:
-        *((uint8_t*)value) = f91NotificationServiceChar1;
+    case F91_NOTIFICATION_SERVICE_CHAR3:
+        // value is a f91_notification_serviceText_t, takes the oldest text.
+        // Returns FAILURE once none are left, the next write raises a new event.
+        if ( f91NotificationServiceChar3Head == f91NotificationServiceChar3Tail )
+        {
+          f91NotificationServiceChar3Pending = false;
+          if ( f91NotificationServiceChar3Head == f91NotificationServiceChar3Tail )
+          {
+            ret = FAILURE;
+            break;
+          }
+        }
+        memcpy(value, &f91NotificationServiceChar3Queue[f91NotificationServiceChar3Head & (TEXT_QUEUE_LEN - 1)],
+               sizeof(f91_notification_serviceText_t));
+        f91NotificationServiceChar3Head++;
       break;
-    case F91_NOTIFICATION_SERVICE_CHAR2:
-        memcpy(value, f91NotificationServiceChar2, f91NotificationServiceChar2Len);
+    case F91_NOTIFICATION_SERVICE_CHAR5:
+        // value is a f91_notification_serviceSync_t.
+        ((f91_notification_serviceSync_t*)value)->len = f91NotificationServiceChar5Len;
+        memcpy(((f91_notification_serviceSync_t*)value)->data, f91NotificationServiceChar5,
+               f91NotificationServiceChar5Len);
       break;
-    case F91_NOTIFICATION_SERVICE_CHAR3:
-        memcpy(value, f91NotificationServiceChar3, f91NotificationServiceChar3Len);
+    case F91_NOTIFICATION_SERVICE_CHAR6:
+        // value is a f91_notification_serviceCommand_t, takes the oldest frame.
+        // Returns FAILURE once none are left, the next write raises a new event.
+        if ( f91NotificationServiceChar6Head == f91NotificationServiceChar6Tail )
+        {
+          // Cleared before looking again so a frame written meanwhile is either
+          // seen here or raises its own event.
+          f91NotificationServiceChar6Pending = false;
+          if ( f91NotificationServiceChar6Head == f91NotificationServiceChar6Tail )
+          {
+            ret = FAILURE;
+            break;
+          }
+        }
+        memcpy(value, &f91NotificationServiceChar6Queue[f91NotificationServiceChar6Head & (COMMAND_QUEUE_LEN - 1)],
+               sizeof(f91_notification_serviceCommand_t));
+        f91NotificationServiceChar6Head++;
+      break;
+    case F91_NOTIFICATION_SERVICE_CHAR6_DROPPED:
+        // value is a bool.
+        *(bool *)value = f91NotificationServiceChar6Dropped;
+        f91NotificationServiceChar6Dropped = false;
       break;
     default:
-      ret = INVALIDPARAMETER;
+      ret = F91Service_getValue( &f91_notification_service, param, value );
       break;
   }
   return ret;
@@ -392,35 +516,153 @@ static bStatus_t f91_notification_service_ReadAttrCB( uint16_t connHandle, gattA
                                        uint8_t *pValue, uint16_t *pLen, uint16_t offset,
                                        uint16_t maxLen, uint8_t method )
 {
-  bStatus_t status = SUCCESS;
-  uint16_t valueLen;
+  return F91Service_read( &f91_notification_service, pAttr, pValue, pLen, offset, maxLen );
+}
 
-  // Make sure it's not a blob operation (no attributes in the profile are long)
-  if ( offset > 0 )
-  {
-    return ( ATT_ERR_ATTR_NOT_LONG );
+/*********************************************************************
+ * @fn      f91_notification_service_ReadSyncStatus
+ *
+ * @brief   Read the state sync: the last sync applied, not the buffer
+ *          being written.
+ *
+ * @param   pValue - pointer to data to be read
+ * @param   pLen - length of data to be read
+ * @param   offset - offset of the first octet to be read, 0
+ * @param   maxLen - maximum length of data to be read
+ *
+ * @return  SUCCESS
+ */
+static bStatus_t f91_notification_service_ReadSyncStatus( uint8_t *pValue, uint16_t *pLen,
+                                            uint16_t offset, uint16_t maxLen )
+{
+  *pLen = SYNC_STATUS_LEN;
+  memcpy(pValue, f91NotificationServiceChar5Status, SYNC_STATUS_LEN);
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      f91_notification_service_ReadEvents
+ *
+ * @brief   Read the event batch, only to build its notification. Cut to
+ *          whole records.
+ *
+ * @param   pValue - pointer to data to be read
+ * @param   pLen - length of data to be read
+ * @param   offset - offset of the first octet to be read, 0
+ * @param   maxLen - maximum length of data to be read
+ *
+ * @return  SUCCESS
+ */
+static bStatus_t f91_notification_service_ReadEvents( uint8_t *pValue, uint16_t *pLen,
+                                            uint16_t offset, uint16_t maxLen )
+{
+  *pLen = MIN(maxLen, f91NotificationServiceChar7Len);
+  *pLen -= *pLen % EVENT_RECORD_LEN;
+  memcpy(pValue, f91NotificationServiceChar7, *pLen);
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      f91_notification_service_QueueCommand
+ *
+ * @brief   Queue a command frame for the application. Frames are written
+ *          without response, an error only drops the frame and the phone
+ *          sends it again when it isn't acked. A frame dropped on a full
+ *          queue is flagged in the next ack.
+ *
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   offset - offset of the first octet to be written
+ * @param   pNotify - set to tell the application, once until it drained the queue
+ *
+ * @return  SUCCESS, ATT_ERR_INVALID_OFFSET, ATT_ERR_INVALID_VALUE_SIZE or
+ *          ATT_ERR_INSUFFICIENT_RESOURCES
+ */
+static bStatus_t f91_notification_service_QueueCommand( uint8_t *pValue, uint16_t len,
+                                            uint16_t offset, bool *pNotify )
+{
+  f91_notification_serviceCommand_t *pFrame;
+
+  if ( offset > 0 ) {
+    return ( ATT_ERR_INVALID_OFFSET );
   }
 
-  if ( pAttr->type.len == ATT_UUID_SIZE ) {
-        // 128-bit UUID
-    if (!memcmp(pAttr->type.uuid, f91_notification_serviceChar1UUID, ATT_UUID_SIZE)) {
-      *pLen = 1;
-      pValue[0] = *pAttr->pValue;
-    } else if (!memcmp(pAttr->type.uuid, f91_notification_serviceChar2UUID, ATT_UUID_SIZE)) {
-      valueLen = f91NotificationServiceChar2Len;
-      *pLen = MIN(maxLen, valueLen - offset);  // Transmit as much as possible
-      memcpy(pValue, pAttr->pValue + offset, *pLen);
-    } else if (!memcmp(pAttr->type.uuid, f91_notification_serviceChar3UUID, ATT_UUID_SIZE)) {
-      valueLen = f91NotificationServiceChar3Len;
-      *pLen = MIN(maxLen, valueLen - offset);  // Transmit as much as possible
-      memcpy(pValue, pAttr->pValue + offset, *pLen);
-    }
+  if ( (len < COMMAND_FRAME_LEN_MIN) || (len > COMMAND_FRAME_LEN) ) {
+    return ( ATT_ERR_INVALID_VALUE_SIZE );
   }
 
+  if ( (uint8_t)(f91NotificationServiceChar6Tail - f91NotificationServiceChar6Head) == COMMAND_QUEUE_LEN ) {
+    f91NotificationServiceChar6Dropped = true;
+    return ( ATT_ERR_INSUFFICIENT_RESOURCES );
+  }
 
-  return status;
+  pFrame = &f91NotificationServiceChar6Queue[f91NotificationServiceChar6Tail & (COMMAND_QUEUE_LEN - 1)];
+  memcpy(pFrame->data, pValue, len);
+  pFrame->len = len;
+  f91NotificationServiceChar6Tail++;
+
+  if ( !f91NotificationServiceChar6Pending ) {
+    f91NotificationServiceChar6Pending = true;
+    *pNotify = true;
+  }
+
+  return ( SUCCESS );
 }
 
+/*********************************************************************
+ * @fn      f91_notification_service_QueueText
+ *
+ * @brief   Queue an incoming text with the body written before it. Both are
+ *          copied here, in the stack's context, so a body written before the
+ *          application task runs can't end up on another text.
+ *
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   offset - offset of the first octet to be written
+ * @param   pNotify - set to tell the application, once until it drained the queue
+ *
+ * @return  SUCCESS, ATT_ERR_ATTR_NOT_LONG, ATT_ERR_INVALID_VALUE_SIZE or
+ *          ATT_ERR_INSUFFICIENT_RESOURCES
+ */
+static bStatus_t f91_notification_service_QueueText( uint8_t *pValue, uint16_t len,
+                                            uint16_t offset, bool *pNotify )
+{
+  f91_notification_serviceText_t *pText;
+
+  if ( offset > 0 ) {
+    return ( ATT_ERR_ATTR_NOT_LONG );
+  }
+
+  if ( len > CONTACT_STREAM_LEN ) {
+    return ( ATT_ERR_INVALID_VALUE_SIZE );
+  }
+
+  // Refused rather than dropped, the body stays for the text's next try.
+  if ( (uint8_t)(f91NotificationServiceChar3Tail - f91NotificationServiceChar3Head) == TEXT_QUEUE_LEN ) {
+    return ( ATT_ERR_INSUFFICIENT_RESOURCES );
+  }
+
+  pText = &f91NotificationServiceChar3Queue[f91NotificationServiceChar3Tail & (TEXT_QUEUE_LEN - 1)];
+  memcpy(pText->sender, pValue, len);
+  pText->sender[len] = '\0';
+  if ( f91NotificationServiceChar4Pending ) {
+    memcpy(pText->body, f91NotificationServiceChar4, f91NotificationServiceChar4Len);
+    pText->body[f91NotificationServiceChar4Len] = '\0';
+    f91NotificationServiceChar4Pending = false;
+  } else {
+    pText->body[0] = '\0';
+  }
+  f91NotificationServiceChar3Tail++;
+
+  if ( !f91NotificationServiceChar3Pending ) {
+    f91NotificationServiceChar3Pending = true;
+    *pNotify = true;
+  }
+
+  return ( SUCCESS );
+}
 
 /*********************************************************************
  * @fn      f91_notification_service_WriteAttrCB
@@ -440,47 +682,32 @@ static bStatus_t f91_notification_service_WriteAttrCB( uint16_t connHandle, gatt
                                         uint8_t *pValue, uint16_t len, uint16_t offset,
                                         uint8_t method )
 {
-  bStatus_t status = SUCCESS;
-  uint8_t notifyApp = 0xFF;
-  uint16_t writeLenMin = CONTACT_STREAM_LEN_MIN;
-  uint16_t writeLenMax = CONTACT_STREAM_LEN;
-  if ( pAttr->type.len == ATT_UUID_SIZE ) {
-      // 128-bit UUID
-      if (!memcmp(pAttr->type.uuid, f91_notification_serviceChar1UUID, ATT_UUID_SIZE)) {
-          uint8_t *pCurValue = (uint8_t *)pAttr->pValue;
-          *pCurValue = pValue[0];
-          if( pAttr->pValue == &f91NotificationServiceChar1 ) {
-            notifyApp = F91_NOTIFICATION_SERVICE_CHAR1;
-          }
-      } else if(!memcmp(pAttr->type.uuid, f91_notification_serviceChar2UUID, ATT_UUID_SIZE)) {
-        if(len <= writeLenMax) {
-          memcpy(pAttr->pValue + offset, pValue, len);
-          if ( offset + len >= writeLenMin ) {
-            notifyApp = F91_NOTIFICATION_SERVICE_CHAR2;
-            f91NotificationServiceChar2Len = offset + len; // Update data length.
-          }
-        } else {
-          status = ATT_ERR_INVALID_VALUE_SIZE;
-        }
-      } else if(!memcmp(pAttr->type.uuid, f91_notification_serviceChar3UUID, ATT_UUID_SIZE)) {
-        if(len <= writeLenMax) {
-          memcpy(pAttr->pValue + offset, pValue, len);
-          if ( offset + len >= writeLenMin ) {
-            notifyApp = F91_NOTIFICATION_SERVICE_CHAR3;
-            f91NotificationServiceChar3Len = offset + len; // Update data length.
-          }
-        } else {
-          status = ATT_ERR_INVALID_VALUE_SIZE;
-        }
-      } else {
-          status = ATT_ERR_INVALID_HANDLE;
-      }
+  bStatus_t status;
+  uint8_t notifyApp;
 
-  } else {
-    // 128-bit UUID
-    status = ATT_ERR_INVALID_HANDLE;
+  // Traffic for the link manager, whatever the write turns out to be.
+  F91Link_countRx(len);
+
+  status = F91Service_write( &f91_notification_service, connHandle, pAttr, pValue, len, offset, &notifyApp );
+
+  if ( (notifyApp == F91_NOTIFICATION_SERVICE_CHAR2) || (notifyApp == F91_NOTIFICATION_SERVICE_CHAR3) ) {
+    F91_LATENCY_MARK(F91_LATENCY_WRITE);
   }
 
+  // A body belongs to the text written right after it, a bar or call in
+  // between means it belongs to none. The application isn't told about it.
+  switch ( notifyApp ) {
+    case F91_NOTIFICATION_SERVICE_CHAR1:
+    case F91_NOTIFICATION_SERVICE_CHAR2:
+      f91NotificationServiceChar4Pending = false;
+      break;
+    case F91_NOTIFICATION_SERVICE_CHAR4:
+      f91NotificationServiceChar4Pending = true;
+      notifyApp = 0xFF;
+      break;
+    default:
+      break;
+  }
 
   // If a characteristic value changed then callback function to notify application of change
   if ( (notifyApp != 0xFF ) && pNotificationsAppCBs && pNotificationsAppCBs->pfnNotificationChangeCb ) {
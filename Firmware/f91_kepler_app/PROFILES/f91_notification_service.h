@@ -61,6 +61,15 @@ extern "C"
 #define F91_NOTIFICATION_SERVICE_CHAR1                 0  // RW uint8 - Profile Characteristic 1 value (Notification Bar)
 #define F91_NOTIFICATION_SERVICE_CHAR2                 1  // RW uint8 - Profile Characteristic 2 value (Incoming Call)
 #define F91_NOTIFICATION_SERVICE_CHAR3                 2  // RW uint8 - Profile Characteristic 3 value (Incoming Text)
+#define F91_NOTIFICATION_SERVICE_CHAR4                 3  // W  uint8 - Profile Characteristic 4 value (Message Body)
+#define F91_NOTIFICATION_SERVICE_CHAR5                 4  // RW uint8 - Profile Characteristic 5 value (State Sync)
+#define F91_NOTIFICATION_SERVICE_CHAR6                 5  // WN uint8 - Profile Characteristic 6 value (Command)
+#define F91_NOTIFICATION_SERVICE_CHAR7                 6  // N  uint8 - Profile Characteristic 7 value (Events)
+#define F91_NOTIFICATION_SERVICE_CHAR8                 7  // RN uint8 - Profile Characteristic 8 value (Status)
+
+// Not a characteristic, GetParameter only: bool, command frames were dropped
+// on a full queue since the last time it was read. Reading clears it.
+#define F91_NOTIFICATION_SERVICE_CHAR6_DROPPED         0x80
 
 // Service UUID
 #define F91_NOTIFICATION_SERVICE_UUID                  0xA2F0
@@ -69,15 +78,86 @@ extern "C"
 #define F91_NOTIFICATION_SERVICE_CHAR1_UUID            0xA2F1
 #define F91_NOTIFICATION_SERVICE_CHAR2_UUID            0xA2F2
 #define F91_NOTIFICATION_SERVICE_CHAR3_UUID            0xA2F3
+#define F91_NOTIFICATION_SERVICE_CHAR4_UUID            0xA2F4
+#define F91_NOTIFICATION_SERVICE_CHAR5_UUID            0xA2F5
+#define F91_NOTIFICATION_SERVICE_CHAR6_UUID            0xA2F6
+#define F91_NOTIFICATION_SERVICE_CHAR7_UUID            0xA2F7
+#define F91_NOTIFICATION_SERVICE_CHAR8_UUID            0xA2F8
 
 #define CONTACT_STREAM_LEN                             20
 #define CONTACT_STREAM_LEN_MIN                         0
 
+// Message body of the next incoming text, written before the text itself.
+// Bodies longer than ATT_MTU - 3 are sent with a long write (prepare/execute),
+// fragments must be in order. As long as the history keeps
+// (F91_HISTORY_BODY_LEN), the phone cuts longer ones on a character boundary.
+#define MESSAGE_STREAM_LEN                             64
+
+// Texts written and not yet taken by the application. The body is paired
+// with its text when the text is written, a bar or call written in between
+// drops it. A text that doesn't fit is refused and written again.
+#define TEXT_QUEUE_LEN                                 2   // power of 2
+
+// State sync, written as [version][seq lo][seq hi] followed by TLV fields
+// (see f91_sync.h). Longer than ATT_MTU - 3 only with a long write. Reads
+// return SYNC_STATUS_LEN bytes: [version][seq lo][seq hi] of the last sync
+// applied.
+#define SYNC_STREAM_LEN                                128
+#define SYNC_STATUS_LEN                                3
+
+// Prepare writes the longest long write (a full sync) takes, 8 at the
+// default ATT_MTU where the stack only queues 5. Set at init.
+#define F91_NOTIFICATION_SERVICE_PREPARE_WRITES        F91_SERVICE_PREPARE_WRITES( SYNC_STREAM_LEN )
+
+#if MESSAGE_STREAM_LEN > SYNC_STREAM_LEN
+#error "The prepare write queue is sized for the state sync"
+#endif
+
+// Command frames, written without response so the phone can send several
+// per connection event. A frame is [seq lo][seq hi] followed by state sync
+// fields and must fit in one write. Frames are queued until the application
+// task gets to them, a frame that doesn't fit is dropped and the next ack
+// says so. Acks are notified on the same characteristic (see f91_command.h).
+#define COMMAND_FRAME_LEN                              64
+#define COMMAND_FRAME_LEN_MIN                          2
+#define COMMAND_QUEUE_LEN                              8   // power of 2
+#define COMMAND_ACK_LEN                                7
+
+// Watch events, notified as a batch of EVENT_RECORD_LEN byte records
+// [seq][event] (see f91_outbound.h). A batch is cut to ATT_MTU - 3.
+#define EVENT_RECORD_LEN                               2
+#define EVENT_BATCH_LEN                                32
+
+// Watch status, read or notified when it changes:
+// [battery mV lo][battery mV hi][unread][drift s lo][drift s hi].
+#define STATUS_LEN                                     5
 
 /*********************************************************************
  * TYPEDEFS
  */
 
+// Value handed out by GetParameter for the state sync characteristic.
+typedef struct
+{
+  uint16_t len;
+  uint8_t  data[SYNC_STREAM_LEN];
+} f91_notification_serviceSync_t;
+
+// Text handed out by GetParameter for the incoming text characteristic,
+// sender and body NUL terminated, the body empty when there was none.
+typedef struct
+{
+  char sender[CONTACT_STREAM_LEN + 1];
+  char body[MESSAGE_STREAM_LEN + 1];
+} f91_notification_serviceText_t;
+
+// Frame handed out by GetParameter for the command characteristic.
+typedef struct
+{
+  uint8_t len;
+  uint8_t data[COMMAND_FRAME_LEN];
+} f91_notification_serviceCommand_t;
+
 /*********************************************************************
  * MACROS
  */
@@ -0,0 +1,405 @@
+/**********************************************************************************************
+ * Filename:       f91_oad_service.c
+ *
+ * Description:    This file contains the implementation of the service.
+ *
+ * Copyright (c) 2015-2021, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "bcomdef.h"
+#include "OSAL.h"
+#include "linkdb.h"
+#include "att.h"
+#include "gatt.h"
+#include "gatt_uuid.h"
+#include "gattservapp.h"
+#include "gapbondmgr.h"
+#include "icall.h"
+#include "f91_utils.h"
+#include "f91_link.h"
+
+#include "f91_oad_service.h"
+#include "f91_service.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+* GLOBAL VARIABLES
+*/
+
+// f91_oad_service Service UUID
+CONST uint8_t f91_oad_serviceUUID[ATT_UUID_SIZE] =
+{
+  F91_BASE_UUID_128(F91_OAD_SERVICE_UUID)
+};
+
+// Characteristic 1 UUID: 0xC2F1
+CONST uint8_t f91_oad_serviceChar1UUID[ATT_UUID_SIZE] =
+{
+ F91_BASE_UUID_128(F91_OAD_SERVICE_CHAR1_UUID)
+};
+
+// Characteristic 2 UUID: 0xC2F2
+CONST uint8_t f91_oad_serviceChar2UUID[ATT_UUID_SIZE] =
+{
+ F91_BASE_UUID_128(F91_OAD_SERVICE_CHAR2_UUID)
+};
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static f91_oad_serviceCBs_t *pOadAppCBs = NULL;
+
+/*********************************************************************
+* Profile Attributes - variables
+*/
+
+// Service declaration
+static CONST gattAttrType_t f91OadServiceDecl = { ATT_UUID_SIZE, f91_oad_serviceUUID };
+
+// F91 OAD Characteristic 1 Properties
+static uint8_t f91OadServiceChar1Props = GATT_PROP_WRITE | GATT_PROP_NOTIFY;
+
+// Characteristic 1 Value, the last command written or response notified
+static uint8_t f91OadServiceChar1[OAD_CONTROL_LEN] = {0};
+
+// Length of the command or response.
+static uint16_t f91OadServiceChar1Len = 0;
+
+// Characteristic 1 Configuration, one per connection
+static gattCharCfg_t *f91OadServiceChar1Config;
+
+// F91 Characteristic 1 User Description
+static uint8_t f91OadServiceUserDesp1[12] = "F91 OAD Ctrl";
+
+// F91 OAD Characteristic 2 Properties
+static uint8_t f91OadServiceChar2Props = GATT_PROP_WRITE_NO_RSP;
+
+// Blocks written and not yet taken by the application, also the value
+// attribute. Written from the stack's write callback and read in place from
+// the application task: only the callback moves the tail and only
+// F91_oad_service_ReleaseBlock moves the head.
+static f91_oad_serviceBlock_t f91OadServiceChar2Queue[OAD_BLOCK_QUEUE_LEN];
+static volatile uint8_t f91OadServiceChar2Head = 0;
+static volatile uint8_t f91OadServiceChar2Tail = 0;
+
+// The application was told about blocks it hasn't drained yet.
+static volatile bool f91OadServiceChar2Pending = false;
+
+// F91 Characteristic 2 User Description
+static uint8_t f91OadServiceUserDesp2[14] = "F91 OAD Block";
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static bStatus_t f91_oad_service_ReadAttrCB( uint16 connHandle, gattAttribute_t *pAttr,
+                                           uint8_t *pValue, uint16 *pLen, uint16 offset,
+                                           uint16 maxLen, uint8_t method );
+static bStatus_t f91_oad_service_WriteAttrCB( uint16 connHandle, gattAttribute_t *pAttr,
+                                            uint8_t *pValue, uint16 len, uint16 offset,
+                                            uint8_t method );
+static bStatus_t f91_oad_service_QueueBlock( uint8_t *pValue, uint16_t len,
+                                            uint16_t offset, bool *pNotify );
+
+/*********************************************************************
+* Profile Characteristics - Table
+*/
+
+// Indexed by F91_OAD_SERVICE_CHARx, the attribute table is built from it.
+static const f91ServiceChar_t f91_oad_serviceChars[] =
+{
+  // Control, commands are written and responses notified
+  { &f91OadServiceChar1Props, f91_oad_serviceChar1UUID,
+    GATT_PERMIT_AUTHEN_WRITE, f91OadServiceUserDesp1,
+    f91OadServiceChar1, &f91OadServiceChar1Len, OAD_CONTROL_LEN_MIN, OAD_CONTROL_LEN, 0,
+    &f91OadServiceChar1Config, NULL, NULL },
+  // Image Block, blocks are queued
+  { &f91OadServiceChar2Props, f91_oad_serviceChar2UUID,
+    GATT_PERMIT_AUTHEN_WRITE, f91OadServiceUserDesp2,
+    (uint8_t *)f91OadServiceChar2Queue, NULL, 0, OAD_BLOCK_HDR_LEN + OAD_BLOCK_LEN, 0, NULL,
+    NULL, f91_oad_service_QueueBlock },
+};
+
+static f91ServiceIndex_t f91_oad_serviceIndex[sizeof( f91_oad_serviceChars ) / sizeof( f91ServiceChar_t )];
+
+/*********************************************************************
+ * PROFILE CALLBACKS
+ */
+// Simple Profile Service Callbacks
+CONST gattServiceCBs_t f91_oad_serviceCBs =
+{
+  f91_oad_service_ReadAttrCB,  // Read callback function pointer
+  f91_oad_service_WriteAttrCB, // Write callback function pointer
+  NULL                       // Authorization callback function pointer
+};
+
+static f91Service_t f91_oad_service =
+{
+  &f91OadServiceDecl,
+  f91_oad_serviceChars,
+  sizeof( f91_oad_serviceChars ) / sizeof( f91ServiceChar_t ),
+  f91_oad_serviceIndex,
+  &f91_oad_serviceCBs
+};
+
+/*********************************************************************
+* PUBLIC FUNCTIONS
+*/
+
+/*
+ * F91_oad_service_AddService- Initializes the F91_oad_service service by registering
+ *          GATT attributes with the GATT server.
+ *
+ */
+bStatus_t F91_oad_service_AddService(void)
+{
+  // The configuration of characteristic 1 is allocated with the attribute
+  // table.
+  return F91Service_init( &f91_oad_service );
+}
+
+/*
+ * F91_oad_service_RegisterAppCBs - Registers the application callback function.
+ *                    Only call this function once.
+ *
+ *    appCallbacks - pointer to application callbacks.
+ */
+bStatus_t F91_oad_service_RegisterAppCBs( f91_oad_serviceCBs_t *appCallbacks )
+{
+  if ( appCallbacks )
+  {
+    pOadAppCBs = appCallbacks;
+
+    return ( SUCCESS );
+  }
+  else
+  {
+    return ( bleAlreadyInRequestedMode );
+  }
+}
+
+/*
+ * F91_oad_service_SetParameter - Set a F91_oad_service parameter.
+ *
+ *    param - Profile parameter ID
+ *    len - length of data to right
+ *    value - pointer to data to write.  This is dependent on
+ *          the parameter ID and WILL be cast to the appropriate
+ *          data type (example: data type of uint16 will be cast to
+ *          uint16 pointer).
+ */
+bStatus_t F91_oad_service_SetParameter( uint8_t param, uint16_t len, void *value )
+{
+  // Blocks only come from the phone.
+  if ( param == F91_OAD_SERVICE_CHAR2 )
+  {
+    return ( INVALIDPARAMETER );
+  }
+
+  // Responses are notified to every client that enabled it.
+  return F91Service_setValue( &f91_oad_service, param, len, value );
+}
+
+
+/*
+ * F91_oad_service_GetParameter - Get a F91_oad_service parameter.
+ *
+ *    param - Profile parameter ID
+ *    value - pointer to data to write.  This is dependent on
+ *          the parameter ID and WILL be cast to the appropriate
+ *          data type (example: data type of uint16 will be cast to
+ *          uint16 pointer).
+ */
+bStatus_t F91_oad_service_GetParameter( uint8_t param, void *value )
+{
+  bStatus_t ret = SUCCESS;
+  switch ( param )
+  {
+    case F91_OAD_SERVICE_CHAR1:
+        // value is a f91_oad_serviceControl_t.
+        ((f91_oad_serviceControl_t*)value)->len = f91OadServiceChar1Len;
+        memcpy(((f91_oad_serviceControl_t*)value)->data, f91OadServiceChar1, f91OadServiceChar1Len);
+      break;
+    case F91_OAD_SERVICE_CHAR2:
+        // value is a f91_oad_serviceBlock_t *, set to the oldest block which
+        // stays queued until released. Returns FAILURE once none are left,
+        // the next write raises a new event.
+        if ( f91OadServiceChar2Head == f91OadServiceChar2Tail )
+        {
+          // Cleared before looking again so a block written meanwhile is either
+          // seen here or raises its own event.
+          f91OadServiceChar2Pending = false;
+          if ( f91OadServiceChar2Head == f91OadServiceChar2Tail )
+          {
+            ret = FAILURE;
+            break;
+          }
+        }
+        *(f91_oad_serviceBlock_t **)value =
+          &f91OadServiceChar2Queue[f91OadServiceChar2Head & (OAD_BLOCK_QUEUE_LEN - 1)];
+      break;
+    default:
+      ret = INVALIDPARAMETER;
+      break;
+  }
+
+  return ret;
+}
+
+/*
+ * F91_oad_service_ReleaseBlock - Release the oldest block, the one
+ *          GetParameter handed out, its slot takes a new write.
+ */
+void F91_oad_service_ReleaseBlock( void )
+{
+  if ( f91OadServiceChar2Head != f91OadServiceChar2Tail )
+  {
+    f91OadServiceChar2Head++;
+  }
+}
+
+/*********************************************************************
+ * @fn          f91_oad_service_ReadAttrCB
+ *
+ * @brief       Read an attribute.
+ *
+ * @param       connHandle - connection message was received on
+ * @param       pAttr - pointer to attribute
+ * @param       pValue - pointer to data to be read
+ * @param       pLen - length of data to be read
+ * @param       offset - offset of the first octet to be read
+ * @param       maxLen - maximum length of data to be read
+ * @param       method - type of read message
+ *
+ * @return      SUCCESS, blePending or Failure
+ */
+static bStatus_t f91_oad_service_ReadAttrCB( uint16_t connHandle, gattAttribute_t *pAttr,
+                                       uint8_t *pValue, uint16_t *pLen, uint16_t offset,
+                                       uint16_t maxLen, uint8_t method )
+{
+  return F91Service_read( &f91_oad_service, pAttr, pValue, pLen, offset, maxLen );
+}
+
+/*********************************************************************
+ * @fn      f91_oad_service_QueueBlock
+ *
+ * @brief   Queue an image block for the application. Blocks are written
+ *          without response, an error only drops the block and the
+ *          application asks for it again.
+ *
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   offset - offset of the first octet to be written
+ * @param   pNotify - set to tell the application, once until it drained the queue
+ *
+ * @return  SUCCESS, ATT_ERR_INVALID_OFFSET, ATT_ERR_INVALID_VALUE_SIZE or
+ *          ATT_ERR_INSUFFICIENT_RESOURCES
+ */
+static bStatus_t f91_oad_service_QueueBlock( uint8_t *pValue, uint16_t len,
+                                            uint16_t offset, bool *pNotify )
+{
+  f91_oad_serviceBlock_t *pBlock;
+
+  if ( offset > 0 ) {
+    return ( ATT_ERR_INVALID_OFFSET );
+  }
+
+  if ( (len <= OAD_BLOCK_HDR_LEN) || (len > OAD_BLOCK_HDR_LEN + OAD_BLOCK_LEN) ) {
+    return ( ATT_ERR_INVALID_VALUE_SIZE );
+  }
+
+  if ( (uint8_t)(f91OadServiceChar2Tail - f91OadServiceChar2Head) == OAD_BLOCK_QUEUE_LEN ) {
+    return ( ATT_ERR_INSUFFICIENT_RESOURCES );
+  }
+
+  pBlock = &f91OadServiceChar2Queue[f91OadServiceChar2Tail & (OAD_BLOCK_QUEUE_LEN - 1)];
+  memcpy(pBlock->data, pValue, len);
+  pBlock->len = len;
+  f91OadServiceChar2Tail++;
+
+  if ( !f91OadServiceChar2Pending ) {
+    f91OadServiceChar2Pending = true;
+    *pNotify = true;
+  }
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      f91_oad_service_WriteAttrCB
+ *
+ * @brief   Validate attribute data prior to a write operation
+ *
+ * @param   connHandle - connection message was received on
+ * @param   pAttr - pointer to attribute
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   offset - offset of the first octet to be written
+ * @param   method - type of write message
+ *
+ * @return  SUCCESS, blePending or Failure
+ */
+static bStatus_t f91_oad_service_WriteAttrCB( uint16_t connHandle, gattAttribute_t *pAttr,
+                                        uint8_t *pValue, uint16_t len, uint16_t offset,
+                                        uint8_t method )
+{
+  bStatus_t status;
+  uint8_t notifyApp;
+
+  // Traffic for the link manager.
+  F91Link_countRx(len);
+
+  status = F91Service_write( &f91_oad_service, connHandle, pAttr, pValue, len, offset, &notifyApp );
+
+  // If a characteristic value changed then callback function to notify application of change
+  if ( (notifyApp != 0xFF ) && pOadAppCBs && pOadAppCBs->pfnOadChangeCb ) {
+    pOadAppCBs->pfnOadChangeCb( notifyApp );
+  }
+
+  return status;
+}
@@ -0,0 +1,175 @@
+/**********************************************************************************************
+ * Filename:       f91_oad_service.h
+ *
+ * Description:    This file contains the f91_oad_service service definitions and
+ *                 prototypes.
+ *
+ * Copyright (c) 2015-2021, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *************************************************************************************************/
+
+
+#ifndef _F91_OAD_SERVICE_H_
+#define _F91_OAD_SERVICE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+/*********************************************************************
+* CONSTANTS
+*/
+
+// Profile Parameters
+#define F91_OAD_SERVICE_CHAR1                   0  // WN uint8 - Profile Characteristic 1 value (Control)
+#define F91_OAD_SERVICE_CHAR2                   1  // W  uint8 - Profile Characteristic 2 value (Image Block)
+
+// Service UUID
+#define F91_OAD_SERVICE_UUID                    0xC2F0
+
+// Characteristic UUID
+#define F91_OAD_SERVICE_CHAR1_UUID              0xC2F1
+#define F91_OAD_SERVICE_CHAR2_UUID              0xC2F2
+
+// Control, written as [op] followed by its arguments and notified as
+// [op][status][next block lo][next block hi] (see f91_oad.h).
+#define OAD_CONTROL_LEN                         11
+#define OAD_CONTROL_LEN_MIN                     1
+#define OAD_RSP_LEN                             4
+
+// Image blocks, written without response so the phone can send several per
+// connection event: [block lo][block hi] followed by OAD_BLOCK_LEN bytes of
+// image, less for the last block. A block must fit in one write, ATT_MTU
+// has to be raised first. Blocks are queued until the application task has
+// programmed them, a block that doesn't fit is dropped and the phone is
+// told where to pick up again.
+#define OAD_BLOCK_LEN                           128
+#define OAD_BLOCK_HDR_LEN                       2
+#define OAD_BLOCK_QUEUE_LEN                     4   // power of 2
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Value handed out by GetParameter for the control characteristic.
+typedef struct
+{
+  uint8_t len;
+  uint8_t data[OAD_CONTROL_LEN];
+} f91_oad_serviceControl_t;
+
+// Block handed out by GetParameter for the image block characteristic, in
+// place in the queue until F91_oad_service_ReleaseBlock.
+typedef struct
+{
+  uint8_t len;
+  uint8_t data[OAD_BLOCK_HDR_LEN + OAD_BLOCK_LEN];
+} f91_oad_serviceBlock_t;
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * Profile Callbacks
+ */
+
+// Callback when a characteristic value has changed
+typedef void (*f91_oad_serviceChange_t)( uint8 paramID );
+
+typedef struct
+{
+  f91_oad_serviceChange_t        pfnOadChangeCb;  // Called when characteristic value changes
+} f91_oad_serviceCBs_t;
+
+
+
+/*********************************************************************
+ * API FUNCTIONS
+ */
+
+
+/*
+ * F91_oad_service_AddService- Initializes the F91_oad_service service by registering
+ *          GATT attributes with the GATT server.
+ *
+ */
+extern bStatus_t F91_oad_service_AddService(void);
+
+/*
+ * F91_oad_service_RegisterAppCBs - Registers the application callback function.
+ *                    Only call this function once.
+ *
+ *    appCallbacks - pointer to application callbacks.
+ */
+extern bStatus_t F91_oad_service_RegisterAppCBs( f91_oad_serviceCBs_t *appCallbacks );
+
+/*
+ * F91_oad_service_SetParameter - Set a F91_oad_service parameter.
+ *
+ *    param - Profile parameter ID
+ *    len - length of data to write
+ *    value - pointer to data to write.  This is dependent on
+ *          the parameter ID and WILL be cast to the appropriate
+ *          data type (example: data type of uint16 will be cast to
+ *          uint16 pointer).
+ */
+extern bStatus_t F91_oad_service_SetParameter( uint8_t param, uint16_t len, void *value );
+
+/*
+ * F91_oad_service_GetParameter - Get a F91_oad_service parameter.
+ *
+ *    param - Profile parameter ID
+ *    value - pointer to data to write.  This is dependent on
+ *          the parameter ID and WILL be cast to the appropriate
+ *          data type (example: data type of uint16 will be cast to
+ *          uint16 pointer).
+ */
+extern bStatus_t F91_oad_service_GetParameter( uint8_t param, void *value );
+
+/*
+ * F91_oad_service_ReleaseBlock - Release the oldest block, once the
+ *          application is done with it.
+ */
+extern void F91_oad_service_ReleaseBlock( void );
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _F91_OAD_SERVICE_H_ */
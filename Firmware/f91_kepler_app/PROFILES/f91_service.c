@@ -0,0 +1,701 @@
+/**********************************************************************************************
+ * Filename:       f91_service.c
+ *
+ * Description:    This file contains the attribute dispatch shared by the F91 services.
+ *
+ *                 The attribute map is built once from the characteristic table,
+ *                 matching each value attribute by its storage. A read or write then
+ *                 goes from the attribute's place in the table to its characteristic,
+ *                 with the length limits checked here for every plain value.
+ *
+ * Copyright (c) 2015-2021, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include <icall.h>
+#include "icall_ble_api.h"
+#include "linkdb.h"
+
+#include "f91_service.h"
+#include "f91_att_queue.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// 32 bit FNV-1a
+#define F91_SERVICE_HASH_BASIS                 0x811C9DC5
+#define F91_SERVICE_HASH_PRIME                 0x01000193
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Services initialized, for F91Service_syncCfg.
+static const f91Service_t *f91Services[F91_SERVICE_MAX];
+static uint8_t f91NumServices = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static void f91Service_syncSlots( const f91Service_t *pService, uint8_t param );
+static uint32_t f91Service_hash( uint32_t hash, const uint8_t *pData, uint8_t len );
+static const f91ServiceChar_t *f91Service_getChar( const f91Service_t *pService,
+                                                   gattAttribute_t *pAttr, uint8_t *pParam );
+static bStatus_t f91Service_reassemble( const f91ServiceChar_t *pChar, uint8_t *pValue,
+                                        uint16_t len, uint16_t offset );
+static bStatus_t f91Service_notify( const f91Service_t *pService, uint8_t param,
+                                    uint16_t connHandle );
+static void f91Service_addAttr( f91Service_t *pService, uint8_t uuidLen, const uint8_t *pUUID,
+                                uint8_t permit, uint8_t *pValue, uint8_t param );
+
+/*********************************************************************
+ * @fn      f91Service_syncSlots
+ *
+ * @brief   Rebuild the notification slots of a characteristic from its
+ *          configuration table.
+ *
+ * @param   pService - service description
+ * @param   param - parameter ID, of a characteristic that notifies
+ *
+ * @return  none
+ */
+static void f91Service_syncSlots( const f91Service_t *pService, uint8_t param )
+{
+  gattCharCfg_t *pCfg = *pService->pChars[param].ppCfg;
+  uint8_t slots = 0;
+  uint8_t i;
+
+  for ( i = 0; i < linkDBNumConns; i++ )
+  {
+    if ( ( pCfg[i].connHandle != INVALID_CONNHANDLE ) &&
+         ( pCfg[i].value & GATT_CLIENT_CFG_NOTIFY ) )
+    {
+      slots |= (1 << i);
+    }
+  }
+
+  pService->pIndex[param].notifySlots = slots;
+}
+
+/*********************************************************************
+ * @fn      f91Service_hash
+ *
+ * @brief   Add bytes to a hash.
+ *
+ * @param   hash - hash so far
+ * @param   pData - bytes to add
+ * @param   len - number of bytes
+ *
+ * @return  the new hash
+ */
+static uint32_t f91Service_hash( uint32_t hash, const uint8_t *pData, uint8_t len )
+{
+  while ( len-- > 0 )
+  {
+    hash = ( hash ^ *pData++ ) * F91_SERVICE_HASH_PRIME;
+  }
+
+  return ( hash );
+}
+
+/*********************************************************************
+ * @fn      f91Service_getChar
+ *
+ * @brief   Characteristic of a value attribute.
+ *
+ * @param   pService - service description
+ * @param   pAttr - pointer to attribute
+ * @param   pParam - set to the parameter ID or F91_SERVICE_ATTR_xxx
+ *
+ * @return  the characteristic, NULL if the attribute is not a value
+ */
+static const f91ServiceChar_t *f91Service_getChar( const f91Service_t *pService,
+                                                   gattAttribute_t *pAttr, uint8_t *pParam )
+{
+  *pParam = F91Service_getParam( pService, pAttr );
+
+  return ( *pParam < pService->numChars ) ? &pService->pChars[*pParam] : NULL;
+}
+
+/*********************************************************************
+ * @fn      f91Service_reassemble
+ *
+ * @brief   Add a write to a value that can be written with a long write.
+ *          A long write hands over its queued fragments one after the other
+ *          on execute. Offset 0 starts a new value, anything else has to
+ *          follow on from what was received so far. On error the partial
+ *          value is dropped.
+ *
+ * @param   pChar - characteristic, with a length
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   offset - offset of the first octet to be written
+ *
+ * @return  SUCCESS, ATT_ERR_INVALID_OFFSET or ATT_ERR_INVALID_VALUE_SIZE
+ */
+static bStatus_t f91Service_reassemble( const f91ServiceChar_t *pChar, uint8_t *pValue,
+                                        uint16_t len, uint16_t offset )
+{
+  if ( offset == 0 ) {
+    *pChar->pLen = 0;
+  }
+
+  if ( offset != *pChar->pLen ) {
+    *pChar->pLen = 0;
+    return ( ATT_ERR_INVALID_OFFSET );
+  }
+
+  if ( len > pChar->maxLen - offset ) {
+    *pChar->pLen = 0;
+    return ( ATT_ERR_INVALID_VALUE_SIZE );
+  }
+
+  memcpy(pChar->pValue + offset, pValue, len);
+  *pChar->pLen = offset + len;
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      f91Service_notify
+ *
+ * @brief   Notify a value to one client, through the ATT queue so it goes
+ *          out in order with what the connection already has waiting.
+ *          Only the first ATT_MTU - 3 octets of a longer value are sent.
+ *          The value attribute comes from the index.
+ *
+ * @param   pService - service description
+ * @param   param - parameter ID
+ * @param   connHandle - connection to notify
+ *
+ * @return  SUCCESS if sent or queued, or the failure
+ */
+static bStatus_t f91Service_notify( const f91Service_t *pService, uint8_t param,
+                                    uint16_t connHandle )
+{
+  attHandleValueNoti_t noti;
+  gattAttribute_t *pAttr = &pService->pAttrTbl[pService->pIndex[param].valueAttr];
+  uint16_t len;
+  bStatus_t status;
+
+  noti.pValue = (uint8_t *)GATT_bm_alloc( connHandle, ATT_HANDLE_VALUE_NOTI,
+                                          GATT_MAX_MTU, &len );
+  if ( noti.pValue == NULL )
+  {
+    return ( bleNoResources );
+  }
+
+  status = pService->pCBs->pfnReadAttrCB( connHandle, pAttr, noti.pValue, &noti.len,
+                                          0, len, GATT_LOCAL_READ );
+  if ( status == SUCCESS )
+  {
+    noti.handle = pAttr->handle;
+    status = F91AttQueue_sendNoti( connHandle, &noti );
+  }
+
+  if ( status != SUCCESS )
+  {
+    GATT_bm_free( (gattMsg_t *)&noti, ATT_HANDLE_VALUE_NOTI );
+  }
+
+  return ( status );
+}
+
+/*********************************************************************
+ * @fn      f91Service_addAttr
+ *
+ * @brief   Append an attribute to the table being built, with its entry
+ *          in the attribute map.
+ *
+ * @param   pService - service description
+ * @param   uuidLen - ATT_BT_UUID_SIZE or ATT_UUID_SIZE
+ * @param   pUUID - attribute type
+ * @param   permit - GATT_PERMIT_xxx
+ * @param   pValue - attribute value
+ * @param   param - parameter ID or F91_SERVICE_ATTR_xxx
+ *
+ * @return  none
+ */
+static void f91Service_addAttr( f91Service_t *pService, uint8_t uuidLen, const uint8_t *pUUID,
+                                uint8_t permit, uint8_t *pValue, uint8_t param )
+{
+  gattAttribute_t *pAttr = &pService->pAttrTbl[pService->numAttrs];
+
+  pAttr->type.len = uuidLen;
+  pAttr->type.uuid = pUUID;
+  pAttr->permissions = permit;
+  pAttr->handle = 0;
+  pAttr->pValue = pValue;
+
+  pService->pAttrMap[pService->numAttrs++] = param;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      F91Service_init
+ *
+ * @brief   Build the attribute table from the characteristics, so the two
+ *          can't disagree: the service declaration, then for each
+ *          characteristic its declaration, value, configuration if it
+ *          notifies and user description. The attribute map and the index
+ *          the other way are filled in as it goes. Every F91 notification
+ *          is for the bonded phone only, a configuration is written over an
+ *          authenticated link. The configurations start out empty. Then
+ *          the table is registered with the GATT server.
+ *
+ * @param   pService - service description
+ *
+ * @return  SUCCESS, bleMemAllocError or the registration failure
+ */
+bStatus_t F91Service_init( f91Service_t *pService )
+{
+  const f91ServiceChar_t *pChar;
+  gattCharCfg_t *pCfg;
+  uint8_t numAttrs = 1;
+  uint8_t param;
+
+  for ( param = 0; param < pService->numChars; param++ )
+  {
+    numAttrs += ( pService->pChars[param].ppCfg != NULL ) ? 4 : 3;
+  }
+
+  pService->pAttrTbl = (gattAttribute_t *)ICall_malloc( sizeof( gattAttribute_t ) * numAttrs );
+  pService->pAttrMap = (uint8_t *)ICall_malloc( numAttrs );
+  if ( (pService->pAttrTbl == NULL) || (pService->pAttrMap == NULL) )
+  {
+    return ( bleMemAllocError );
+  }
+  pService->numAttrs = 0;
+
+  f91Service_addAttr( pService, ATT_BT_UUID_SIZE, primaryServiceUUID, GATT_PERMIT_READ,
+                      (uint8_t *)pService->pDecl, F91_SERVICE_ATTR_NONE );
+
+  for ( param = 0; param < pService->numChars; param++ )
+  {
+    pChar = &pService->pChars[param];
+
+    f91Service_addAttr( pService, ATT_BT_UUID_SIZE, characterUUID, GATT_PERMIT_READ,
+                        pChar->pProps, F91_SERVICE_ATTR_NONE );
+
+    pService->pIndex[param].valueAttr = pService->numAttrs;
+    pService->pIndex[param].notifySlots = 0;
+    f91Service_addAttr( pService, ATT_UUID_SIZE, pChar->pUUID, pChar->permit,
+                        pChar->pValue, param );
+
+    if ( pChar->ppCfg != NULL )
+    {
+      pCfg = (gattCharCfg_t *)ICall_malloc( sizeof( gattCharCfg_t ) * linkDBNumConns );
+      if ( pCfg == NULL )
+      {
+        return ( bleMemAllocError );
+      }
+      GATTServApp_InitCharCfg( INVALID_CONNHANDLE, pCfg );
+      *pChar->ppCfg = pCfg;
+
+      f91Service_addAttr( pService, ATT_BT_UUID_SIZE, clientCharCfgUUID,
+                          GATT_PERMIT_READ | GATT_PERMIT_AUTHEN_WRITE,
+                          (uint8_t *)pChar->ppCfg, F91_SERVICE_ATTR_CCC );
+    }
+
+    f91Service_addAttr( pService, ATT_BT_UUID_SIZE, charUserDescUUID, GATT_PERMIT_READ,
+                        pChar->pDesc, F91_SERVICE_ATTR_NONE );
+  }
+
+  if ( f91NumServices < F91_SERVICE_MAX )
+  {
+    f91Services[f91NumServices++] = pService;
+  }
+
+  return GATTServApp_RegisterService( pService->pAttrTbl, pService->numAttrs,
+                                      GATT_MAX_ENCRYPT_KEY_SIZE, pService->pCBs );
+}
+
+/*********************************************************************
+ * @fn      F91Service_syncCfg
+ *
+ * @brief   Rebuild the notification slots of every service. Clients write
+ *          their configuration through F91Service_write, which keeps the
+ *          slots up to date, but the stack also sets them on its own: it
+ *          restores those of a bonded client and clears them on a
+ *          disconnection.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void F91Service_syncCfg( void )
+{
+  const f91Service_t *pService;
+  uint8_t i, param;
+
+  for ( i = 0; i < f91NumServices; i++ )
+  {
+    pService = f91Services[i];
+    for ( param = 0; param < pService->numChars; param++ )
+    {
+      if ( pService->pChars[param].ppCfg != NULL )
+      {
+        f91Service_syncSlots( pService, param );
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      F91Service_getHash
+ *
+ * @brief   Hash what a client caches of the services: the type and
+ *          permissions of every attribute, the UUID a service declaration
+ *          declares and the properties a characteristic declaration does.
+ *          Handles follow from the order, the values are left out.
+ *
+ * @param   none
+ *
+ * @return  the hash
+ */
+uint32_t F91Service_getHash( void )
+{
+  const f91Service_t *pService;
+  gattAttribute_t *pAttr;
+  gattAttrType_t *pDecl;
+  uint16_t uuid;
+  uint32_t hash = F91_SERVICE_HASH_BASIS;
+  uint8_t i, j;
+
+  for ( i = 0; i < f91NumServices; i++ )
+  {
+    pService = f91Services[i];
+    for ( j = 0; j < pService->numAttrs; j++ )
+    {
+      pAttr = &pService->pAttrTbl[j];
+      hash = f91Service_hash( hash, pAttr->type.uuid, pAttr->type.len );
+      hash = f91Service_hash( hash, &pAttr->permissions, sizeof( pAttr->permissions ) );
+
+      if ( pAttr->type.len != ATT_BT_UUID_SIZE )
+      {
+        continue;
+      }
+
+      uuid = BUILD_UINT16( pAttr->type.uuid[0], pAttr->type.uuid[1] );
+      if ( uuid == GATT_PRIMARY_SERVICE_UUID )
+      {
+        pDecl = (gattAttrType_t *)pAttr->pValue;
+        hash = f91Service_hash( hash, pDecl->uuid, pDecl->len );
+      }
+      else if ( uuid == GATT_CHARACTER_UUID )
+      {
+        hash = f91Service_hash( hash, pAttr->pValue, 1 );
+      }
+    }
+  }
+
+  return ( hash );
+}
+
+/*********************************************************************
+ * @fn      F91Service_getParam
+ *
+ * @brief   Look an attribute up in the attribute map. The stack hands over
+ *          pointers into the registered table.
+ *
+ * @param   pService - service description
+ * @param   pAttr - pointer to attribute
+ *
+ * @return  parameter ID, or F91_SERVICE_ATTR_xxx
+ */
+uint8_t F91Service_getParam( const f91Service_t *pService, gattAttribute_t *pAttr )
+{
+  if ( (pAttr < pService->pAttrTbl) || (pAttr >= pService->pAttrTbl + pService->numAttrs) )
+  {
+    return ( F91_SERVICE_ATTR_NONE );
+  }
+
+  return pService->pAttrMap[pAttr - pService->pAttrTbl];
+}
+
+/*********************************************************************
+ * @fn      F91Service_read
+ *
+ * @brief   Read an attribute. Only values are read here, the stack reads
+ *          the other attributes itself.
+ *
+ * @param   pService - service description
+ * @param   pAttr - pointer to attribute
+ * @param   pValue - pointer to data to be read
+ * @param   pLen - length of data to be read
+ * @param   offset - offset of the first octet to be read
+ * @param   maxLen - maximum length of data to be read
+ *
+ * @return  SUCCESS, ATT_ERR_ATTR_NOT_LONG or ATT_ERR_INVALID_OFFSET
+ */
+bStatus_t F91Service_read( const f91Service_t *pService, gattAttribute_t *pAttr,
+                           uint8_t *pValue, uint16_t *pLen, uint16_t offset,
+                           uint16_t maxLen )
+{
+  const f91ServiceChar_t *pChar;
+  uint16_t valueLen;
+  uint8_t param;
+
+  if ( (pChar = f91Service_getChar( pService, pAttr, &param )) == NULL )
+  {
+    return ( SUCCESS );
+  }
+
+  if ( (offset > 0) && !(pChar->flags & F91_SERVICE_LONG) )
+  {
+    return ( ATT_ERR_ATTR_NOT_LONG );
+  }
+
+  if ( pChar->pfnRead )
+  {
+    return pChar->pfnRead( pValue, pLen, offset, maxLen );
+  }
+
+  valueLen = pChar->pLen ? *pChar->pLen : pChar->maxLen;
+  if ( offset > valueLen )
+  {
+    return ( ATT_ERR_INVALID_OFFSET );
+  }
+
+  *pLen = MIN( maxLen, valueLen - offset );  // Transmit as much as possible
+  memcpy( pValue, pChar->pValue + offset, *pLen );
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      F91Service_write
+ *
+ * @brief   Write an attribute: a value or a configuration.
+ *
+ * @param   pService - service description
+ * @param   connHandle - connection message was received on
+ * @param   pAttr - pointer to attribute
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   offset - offset of the first octet to be written
+ * @param   pParam - set to the parameter ID to tell the application about, 0xFF if none
+ *
+ * @return  SUCCESS, or an ATT error
+ */
+bStatus_t F91Service_write( const f91Service_t *pService, uint16_t connHandle,
+                            gattAttribute_t *pAttr, uint8_t *pValue, uint16_t len,
+                            uint16_t offset, uint8_t *pParam )
+{
+  const f91ServiceChar_t *pChar;
+  bStatus_t status = SUCCESS;
+  bool notify = false;
+  uint8_t param;
+
+  *pParam = 0xFF;
+
+  if ( (pChar = f91Service_getChar( pService, pAttr, &param )) == NULL )
+  {
+    if ( param == F91_SERVICE_ATTR_CCC )
+    {
+      status = GATTServApp_ProcessCCCWriteReq( connHandle, pAttr, pValue, len,
+                                               offset, GATT_CLIENT_CFG_NOTIFY );
+      // The configuration comes after its value.
+      param = F91Service_getParam( pService, pAttr - 1 );
+      if ( ( status == SUCCESS ) && ( param < pService->numChars ) )
+      {
+        f91Service_syncSlots( pService, param );
+      }
+      return ( status );
+    }
+    return ( ATT_ERR_INVALID_HANDLE );
+  }
+
+  if ( pChar->pfnWrite )
+  {
+    status = pChar->pfnWrite( pValue, len, offset, &notify );
+  }
+  else if ( pChar->flags & F91_SERVICE_LONG_WRITE )
+  {
+    status = f91Service_reassemble( pChar, pValue, len, offset );
+    // One event per write. All fragments of an execute are written before
+    // the application task gets to run, so it sees the complete value.
+    notify = (status == SUCCESS) && (offset == 0);
+  }
+  else if ( pChar->pLen == NULL )
+  {
+    if ( offset > 0 )
+    {
+      status = ATT_ERR_ATTR_NOT_LONG;
+    }
+    else if ( len != pChar->maxLen )
+    {
+      status = ATT_ERR_INVALID_VALUE_SIZE;
+    }
+    else
+    {
+      memcpy( pChar->pValue, pValue, len );
+      notify = true;
+    }
+  }
+  else if ( offset + len > pChar->maxLen )
+  {
+    status = ATT_ERR_INVALID_VALUE_SIZE;
+  }
+  else
+  {
+    memcpy( pChar->pValue + offset, pValue, len );
+    if ( offset + len >= pChar->minLen )
+    {
+      *pChar->pLen = offset + len; // Update data length.
+      notify = true;
+    }
+  }
+
+  if ( (status == SUCCESS) && notify )
+  {
+    *pParam = param;
+  }
+
+  return ( status );
+}
+
+/*********************************************************************
+ * @fn      F91Service_setValue
+ *
+ * @brief   Set a characteristic value from the application, then notify
+ *          it to every client that enabled it. Only the slots of those
+ *          clients are visited. A bonded client's configuration is back
+ *          before its link is encrypted again, it is skipped until the
+ *          link is authenticated.
+ *
+ * @param   pService - service description
+ * @param   param - parameter ID
+ * @param   len - length of data to write
+ * @param   value - pointer to data to write
+ *
+ * @return  SUCCESS, INVALIDPARAMETER, bleInvalidRange or the first
+ *          failed notification status
+ */
+bStatus_t F91Service_setValue( const f91Service_t *pService, uint8_t param,
+                               uint16_t len, void *value )
+{
+  const f91ServiceChar_t *pChar;
+  gattCharCfg_t *pCfg;
+  bStatus_t status = SUCCESS;
+  bStatus_t ret;
+  uint8_t slots;
+  uint8_t i;
+
+  if ( param >= pService->numChars )
+  {
+    return ( INVALIDPARAMETER );
+  }
+
+  pChar = &pService->pChars[param];
+  if ( pChar->pLen ? ((len < pChar->minLen) || (len > pChar->maxLen)) : (len != pChar->maxLen) )
+  {
+    return ( bleInvalidRange );
+  }
+
+  memcpy( pChar->pValue, value, len );
+  if ( pChar->pLen )
+  {
+    *pChar->pLen = len;
+  }
+
+  if ( pChar->ppCfg == NULL )
+  {
+    return ( SUCCESS );
+  }
+
+  pCfg = *pChar->ppCfg;
+  for ( i = 0, slots = pService->pIndex[param].notifySlots; slots != 0; i++, slots >>= 1 )
+  {
+    // A slot cleared by the stack since the last sync is skipped. The
+    // first failure is reported as is, the remaining slots still notify.
+    if ( ( slots & 1 ) && ( pCfg[i].connHandle != INVALID_CONNHANDLE ) &&
+         linkDB_State( pCfg[i].connHandle, LINK_AUTHENTICATED ) )
+    {
+      ret = f91Service_notify( pService, param, pCfg[i].connHandle );
+      if ( ( status == SUCCESS ) && ( ret != SUCCESS ) )
+      {
+        status = ret;
+      }
+    }
+  }
+
+  return ( status );
+}
+
+/*********************************************************************
+ * @fn      F91Service_getValue
+ *
+ * @brief   Copy a characteristic value out, its current length for a
+ *          variable length one.
+ *
+ * @param   pService - service description
+ * @param   param - parameter ID
+ * @param   value - pointer to data to read into, maxLen bytes
+ *
+ * @return  SUCCESS or INVALIDPARAMETER
+ */
+bStatus_t F91Service_getValue( const f91Service_t *pService, uint8_t param,
+                               void *value )
+{
+  const f91ServiceChar_t *pChar;
+
+  if ( param >= pService->numChars )
+  {
+    return ( INVALIDPARAMETER );
+  }
+
+  pChar = &pService->pChars[param];
+  memcpy( value, pChar->pValue, pChar->pLen ? *pChar->pLen : pChar->maxLen );
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+*********************************************************************/
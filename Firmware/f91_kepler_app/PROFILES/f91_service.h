@@ -0,0 +1,205 @@
+/**********************************************************************************************
+ * Filename:       f91_service.h
+ *
+ * Description:    This file contains the definitions and prototypes shared by the
+ *                 F91 services: a service is described by its attribute table and
+ *                 a table of its characteristic values, reads and writes are
+ *                 dispatched from the attribute to the value in one step.
+ *
+ * Copyright (c) 2015-2021, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *************************************************************************************************/
+
+#ifndef _F91_SERVICE_H_
+#define _F91_SERVICE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "bcomdef.h"
+#include "att.h"
+#include "gatt.h"
+#include "gatt_uuid.h"
+#include "gattservapp.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Attribute map entries for the attributes that are not a characteristic value.
+#define F91_SERVICE_ATTR_NONE                  0xFF  // declaration or description
+#define F91_SERVICE_ATTR_CCC                   0xFE  // client characteristic configuration
+
+// Characteristic value flags
+#define F91_SERVICE_LONG                       0x01  // may be read at an offset (Read Blob)
+#define F91_SERVICE_LONG_WRITE                 0x02  // reassembled from a long write, needs a length
+
+// Prepare writes the stack has to queue for a long write of len bytes at
+// the default ATT_MTU, each carries ATT_MTU_SIZE - 5 bytes.
+#define F91_SERVICE_PREPARE_WRITES( len )      ( ( (len) + ATT_MTU_SIZE - 6 ) / ( ATT_MTU_SIZE - 5 ) )
+
+// Services sharing the configuration index, synced together.
+#define F91_SERVICE_MAX                        4
+
+// Configuration slots (one per connection) are tracked in a byte.
+#if defined( MAX_NUM_BLE_CONNS ) && ( MAX_NUM_BLE_CONNS > 8 )
+#error "F91 services track at most 8 connections"
+#endif
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Read of a value that isn't a plain copy. Offset is 0 unless F91_SERVICE_LONG.
+typedef bStatus_t (*f91ServiceRead_t)( uint8_t *pValue, uint16_t *pLen, uint16_t offset,
+                                       uint16_t maxLen );
+
+// Write of a value that isn't a plain copy, *pNotify set to tell the application.
+typedef bStatus_t (*f91ServiceWrite_t)( uint8_t *pValue, uint16_t len, uint16_t offset,
+                                        bool *pNotify );
+
+// A characteristic, the one description its attributes are built from:
+// declaration, value, configuration if it notifies and user description.
+// Without a length the value is exactly maxLen bytes, written whole. With one
+// it is minLen to maxLen bytes, written at any offset, and the application
+// hears about it once it holds minLen bytes. With F91_SERVICE_LONG_WRITE
+// offset 0 starts a new value, each fragment has to follow on, and the
+// application hears about every write at offset 0.
+typedef struct
+{
+  uint8_t           *pProps;            // GATT_PROP_xxx, the declaration's value
+  const uint8_t     *pUUID;             // 128-bit UUID of the value
+  uint8_t           permit;             // GATT_PERMIT_xxx of the value
+  uint8_t           *pDesc;             // user description
+  uint8_t           *pValue;            // value storage, the value attribute's pValue
+  uint16_t          *pLen;              // current length, NULL for a fixed length
+  uint16_t          minLen;
+  uint16_t          maxLen;
+  uint8_t           flags;              // F91_SERVICE_xxx
+  gattCharCfg_t     **ppCfg;            // configuration if it notifies, NULL otherwise, allocated at init
+  f91ServiceRead_t  pfnRead;            // NULL for a copy of the value
+  f91ServiceWrite_t pfnWrite;           // NULL for a copy into the value
+} f91ServiceChar_t;
+
+// Index of a characteristic, built by F91Service_init so a notification
+// needs no search of the tables.
+typedef struct
+{
+  uint8_t                 valueAttr;    // value attribute in the attribute table
+  uint8_t                 notifySlots;  // configuration slots with notifications on, a bit each
+} f91ServiceIndex_t;
+
+// A service. The characteristics are indexed by their parameter ID.
+typedef struct
+{
+  const gattAttrType_t    *pDecl;       // service declaration, the service UUID
+  const f91ServiceChar_t  *pChars;
+  uint8_t                 numChars;
+  f91ServiceIndex_t       *pIndex;      // one per characteristic
+  const gattServiceCBs_t  *pCBs;        // registered with the attributes
+  // Built by F91Service_init.
+  gattAttribute_t         *pAttrTbl;
+  uint8_t                 numAttrs;
+  uint8_t                 *pAttrMap;    // parameter ID or F91_SERVICE_ATTR_xxx, one per attribute
+} f91Service_t;
+
+/*********************************************************************
+ * API FUNCTIONS
+ */
+
+/*
+ * F91Service_init - Build the attribute table, map and index from the
+ *          characteristics and register the service, once.
+ */
+extern bStatus_t F91Service_init( f91Service_t *pService );
+
+/*
+ * F91Service_syncCfg - Rebuild the notification slots of every service from the
+ *          configurations, after the stack changed them: connection, bond
+ *          restored, disconnection.
+ */
+extern void F91Service_syncCfg( void );
+
+/*
+ * F91Service_getHash - Hash of the layout of every service, changes when the
+ *          attribute database does.
+ */
+extern uint32_t F91Service_getHash( void );
+
+/*
+ * F91Service_getParam - Parameter ID of an attribute, or F91_SERVICE_ATTR_xxx.
+ */
+extern uint8_t F91Service_getParam( const f91Service_t *pService, gattAttribute_t *pAttr );
+
+/*
+ * F91Service_read - Read an attribute of the service.
+ */
+extern bStatus_t F91Service_read( const f91Service_t *pService, gattAttribute_t *pAttr,
+                                  uint8_t *pValue, uint16_t *pLen, uint16_t offset,
+                                  uint16_t maxLen );
+
+/*
+ * F91Service_write - Write an attribute of the service, *pParam is set to the
+ *          parameter ID to tell the application about or 0xFF.
+ */
+extern bStatus_t F91Service_write( const f91Service_t *pService, uint16_t connHandle,
+                                   gattAttribute_t *pAttr, uint8_t *pValue, uint16_t len,
+                                   uint16_t offset, uint8_t *pParam );
+
+/*
+ * F91Service_setValue - Set a characteristic value, notified if it notifies.
+ */
+extern bStatus_t F91Service_setValue( const f91Service_t *pService, uint8_t param,
+                                      uint16_t len, void *value );
+
+/*
+ * F91Service_getValue - Copy a characteristic value out.
+ */
+extern bStatus_t F91Service_getValue( const f91Service_t *pService, uint8_t param,
+                                      void *value );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _F91_SERVICE_H_ */
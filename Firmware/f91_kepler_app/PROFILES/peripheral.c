@@ -80,11 +80,15 @@
 #define START_ADVERTISING_EVT         Event_Id_00
 #define START_CONN_UPDATE_EVT         Event_Id_01
 #define CONN_PARAM_TIMEOUT_EVT        Event_Id_02
+#define ADV_NEXT_STEP_EVT             Event_Id_03
+#define ADV_RESTART_SCHEDULE_EVT      Event_Id_04
 
-#define GAPROLE_ALL_EVENTS            (GAPROLE_ICALL_EVT     | \
-                                       START_ADVERTISING_EVT | \
-                                       START_CONN_UPDATE_EVT | \
-                                       CONN_PARAM_TIMEOUT_EVT)
+#define GAPROLE_ALL_EVENTS            (GAPROLE_ICALL_EVT      | \
+                                       START_ADVERTISING_EVT  | \
+                                       START_CONN_UPDATE_EVT  | \
+                                       CONN_PARAM_TIMEOUT_EVT | \
+                                       ADV_NEXT_STEP_EVT      | \
+                                       ADV_RESTART_SCHEDULE_EVT)
 
 #define DEFAULT_ADVERT_OFF_TIME       30000   // 30 seconds
 
@@ -164,6 +168,7 @@ static ICall_SyncHandle syncEvent;
 static Clock_Struct startAdvClock;
 static Clock_Struct startUpdateClock;
 static Clock_Struct updateTimeoutClock;
+static Clock_Struct advStepClock;
 
 // Task setup
 Task_Struct gapRoleTask;
@@ -233,6 +238,20 @@ static uint8_t  gapRole_ConnTermReason = 0;
 
 static uint8_t paramUpdateNoSuccessOption = GAPROLE_NO_ACTION;
 
+// Advertising schedule, no steps to use the GAP interval as set.
+static gapRoleAdvStep_t gapRole_AdvSchedule[GAPROLE_ADV_SCHEDULE_MAX_STEPS];
+static uint8_t  gapRole_AdvScheduleLen = 0;
+static uint8_t  gapRole_AdvStep = 0;
+
+// Advertising was ended to change step, not to stop.
+static uint8_t  gapRole_AdvStepping = FALSE;
+
+// Advertising in progress and since boot.
+static uint8_t  gapRole_AdvOn = FALSE;
+static uint32_t gapRole_AdvStartTicks;
+static uint16_t gapRole_AdvInt;
+static gapRoleAdvStats_t gapRole_AdvStats = {0};
+
 // Application callbacks
 static gapRolesCBs_t *pGapRoles_AppCGs = NULL;
 static gapRolesParamUpdateCB_t *pGapRoles_ParamUpdateCB = NULL;
@@ -259,6 +278,9 @@ static bStatus_t gapRole_startConnUpdate(uint8_t handleFailure,
                                        gapRole_updateConnParams_t *pConnParams);
 
 static void gapRole_setEvent(uint32_t event);
+static void gapRole_advStarted(void);
+static void gapRole_advStopped(void);
+static uint32_t gapRole_advEvents(uint32_t ms, uint16_t advInt);
 
 /*********************************************************************
  * CALLBACKS
@@ -596,6 +618,22 @@ bStatus_t GAPRole_SetParameter(uint16_t param, uint8_t len, void *pValue)
         }
         break;
 
+    case GAPROLE_ADV_SCHEDULE:
+      if ((len >= sizeof(gapRoleAdvStep_t)) &&
+          (len <= sizeof(gapRole_AdvSchedule)) &&
+          (len % sizeof(gapRoleAdvStep_t) == 0))
+      {
+        // Taken on the next start or step
+        VOID memcpy(gapRole_AdvSchedule, pValue, len);
+        gapRole_AdvScheduleLen = len / sizeof(gapRoleAdvStep_t);
+        gapRole_AdvStep = 0;
+      }
+      else
+      {
+        ret = bleInvalidRange;
+      }
+      break;
+
     default:
       // The param value isn't part of this profile, try the GAP.
       if ((param < TGAP_PARAMID_MAX) && (len == sizeof (uint16_t)))
@@ -734,6 +772,33 @@ bStatus_t GAPRole_GetParameter(uint16_t param, void *pValue)
       *((uint8_t*)pValue) = gapRole_ConnTermReason;
       break;
 
+    case GAPROLE_ADV_SCHEDULE:
+      VOID memcpy(pValue, gapRole_AdvSchedule,
+                  gapRole_AdvScheduleLen * sizeof(gapRoleAdvStep_t));
+      break;
+
+    case GAPROLE_ADV_STEP:
+      *((uint8_t*)pValue) = gapRole_AdvStep;
+      break;
+
+    case GAPROLE_ADV_STATS:
+      {
+        gapRoleAdvStats_t *pStats = (gapRoleAdvStats_t *)pValue;
+
+        *pStats = gapRole_AdvStats;
+
+        // Count the advertising in progress too
+        if (gapRole_AdvOn)
+        {
+          uint32_t ms = (Clock_getTicks() - gapRole_AdvStartTicks) /
+                        (1000 / Clock_tickPeriod);
+
+          pStats->advTime += ms;
+          pStats->advEvents += gapRole_advEvents(ms, gapRole_AdvInt);
+        }
+      }
+      break;
+
     default:
       // The param value isn't part of this profile, try the GAP.
       if (param < TGAP_PARAMID_MAX)
@@ -789,6 +854,17 @@ void GAPRole_RegisterAppCBs(gapRolesParamUpdateCB_t *pParamUpdateCB)
   }
 }
 
+/*********************************************************************
+ * @brief   Go back to the first step of the advertising schedule.
+ *
+ * Public function defined in peripheral.h.
+ */
+void GAPRole_RestartAdvertSchedule(void)
+{
+  // The GAPRole task owns the schedule
+  gapRole_setEvent(ADV_RESTART_SCHEDULE_EVT);
+}
+
 /*********************************************************************
  * @brief   Terminates the existing connection.
  *
@@ -864,6 +940,8 @@ static void gapRole_init(void)
                       0, 0, false, START_CONN_UPDATE_EVT);
   Util_constructClock(&updateTimeoutClock, gapRole_clockHandler,
                       0, 0, false, CONN_PARAM_TIMEOUT_EVT);
+  Util_constructClock(&advStepClock, gapRole_clockHandler,
+                      0, 0, false, ADV_NEXT_STEP_EVT);
 
   // Initialize the Profile Advertising and Connection Parameters
   gapRole_profileRole = GAP_PROFILE_PERIPHERAL;
@@ -964,6 +1042,17 @@ static void gapRole_taskFxn(UArg a0, UArg a1)
           params.channelMap = gapRole_AdvChanMap;
           params.filterPolicy = gapRole_AdvFilterPolicy;
 
+          // Interval of the schedule's step, taken when advertising starts
+          if (gapRole_AdvScheduleLen > 0)
+          {
+            uint16_t advInt = gapRole_AdvSchedule[gapRole_AdvStep].advInt;
+
+            VOID GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MIN, advInt);
+            VOID GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MAX, advInt);
+            VOID GAP_SetParamValue(TGAP_LIM_DISC_ADV_INT_MIN, advInt);
+            VOID GAP_SetParamValue(TGAP_LIM_DISC_ADV_INT_MAX, advInt);
+          }
+
           if (GAP_MakeDiscoverable(selfEntity, &params) != SUCCESS)
           {
             gapRole_state = GAPROLE_ERROR;
@@ -988,6 +1077,45 @@ static void gapRole_taskFxn(UArg a0, UArg a1)
         // Unsuccessful in updating connection parameters
         gapRole_HandleParamUpdateNoSuccess();
       }
+
+      if (events & ADV_RESTART_SCHEDULE_EVT)
+      {
+        if ((gapRole_AdvScheduleLen > 1) && (gapRole_AdvStepping == FALSE) &&
+            ((gapRole_state == GAPROLE_ADVERTISING) ||
+             (gapRole_state == GAPROLE_ADVERTISING_NONCONN)))
+        {
+          if (gapRole_AdvStep == 0)
+          {
+            // Already fast, stay on it for the whole step from now
+            Util_restartClock(&advStepClock, gapRole_AdvSchedule[0].duration);
+          }
+          else
+          {
+            // Restarted at the first step's interval
+            gapRole_AdvStep = 0;
+            gapRole_AdvStepping = TRUE;
+            VOID GAP_EndDiscoverable(selfEntity);
+          }
+        }
+        else
+        {
+          // Taken when advertising starts
+          gapRole_AdvStep = 0;
+        }
+      }
+
+      if (events & ADV_NEXT_STEP_EVT)
+      {
+        if ((gapRole_AdvStepping == FALSE) &&
+            (gapRole_AdvStep + 1 < gapRole_AdvScheduleLen) &&
+            ((gapRole_state == GAPROLE_ADVERTISING) ||
+             (gapRole_state == GAPROLE_ADVERTISING_NONCONN)))
+        {
+          gapRole_AdvStep++;
+          gapRole_AdvStepping = TRUE;
+          VOID GAP_EndDiscoverable(selfEntity);
+        }
+      }
     }
   } // for
 }
@@ -1127,11 +1255,14 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
     case GAP_END_DISCOVERABLE_DONE_EVENT:
       {
         gapMakeDiscoverableRspEvent_t *pPkt = (gapMakeDiscoverableRspEvent_t *)pMsg;
+        uint8_t stepped = FALSE;
 
         if (pPkt->hdr.status == SUCCESS)
         {
           if (pMsg->opcode == GAP_MAKE_DISCOVERABLE_DONE_EVENT)
           {
+            gapRole_advStarted();
+
             if (gapRole_state == GAPROLE_CONNECTED)
             {
               gapRole_state = GAPROLE_CONNECTED_ADV;
@@ -1145,8 +1276,20 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
               gapRole_state = GAPROLE_ADVERTISING_NONCONN;
             }
           }
+          else if ((gapRole_AdvStepping) &&
+                   ((gapRole_AdvEnabled) || (gapRole_AdvNonConnEnabled)))
+          {
+            // Ended to change step, start again at once in the same state
+            gapRole_advStopped();
+            gapRole_AdvStepping = FALSE;
+            gapRole_setEvent(START_ADVERTISING_EVT);
+            stepped = TRUE;
+          }
           else // GAP_END_DISCOVERABLE_DONE_EVENT
           {
+            gapRole_advStopped();
+            gapRole_AdvStepping = FALSE;
+
             if (gapRole_AdvertOffTime != 0)
             {
               if ((gapRole_AdvEnabled) || (gapRole_AdvNonConnEnabled))
@@ -1188,7 +1331,8 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
           gapRole_state = GAPROLE_ERROR;
         }
 
-        notify = TRUE;
+        // A step change isn't a state change
+        notify = (stepped == FALSE);
       }
       break;
 
@@ -1196,6 +1340,13 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
       {
         gapEstLinkReqEvent_t *pPkt = (gapEstLinkReqEvent_t *)pMsg;
 
+        // Connectable advertising ends with the connection
+        if (gapRole_state == GAPROLE_ADVERTISING)
+        {
+          gapRole_advStopped();
+          gapRole_AdvStepping = FALSE;
+        }
+
         if (pPkt->hdr.status == SUCCESS)
         {
           VOID memcpy(gapRole_ConnectedDevAddr, pPkt->devAddr, B_ADDR_LEN);
@@ -1282,7 +1433,9 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
             gapRole_state = GAPROLE_WAITING;
           }
 
-          // Start advertising, if enabled.
+          // Start advertising, if enabled, fast for the phone to find
+          // the watch again.
+          gapRole_AdvStep = 0;
           gapRole_setEvent(START_ADVERTISING_EVT);
         }
       }
@@ -1599,6 +1752,75 @@ bStatus_t GAPRole_SendUpdateParam(uint16_t minConnInterval,
   }
 }
 
+/*********************************************************************
+ * @fn      gapRole_advEvents
+ *
+ * @brief   Advertising events in a stretch of advertising at one interval.
+ *
+ * @param   ms - time advertising
+ * @param   advInt - advertising interval (units of 625us)
+ *
+ * @return  Number of advertising events.
+ */
+static uint32_t gapRole_advEvents(uint32_t ms, uint16_t advInt)
+{
+  if (advInt == 0)
+  {
+    return (0);
+  }
+
+  return ((ms * 8) / ((uint32_t)advInt * 5));
+}
+
+/*********************************************************************
+ * @fn      gapRole_advStarted
+ *
+ * @brief   Advertising started, time it and set the clock for the next
+ *          step of the schedule.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void gapRole_advStarted(void)
+{
+  gapRole_AdvOn = TRUE;
+  gapRole_AdvStartTicks = Clock_getTicks();
+  gapRole_AdvInt = GAP_GetParamValue(TGAP_GEN_DISC_ADV_INT_MIN);
+
+  if (gapRole_AdvStep + 1 < gapRole_AdvScheduleLen)
+  {
+    Util_restartClock(&advStepClock, gapRole_AdvSchedule[gapRole_AdvStep].duration);
+  }
+}
+
+/*********************************************************************
+ * @fn      gapRole_advStopped
+ *
+ * @brief   Advertising stopped, add it to the totals.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void gapRole_advStopped(void)
+{
+  uint32_t ms;
+
+  Util_stopClock(&advStepClock);
+
+  if (gapRole_AdvOn == FALSE)
+  {
+    return;
+  }
+
+  ms = (Clock_getTicks() - gapRole_AdvStartTicks) / (1000 / Clock_tickPeriod);
+
+  gapRole_AdvStats.advTime += ms;
+  gapRole_AdvStats.advEvents += gapRole_advEvents(ms, gapRole_AdvInt);
+  gapRole_AdvOn = FALSE;
+}
+
 /*********************************************************************
  * @fn      gapRole_setEvent
  *
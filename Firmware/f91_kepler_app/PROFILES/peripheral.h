@@ -404,12 +404,56 @@ extern "C"
  */
 #define GAPROLE_CONN_TERM_REASON    0x31D
 
+/**
+ * @brief Advertising schedule (Read/Write)
+ *
+ * Each step is advertised for its duration, then the next one. The last
+ * step lasts until advertising stops. The schedule starts over from the
+ * first step on a disconnect and on @ref GAPRole_RestartAdvertSchedule.
+ *
+ * size: array of 1 to @ref GAPROLE_ADV_SCHEDULE_MAX_STEPS gapRoleAdvStep_t
+ *
+ * default: none, the interval set with TGAP_GEN_DISC_ADV_INT_MIN/MAX is used
+ */
+#define GAPROLE_ADV_SCHEDULE        0x31E
+
+/**
+ * @brief Step of the advertising schedule in use (Read-only)
+ *
+ * size: uint8_t
+ */
+#define GAPROLE_ADV_STEP            0x31F
+
+/**
+ * @brief Time spent advertising and advertising events since boot (Read-only)
+ *
+ * size: gapRoleAdvStats_t
+ */
+#define GAPROLE_ADV_STATS           0x320
+
 /** @} End Peripheral_Params */
 
+/// @brief Most steps in the advertising schedule.
+#define GAPROLE_ADV_SCHEDULE_MAX_STEPS  6
+
 /*-------------------------------------------------------------------
  * TYPEDEFS
  */
 
+/// @brief A step of the advertising schedule.
+typedef struct
+{
+  uint16_t advInt;                        //!< Advertising interval (units of 625us)
+  uint32_t duration;                      //!< Time on this step (ms), ignored for the last step
+} gapRoleAdvStep_t;
+
+/// @brief Advertising since boot.
+typedef struct
+{
+  uint32_t advTime;                       //!< Time advertising (ms)
+  uint32_t advEvents;                     //!< Advertising events, from the time spent on each interval
+} gapRoleAdvStats_t;
+
 /// @brief GAP Peripheral Role States.
 typedef enum
 {
@@ -593,6 +637,13 @@ extern bStatus_t GAPRole_SendUpdateParam(uint16_t minConnInterval,
  */
 extern void GAPRole_RegisterAppCBs(gapRolesParamUpdateCB_t *pParamUpdateCB);
 
+/**
+ * @brief       Go back to the first step of the advertising schedule, on
+ *              user interaction. Advertising in progress is restarted at
+ *              the first step's interval.
+ */
+extern void GAPRole_RestartAdvertSchedule(void);
+
 /// @cond NODOC
 
 /*-------------------------------------------------------------------
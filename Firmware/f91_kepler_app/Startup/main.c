@@ -61,7 +61,6 @@
 
 #include <ti/sysbios/BIOS.h>
 #include <ti/sysbios/knl/Clock.h>
-#include <ti/sysbios/knl/Mailbox.h>
 #include <ti/display/Display.h>
 
 #include "Board.h"
@@ -71,7 +70,6 @@
 #include "bcomdef.h"
 #include "peripheral.h"
 #include "f91_kepler.h"
-#include "f91_clock.h"
 #include "f91_utils.h"
 /* Header files required to enable instruction fetch cache */
 #include <inc/hw_memmap.h>
@@ -125,12 +123,6 @@ Display_Handle F91_LOGGER = NULL;
 Semaphore_Struct semStruct;
 Semaphore_Handle semHandle;
 
-/* This buffer is not directly accessed by the application */
-MailboxMsgObj mailboxBuffer[NUMMSGS];
-
-Mailbox_Struct mbxStruct;
-Mailbox_Handle mbxHandle;
-
 #ifdef CC1350_LAUNCHXL
 #ifdef POWER_SAVING
 // Power Notify Object for wake-up callbacks
@@ -225,14 +217,6 @@ int main()
   user0Cfg.appServiceInfo->timerMaxMillisecond  = ICall_getMaxMSecs();
 #endif  /* ICALL_JT */
   
-  //Contrust a mailbox object to be used to communicate across tasks.
-  Mailbox_Params mbxParams;
-  Mailbox_Params_init(&mbxParams);
-  mbxParams.buf = (Ptr)mailboxBuffer;
-  mbxParams.bufSize = sizeof(mailboxBuffer);
-  Mailbox_construct(&mbxStruct, sizeof(MsgObj), NUMMSGS, &mbxParams, NULL);
-  mbxHandle = Mailbox_handle(&mbxStruct);
-
   /* Construct a Semaphore object to be use as a resource lock, inital count 1 */
   Semaphore_Params semParams;
   Semaphore_Params_init(&semParams);
@@ -250,10 +234,7 @@ int main()
   /* Kick off profile - Priority 3 */
   GAPRole_createTask();
 
-  /* Kick off clock application - Priority 2 */
-  F91Clock_createTask();
-
-  /* Kick off main smart watch application - Priority 1 */
+  /* Kick off main smart watch application - Priority 2 */
   F91Kepler_createTask();
 
   /* enable interrupts and start SYS/BIOS */
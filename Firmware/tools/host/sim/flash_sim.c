@@ -0,0 +1,93 @@
+/*
+ * In-memory stand-in for the CC2640R2 internal flash, see flash_sim.h.
+ * Like NOR flash, an erase sets a whole sector to 0xFF and programming can
+ * only clear bits. A program that would set one is counted, the bits stay
+ * as the flash would leave them.
+ */
+#include <string.h>
+
+#include <driverlib/flash.h>
+#include <driverlib/vims.h>
+
+#include "flash_sim.h"
+
+uint8_t flashSim_mem[FLASH_SIM_SIZE];
+flashSimStats_t flashSim_stats;
+
+static uint32_t vimsMode = VIMS_MODE_ENABLED;
+static bool     failing = false;
+
+void flashSim_reset(void)
+{
+  memset(flashSim_mem, 0xFF, sizeof(flashSim_mem));
+  memset(&flashSim_stats, 0, sizeof(flashSim_stats));
+  vimsMode = VIMS_MODE_ENABLED;
+  failing = false;
+}
+
+void flashSim_fail(bool fail)
+{
+  failing = fail;
+}
+
+uint32_t flashSim_busyUs(const flashSimStats_t *pStats)
+{
+  return pStats->erases * FLASH_SIM_ERASE_US + pStats->words * FLASH_SIM_WORD_US;
+}
+
+uint32_t FlashSectorErase(uint32_t ui32SectorAddress)
+{
+  if (failing || (ui32SectorAddress >= FLASH_SIM_SIZE)) {
+    return FAPI_STATUS_FSM_ERROR;
+  }
+  if (vimsMode != VIMS_MODE_DISABLED) {
+    flashSim_stats.cacheOn++;
+  }
+
+  memset(&flashSim_mem[ui32SectorAddress & ~(FLASH_SIM_SECTOR_SIZE - 1)], 0xFF, FLASH_SIM_SECTOR_SIZE);
+  flashSim_stats.erases++;
+  return FAPI_STATUS_SUCCESS;
+}
+
+uint32_t FlashProgram(uint8_t *pui8DataBuffer, uint32_t ui32Address, uint32_t ui32Count)
+{
+  uint32_t i;
+
+  if (failing || (ui32Address + ui32Count > FLASH_SIM_SIZE)) {
+    return FAPI_STATUS_FSM_ERROR;
+  }
+  if (vimsMode != VIMS_MODE_DISABLED) {
+    flashSim_stats.cacheOn++;
+  }
+
+  for (i = 0; i < ui32Count; i++) {
+    if (pui8DataBuffer[i] & ~flashSim_mem[ui32Address + i]) {
+      flashSim_stats.bitsSet++;
+    }
+    flashSim_mem[ui32Address + i] &= pui8DataBuffer[i];
+  }
+
+  flashSim_stats.bytesProgrammed += ui32Count;
+  if (ui32Count > 0) {
+    flashSim_stats.words += (ui32Address + ui32Count + 3) / 4 - ui32Address / 4;
+  }
+  return FAPI_STATUS_SUCCESS;
+}
+
+uint32_t VIMSModeGet(uint32_t ui32Base)
+{
+  return vimsMode;
+}
+
+void VIMSModeSet(uint32_t ui32Base, uint32_t ui32Mode)
+{
+  vimsMode = ui32Mode;
+}
+
+void VIMSLineBufDisable(uint32_t ui32Base)
+{
+}
+
+void VIMSLineBufEnable(uint32_t ui32Base)
+{
+}
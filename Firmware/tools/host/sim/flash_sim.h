@@ -0,0 +1,39 @@
+/*
+ * In-memory stand-in for the CC2640R2 internal flash, behind the driverlib
+ * flash and VIMS calls.
+ */
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FLASH_SIM_SIZE          (128 * 1024)
+#define FLASH_SIM_SECTOR_SIZE   4096
+
+// CC2640R2 datasheet typical figures, for the modelled flash time.
+#define FLASH_SIM_ERASE_US      8000    // sector erase
+#define FLASH_SIM_WORD_US       8       // program a 32-bit word
+
+typedef struct
+{
+  uint32_t erases;
+  uint32_t bytesProgrammed;
+  uint32_t words;             // 32-bit words touched by programming
+  uint32_t bitsSet;           // programming asked for a 0 to become a 1
+  uint32_t cacheOn;           // erase or program with the VIMS cache on
+} flashSimStats_t;
+
+// Erase all of the flash, the statistics and the failure.
+extern void flashSim_reset(void);
+
+// Make erases and programs fail (FAPI_STATUS_FSM_ERROR) while set.
+extern void flashSim_fail(bool fail);
+
+// Modelled time of the erases and programs so far, in us.
+extern uint32_t flashSim_busyUs(const flashSimStats_t *pStats);
+
+extern uint8_t flashSim_mem[FLASH_SIM_SIZE];
+extern flashSimStats_t flashSim_stats;
+
+#endif /* FLASH_SIM_H */
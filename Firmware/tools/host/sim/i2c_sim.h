@@ -0,0 +1,22 @@
+/*
+ * Stand-in for the I2C driver that counts what goes on the bus, to put a
+ * bus time on a panel update.
+ */
+#ifndef I2C_SIM_H
+#define I2C_SIM_H
+
+#include <ti/drivers/I2C.h>
+
+typedef struct
+{
+  uint32_t transfers;
+  uint32_t bytes;               // address byte included
+} i2cSimStats_t;
+
+// Time the transfers counted in pStats take on the bus, in us. Every byte
+// is 9 clocks, the start and stop of a transfer about 2 more.
+extern uint32_t i2cSim_busUs(const i2cSimStats_t *pStats);
+
+extern i2cSimStats_t i2cSim_stats;
+
+#endif /* I2C_SIM_H */
@@ -0,0 +1,85 @@
+/*
+ * In-memory stand-in for the OSAL SNV driver, see snv_sim.h. Items are
+ * read back with the length they were written with, like NV_SIMPLE.
+ */
+#include <string.h>
+
+#include "snv_sim.h"
+
+typedef struct
+{
+  bool     valid;
+  uint16_t len;
+  uint8_t  data[SNV_SIM_ITEM_MAX];
+} snvSimItem_t;
+
+static snvSimItem_t items[SNV_SIM_ITEMS];
+
+static uint8_t  tearMode = SNV_SIM_TEAR_NONE;
+static uint32_t tearSkip;
+static uint16_t tearLen;
+static bool     failing = false;
+
+snvSimStats_t snvSim_stats;
+
+void snvSim_reset(void)
+{
+  memset(items, 0, sizeof(items));
+  memset(&snvSim_stats, 0, sizeof(snvSim_stats));
+  tearMode = SNV_SIM_TEAR_NONE;
+  failing = false;
+}
+
+void snvSim_tear(uint8_t mode, uint32_t skip, uint16_t tearBytes)
+{
+  tearMode = mode;
+  tearSkip = skip;
+  tearLen = tearBytes;
+}
+
+void snvSim_failWrites(bool fail)
+{
+  failing = fail;
+}
+
+uint8_t osal_snv_read(osalSnvId_t id, osalSnvLen_t len, void *pBuf)
+{
+  snvSim_stats.reads++;
+
+  if (!items[id].valid || (len > SNV_SIM_ITEM_MAX)) {
+    return FAILURE;
+  }
+
+  memcpy(pBuf, items[id].data, len);
+  return SUCCESS;
+}
+
+uint8_t osal_snv_write(osalSnvId_t id, osalSnvLen_t len, void *pBuf)
+{
+  if (failing || (len > SNV_SIM_ITEM_MAX)) {
+    return FAILURE;
+  }
+
+  if ((tearMode != SNV_SIM_TEAR_NONE) && (tearSkip-- == 0)) {
+    uint8_t mode = tearMode;
+
+    tearMode = SNV_SIM_TEAR_NONE;
+    if (mode == SNV_SIM_TEAR_PARTIAL) {
+      memcpy(items[id].data, pBuf, (tearLen < len) ? tearLen : len);
+      items[id].len = len;
+      items[id].valid = true;
+    }
+
+    // The writer never learns, the power is gone.
+    snvSim_stats.writes++;
+    snvSim_stats.bytesWritten += len;
+    return SUCCESS;
+  }
+
+  memcpy(items[id].data, pBuf, len);
+  items[id].len = len;
+  items[id].valid = true;
+  snvSim_stats.writes++;
+  snvSim_stats.bytesWritten += len;
+  return SUCCESS;
+}
@@ -0,0 +1,35 @@
+/*
+ * In-memory stand-in for the OSAL SNV driver, with power loss injection.
+ */
+#ifndef SNV_SIM_H
+#define SNV_SIM_H
+
+#include "osal_snv.h"
+
+#define SNV_SIM_ITEMS           256
+#define SNV_SIM_ITEM_MAX        256
+
+// What the next write does when it is torn.
+#define SNV_SIM_TEAR_NONE       0
+#define SNV_SIM_TEAR_LOST       1   // power lost before the item is committed, old value stays
+#define SNV_SIM_TEAR_PARTIAL    2   // only the first tearBytes bytes of the new value land
+
+typedef struct
+{
+  uint32_t reads;
+  uint32_t writes;
+  uint32_t bytesWritten;
+} snvSimStats_t;
+
+// Erase every item and the statistics.
+extern void snvSim_reset(void);
+
+// Tear the write after skip more writes.
+extern void snvSim_tear(uint8_t mode, uint32_t skip, uint16_t tearBytes);
+
+// Make writes fail (returns FAILURE) while set.
+extern void snvSim_failWrites(bool fail);
+
+extern snvSimStats_t snvSim_stats;
+
+#endif /* SNV_SIM_H */
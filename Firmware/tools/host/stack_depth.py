@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# Worst-case stack depth of a task, from the call graph and frame sizes gcc
+# writes with -fstack-usage -fcallgraph-info=su (see `make stack`).
+#
+#   stack_depth.py <dir with .ci files> <task function> [stack size]
+#
+# Frames are the host compiler's, -Os. They stand in for the Thumb-2 ones:
+# x86-64 saves 8 byte registers and return addresses and aligns frames to
+# 16, so they come out at least as large. What the firmware calls but the
+# host doesn't build (the SDK, the BLE stack through ICall, TI's RTS) gets
+# the allowance below, and the task's stack also takes an exception frame
+# and the context the kernel saves on a switch.
+#
+# Calls through a pointer can't be followed from the call graph, the
+# functions they reach are listed in INDIRECT. Add to it when a module
+# registers a callback that runs on the task.
+
+import glob
+import math
+import re
+import sys
+
+# Callbacks reached through a pointer from these functions.
+INDIRECT = {
+    'F91Timers_processEvent': ['_F91Alarm_alarmExpired', '_F91Alarm_snoozeExpired',
+                               '_F91Alarm_countdownExpired', '_F91Alarm_chimeExpired',
+                               '_F91Alarm_alertExpired', '_F91Log_flushExpired'],
+    'F91Bulk_processData': ['_F91Oad_processBlock', '_F91Notification_receiveText'],
+    'F91Log_replay': ['_F91Notification_replayRecord'],
+    'F91Service_setValue': ['f91_clock_service_ReadAttrCB', 'f91_notification_service_ReadAttrCB',
+                            'f91_oad_service_ReadAttrCB'],
+    'F91Service_read': ['f91_clock_service_ReadTime'],
+    'F91Service_write': ['f91_clock_service_WriteAlarm', 'f91_oad_service_QueueBlock'],
+    'gattServApp_SendNotiInd': ['f91_clock_service_ReadAttrCB',
+                                'f91_notification_service_ReadAttrCB',
+                                'f91_oad_service_ReadAttrCB'],
+}
+
+# Bytes allowed for what isn't built here, by name pattern, first match.
+# Stack API calls run on the stack task under ICALL_LITE, the app stack
+# only holds the direct API's message and the wait for the answer.
+EXTERNAL = [
+    (r'^(GAP|GAPRole|GAPBondMgr|GGS|GATT|GATTServApp|HCI|L2CAP|ATT|linkDB|osal_snv|DevInfo)_', 128),
+    (r'^BM_free$', 128),
+    (r'^host_display$', 160),               # Display_printf, UART, System_vsnprintf
+    (r'^I2C_', 96),                         # blocking transfer, waits on a semaphore
+    (r'^(localtime|time|mktime|ltoa)$', 64),
+    (r'^(Flash|VIMS)', 64),                 # ROM, HAPI
+    (r'^(Task|Event|Semaphore|Clock|Queue|Seconds|Hwi|Swi|BIOS)_', 64),
+    (r'^ICall_', 64),
+    (r'^(PIN|IOC|AON|Power)', 32),
+    (r'^(mem|str)[a-z]*$', 32),
+    (r'^(malloc|free)$', 48),
+]
+EXTERNAL_DEFAULT = 64
+
+# Exception frame (8 words, 4 for alignment) and the registers saved on a
+# task switch (r4-r11, lr, padding).
+EXCEPTION_FRAME = 36
+SWITCH_FRAME = 40
+
+NODE = re.compile(r'node: \{ title: "([^"]*)" label: "([^"]*)"')
+EDGE = re.compile(r'edge: \{ sourcename: "([^"]*)" targetname: "([^"]*)"')
+FRAME = re.compile(r'\\n(\d+) bytes \(([^)]*)\)')
+
+
+def name(title):
+    return title.split(':')[-1]
+
+
+def external(func):
+    for pattern, size in EXTERNAL:
+        if re.search(pattern, func):
+            return size
+    return EXTERNAL_DEFAULT
+
+
+def load(path):
+    frames = {}
+    dynamic = set()
+    calls = {}
+
+    for ci in glob.glob(path + '/*.ci'):
+        with open(ci) as f:
+            for line in f:
+                m = NODE.match(line)
+                if m:
+                    frame = FRAME.search(m.group(2))
+                    if frame:
+                        frames[name(m.group(1))] = int(frame.group(1))
+                        if 'dynamic' in frame.group(2) and 'bounded' not in frame.group(2):
+                            dynamic.add(name(m.group(1)))
+                    continue
+                m = EDGE.match(line)
+                if m:
+                    calls.setdefault(name(m.group(1)), set()).add(name(m.group(2)))
+
+    for caller, targets in INDIRECT.items():
+        if caller in calls:
+            calls[caller].discard('__indirect_call')
+            calls[caller].update(targets)
+
+    return frames, dynamic, calls
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit('usage: stack_depth.py <ci dir> <task function> [stack size]')
+
+    frames, dynamic, calls = load(sys.argv[1])
+    root = sys.argv[2]
+    if root not in frames:
+        sys.exit('%s not found in %s' % (root, sys.argv[1]))
+
+    memo = {}
+    recursive = set()
+    unresolved = set()
+
+    # Deepest path below func, as (bytes, [(func, bytes)]).
+    def deepest(func, path):
+        if func in path:
+            recursive.add(func)
+            return 0, []
+        if func in memo:
+            return memo[func]
+        if func == '__indirect_call':
+            unresolved.update(f for f in path if '__indirect_call' in calls.get(f, ()))
+            return 0, []
+        if func not in frames:
+            return external(func), [(func + ' (allowance)', external(func))]
+
+        best = (0, [])
+        for callee in sorted(calls.get(func, ())):
+            depth = deepest(callee, path + (func,))
+            if depth[0] > best[0]:
+                best = depth
+        memo[func] = (frames[func] + best[0], [(func, frames[func])] + best[1])
+        return memo[func]
+
+    depth, path = deepest(root, ())
+    total = depth + EXCEPTION_FRAME + SWITCH_FRAME
+    size = int(math.ceil(total * 1.25 / 8)) * 8
+
+    print('  deepest path from %s:' % root)
+    for func, frame in path:
+        print('    %5d  %s' % (frame, func))
+    print('    %5d  exception frame' % EXCEPTION_FRAME)
+    print('    %5d  task switch' % SWITCH_FRAME)
+    print('  worst case %d bytes, %d of it allowances, stack with a quarter margin: %d'
+          % (total, sum(f for n, f in path if n.endswith('(allowance)')) +
+             EXCEPTION_FRAME + SWITCH_FRAME, size))
+
+    for func in sorted(recursive):
+        print('  recursion through %s, counted once' % func)
+    for func in sorted(unresolved):
+        print('  call through a pointer in %s not in INDIRECT' % func)
+    for func in sorted(dynamic):
+        print('  unbounded dynamic frame in %s' % func)
+
+    if len(sys.argv) > 3:
+        configured = int(sys.argv[3], 0)
+        print('  configured %d bytes: %s' % (configured, 'ok' if configured >= total else 'TOO SMALL'))
+        if configured < total:
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,44 @@
+/*
+ * Shared pieces of the host harnesses, see host.h.
+ */
+#include <string.h>
+#include <time.h>
+
+#include "host.h"
+
+int host_failures = 0;
+
+uint64_t host_nowNs(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int cmpU64(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+uint64_t host_percentile(uint64_t *pSamples, uint32_t count, uint8_t pct)
+{
+  uint32_t i;
+
+  if (count == 0) {
+    return 0;
+  }
+
+  qsort(pSamples, count, sizeof(uint64_t), cmpU64);
+  i = (uint32_t)(((uint64_t)count * pct + 99) / 100);
+  return pSamples[(i == 0) ? 0 : (i - 1)];
+}
+
+int host_done(const char *name)
+{
+  printf("%s: %s\n", name, host_failures ? "FAILED" : "ok");
+  return host_failures ? 1 : 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * Shared pieces of the host harnesses: checks, timing and percentiles.
+ */
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+extern int host_failures;
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if (!(cond)) {                                                        \
+      printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+      host_failures++;                                                    \
+    }                                                                     \
+  } while (0)
+
+// Move the RTOS tick counter (Clock_getTicks) forward, running the clocks
+// that expire on the way.
+extern void host_advanceTicks(uint32_t n);
+
+// Ticks until the next clock expires, false when none is running.
+extern bool host_nextClock(uint32_t *pTicks);
+
+// Monotonic host time in ns.
+extern uint64_t host_nowNs(void);
+
+// Sort samples and return the given percentile (0..100).
+extern uint64_t host_percentile(uint64_t *pSamples, uint32_t count, uint8_t pct);
+
+// Print the result line and return the exit status for main.
+extern int host_done(const char *name);
+
+#endif /* HOST_H */
@@ -0,0 +1,162 @@
+/*
+ * Host stand-in for the GATT server: services register their attribute
+ * table here and the harness writes to it the way the stack would, by
+ * the value's UUID. Writes come on connection handle 0, configurations
+ * on any link. Notification payloads are allocated and freed like the
+ * stack's, hostGatt_stats.buffers counts those not given back.
+ */
+#include <string.h>
+
+#include "gattservapp.h"
+#include "linkdb.h"
+
+#include "host.h"
+#include "host_gatt.h"
+
+#define HOST_GATT_SERVICES_MAX  4
+
+typedef struct
+{
+  gattAttribute_t         *pAttrs;
+  uint16                  numAttrs;
+  const gattServiceCBs_t  *pCBs;
+} hostGattService_t;
+
+static hostGattService_t services[HOST_GATT_SERVICES_MAX];
+static uint8_t           numServices;
+static uint16            nextHandle = GATT_MIN_HANDLE;
+
+uint8 host_linkState = LINK_CONNECTED | LINK_AUTHENTICATED | LINK_ENCRYPTED;
+
+hostGattStats_t hostGatt_stats;
+
+int32_t hostGatt_txBuffers = -1;
+
+const uint8 primaryServiceUUID[ATT_BT_UUID_SIZE] =
+  { LO_UINT16(GATT_PRIMARY_SERVICE_UUID), HI_UINT16(GATT_PRIMARY_SERVICE_UUID) };
+const uint8 characterUUID[ATT_BT_UUID_SIZE] =
+  { LO_UINT16(GATT_CHARACTER_UUID), HI_UINT16(GATT_CHARACTER_UUID) };
+const uint8 charUserDescUUID[ATT_BT_UUID_SIZE] =
+  { LO_UINT16(GATT_CHAR_USER_DESC_UUID), HI_UINT16(GATT_CHAR_USER_DESC_UUID) };
+const uint8 clientCharCfgUUID[ATT_BT_UUID_SIZE] =
+  { LO_UINT16(GATT_CLIENT_CHAR_CFG_UUID), HI_UINT16(GATT_CLIENT_CHAR_CFG_UUID) };
+
+bStatus_t GATTServApp_RegisterService(gattAttribute_t *pAttrs, uint16 numAttrs,
+                                      uint8 encKeySize, const gattServiceCBs_t *pServiceCBs)
+{
+  uint16 i;
+
+  if (numServices == HOST_GATT_SERVICES_MAX) {
+    return FAILURE;
+  }
+
+  for (i = 0; i < numAttrs; i++) {
+    pAttrs[i].handle = nextHandle++;
+  }
+
+  services[numServices].pAttrs = pAttrs;
+  services[numServices].numAttrs = numAttrs;
+  services[numServices].pCBs = pServiceCBs;
+  numServices++;
+  return SUCCESS;
+}
+
+uint16 ATT_GetMTU(uint16 connHandle)
+{
+  return ATT_MTU_SIZE;
+}
+
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size, uint16 *pSizeAlloc)
+{
+  size = MIN(size, ATT_MTU_SIZE);
+  if (pSizeAlloc != NULL) {
+    *pSizeAlloc = size;
+  }
+
+  hostGatt_stats.buffers++;
+  return malloc(size);
+}
+
+void GATT_bm_free(void *pMsg, uint8 opcode)
+{
+  if (opcode == ATT_HANDLE_VALUE_NOTI) {
+    free(((attHandleValueNoti_t *)pMsg)->pValue);
+    hostGatt_stats.buffers--;
+  }
+}
+
+// The controller takes the payload, or is out of buffers.
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti, uint8 authenticated)
+{
+  if (hostGatt_txBuffers == 0) {
+    return MSG_BUFFER_NOT_AVAIL;
+  }
+  if (hostGatt_txBuffers > 0) {
+    hostGatt_txBuffers--;
+  }
+
+  free(pNoti->pValue);
+  hostGatt_stats.buffers--;
+  hostGatt_stats.notifications++;
+  return SUCCESS;
+}
+
+bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd, uint8 authenticated,
+                          uint8 taskId)
+{
+  return GATT_Notification(connHandle, pInd, authenticated);
+}
+
+bStatus_t GATT_SendRsp(uint16 connHandle, uint8 method, gattMsg_t *pRspMsg)
+{
+  return SUCCESS;
+}
+
+// The attribute holding the value of a 128-bit UUID, with its service.
+static gattAttribute_t *findValue(const uint8 *pUUID, const hostGattService_t **ppService)
+{
+  uint8_t s;
+  uint16 i;
+
+  for (s = 0; s < numServices; s++) {
+    for (i = 0; i < services[s].numAttrs; i++) {
+      gattAttribute_t *pAttr = &services[s].pAttrs[i];
+
+      if ((pAttr->type.len == ATT_UUID_SIZE) && (memcmp(pAttr->type.uuid, pUUID, ATT_UUID_SIZE) == 0)) {
+        *ppService = &services[s];
+        return pAttr;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+bStatus_t hostGatt_write(const uint8 *pUUID, uint8 *pValue, uint16 len, uint16 offset)
+{
+  const hostGattService_t *pService;
+  gattAttribute_t *pAttr = findValue(pUUID, &pService);
+
+  if (pAttr == NULL) {
+    return ATT_ERR_ATTR_NOT_FOUND;
+  }
+
+  hostGatt_stats.writes++;
+  return pService->pCBs->pfnWriteAttrCB(0, pAttr, pValue, len, offset, ATT_WRITE_REQ);
+}
+
+bStatus_t hostGatt_writeCfg(const uint8 *pUUID, uint16 connHandle, uint16 value)
+{
+  const hostGattService_t *pService;
+  gattAttribute_t *pAttr = findValue(pUUID, &pService);
+  uint8 cfg[2] = { LO_UINT16(value), HI_UINT16(value) };
+
+  // The configuration follows the value.
+  if ((pAttr == NULL) || (pAttr[1].type.len != ATT_BT_UUID_SIZE) ||
+      (memcmp(pAttr[1].type.uuid, clientCharCfgUUID, ATT_BT_UUID_SIZE) != 0)) {
+    return ATT_ERR_ATTR_NOT_FOUND;
+  }
+
+  hostGatt_stats.writes++;
+  return pService->pCBs->pfnWriteAttrCB(connHandle, &pAttr[1], cfg, sizeof(cfg), 0, ATT_WRITE_REQ);
+}
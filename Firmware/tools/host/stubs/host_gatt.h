@@ -0,0 +1,30 @@
+/*
+ * Host stand-in for the GATT server, see host_gatt.c.
+ */
+#ifndef HOST_GATT_H
+#define HOST_GATT_H
+
+#include "gatt.h"
+
+typedef struct
+{
+  uint32_t writes;
+  uint32_t notifications;
+  int32_t  buffers;           // notification payloads allocated and not yet freed or sent
+} hostGattStats_t;
+
+// Write a characteristic value, found by its 128-bit UUID, as a Write
+// Request from the phone. Returns what the service's write callback does.
+extern bStatus_t hostGatt_write(const uint8 *pUUID, uint8 *pValue, uint16 len, uint16 offset);
+
+// Write the client characteristic configuration of a value, found by its
+// 128-bit UUID, from a link.
+extern bStatus_t hostGatt_writeCfg(const uint8 *pUUID, uint16 connHandle, uint16 value);
+
+extern hostGattStats_t hostGatt_stats;
+
+// Notifications the controller takes before it is out of buffers, -1 for
+// no limit.
+extern int32_t hostGatt_txBuffers;
+
+#endif /* HOST_GATT_H */
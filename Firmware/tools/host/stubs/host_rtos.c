@@ -0,0 +1,223 @@
+/*
+ * Host stand-ins for the TI-RTOS and driver calls the firmware modules
+ * make: a tick counter and a seconds counter the harnesses move by hand,
+ * clocks that run as the ticks pass them, queues, events, the ICall heap
+ * and the Display driver printing to stdout when asked to.
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <icall.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Event.h>
+#include <ti/sysbios/knl/Queue.h>
+#include <ti/sysbios/hal/Seconds.h>
+#include <ti/display/Display.h>
+
+#include "host.h"
+
+uint32_t Clock_tickPeriod = 10;
+
+Display_Handle F91_LOGGER = NULL;
+
+bool host_displayVerbose = false;
+
+#define HOST_CLOCKS_MAX         16
+
+static uint32_t ticks;
+static uint32_t seconds;
+
+// Every clock constructed, in order.
+static Clock_Struct *clocks[HOST_CLOCKS_MAX];
+static uint8_t      numClocks;
+
+uint32_t Clock_getTicks(void)
+{
+  return ticks;
+}
+
+// The active clock that expires first, NULL if none is running.
+static Clock_Struct *nextClock(void)
+{
+  Clock_Struct *pNext = NULL;
+  uint8_t i;
+
+  for (i = 0; i < numClocks; i++) {
+    if (clocks[i]->active &&
+        ((pNext == NULL) || ((int32_t)(clocks[i]->deadline - pNext->deadline) < 0))) {
+      pNext = clocks[i];
+    }
+  }
+
+  return pNext;
+}
+
+void host_advanceTicks(uint32_t n)
+{
+  uint32_t target = ticks + n;
+  Clock_Struct *pClock;
+
+  // Clocks run in deadline order, each at its own tick.
+  while (((pClock = nextClock()) != NULL) && ((int32_t)(pClock->deadline - target) <= 0)) {
+    ticks = pClock->deadline;
+    if (pClock->period > 0) {
+      pClock->deadline += pClock->period;
+    } else {
+      pClock->active = false;
+    }
+    pClock->fxn(pClock->arg);
+  }
+
+  ticks = target;
+}
+
+bool host_nextClock(uint32_t *pTicks)
+{
+  Clock_Struct *pClock = nextClock();
+
+  if (pClock == NULL) {
+    return false;
+  }
+
+  *pTicks = pClock->deadline - ticks;
+  return true;
+}
+
+void Clock_Params_init(Clock_Params *params)
+{
+  params->period = 0;
+  params->startFlag = false;
+  params->arg = 0;
+}
+
+void Clock_construct(Clock_Struct *pClock, Clock_FuncPtr fxn, uint32_t timeout,
+                     const Clock_Params *params)
+{
+  pClock->fxn = fxn;
+  pClock->arg = params->arg;
+  pClock->timeout = timeout;
+  pClock->period = params->period;
+  pClock->active = false;
+
+  if (numClocks < HOST_CLOCKS_MAX) {
+    clocks[numClocks++] = pClock;
+  }
+
+  if (params->startFlag) {
+    Clock_start(pClock);
+  }
+}
+
+void Clock_start(Clock_Handle handle)
+{
+  handle->deadline = ticks + handle->timeout;
+  handle->active = true;
+}
+
+void Clock_stop(Clock_Handle handle)
+{
+  handle->active = false;
+}
+
+bool Clock_isActive(Clock_Handle handle)
+{
+  return handle->active;
+}
+
+void Clock_setTimeout(Clock_Handle handle, uint32_t timeout)
+{
+  handle->timeout = timeout;
+}
+
+void Clock_setPeriod(Clock_Handle handle, uint32_t period)
+{
+  handle->period = period;
+}
+
+void Queue_construct(Queue_Struct *pQueue, void *params)
+{
+  pQueue->next = pQueue;
+  pQueue->prev = pQueue;
+}
+
+void Queue_put(Queue_Handle queue, Queue_Elem *pElem)
+{
+  pElem->next = queue;
+  pElem->prev = queue->prev;
+  queue->prev->next = pElem;
+  queue->prev = pElem;
+}
+
+void *Queue_get(Queue_Handle queue)
+{
+  Queue_Elem *pElem = queue->next;
+
+  // An empty queue returns itself, as on the target.
+  queue->next = pElem->next;
+  pElem->next->prev = queue;
+  return pElem;
+}
+
+bool Queue_empty(Queue_Handle queue)
+{
+  return queue->next == queue;
+}
+
+void Event_post(Event_Handle event, UInt32 eventMask)
+{
+  event->posted |= eventMask;
+}
+
+UInt32 host_eventTake(Event_Handle event)
+{
+  UInt32 posted = event->posted;
+
+  event->posted = 0;
+  return posted;
+}
+
+void *ICall_malloc(size_t size)
+{
+  return malloc(size);
+}
+
+void ICall_free(void *msg)
+{
+  free(msg);
+}
+
+void ICall_freeMsg(void *msg)
+{
+  free(msg);
+}
+
+uint8_t ICall_getLocalMsgEntityId(uint8_t service, uint8_t selfEntityId)
+{
+  return selfEntityId;
+}
+
+uint32_t Seconds_get(void)
+{
+  return seconds;
+}
+
+void Seconds_set(uint32_t s)
+{
+  seconds = s;
+}
+
+void host_display(uint8_t line, const char *fmt, ...)
+{
+  va_list args;
+
+  if (!host_displayVerbose) {
+    return;
+  }
+
+  va_start(args, fmt);
+  printf("  [%2d] ", line);
+  vprintf(fmt, args);
+  printf("\n");
+  va_end(args);
+}
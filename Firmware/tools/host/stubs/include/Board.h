@@ -0,0 +1,2 @@
+/* Host stand-in for Board.h, same as board.h. */
+#include "board.h"
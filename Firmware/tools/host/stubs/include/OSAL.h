@@ -0,0 +1,7 @@
+/* Host stand-in for OSAL.h, the services only need the stack types. */
+#ifndef OSAL_H
+#define OSAL_H
+
+#include "bcomdef.h"
+
+#endif /* OSAL_H */
@@ -0,0 +1,9 @@
+/*
+ * Host stand-in for the BLE stack's att.h, the ATT types are in gatt.h.
+ */
+#ifndef ATT_H
+#define ATT_H
+
+#include "gatt.h"
+
+#endif /* ATT_H */
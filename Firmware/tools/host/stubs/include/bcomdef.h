@@ -0,0 +1,63 @@
+/*
+ * Host stand-in for the BLE stack's bcomdef.h, only what the firmware
+ * modules built by tools/host use.
+ */
+#ifndef BCOMDEF_H
+#define BCOMDEF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int8_t   int8;
+typedef int16_t  int16;
+typedef int32_t  int32;
+typedef uint8_t  bStatus_t;
+typedef uint8_t  Status_t;
+
+#define CONST                   const
+#define VOID                    (void)
+
+#ifndef TRUE
+#define TRUE                    1
+#define FALSE                   0
+#endif
+
+#define SUCCESS                 0x00
+#define FAILURE                 0x01
+#define INVALIDPARAMETER        0x02
+#define bleAlreadyInRequestedMode 0x11
+#define bleMemAllocError        0x13
+#define bleNotConnected         0x14
+#define bleNoResources          0x15
+#define bleInvalidRange         0x18
+#define blePending              0x17
+#define bleProcedureComplete    0x1A
+#define MSG_BUFFER_NOT_AVAIL    0x04
+
+#define BLE_NVID_CUST_START     0x80
+#define BLE_NVID_CUST_END       0x8F
+
+#define B_ADDR_LEN              6
+
+#ifndef MIN
+#define MIN(n, m)               (((n) < (m)) ? (n) : (m))
+#endif
+#ifndef MAX
+#define MAX(n, m)               (((n) < (m)) ? (m) : (n))
+#endif
+
+#define LO_UINT16(a)            ((uint8_t)((a) & 0xFF))
+#define HI_UINT16(a)            ((uint8_t)(((a) >> 8) & 0xFF))
+#define BUILD_UINT16(lo, hi)    ((uint16_t)(((lo) & 0xFF) | (((hi) & 0xFF) << 8)))
+#define BUILD_UINT32(b0, b1, b2, b3) \
+  ((uint32_t)(((uint32_t)(b0) & 0xFF) | (((uint32_t)(b1) & 0xFF) << 8) | \
+              (((uint32_t)(b2) & 0xFF) << 16) | (((uint32_t)(b3) & 0xFF) << 24)))
+#define BREAK_UINT32(v, byte)   ((uint8_t)((v) >> ((byte) * 8)))
+
+#define INVALID_CONNHANDLE      0xFFFF
+
+#endif /* BCOMDEF_H */
@@ -0,0 +1,13 @@
+/* Host stand-in for board.h, no pins on the host. */
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define Board_I2C0              0
+#define Board_BUTTON0           13
+#define Board_BUTTON1           14
+#define Board_BUTTON2           15
+
+#endif /* BOARD_H */
@@ -0,0 +1,7 @@
+/* Host stand-in for board_key.h, no keys on the host. */
+#ifndef BOARD_KEY_H
+#define BOARD_KEY_H
+
+#include "board.h"
+
+#endif /* BOARD_KEY_H */
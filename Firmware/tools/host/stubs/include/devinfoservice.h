@@ -0,0 +1,13 @@
+/* Host stand-in for the Device Information service. */
+#ifndef DEVINFOSERVICE_H
+#define DEVINFOSERVICE_H
+
+#include "bcomdef.h"
+
+#define DEVINFO_SYSTEM_ID       0
+#define DEVINFO_SYSTEM_ID_LEN   8
+
+extern bStatus_t DevInfo_AddService(void);
+extern bStatus_t DevInfo_SetParameter(uint8 param, uint8 len, void *value);
+
+#endif /* DEVINFOSERVICE_H */
@@ -0,0 +1,10 @@
+/* Host stand-in for the driverlib battery monitor API. */
+#ifndef DRIVERLIB_AON_BATMON_H
+#define DRIVERLIB_AON_BATMON_H
+
+#include <stdint.h>
+
+extern void AONBatMonEnable(void);
+extern uint32_t AONBatMonBatteryVoltageGet(void);
+
+#endif /* DRIVERLIB_AON_BATMON_H */
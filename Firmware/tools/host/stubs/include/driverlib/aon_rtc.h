@@ -0,0 +1,9 @@
+/* Host stand-in for the driverlib AON RTC API. */
+#ifndef DRIVERLIB_AON_RTC_H
+#define DRIVERLIB_AON_RTC_H
+
+#include <stdint.h>
+
+extern uint64_t AONRTCCurrent64BitValueGet(void);
+
+#endif /* DRIVERLIB_AON_RTC_H */
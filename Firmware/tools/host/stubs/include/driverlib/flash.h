@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for the driverlib flash API, backed by sim/flash_sim.c.
+ */
+#ifndef DRIVERLIB_FLASH_H
+#define DRIVERLIB_FLASH_H
+
+#include <stdint.h>
+
+#define FAPI_STATUS_SUCCESS         0x00000000
+#define FAPI_STATUS_FSM_ERROR       0x00000101
+
+extern uint32_t FlashSectorErase(uint32_t ui32SectorAddress);
+extern uint32_t FlashProgram(uint8_t *pui8DataBuffer, uint32_t ui32Address, uint32_t ui32Count);
+
+#endif /* DRIVERLIB_FLASH_H */
@@ -0,0 +1,26 @@
+/* Host stand-in for the driverlib IO controller API, no pins on the host. */
+#ifndef DRIVERLIB_IOC_H
+#define DRIVERLIB_IOC_H
+
+#include <stdint.h>
+
+#define IOID_8                          8
+#define IOID_9                          9
+#define IOID_10                         10
+#define IOID_11                         11
+#define IOID_12                         12
+
+#define IOC_PORT_RFC_TRC                0x2E
+#define IOC_PORT_RFC_GPO0               0x2F
+#define IOC_PORT_RFC_GPI0               0x33
+#define IOC_IOCFG0_PORT_ID_RFC_SMI_CL_OUT 0x2B
+#define IOC_IOCFG0_PORT_ID_RFC_SMI_CL_IN  0x2C
+
+#define IOC_STD_INPUT                   0x60006000
+#define IOC_STD_OUTPUT                  0x00006000
+#define IOC_CURRENT_4MA                 0x00000100
+#define IOC_SLEW_ENABLE                 0x00001000
+
+extern void IOCPortConfigureSet(uint32_t ui32IOId, uint32_t ui32PortId, uint32_t ui32IOConfig);
+
+#endif /* DRIVERLIB_IOC_H */
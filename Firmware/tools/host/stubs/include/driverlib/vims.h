@@ -0,0 +1,19 @@
+/*
+ * Host stand-in for the driverlib VIMS cache control. Only the mode is
+ * kept, sim/flash_sim.c refuses to program while the cache is on.
+ */
+#ifndef DRIVERLIB_VIMS_H
+#define DRIVERLIB_VIMS_H
+
+#include <stdint.h>
+
+#define VIMS_BASE                   0x40034000
+#define VIMS_MODE_DISABLED          0x00000000
+#define VIMS_MODE_ENABLED           0x00000001
+
+extern uint32_t VIMSModeGet(uint32_t ui32Base);
+extern void VIMSModeSet(uint32_t ui32Base, uint32_t ui32Mode);
+extern void VIMSLineBufDisable(uint32_t ui32Base);
+extern void VIMSLineBufEnable(uint32_t ui32Base);
+
+#endif /* DRIVERLIB_VIMS_H */
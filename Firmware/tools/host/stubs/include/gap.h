@@ -0,0 +1,45 @@
+/*
+ * Host stand-in for the BLE stack's gap.h, declarations only: nothing the
+ * host runs calls into the GAP.
+ */
+#ifndef GAP_H
+#define GAP_H
+
+#include "bcomdef.h"
+
+#define GAP_ADTYPE_FLAGS                        0x01
+#define GAP_ADTYPE_16BIT_MORE                   0x02
+#define GAP_ADTYPE_LOCAL_NAME_COMPLETE          0x09
+#define GAP_ADTYPE_POWER_LEVEL                  0x0A
+#define GAP_ADTYPE_SLAVE_CONN_INTERVAL_RANGE    0x12
+#define GAP_ADTYPE_FLAGS_LIMITED                0x01
+#define GAP_ADTYPE_FLAGS_GENERAL                0x02
+#define GAP_ADTYPE_FLAGS_BREDR_NOT_SUPPORTED    0x04
+
+#define TGAP_LIM_DISC_ADV_INT_MIN               6
+#define TGAP_LIM_DISC_ADV_INT_MAX               7
+#define TGAP_GEN_DISC_ADV_INT_MIN               8
+#define TGAP_GEN_DISC_ADV_INT_MAX               9
+#define TGAP_CONN_PAUSE_PERIPHERAL              26
+
+#define GAP_BONDINGS_MAX                        5
+
+#define GAP_CB_REGISTER                         0x01
+#define GAP_CB_UNREGISTER                       0x00
+
+typedef struct
+{
+  uint8  status;
+  uint16 handle;
+  uint8  channel;
+  uint8  phy;
+  int8   lastRssi;
+} Gap_ConnEventRpt_t;
+
+typedef void (*pfnGapConnEvtCB_t)(Gap_ConnEventRpt_t *pReport);
+
+extern bStatus_t GAP_SetParamValue(uint16 paramID, uint16 paramValue);
+extern void GAP_RegisterForMsgs(uint8 taskID);
+extern bStatus_t GAP_RegisterConnEventCb(pfnGapConnEvtCB_t cb, uint8 action, uint16 connHandle);
+
+#endif /* GAP_H */
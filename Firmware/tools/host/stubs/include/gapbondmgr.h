@@ -0,0 +1,40 @@
+/* Host stand-in for gapbondmgr.h, declarations only. */
+#ifndef GAPBONDMGR_H
+#define GAPBONDMGR_H
+
+#include "bcomdef.h"
+#include "gap.h"
+
+#define GAPBOND_PAIRING_MODE                0x400
+#define GAPBOND_MITM_PROTECTION             0x402
+#define GAPBOND_IO_CAPABILITIES             0x403
+#define GAPBOND_BONDING_ENABLED             0x406
+#define GAPBOND_LRU_BOND_REPLACEMENT        0x418
+
+#define GAPBOND_PAIRING_MODE_WAIT_FOR_REQ   0x01
+#define GAPBOND_IO_CAP_DISPLAY_ONLY         0x00
+
+#define B_APP_DEFAULT_PASSCODE              123456
+
+#define GAPBOND_PAIRING_STATE_STARTED       0x00
+#define GAPBOND_PAIRING_STATE_COMPLETE      0x01
+#define GAPBOND_PAIRING_STATE_BONDED        0x02
+#define GAPBOND_PAIRING_STATE_BOND_SAVED    0x03
+
+typedef void (*pfnPasscodeCB_t)(uint8_t *deviceAddr, uint16_t connectionHandle,
+                                uint8_t uiInputs, uint8_t uiOutputs, uint32_t numComparison);
+typedef void (*pfnPairStateCB_t)(uint16_t connectionHandle, uint8_t state, uint8_t status);
+
+typedef struct
+{
+  pfnPasscodeCB_t  passcodeCB;
+  pfnPairStateCB_t pairStateCB;
+} gapBondCBs_t;
+
+extern bStatus_t GAPBondMgr_SetParameter(uint16_t param, uint8_t len, void *pValue);
+extern uint8_t GAPBondMgr_ResolveAddr(uint8_t addrType, uint8_t *pDevAddr, uint8_t *pResolvedAddr);
+extern bStatus_t GAPBondMgr_ServiceChangeInd(uint16_t connectionHandle, uint8_t setParam);
+extern void GAPBondMgr_Register(gapBondCBs_t *pCB);
+extern bStatus_t GAPBondMgr_PasscodeRsp(uint16_t connectionHandle, uint8_t status, uint32_t passcode);
+
+#endif /* GAPBONDMGR_H */
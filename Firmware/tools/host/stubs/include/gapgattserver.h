@@ -0,0 +1,12 @@
+/* Host stand-in for the GAP GATT server, declarations only. */
+#ifndef GAPGATTSERVER_H
+#define GAPGATTSERVER_H
+
+#include "bcomdef.h"
+
+#define GGS_DEVICE_NAME_ATT     0
+
+extern bStatus_t GGS_AddService(uint32 services);
+extern bStatus_t GGS_SetParameter(uint8 param, uint8 len, void *value);
+
+#endif /* GAPGATTSERVER_H */
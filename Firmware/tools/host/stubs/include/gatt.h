@@ -0,0 +1,199 @@
+/*
+ * Host stand-in for the BLE stack's gatt.h and att.h, the types and
+ * constants the F91 services use.
+ */
+#ifndef GATT_H
+#define GATT_H
+
+#include "bcomdef.h"
+
+#define ATT_BT_UUID_SIZE                2
+#define ATT_UUID_SIZE                   16
+
+#define ATT_ERR_INVALID_HANDLE          0x01
+#define ATT_ERR_READ_NOT_PERMITTED      0x02
+#define ATT_ERR_WRITE_NOT_PERMITTED     0x03
+#define ATT_ERR_INSUFFICIENT_AUTHEN     0x05
+#define ATT_ERR_ATTR_NOT_LONG           0x0B
+#define ATT_ERR_INVALID_OFFSET          0x07
+#define ATT_ERR_ATTR_NOT_FOUND          0x0A
+#define ATT_ERR_INVALID_VALUE_SIZE      0x0D
+#define ATT_ERR_UNLIKELY                0x0E
+#define ATT_ERR_INSUFFICIENT_RESOURCES  0x11
+#define ATT_ERR_INVALID_VALUE           0x80
+
+#define ATT_ERROR_RSP                   0x01
+#define ATT_EXCHANGE_MTU_REQ            0x02
+#define ATT_EXCHANGE_MTU_RSP            0x03
+#define ATT_FIND_INFO_RSP               0x05
+#define ATT_FIND_BY_TYPE_VALUE_RSP      0x07
+#define ATT_READ_BY_TYPE_RSP            0x09
+#define ATT_WRITE_REQ                   0x12
+#define ATT_WRITE_RSP                   0x13
+#define ATT_HANDLE_VALUE_NOTI           0x1B
+#define ATT_FLOW_CTRL_VIOLATED_EVENT    0x7E
+#define ATT_MTU_UPDATED_EVENT           0x7F
+
+#define GATT_MSG_EVENT                  0xB0
+
+#define ATT_HANDLE_BT_UUID_TYPE         0x01
+#define ATT_MTU_SIZE                    23
+#define GATT_MAX_MTU                    0xFFFF
+
+#define GATT_PERMIT_READ                0x01
+#define GATT_PERMIT_WRITE               0x02
+#define GATT_PERMIT_AUTHEN_READ         0x04
+#define GATT_PERMIT_AUTHEN_WRITE        0x08
+#define GATT_PERMIT_AUTHOR_READ         0x10
+#define GATT_PERMIT_AUTHOR_WRITE        0x20
+#define GATT_PERMIT_ENCRYPT_READ        0x40
+#define GATT_PERMIT_ENCRYPT_WRITE       0x80
+
+#define GATT_PROP_BCAST                 0x01
+#define GATT_PROP_READ                  0x02
+#define GATT_PROP_WRITE_NO_RSP          0x04
+#define GATT_PROP_WRITE                 0x08
+#define GATT_PROP_NOTIFY                0x10
+#define GATT_PROP_INDICATE              0x20
+
+#define GATT_CLIENT_CFG_NOTIFY          0x0001
+#define GATT_CLIENT_CFG_INDICATE        0x0002
+#define GATT_CFG_NO_OPERATION           0x0000
+
+// Configuration table an attribute's value points to.
+#define GATT_CCC_TBL(pValue)            (*(gattCharCfg_t **)(pValue))
+
+#define GATT_INVALID_HANDLE             0x0000
+#define GATT_MIN_HANDLE                 0x0001
+#define GATT_MAX_HANDLE                 0xFFFF
+
+#define GATT_MAX_NUM_CONN               1
+
+typedef struct
+{
+  uint8 len;
+  const uint8 *uuid;
+} gattAttrType_t;
+
+typedef struct attAttribute_t
+{
+  gattAttrType_t type;
+  uint8 permissions;
+  uint16 handle;
+  uint8 *pValue;
+} gattAttribute_t;
+
+typedef struct
+{
+  uint16 connHandle;
+  uint8  value;
+} gattCharCfg_t;
+
+typedef struct
+{
+  uint16 handle;
+  uint16 len;
+  uint8 *pValue;
+} attHandleValueNoti_t;
+
+typedef attHandleValueNoti_t attHandleValueInd_t;
+
+typedef struct
+{
+  uint8  reqOpcode;
+  uint16 handle;
+  uint8  errCode;
+} attErrorRsp_t;
+
+typedef struct
+{
+  uint16 clientRxMTU;
+} attExchangeMTUReq_t;
+
+typedef struct
+{
+  uint8 opcode;
+  uint8 pendingOpcode;
+} attFlowCtrlViolatedEvt_t;
+
+typedef struct
+{
+  uint16 MTU;
+} attMtuUpdatedEvt_t;
+
+typedef struct
+{
+  uint8  numInfo;
+  uint8 *pHandlesInfo;
+} attFindByTypeValueRsp_t;
+
+typedef struct
+{
+  uint16 numPairs;
+  uint16 len;
+  uint8 *pDataList;
+  uint16 dataLen;
+} attReadByTypeRsp_t;
+
+typedef struct
+{
+  uint8  numInfo;
+  uint8  format;
+  uint8 *pInfo;
+} attFindInfoRsp_t;
+
+typedef struct
+{
+  uint16 handle;
+  uint16 len;
+  uint8 *pValue;
+  uint8  sig;
+  uint8  cmd;
+} attWriteReq_t;
+
+typedef union
+{
+  attErrorRsp_t errorRsp;
+  attFindByTypeValueRsp_t findByTypeValueRsp;
+  attReadByTypeRsp_t readByTypeRsp;
+  attFindInfoRsp_t findInfoRsp;
+  attWriteReq_t writeReq;
+  attHandleValueNoti_t handleValueNoti;
+  attFlowCtrlViolatedEvt_t flowCtrlEvt;
+  attMtuUpdatedEvt_t mtuEvt;
+} gattMsg_t;
+
+typedef struct
+{
+  uint8 event;
+  uint8 status;
+} osal_event_hdr_t;
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint16 connHandle;
+  uint8 method;
+  gattMsg_t msg;
+} gattMsgEvent_t;
+
+extern uint16 ATT_GetMTU(uint16 connHandle);
+extern void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size, uint16 *pSizeAlloc);
+extern void GATT_bm_free(void *pMsg, uint8 opcode);
+extern bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti, uint8 authenticated);
+extern bStatus_t GATT_SendRsp(uint16 connHandle, uint8 method, gattMsg_t *pRspMsg);
+extern bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd, uint8 authenticated,
+                                 uint8 taskId);
+
+extern bStatus_t GATT_RegisterForMsgs(uint8 taskId);
+
+// GATT client procedures, answered by the harness.
+extern void GATT_InitClient(void);
+extern void GATT_RegisterForInd(uint8 taskId);
+extern bStatus_t GATT_DiscPrimaryServiceByUUID(uint16 connHandle, uint8 *pUUID, uint8 len, uint8 taskId);
+extern bStatus_t GATT_DiscAllChars(uint16 connHandle, uint16 startHandle, uint16 endHandle, uint8 taskId);
+extern bStatus_t GATT_DiscAllCharDescs(uint16 connHandle, uint16 startHandle, uint16 endHandle, uint8 taskId);
+extern bStatus_t GATT_ExchangeMTU(uint16 connHandle, attExchangeMTUReq_t *pReq, uint8 taskId);
+extern bStatus_t GATT_WriteCharValue(uint16 connHandle, attWriteReq_t *pReq, uint8 taskId);
+
+#endif /* GATT_H */
@@ -0,0 +1,20 @@
+/*
+ * Host stand-in for the BLE stack's gatt_uuid.h.
+ */
+#ifndef GATT_UUID_H
+#define GATT_UUID_H
+
+#include "bcomdef.h"
+
+#define GATT_PRIMARY_SERVICE_UUID       0x2800
+#define GATT_CHARACTER_UUID             0x2803
+#define GATT_CHAR_USER_DESC_UUID        0x2901
+#define GATT_CLIENT_CHAR_CFG_UUID       0x2902
+
+// Defined by stubs/host_gatt.c.
+extern const uint8 primaryServiceUUID[];
+extern const uint8 characterUUID[];
+extern const uint8 charUserDescUUID[];
+extern const uint8 clientCharCfgUUID[];
+
+#endif /* GATT_UUID_H */
@@ -0,0 +1,50 @@
+/*
+ * Host stand-in for the BLE stack's gattservapp.h. Registration hands the
+ * attribute table to the harness, which plays the GATT server. The
+ * configuration helpers are TI's, PROFILES/gattservapp_util.c.
+ */
+#ifndef GATTSERVAPP_H
+#define GATTSERVAPP_H
+
+#include "gatt.h"
+#include "gatt_uuid.h"
+
+#define GATT_MAX_ENCRYPT_KEY_SIZE       16
+#define GATT_LOCAL_READ                 0xFF
+#define GATT_ALL_SERVICES               0xFFFFFFFF
+#define GATT_PARAM_NUM_PREPARE_WRITES   0
+
+typedef bStatus_t (*pfnGATTReadAttrCB_t)(uint16 connHandle, gattAttribute_t *pAttr,
+                                         uint8 *pValue, uint16 *pLen, uint16 offset,
+                                         uint16 maxLen, uint8 method);
+typedef bStatus_t (*pfnGATTWriteAttrCB_t)(uint16 connHandle, gattAttribute_t *pAttr,
+                                          uint8 *pValue, uint16 len, uint16 offset,
+                                          uint8 method);
+typedef bStatus_t (*pfnGATTAuthorizeAttrCB_t)(uint16 connHandle, gattAttribute_t *pAttr,
+                                              uint8 opcode);
+
+typedef struct
+{
+  pfnGATTReadAttrCB_t pfnReadAttrCB;
+  pfnGATTWriteAttrCB_t pfnWriteAttrCB;
+  pfnGATTAuthorizeAttrCB_t pfnAuthorizeAttrCB;
+} gattServiceCBs_t;
+
+extern void GATTServApp_InitCharCfg(uint16 connHandle, gattCharCfg_t *charCfgTbl);
+extern uint16 GATTServApp_ReadCharCfg(uint16 connHandle, gattCharCfg_t *charCfgTbl);
+extern bStatus_t GATTServApp_ProcessCCCWriteReq(uint16 connHandle, gattAttribute_t *pAttr,
+                                                uint8 *pValue, uint16 len, uint16 offset,
+                                                uint16 validCfg);
+extern uint8 GATTServApp_WriteCharCfg(uint16 connHandle, gattCharCfg_t *charCfgTbl, uint16 value);
+extern bStatus_t GATTServApp_ProcessCharCfg(gattCharCfg_t *charCfgTbl, uint8 *pValue,
+                                            uint8 authenticated, gattAttribute_t *attrTbl,
+                                            uint16 numAttrs, uint8 taskId,
+                                            pfnGATTReadAttrCB_t pfnReadAttrCB);
+extern gattAttribute_t *GATTServApp_FindAttr(gattAttribute_t *pAttrTbl, uint16 numAttrs,
+                                             uint8 *pValue);
+extern bStatus_t GATTServApp_AddService(uint32 services);
+extern bStatus_t GATTServApp_SetParameter(uint8 param, uint8 len, void *value);
+extern bStatus_t GATTServApp_RegisterService(gattAttribute_t *pAttrs, uint16 numAttrs,
+                                             uint8 encKeySize, const gattServiceCBs_t *pServiceCBs);
+
+#endif /* GATTSERVAPP_H */
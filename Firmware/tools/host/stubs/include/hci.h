@@ -0,0 +1,31 @@
+/* Host stand-in for the BLE stack's hci.h, declarations only. */
+#ifndef HCI_H
+#define HCI_H
+
+#include "bcomdef.h"
+#include "gatt.h"
+
+#define HCI_GAP_EVENT_EVENT                     0x09
+#define HCI_COMMAND_COMPLETE_EVENT_CODE         0x0E
+#define HCI_BLE_HARDWARE_ERROR_EVENT_CODE       0x10
+#define HCI_LE_READ_LOCAL_SUPPORTED_FEATURES    0x2003
+
+#define HAL_ASSERT_CAUSE_HARDWARE_ERROR         0x05
+
+#define HCI_EXT_DISABLE_SL_OVERRIDE             0
+#define HCI_EXT_ENABLE_SL_OVERRIDE              1
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint8  numHciCmdPkt;
+  uint16 cmdOpcode;
+  uint8  *pReturnParam;
+} hciEvt_CmdComplete_t;
+
+extern bStatus_t HCI_LE_ReadLocalSupportedFeaturesCmd(void);
+extern bStatus_t HCI_LE_SetDataLenCmd(uint16 connHandle, uint16 txOctets, uint16 txTime);
+extern bStatus_t HCI_EXT_SetLocalSupportedFeaturesCmd(uint8 *localFeatures);
+extern bStatus_t HCI_EXT_SetSlaveLatencyOverrideCmd(uint8 control);
+
+#endif /* HCI_H */
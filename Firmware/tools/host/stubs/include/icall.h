@@ -0,0 +1,50 @@
+/*
+ * Host stand-in for ICall, the heap is the host's. No stack sends
+ * messages on the host, the messaging types are for the builds that only
+ * compile (make stack).
+ */
+#ifndef ICALL_H
+#define ICALL_H
+
+#include "bcomdef.h"
+
+#include <ti/sysbios/knl/Event.h>
+
+#define ICALL_SERVICE_CLASS_BLE         0x0010
+#define ICALL_SERVICE_CLASS_BLE_MSG     0x0050
+
+#define ICALL_ERRNO_SUCCESS             0
+#define ICALL_MSG_EVENT_ID              Event_Id_31
+#define ICALL_TIMEOUT_FOREVER           0xFFFFFFFF
+
+typedef uint8_t  ICall_EntityID;
+typedef uint16_t ICall_ServiceEnum;
+typedef Event_Handle ICall_SyncHandle;
+typedef int      ICall_Errno;
+
+typedef struct
+{
+  uint8_t event;
+  uint8_t status;
+} ICall_Hdr;
+
+typedef struct
+{
+  ICall_Hdr hdr;
+  uint8_t   *pData;
+} ICall_HciExtEvt;
+
+typedef struct
+{
+  ICall_Hdr hdr;
+  uint16_t  signature;
+} ICall_Stack_Event;
+
+extern void *ICall_malloc(size_t size);
+extern void ICall_free(void *msg);
+extern void ICall_freeMsg(void *msg);
+extern uint8_t ICall_getLocalMsgEntityId(uint8_t service, uint8_t selfEntityId);
+extern ICall_Errno ICall_registerApp(ICall_EntityID *entity, ICall_SyncHandle *msgSyncHdl);
+extern ICall_Errno ICall_fetchServiceMsg(ICall_ServiceEnum *src, ICall_EntityID *dest, void **msg);
+
+#endif /* ICALL_H */
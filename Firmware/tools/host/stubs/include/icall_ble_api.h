@@ -0,0 +1,18 @@
+/*
+ * Host stand-in for the ICall BLE API, the stack calls are declared in
+ * the headers they come from. Pulls in the ones the application expects.
+ */
+#ifndef ICALL_BLE_API_H
+#define ICALL_BLE_API_H
+
+#include "gap.h"
+#include "gapbondmgr.h"
+#include "gapgattserver.h"
+#include "gatt.h"
+#include "gattservapp.h"
+#include "hci.h"
+#include "l2cap.h"
+#include "linkdb.h"
+#include "osal_snv.h"
+
+#endif /* ICALL_BLE_API_H */
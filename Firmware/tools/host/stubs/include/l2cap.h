@@ -0,0 +1,115 @@
+/*
+ * Host stand-in for the BLE stack's l2cap.h, what the bulk channel uses
+ * of connection oriented channels.
+ */
+#ifndef L2CAP_H
+#define L2CAP_H
+
+#include "gatt.h"
+
+// Stack messages
+#define L2CAP_SIGNAL_EVENT                  0x92
+#define L2CAP_DATA_EVENT                    0x93
+
+// Signaling events
+#define L2CAP_CHANNEL_ESTABLISHED_EVT       0x60
+#define L2CAP_CHANNEL_TERMINATED_EVT        0x61
+#define L2CAP_OUT_OF_CREDIT_EVT             0x62
+#define L2CAP_PEER_CREDIT_THRESHOLD_EVT     0x63
+
+// Connection results
+#define L2CAP_CONN_SUCCESS                  0x0000
+#define L2CAP_CONN_INSUFFICIENT_AUTHEN      0x0005
+
+typedef struct
+{
+  uint16 psm;
+  uint16 srcCID;
+  uint16 mtu;
+  uint16 mps;
+  uint16 initCredits;
+} l2capConnectReq_t;
+
+typedef uint8 (*pfnVerifySecCB_t)(uint16 connHandle, uint8 id, l2capConnectReq_t *pReq);
+
+typedef struct
+{
+  uint16 psm;
+  uint16 mtu;
+  uint16 initPeerCredits;
+  uint16 peerCreditThreshold;
+  uint8  maxNumChannels;
+  uint8  taskId;
+  pfnVerifySecCB_t pfnVerifySecCB;
+} l2capPsm_t;
+
+typedef struct
+{
+  uint16 psm;
+  uint16 mtu;
+  uint16 mps;
+  uint16 credits;
+  uint16 peerCID;
+  uint16 peerMtu;
+  uint16 peerMps;
+  uint16 peerCredits;
+  uint16 peerCreditThreshold;
+} l2capCoChannelInfo_t;
+
+typedef struct
+{
+  uint16 result;
+  uint16 CID;
+  l2capCoChannelInfo_t info;
+} l2capChannelEstEvt_t;
+
+typedef struct
+{
+  uint16 CID;
+  uint16 peerCID;
+  uint16 reason;
+} l2capChannelTermEvt_t;
+
+typedef struct
+{
+  uint16 CID;
+  uint16 peerCID;
+  uint16 credits;
+} l2capCreditEvt_t;
+
+typedef union
+{
+  l2capChannelEstEvt_t  channelEstEvt;
+  l2capChannelTermEvt_t channelTermEvt;
+  l2capCreditEvt_t      creditEvt;
+} l2capSignalCmd_t;
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint16 connHandle;
+  uint8  id;
+  uint8  opcode;
+  l2capSignalCmd_t cmd;
+} l2capSignalEvent_t;
+
+typedef struct
+{
+  uint16 CID;
+  uint16 len;
+  uint8 *pPayload;
+} l2capPacket_t;
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint16 connHandle;
+  l2capPacket_t pkt;
+} l2capDataEvent_t;
+
+// Left to the harness that plays the peer.
+extern bStatus_t L2CAP_RegisterPsm(l2capPsm_t *pPsm);
+extern bStatus_t L2CAP_FlowCtrlCredit(uint16 CID, uint16 peerCredits);
+extern void BM_free(void *pBuf);
+
+#endif /* L2CAP_H */
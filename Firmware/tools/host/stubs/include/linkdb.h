@@ -0,0 +1,42 @@
+/*
+ * Host stand-in for the BLE stack's linkdb.h. One link unless a harness
+ * is built with more (HOST_NUM_CONNS, at most 8), every link in the state
+ * the harness sets.
+ */
+#ifndef LINKDB_H
+#define LINKDB_H
+
+#include "bcomdef.h"
+
+#define LINK_NOT_CONNECTED      0x00
+#define LINK_CONNECTED          0x01
+#define LINK_AUTHENTICATED      0x02
+#define LINK_BOUND              0x04
+#define LINK_ENCRYPTED          0x10
+
+#ifndef HOST_NUM_CONNS
+#define HOST_NUM_CONNS          1
+#endif
+
+#define linkDBNumConns          HOST_NUM_CONNS
+
+extern uint8 host_linkState;
+
+#define linkDB_State(connHandle, state)  ((host_linkState & (state)) == (state))
+
+#define LINKDB_CONNHANDLE_ALL   0xFFFF
+
+typedef struct
+{
+  uint8  taskID;
+  uint16 connectionHandle;
+  uint8  stateFlags;
+  uint8  addrType;
+  uint8  addr[B_ADDR_LEN];
+  uint16 connInterval;
+} linkDBInfo_t;
+
+extern uint8 linkDB_NumActive(void);
+extern uint8 linkDB_GetInfo(uint16 connectionHandle, linkDBInfo_t *pInfo);
+
+#endif /* LINKDB_H */
@@ -0,0 +1,11 @@
+/* Host stand-in for the link layer's ll_common.h. */
+#ifndef LL_COMMON_H
+#define LL_COMMON_H
+
+#include "bcomdef.h"
+
+#define LL_FEATURE_CONN_PARAMS_REQ  0x02
+
+#define CLR_FEATURE_FLAG(var, feature)  ((var) &= ~(feature))
+
+#endif /* LL_COMMON_H */
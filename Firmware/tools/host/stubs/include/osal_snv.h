@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for osal_snv.h, backed by sim/snv_sim.c.
+ */
+#ifndef OSAL_SNV_H
+#define OSAL_SNV_H
+
+#include "bcomdef.h"
+
+typedef uint8_t  osalSnvId_t;
+typedef uint16_t osalSnvLen_t;
+
+extern uint8_t osal_snv_read(osalSnvId_t id, osalSnvLen_t len, void *pBuf);
+extern uint8_t osal_snv_write(osalSnvId_t id, osalSnvLen_t len, void *pBuf);
+
+#endif /* OSAL_SNV_H */
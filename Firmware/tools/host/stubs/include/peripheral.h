@@ -0,0 +1,12 @@
+/*
+ * Host stand-in for the GAP peripheral role: the role's own header from
+ * PROFILES, after the types it expects to have been included.
+ */
+#ifndef HOST_PERIPHERAL_H
+#define HOST_PERIPHERAL_H
+
+#include "bcomdef.h"
+
+#include_next "peripheral.h"
+
+#endif /* HOST_PERIPHERAL_H */
@@ -0,0 +1,30 @@
+/*
+ * Host stand-in for the TI Display driver. Lines are dropped unless the
+ * harness sets host_displayVerbose.
+ */
+#ifndef TI_DISPLAY_DISPLAY_H
+#define TI_DISPLAY_DISPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void *Display_Handle;
+
+#define Display_Type_UART       0x10
+
+extern void Display_init(void);
+extern Display_Handle Display_open(uint32_t id, void *params);
+
+extern bool host_displayVerbose;
+extern void host_display(uint8_t line, const char *fmt, ...);
+
+#define Display_print0(h, l, c, f)                  host_display((l), (f))
+#define Display_print1(h, l, c, f, a)               host_display((l), (f), (a))
+#define Display_print2(h, l, c, f, a, b)            host_display((l), (f), (a), (b))
+#define Display_print3(h, l, c, f, a, b, d)         host_display((l), (f), (a), (b), (d))
+#define Display_print4(h, l, c, f, a, b, d, e)      host_display((l), (f), (a), (b), (d), (e))
+#define Display_print5(h, l, c, f, a, b, d, e, g)   host_display((l), (f), (a), (b), (d), (e), (g))
+#define Display_clearLine(h, l)
+#define Display_clearLines(h, f, t)
+
+#endif /* TI_DISPLAY_DISPLAY_H */
@@ -0,0 +1,7 @@
+/* Host stand-in for the GPIO driver, no pins on the host. */
+#ifndef TI_DRIVERS_GPIO_H
+#define TI_DRIVERS_GPIO_H
+
+#include <stdint.h>
+
+#endif /* TI_DRIVERS_GPIO_H */
@@ -0,0 +1,37 @@
+/*
+ * Host stand-in for the I2C driver, transfers go to sim/i2c_sim.c.
+ */
+#ifndef TI_DRIVERS_I2C_H
+#define TI_DRIVERS_I2C_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum
+{
+  I2C_100kHz = 0,
+  I2C_400kHz = 1
+} I2C_BitRate;
+
+typedef struct
+{
+  I2C_BitRate bitRate;
+} I2C_Params;
+
+typedef struct
+{
+  void    *writeBuf;
+  size_t  writeCount;
+  void    *readBuf;
+  size_t  readCount;
+  uint_least8_t slaveAddress;
+} I2C_Transaction;
+
+typedef struct I2C_Config *I2C_Handle;
+
+extern void I2C_Params_init(I2C_Params *params);
+extern I2C_Handle I2C_open(uint_least8_t index, I2C_Params *params);
+extern bool I2C_transfer(I2C_Handle handle, I2C_Transaction *transaction);
+
+#endif /* TI_DRIVERS_I2C_H */
@@ -0,0 +1,32 @@
+/* Host stand-in for the PIN driver, no pins on the host. */
+#ifndef TI_DRIVERS_PIN_H
+#define TI_DRIVERS_PIN_H
+
+#include <stdint.h>
+
+typedef uint32_t PIN_Id;
+typedef uint32_t PIN_Config;
+typedef void *PIN_Handle;
+
+typedef struct
+{
+  PIN_Config *pConfig;
+} PIN_State;
+
+typedef void (*PIN_IntCb)(PIN_Handle handle, PIN_Id pinId);
+
+#define PIN_TERMINATE           0xFE
+#define PIN_INPUT_EN            (1u << 29)
+#define PIN_PULLUP              (1u << 13)
+#define PIN_PULLDOWN            (2u << 13)
+#define PIN_IRQ_DIS             (0u << 16)
+#define PIN_IRQ_NEGEDGE         (5u << 16)
+#define PIN_IRQ_POSEDGE         (6u << 16)
+#define PIN_BM_IRQ              (7u << 16)
+
+extern PIN_Handle PIN_open(PIN_State *state, const PIN_Config pinList[]);
+extern int PIN_registerIntCb(PIN_Handle handle, PIN_IntCb callbackFxn);
+extern int PIN_setConfig(PIN_Handle handle, PIN_Config updateMask, PIN_Config pinCfg);
+extern uint32_t PIN_getInputValue(PIN_Id pinId);
+
+#endif /* TI_DRIVERS_PIN_H */
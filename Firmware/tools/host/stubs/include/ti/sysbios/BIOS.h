@@ -0,0 +1,10 @@
+/* Host stand-in for ti/sysbios/BIOS.h. */
+#ifndef TI_SYSBIOS_BIOS_H
+#define TI_SYSBIOS_BIOS_H
+
+#include <xdc/std.h>
+
+#define BIOS_WAIT_FOREVER       (~(UInt32)0)
+#define BIOS_NO_WAIT            0
+
+#endif /* TI_SYSBIOS_BIOS_H */
@@ -0,0 +1,10 @@
+/* Host stand-in for the TI-RTOS Hwi module, one thread on the host. */
+#ifndef TI_SYSBIOS_HAL_HWI_H
+#define TI_SYSBIOS_HAL_HWI_H
+
+#include <xdc/std.h>
+
+#define Hwi_disable()           ((UInt)0)
+#define Hwi_restore(key)        ((void)(key))
+
+#endif /* TI_SYSBIOS_HAL_HWI_H */
@@ -0,0 +1,10 @@
+/* Host stand-in for the TI-RTOS Seconds module, see host_rtos.c. */
+#ifndef TI_SYSBIOS_HAL_SECONDS_H
+#define TI_SYSBIOS_HAL_SECONDS_H
+
+#include <xdc/std.h>
+
+extern uint32_t Seconds_get(void);
+extern void Seconds_set(uint32_t seconds);
+
+#endif /* TI_SYSBIOS_HAL_SECONDS_H */
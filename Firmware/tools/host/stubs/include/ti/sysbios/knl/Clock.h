@@ -0,0 +1,48 @@
+/*
+ * Host stand-in for the TI-RTOS Clock module. Ticks come from host_rtos.c,
+ * which the harnesses advance by hand, the clocks that expire on the way
+ * run their function.
+ */
+#ifndef TI_SYSBIOS_KNL_CLOCK_H
+#define TI_SYSBIOS_KNL_CLOCK_H
+
+#include <xdc/std.h>
+
+typedef void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct
+{
+  Clock_FuncPtr fxn;
+  UArg          arg;
+  uint32_t      timeout;
+  uint32_t      period;
+  uint32_t      deadline;
+  bool          active;
+} Clock_Struct;
+
+typedef Clock_Struct *Clock_Handle;
+
+typedef struct
+{
+  uint32_t period;
+  bool     startFlag;
+  UArg     arg;
+} Clock_Params;
+
+#define Clock_handle(pClock)    (pClock)
+
+// Length of a tick in us, as the firmware's BIOS config.
+extern uint32_t Clock_tickPeriod;
+
+extern uint32_t Clock_getTicks(void);
+
+extern void Clock_Params_init(Clock_Params *params);
+extern void Clock_construct(Clock_Struct *pClock, Clock_FuncPtr fxn, uint32_t timeout,
+                            const Clock_Params *params);
+extern void Clock_start(Clock_Handle handle);
+extern void Clock_stop(Clock_Handle handle);
+extern bool Clock_isActive(Clock_Handle handle);
+extern void Clock_setTimeout(Clock_Handle handle, uint32_t timeout);
+extern void Clock_setPeriod(Clock_Handle handle, uint32_t period);
+
+#endif /* TI_SYSBIOS_KNL_CLOCK_H */
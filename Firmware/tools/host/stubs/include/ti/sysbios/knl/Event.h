@@ -0,0 +1,35 @@
+/*
+ * Host stand-in for the TI-RTOS Event module. Nothing blocks on the host,
+ * the harness takes the posted events itself.
+ */
+#ifndef TI_SYSBIOS_KNL_EVENT_H
+#define TI_SYSBIOS_KNL_EVENT_H
+
+#include <xdc/std.h>
+
+#define Event_Id_NONE           0
+#define Event_Id_00             (1u << 0)
+#define Event_Id_01             (1u << 1)
+#define Event_Id_02             (1u << 2)
+#define Event_Id_03             (1u << 3)
+#define Event_Id_04             (1u << 4)
+#define Event_Id_05             (1u << 5)
+#define Event_Id_06             (1u << 6)
+#define Event_Id_07             (1u << 7)
+#define Event_Id_30             (1u << 30)
+#define Event_Id_31             (1u << 31)
+
+typedef struct
+{
+  UInt32 posted;
+} Event_Struct;
+
+typedef Event_Struct *Event_Handle;
+
+extern void Event_post(Event_Handle event, UInt32 eventMask);
+extern UInt32 Event_pend(Event_Handle event, UInt32 andMask, UInt32 orMask, UInt32 timeout);
+
+// Takes the posted events, 0 when there are none.
+extern UInt32 host_eventTake(Event_Handle event);
+
+#endif /* TI_SYSBIOS_KNL_EVENT_H */
@@ -0,0 +1,23 @@
+/* Host stand-in for the TI-RTOS Queue module, a circular list. */
+#ifndef TI_SYSBIOS_KNL_QUEUE_H
+#define TI_SYSBIOS_KNL_QUEUE_H
+
+#include <xdc/std.h>
+
+typedef struct Queue_Elem
+{
+  struct Queue_Elem *next;
+  struct Queue_Elem *prev;
+} Queue_Elem;
+
+typedef Queue_Elem Queue_Struct;
+typedef Queue_Elem *Queue_Handle;
+
+#define Queue_handle(pQueue)    (pQueue)
+
+extern void Queue_construct(Queue_Struct *pQueue, void *params);
+extern void Queue_put(Queue_Handle queue, Queue_Elem *pElem);
+extern void *Queue_get(Queue_Handle queue);
+extern bool Queue_empty(Queue_Handle queue);
+
+#endif /* TI_SYSBIOS_KNL_QUEUE_H */
@@ -0,0 +1,20 @@
+/* Host stand-in for the TI-RTOS Semaphore module. */
+#ifndef TI_SYSBIOS_KNL_SEMAPHORE_H
+#define TI_SYSBIOS_KNL_SEMAPHORE_H
+
+#include <xdc/std.h>
+
+typedef struct { int count; } Semaphore_Struct;
+typedef Semaphore_Struct *Semaphore_Handle;
+
+// One thread on the host, a pend never waits.
+static inline Bool Semaphore_pend(Semaphore_Handle handle, UInt32 timeout)
+{
+  return true;
+}
+
+static inline void Semaphore_post(Semaphore_Handle handle)
+{
+}
+
+#endif /* TI_SYSBIOS_KNL_SEMAPHORE_H */
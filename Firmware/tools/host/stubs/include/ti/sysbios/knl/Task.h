@@ -0,0 +1,36 @@
+/* Host stand-in for the TI-RTOS Task module, no tasks run on the host. */
+#ifndef TI_SYSBIOS_KNL_TASK_H
+#define TI_SYSBIOS_KNL_TASK_H
+
+#include <xdc/std.h>
+
+typedef void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef struct
+{
+  Task_FuncPtr fxn;
+} Task_Struct;
+
+typedef Task_Struct *Task_Handle;
+
+typedef struct
+{
+  void   *stack;
+  size_t stackSize;
+  Int    priority;
+} Task_Params;
+
+typedef struct
+{
+  size_t stackSize;
+  size_t used;
+} Task_Stat;
+
+#define Task_handle(pTask)      (pTask)
+
+extern void Task_Params_init(Task_Params *params);
+extern void Task_construct(Task_Struct *pTask, Task_FuncPtr fxn, const Task_Params *params,
+                           void *eb);
+extern void Task_stat(Task_Handle handle, Task_Stat *statbuf);
+
+#endif /* TI_SYSBIOS_KNL_TASK_H */
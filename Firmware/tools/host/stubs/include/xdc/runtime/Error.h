@@ -0,0 +1,7 @@
+/* Host stand-in for xdc/runtime/Error.h. */
+#ifndef XDC_RUNTIME_ERROR_H
+#define XDC_RUNTIME_ERROR_H
+
+#include <xdc/std.h>
+
+#endif /* XDC_RUNTIME_ERROR_H */
@@ -0,0 +1,7 @@
+/* Host stand-in for xdc/runtime/System.h. */
+#ifndef XDC_RUNTIME_SYSTEM_H
+#define XDC_RUNTIME_SYSTEM_H
+
+#include <xdc/std.h>
+
+#endif /* XDC_RUNTIME_SYSTEM_H */
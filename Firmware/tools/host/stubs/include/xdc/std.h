@@ -0,0 +1,16 @@
+/* Host stand-in for xdc/std.h. */
+#ifndef XDC_STD_H
+#define XDC_STD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef uintptr_t UArg;
+typedef char      Char;
+typedef int       Int;
+typedef unsigned  UInt;
+typedef uint32_t  UInt32;
+typedef bool      Bool;
+
+#endif /* XDC_STD_H */
@@ -0,0 +1,395 @@
+/*
+ * Host test of the ANCS client (f91_ancs.c) against a simulated iPhone.
+ *
+ * Discovery and subscription are answered once, then Get Notification
+ * Attributes answers are fed to the Data Source parser whole, split at
+ * every byte, with values the phone cut or didn't cut to the length asked
+ * for, and for a notification that wasn't asked for.
+ */
+#include <string.h>
+
+#include "host.h"
+
+#include "f91_ancs.h"
+#include "f91_notification.h"
+#include "gatt_uuid.h"
+
+#define CONN_HANDLE             0
+
+// Handles of the simulated ANCS.
+#define SVC_START               0x0030
+#define SVC_END                 0x003F
+#define NOTIF_SRC_HANDLE        0x0032
+#define NOTIF_SRC_CCCD          0x0033
+#define CTRL_POINT_HANDLE       0x0035
+#define DATA_SRC_HANDLE         0x0037
+#define DATA_SRC_CCCD           0x0038
+
+// Last write to the central and what the client asked for.
+static uint16_t lastWriteHandle;
+static uint8_t  lastWrite[32];
+static uint8_t  lastWriteLen;
+static uint32_t writes;
+static uint32_t discoveries;
+
+// Last call or text handed to the notification module.
+static f91SyncState_t delivered;
+static uint32_t deliveries;
+
+/*********************************************************************
+ * Stack and notification module stand-ins
+ */
+void GATT_InitClient(void)
+{
+}
+
+void GATT_RegisterForInd(uint8 taskId)
+{
+}
+
+bStatus_t GATT_DiscPrimaryServiceByUUID(uint16 connHandle, uint8 *pUUID, uint8 len, uint8 taskId)
+{
+  discoveries++;
+  return SUCCESS;
+}
+
+bStatus_t GATT_DiscAllChars(uint16 connHandle, uint16 startHandle, uint16 endHandle, uint8 taskId)
+{
+  CHECK((startHandle == SVC_START) && (endHandle == SVC_END));
+  discoveries++;
+  return SUCCESS;
+}
+
+bStatus_t GATT_DiscAllCharDescs(uint16 connHandle, uint16 startHandle, uint16 endHandle, uint8 taskId)
+{
+  discoveries++;
+  return SUCCESS;
+}
+
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size, uint16 *pSizeAlloc)
+{
+  return malloc(size);
+}
+
+void GATT_bm_free(void *pMsg, uint8 opcode)
+{
+  free(((attWriteReq_t *)pMsg)->pValue);
+}
+
+bStatus_t GATT_WriteCharValue(uint16 connHandle, attWriteReq_t *pReq, uint8 taskId)
+{
+  lastWriteHandle = pReq->handle;
+  lastWriteLen = (pReq->len < sizeof(lastWrite)) ? pReq->len : sizeof(lastWrite);
+  memcpy(lastWrite, pReq->pValue, lastWriteLen);
+  free(pReq->pValue);
+  writes++;
+  return SUCCESS;
+}
+
+void F91Notification_applySync(const f91SyncState_t *pSync)
+{
+  if (pSync->present & (F91_SYNC_FIELD(F91_SYNC_TAG_CALL) | F91_SYNC_FIELD(F91_SYNC_TAG_TEXT))) {
+    delivered = *pSync;
+    deliveries++;
+  }
+}
+
+void F91Notification_post(uint8_t type)
+{
+}
+
+/*********************************************************************
+ * Simulated central
+ */
+static void respond(uint8_t method, uint8_t status, gattMsg_t *pMsg)
+{
+  gattMsgEvent_t evt;
+
+  memset(&evt, 0, sizeof(evt));
+  evt.connHandle = CONN_HANDLE;
+  evt.method = method;
+  evt.hdr.status = status;
+  if (pMsg != NULL) {
+    evt.msg = *pMsg;
+  }
+  CHECK(F91Ancs_processGATTMsg(&evt));
+}
+
+static void putDecl(uint8_t *pDecl, uint16_t valueHandle, const uint8_t *pUUID)
+{
+  pDecl[0] = LO_UINT16(valueHandle - 1);
+  pDecl[1] = HI_UINT16(valueHandle - 1);
+  pDecl[2] = GATT_PROP_NOTIFY;
+  pDecl[3] = LO_UINT16(valueHandle);
+  pDecl[4] = HI_UINT16(valueHandle);
+  memcpy(&pDecl[5], pUUID, ATT_UUID_SIZE);
+}
+
+static void putInfo(uint8_t *pInfo, uint16_t handle, uint16_t uuid)
+{
+  pInfo[0] = LO_UINT16(handle);
+  pInfo[1] = HI_UINT16(handle);
+  pInfo[2] = LO_UINT16(uuid);
+  pInfo[3] = HI_UINT16(uuid);
+}
+
+// Discovery and both subscriptions, leaves the client ready.
+static void connect(void)
+{
+  static const uint8_t notifSrcUUID[ATT_UUID_SIZE] =
+    { 0xBD, 0x1D, 0xA2, 0x99, 0xE6, 0x25, 0x58, 0x8C, 0xD9, 0x42, 0x01, 0x63, 0x0D, 0x12, 0xBF, 0x9F };
+  static const uint8_t ctrlPointUUID[ATT_UUID_SIZE] =
+    { 0xD9, 0xD9, 0xAA, 0xFD, 0xBD, 0x9B, 0x21, 0x98, 0xA8, 0x49, 0xE1, 0x45, 0xF3, 0xD8, 0xD1, 0x69 };
+  static const uint8_t dataSrcUUID[ATT_UUID_SIZE] =
+    { 0xFB, 0x7B, 0x7C, 0xCE, 0x6A, 0xB3, 0x44, 0xBE, 0xB5, 0x4B, 0xD6, 0x24, 0xE9, 0xC6, 0xEA, 0x22 };
+  uint8_t handles[4] = { LO_UINT16(SVC_START), HI_UINT16(SVC_START), LO_UINT16(SVC_END), HI_UINT16(SVC_END) };
+  uint8_t decls[3 * 21];
+  uint8_t info[5 * 4];
+  gattMsg_t msg;
+
+  F91Ancs_reset();
+  discoveries = 0;
+  F91Ancs_start(CONN_HANDLE);
+
+  memset(&msg, 0, sizeof(msg));
+  msg.findByTypeValueRsp.numInfo = 1;
+  msg.findByTypeValueRsp.pHandlesInfo = handles;
+  respond(ATT_FIND_BY_TYPE_VALUE_RSP, bleProcedureComplete, &msg);
+
+  putDecl(&decls[0], NOTIF_SRC_HANDLE, notifSrcUUID);
+  putDecl(&decls[21], CTRL_POINT_HANDLE, ctrlPointUUID);
+  putDecl(&decls[42], DATA_SRC_HANDLE, dataSrcUUID);
+  memset(&msg, 0, sizeof(msg));
+  msg.readByTypeRsp.numPairs = 3;
+  msg.readByTypeRsp.len = 21;
+  msg.readByTypeRsp.pDataList = decls;
+  respond(ATT_READ_BY_TYPE_RSP, bleProcedureComplete, &msg);
+
+  putInfo(&info[0], NOTIF_SRC_HANDLE, 0x9999);
+  putInfo(&info[4], NOTIF_SRC_CCCD, GATT_CLIENT_CHAR_CFG_UUID);
+  putInfo(&info[8], CTRL_POINT_HANDLE, 0x9999);
+  putInfo(&info[12], DATA_SRC_HANDLE, 0x9999);
+  putInfo(&info[16], DATA_SRC_CCCD, GATT_CLIENT_CHAR_CFG_UUID);
+  memset(&msg, 0, sizeof(msg));
+  msg.findInfoRsp.numInfo = 5;
+  msg.findInfoRsp.format = ATT_HANDLE_BT_UUID_TYPE;
+  msg.findInfoRsp.pInfo = info;
+  respond(ATT_FIND_INFO_RSP, bleProcedureComplete, &msg);
+
+  // Data Source first.
+  CHECK(lastWriteHandle == DATA_SRC_CCCD);
+  respond(ATT_WRITE_RSP, SUCCESS, NULL);
+  CHECK(lastWriteHandle == NOTIF_SRC_CCCD);
+  respond(ATT_WRITE_RSP, SUCCESS, NULL);
+
+  CHECK(discoveries == 3);
+  CHECK(!F91Ancs_isBusy());
+}
+
+static void notify(uint16_t handle, uint8_t *pValue, uint16_t len)
+{
+  gattMsg_t msg;
+
+  memset(&msg, 0, sizeof(msg));
+  msg.handleValueNoti.handle = handle;
+  msg.handleValueNoti.len = len;
+  msg.handleValueNoti.pValue = pValue;
+  respond(ATT_HANDLE_VALUE_NOTI, SUCCESS, &msg);
+}
+
+// Notification Source: a new notification.
+static void added(uint32_t uid, uint8_t category)
+{
+  uint8_t evt[8] = { ANCS_EVENT_ADDED, 0, category, 1,
+                     BREAK_UINT32(uid, 0), BREAK_UINT32(uid, 1), BREAK_UINT32(uid, 2), BREAK_UINT32(uid, 3) };
+
+  notify(NOTIF_SRC_HANDLE, evt, sizeof(evt));
+}
+
+static uint16_t putAttr(uint8_t *p, uint8_t id, const char *value, uint16_t len)
+{
+  p[0] = id;
+  p[1] = LO_UINT16(len);
+  p[2] = HI_UINT16(len);
+  memcpy(&p[3], value, len);
+  return 3 + len;
+}
+
+// Get Notification Attributes answer, with the value lengths given.
+static uint16_t answer(uint8_t *p, uint32_t uid, const char *app, uint16_t appLen,
+                       const char *title, uint16_t titleLen, const char *msg, uint16_t msgLen)
+{
+  uint16_t len = 0;
+
+  p[len++] = ANCS_CMD_GET_NOTIF_ATTR;
+  p[len++] = BREAK_UINT32(uid, 0);
+  p[len++] = BREAK_UINT32(uid, 1);
+  p[len++] = BREAK_UINT32(uid, 2);
+  p[len++] = BREAK_UINT32(uid, 3);
+  len += putAttr(&p[len], ANCS_ATTR_APP_ID, app, appLen);
+  len += putAttr(&p[len], ANCS_ATTR_TITLE, title, titleLen);
+  len += putAttr(&p[len], ANCS_ATTR_MESSAGE, msg, msgLen);
+  return len;
+}
+
+// The answer in notifications of at most mtu - 3 bytes, as the phone sends it.
+static void sendAnswer(uint8_t *p, uint16_t len, uint16_t piece)
+{
+  uint16_t pos;
+
+  for (pos = 0; pos < len; pos += piece) {
+    notify(DATA_SRC_HANDLE, &p[pos], (len - pos < piece) ? (len - pos) : piece);
+  }
+}
+
+/*********************************************************************
+ * Cases
+ */
+static void testRequest(void)
+{
+  connect();
+
+  added(0x11223344, ANCS_CATEGORY_SOCIAL);
+  CHECK(lastWriteHandle == CTRL_POINT_HANDLE);
+  CHECK(lastWriteLen == 12);
+  CHECK(lastWrite[0] == ANCS_CMD_GET_NOTIF_ATTR);
+  CHECK(BUILD_UINT32(lastWrite[1], lastWrite[2], lastWrite[3], lastWrite[4]) == 0x11223344);
+  CHECK((lastWrite[5] == ANCS_ATTR_APP_ID) && (lastWrite[6] == ANCS_ATTR_TITLE) && (lastWrite[9] == ANCS_ATTR_MESSAGE));
+  CHECK(BUILD_UINT16(lastWrite[7], lastWrite[8]) == F91_HISTORY_SENDER_LEN);
+  CHECK(BUILD_UINT16(lastWrite[10], lastWrite[11]) == F91_HISTORY_BODY_LEN);
+  CHECK(F91Ancs_isBusy());
+}
+
+// Every split point of the answer, and a byte per notification.
+static void testSplit(void)
+{
+  uint8_t  rsp[128];
+  uint16_t len;
+  uint16_t split;
+  uint32_t uid;
+
+  connect();
+  len = answer(rsp, 0, "com.apple.MobileSMS", 19, "Ada", 3, "see you at 6", 12);
+
+  for (split = 0; split <= len; split++) {
+    uid = 100 + split;
+    len = answer(rsp, uid, "com.apple.MobileSMS", 19, "Ada", 3, "see you at 6", 12);
+    deliveries = 0;
+    added(uid, ANCS_CATEGORY_SOCIAL);
+    if (split > 0) {
+      notify(DATA_SRC_HANDLE, rsp, split);
+    }
+    if (split < len) {
+      CHECK(deliveries == 0);
+      notify(DATA_SRC_HANDLE, &rsp[split], len - split);
+    }
+    CHECK(deliveries == 1);
+    CHECK(strcmp(delivered.text, "Ada") == 0);
+    CHECK(strcmp(delivered.body, "see you at 6") == 0);
+    CHECK(!F91Ancs_isBusy());
+  }
+
+  deliveries = 0;
+  added(999, ANCS_CATEGORY_INCOMING_CALL);
+  len = answer(rsp, 999, "com.apple.mobilephone", 21, "Grace", 5, "", 0);
+  sendAnswer(rsp, len, 1);
+  CHECK(deliveries == 1);
+  CHECK(delivered.present == F91_SYNC_FIELD(F91_SYNC_TAG_CALL));
+  CHECK(strcmp(delivered.call, "Grace") == 0);
+}
+
+// Values cut to the length asked for, or sent longer anyway.
+static void testTruncated(void)
+{
+  char     longTitle[64];
+  char     longMsg[200];
+  uint8_t  rsp[300];
+  uint16_t len;
+
+  connect();
+  memset(longTitle, 'T', sizeof(longTitle));
+  memset(longMsg, 'm', sizeof(longMsg));
+
+  // Cut by the phone to exactly the lengths asked for.
+  deliveries = 0;
+  added(1, ANCS_CATEGORY_SOCIAL);
+  len = answer(rsp, 1, "x", 1, longTitle, F91_HISTORY_SENDER_LEN, longMsg, F91_HISTORY_BODY_LEN);
+  sendAnswer(rsp, len, ATT_MTU_SIZE - 3);
+  CHECK(deliveries == 1);
+  CHECK(strlen(delivered.text) == F91_HISTORY_SENDER_LEN);
+  CHECK(strlen(delivered.body) == F91_HISTORY_BODY_LEN);
+
+  // Longer than asked for: kept to the buffer, the rest parsed over so the
+  // message after it still lands.
+  deliveries = 0;
+  added(2, ANCS_CATEGORY_SOCIAL);
+  len = answer(rsp, 2, "x", 1, longTitle, sizeof(longTitle), longMsg, sizeof(longMsg));
+  sendAnswer(rsp, len, ATT_MTU_SIZE - 3);
+  CHECK(deliveries == 1);
+  CHECK(strlen(delivered.text) == F91_HISTORY_SENDER_LEN);
+  CHECK(strlen(delivered.body) == F91_HISTORY_BODY_LEN);
+  CHECK(!F91Ancs_isBusy());
+
+  // No title, the app name stands in.
+  deliveries = 0;
+  added(3, ANCS_CATEGORY_SOCIAL);
+  len = answer(rsp, 3, "net.whatsapp.WhatsApp", 21, "", 0, "hi", 2);
+  sendAnswer(rsp, len, ATT_MTU_SIZE - 3);
+  CHECK(deliveries == 1);
+  CHECK(strcmp(delivered.text, "WhatsApp") == 0);
+
+  // An answer that stops short keeps the request open until the link goes.
+  deliveries = 0;
+  added(4, ANCS_CATEGORY_SOCIAL);
+  len = answer(rsp, 4, "x", 1, "Ada", 3, "lost", 4);
+  notify(DATA_SRC_HANDLE, rsp, len - 2);
+  CHECK(deliveries == 0);
+  CHECK(F91Ancs_isBusy());
+  F91Ancs_reset();
+  CHECK(!F91Ancs_isBusy());
+}
+
+// An answer for another notification, or not an answer, is skipped and
+// the next one asked for.
+static void testWrongAnswer(void)
+{
+  uint8_t  rsp[64];
+  uint16_t len;
+  uint32_t before;
+
+  connect();
+  deliveries = 0;
+
+  added(10, ANCS_CATEGORY_SOCIAL);
+  added(11, ANCS_CATEGORY_SOCIAL);
+  before = writes;
+  len = answer(rsp, 77, "x", 1, "Eve", 3, "no", 2);
+  sendAnswer(rsp, len, ATT_MTU_SIZE - 3);
+  CHECK(deliveries == 0);
+  CHECK(writes == before + 1);
+  CHECK(BUILD_UINT32(lastWrite[1], lastWrite[2], lastWrite[3], lastWrite[4]) == 11);
+
+  rsp[0] = 0x7F;
+  notify(DATA_SRC_HANDLE, rsp, 1);
+  CHECK(deliveries == 0);
+  CHECK(!F91Ancs_isBusy());
+
+  // The parser takes the next answer from its start.
+  added(12, ANCS_CATEGORY_SOCIAL);
+  len = answer(rsp, 12, "x", 1, "Bob", 3, "ok", 2);
+  sendAnswer(rsp, len, ATT_MTU_SIZE - 3);
+  CHECK(deliveries == 1);
+  CHECK(strcmp(delivered.text, "Bob") == 0);
+}
+
+int main(void)
+{
+  F91Ancs_init(0);
+
+  testRequest();
+  testSplit();
+  testTruncated();
+  testWrongAnswer();
+
+  return host_done("test_ancs");
+}
@@ -0,0 +1,356 @@
+/*
+ * Host benchmark of the bulk channel (f91_bulk.c) against the
+ * characteristic writes it was added next to.
+ *
+ * The same image goes to the same consumer, the OAD block writer into the
+ * simulated flash, once as writes without response on the block
+ * characteristic and once as SDUs of the connection oriented channel.
+ * The harness plays the phone and the stack: SDUs are handed over in a
+ * buffer of their own, freed by the module, and the phone spends a credit
+ * per SDU and gets back what the watch returns on the next event.
+ *
+ * Measured: host ns from the first block to the last, per path. Modelled,
+ * from the connection events the phone needs: the link time on the watch.
+ * The phone gets PHONE_PDUS_PER_EVENT PDUs into an event. On the
+ * characteristic it can't send more than the service queues
+ * (OAD_BLOCK_QUEUE_LEN) or the blocks past it are dropped. On the channel
+ * it is held back only by its credits. A block of either fits in one PDU,
+ * the characteristic needs ATT_MTU raised to take it.
+ */
+#include <string.h>
+
+#include "host.h"
+#include "host_gatt.h"
+#include "sim/flash_sim.h"
+
+#include "l2cap.h"
+#include "linkdb.h"
+
+#include "f91_att_queue.h"
+#include "f91_bulk.h"
+#include "f91_kepler.h"
+#include "f91_link.h"
+#include "f91_oad.h"
+#include "f91_oad_service.h"
+
+#define PASSES                  20
+
+// Assumed: PDUs the phone gets into one connection event, and its interval.
+#define PHONE_PDUS_PER_EVENT    6
+#define CONN_INTERVAL_US        7500
+
+#define BULK_CID                0x0040
+
+extern const uint8_t f91_oad_serviceChar1UUID[];
+extern const uint8_t f91_oad_serviceChar2UUID[];
+
+// Channel registered by the module.
+static l2capPsm_t psm;
+
+// The phone's credits, and the ones returned for the next event.
+static uint16_t credits;
+static uint16_t returned;
+static bool     outOfCredit;
+
+// Characteristics written since the last drain, bit per F91_OAD_SERVICE_CHARx.
+static uint8_t  pending;
+
+static uint8_t  image[F91_OAD_IMAGE_MAX];
+static uint32_t imageLen;
+
+/*********************************************************************
+ * The stack and the rest of the application.
+ */
+bStatus_t L2CAP_RegisterPsm(l2capPsm_t *pPsm)
+{
+  psm = *pPsm;
+  return SUCCESS;
+}
+
+bStatus_t L2CAP_FlowCtrlCredit(uint16 CID, uint16 peerCredits)
+{
+  CHECK(CID == BULK_CID);
+  returned += peerCredits;
+  return SUCCESS;
+}
+
+void BM_free(void *pBuf)
+{
+  free(pBuf);
+}
+
+void F91Kepler_oadCharValueChangeCB(uint8_t paramID)
+{
+  pending |= 1 << paramID;
+}
+
+bStatus_t F91AttQueue_sendNoti(uint16_t connHandle, attHandleValueNoti_t *pNoti)
+{
+  return GATT_Notification(connHandle, pNoti, FALSE);
+}
+
+void F91Link_countRx(uint16_t len)                      { }
+void F91Link_setBulkHint(bool bulk)                     { }
+
+/*********************************************************************
+ * Helpers
+ */
+static uint32_t crc32(const uint8_t *pData, uint32_t len)
+{
+  uint32_t crc = 0xFFFFFFFF;
+  uint8_t bit;
+
+  while (len--) {
+    crc ^= *pData++;
+    for (bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+    }
+  }
+
+  return ~crc;
+}
+
+static void makeImage(uint32_t seed)
+{
+  uint32_t i;
+
+  imageLen = F91_OAD_IMAGE_MAX;
+  for (i = 0; i < imageLen; i++) {
+    seed = seed * 1103515245 + 12345;
+    image[i] = (uint8_t)(seed >> 16);
+  }
+}
+
+static uint16_t blocks(void)
+{
+  return (imageLen + OAD_BLOCK_LEN - 1) / OAD_BLOCK_LEN;
+}
+
+// [block lo][block hi][data] at pBlock, returns its length.
+static uint16_t block(uint8_t *pBlock, uint16_t n)
+{
+  uint32_t offset = (uint32_t)n * OAD_BLOCK_LEN;
+  uint16_t len = MIN(OAD_BLOCK_LEN, imageLen - offset);
+
+  pBlock[0] = LO_UINT16(n);
+  pBlock[1] = HI_UINT16(n);
+  memcpy(&pBlock[OAD_BLOCK_HDR_LEN], &image[offset], len);
+  return OAD_BLOCK_HDR_LEN + len;
+}
+
+// The F91Kepler task takes what was written during the event.
+static void drain(void)
+{
+  uint8_t param;
+
+  while (pending) {
+    for (param = F91_OAD_SERVICE_CHAR1; param <= F91_OAD_SERVICE_CHAR2; param++) {
+      if (pending & (1 << param)) {
+        pending &= ~(1 << param);
+        F91Oad_processCharChangeEvt(param);
+      }
+    }
+  }
+}
+
+static bool complete(void)
+{
+  f91_oad_serviceControl_t rsp;
+
+  F91_oad_service_GetParameter(F91_OAD_SERVICE_CHAR1, &rsp);
+  return (rsp.len == OAD_RSP_LEN) && (rsp.data[0] == F91_OAD_RSP_COMPLETE) &&
+         (rsp.data[1] == F91_OAD_SUCCESS);
+}
+
+// Abort whatever came before and start the image.
+static void start(void)
+{
+  uint8_t  op = F91_OAD_CMD_ABORT;
+  uint32_t crc = crc32(image, imageLen);
+  uint8_t  cmd[OAD_CONTROL_LEN] =
+  {
+    F91_OAD_CMD_START, 1, 0,
+    BREAK_UINT32(imageLen, 0), BREAK_UINT32(imageLen, 1),
+    BREAK_UINT32(imageLen, 2), BREAK_UINT32(imageLen, 3),
+    BREAK_UINT32(crc, 0), BREAK_UINT32(crc, 1), BREAK_UINT32(crc, 2), BREAK_UINT32(crc, 3)
+  };
+
+  CHECK(hostGatt_write(f91_oad_serviceChar1UUID, &op, 1, 0) == SUCCESS);
+  CHECK(hostGatt_write(f91_oad_serviceChar1UUID, cmd, sizeof(cmd), 0) == SUCCESS);
+  drain();
+}
+
+static void channelEvent(uint8_t opcode)
+{
+  l2capSignalEvent_t evt;
+
+  memset(&evt, 0, sizeof(evt));
+  evt.opcode = opcode;
+  evt.cmd.channelEstEvt.result = L2CAP_CONN_SUCCESS;
+  evt.cmd.channelEstEvt.CID = BULK_CID;
+  evt.cmd.channelEstEvt.info.psm = psm.psm;
+  if (opcode != L2CAP_CHANNEL_ESTABLISHED_EVT) {
+    evt.cmd.creditEvt.CID = BULK_CID;
+  }
+  F91Bulk_processSignal(&evt);
+}
+
+// The phone opens the channel with the credits the watch gives.
+static void openChannel(void)
+{
+  F91Bulk_updateSecurity(0);
+  channelEvent(L2CAP_CHANNEL_ESTABLISHED_EVT);
+  credits = psm.initPeerCredits;
+  returned = 0;
+  outOfCredit = false;
+}
+
+// An SDU in a buffer of its own, the module frees it.
+static void sdu(uint16_t n)
+{
+  l2capDataEvent_t evt;
+  uint8_t *pSdu = malloc(F91_BULK_HDR_LEN + OAD_BLOCK_HDR_LEN + OAD_BLOCK_LEN);
+
+  pSdu[0] = F91_BULK_TYPE_OAD_BLOCK;
+  evt.connHandle = 0;
+  evt.pkt.CID = BULK_CID;
+  evt.pkt.pPayload = pSdu;
+  evt.pkt.len = F91_BULK_HDR_LEN + block(&pSdu[F91_BULK_HDR_LEN], n);
+  F91Bulk_processData(&evt);
+
+  // The stack tells the watch once the phone is down to the threshold.
+  if (--credits == psm.peerCreditThreshold) {
+    channelEvent(L2CAP_PEER_CREDIT_THRESHOLD_EVT);
+  }
+}
+
+/*********************************************************************
+ * Paths, each returns the connection events the image took.
+ */
+static uint32_t viaCharacteristic(void)
+{
+  uint8_t  value[OAD_BLOCK_HDR_LEN + OAD_BLOCK_LEN];
+  uint32_t events = 0;
+  uint16_t n = 0;
+  uint8_t  i;
+
+  while (n < blocks()) {
+    for (i = 0; (i < MIN(PHONE_PDUS_PER_EVENT, OAD_BLOCK_QUEUE_LEN)) && (n < blocks()); i++, n++) {
+      CHECK(hostGatt_write(f91_oad_serviceChar2UUID, value, block(value, n), 0) == SUCCESS);
+    }
+    drain();
+    events++;
+  }
+
+  return events;
+}
+
+static uint32_t viaChannel(void)
+{
+  uint32_t events = 0;
+  uint16_t n = 0;
+  uint8_t  i;
+
+  while (n < blocks()) {
+    credits += returned;
+    returned = 0;
+    if (credits == 0) {
+      outOfCredit = true;
+    }
+
+    for (i = 0; (i < PHONE_PDUS_PER_EVENT) && (credits > 0) && (n < blocks()); i++, n++) {
+      sdu(n);
+    }
+    events++;
+  }
+
+  return events;
+}
+
+/*********************************************************************
+ * Cases
+ */
+static void testUnauthenticated(void)
+{
+  uint8_t linkState = host_linkState;
+
+  makeImage(1);
+  start();
+  openChannel();
+
+  // The link lost its keys since the channel opened, the SDU is dropped.
+  host_linkState = LINK_CONNECTED | LINK_ENCRYPTED;
+  sdu(0);
+  host_linkState = linkState;
+  CHECK(!complete());
+
+  channelEvent(L2CAP_CHANNEL_TERMINATED_EVT);
+}
+
+static void benchmark(void)
+{
+  uint64_t samples[2][PASSES];
+  uint32_t events[2] = { 0, 0 };
+  uint32_t bytes[2];
+  uint64_t begin;
+  uint32_t pass;
+  uint8_t  path;
+
+  for (pass = 0; pass < PASSES; pass++) {
+    for (path = 0; path < 2; path++) {
+      makeImage(pass * 2 + path + 2);
+      start();
+      flashSim_reset();
+
+      if (path == 1) {
+        openChannel();
+      }
+
+      begin = host_nowNs();
+      events[path] = (path == 0) ? viaCharacteristic() : viaChannel();
+      samples[path][pass] = host_nowNs() - begin;
+
+      CHECK(complete());
+      CHECK(memcmp(&flashSim_mem[F91_OAD_IMAGE_ADDR], image, imageLen) == 0);
+
+      if (path == 1) {
+        CHECK(!outOfCredit);
+        channelEvent(L2CAP_CHANNEL_TERMINATED_EVT);
+      }
+    }
+  }
+
+  // What crosses the air for the blocks: ATT header or SDU length and type.
+  bytes[0] = blocks() * 3 + blocks() * OAD_BLOCK_HDR_LEN + imageLen;
+  bytes[1] = blocks() * (2 + F91_BULK_HDR_LEN) + blocks() * OAD_BLOCK_HDR_LEN + imageLen;
+
+  printf("  %u byte image, %u blocks, %u passes, %u PDUs per %u us event assumed:\n",
+         imageLen, blocks(), PASSES, PHONE_PDUS_PER_EVENT, CONN_INTERVAL_US);
+  for (path = 0; path < 2; path++) {
+    uint64_t ns = host_percentile(samples[path], PASSES, 50);
+    uint32_t linkMs = events[path] * CONN_INTERVAL_US / 1000;
+
+    printf("    %-14s host p50 %6llu ns/block  %u bytes over the air  %u events, %u ms, %u B/s\n",
+           (path == 0) ? "characteristic" : "channel",
+           (unsigned long long)(ns / blocks()), bytes[path], events[path], linkMs,
+           linkMs ? imageLen * 1000 / linkMs : 0);
+  }
+  printf("    flash, the same for both: %u ms modelled\n",
+         flashSim_busyUs(&flashSim_stats) / 1000);
+
+  CHECK(events[1] < events[0]);
+}
+
+int main(void)
+{
+  flashSim_reset();
+  F91Oad_init();
+  F91Bulk_init(0);
+  CHECK(psm.psm == F91_BULK_PSM);
+  CHECK(psm.initPeerCredits > psm.peerCreditThreshold);
+
+  testUnauthenticated();
+  benchmark();
+
+  return host_done("test_bulk");
+}
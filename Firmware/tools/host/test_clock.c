@@ -0,0 +1,182 @@
+/*
+ * Host benchmark of the per-second clock update (f91_clock.c) and of the
+ * wait it puts on a BLE message, now that it runs on the F91Kepler event
+ * loop rather than on a task of its own.
+ *
+ * The update, the clock service, the display driver and the log run as
+ * built for the watch, with the display on and the seconds moving. Each
+ * update is timed in host ns, and the I2C bus time of its panel transfer
+ * is put on it from the bytes sent. A message that comes in just after an
+ * update started waits, worst case:
+ *  - on the loop (now): the whole update, rendering and panel transfer.
+ *  - on the clock task (before, priority 1 under F91Kepler's 2): nothing
+ *    unless it updates the panel too, then the panel transfer the clock
+ *    task holds the display lock for.
+ */
+#include <string.h>
+#include <time.h>
+
+#include "host.h"
+#include "host_gatt.h"
+#include "sim/i2c_sim.h"
+#include "sim/snv_sim.h"
+
+#include <ti/sysbios/hal/Seconds.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+#include "f91_utils.h"
+#include "ssd1306.h"
+#include "f91_alarm.h"
+#include "f91_att_queue.h"
+#include "f91_clock.h"
+#include "f91_kepler.h"
+#include "f91_link.h"
+#include "f91_log.h"
+#include "f91_notification.h"
+#include "f91_outbound.h"
+#include "f91_stopwatch.h"
+#include "f91_timers.h"
+
+#define UPDATES                 600
+
+// Display lock, from f91_kepler.c.
+Semaphore_Struct semStruct;
+Semaphore_Handle semHandle = &semStruct;
+
+static uint32_t ticks;
+
+/*********************************************************************
+ * The RTS and the modules off the path.
+ */
+time_t time(time_t *pTime)
+{
+  time_t now = Seconds_get();
+
+  if (pTime) {
+    *pTime = now;
+  }
+  return now;
+}
+
+// TI's RTS, the decimal digits of val.
+int ltoa(long val, char *pBuf)
+{
+  return sprintf(pBuf, "%ld", val);
+}
+
+uint64_t AONRTCCurrent64BitValueGet(void)
+{
+  return 0;
+}
+
+void F91Kepler_clockTickCB(void)
+{
+  ticks++;
+}
+
+void F91Timers_construct(f91Timer_t *pTimer, f91TimerCB_t pfnExpire, UArg arg)
+{
+  memset(pTimer, 0, sizeof(*pTimer));
+}
+
+void F91Timers_start(f91Timer_t *pTimer, uint32_t expires)
+{
+}
+
+void F91Timers_stop(f91Timer_t *pTimer)
+{
+}
+
+bool F91Timers_isActive(f91Timer_t *pTimer)
+{
+  return false;
+}
+
+bStatus_t F91AttQueue_sendNoti(uint16_t connHandle, attHandleValueNoti_t *pNoti)
+{
+  return GATT_Notification(connHandle, pNoti, FALSE);
+}
+
+void F91Kepler_clockCharValueChangeCB(uint8_t paramID)  { }
+void F91Link_countRx(uint16_t len)                      { }
+void F91Outbound_setDrift(int32_t delta)                { }
+void F91Alarm_configure(uint8_t *record)                { }
+void F91Alarm_timeChanged(int32_t delta)                { }
+bool F91Alarm_isAlerting(void)                          { return false; }
+bool F91Stopwatch_isActive(void)                        { return false; }
+bool F91Notification_getNotificationState(void)         { return false; }
+
+/*********************************************************************
+ * Cases
+ */
+static void testDisplayOff(void)
+{
+  i2cSimStats_t before;
+
+  ssd1306_toggle_display(true);
+  F91Clock_wake();
+  host_advanceTicks(1000 * (1000 / Clock_tickPeriod));
+  CHECK(ticks == 1);
+
+  // The tick stops itself and nothing goes on the bus.
+  ssd1306_toggle_display(false);
+  before = i2cSim_stats;
+  F91Clock_processEvent();
+  CHECK(i2cSim_stats.transfers == before.transfers);
+
+  host_advanceTicks(2000 * (1000 / Clock_tickPeriod));
+  CHECK(ticks == 1);
+}
+
+static void benchmark(void)
+{
+  static uint64_t samples[UPDATES];
+  i2cSimStats_t before;
+  i2cSimStats_t panel;
+  uint32_t busUs = 0;
+  uint32_t bytes = 0;
+  uint64_t begin;
+  uint64_t p99;
+  uint32_t n;
+
+  ssd1306_toggle_display(true);
+  F91Clock_wake();
+
+  for (n = 0; n < UPDATES; n++) {
+    Seconds_set(Seconds_get() + 1);
+
+    before = i2cSim_stats;
+    begin = host_nowNs();
+    F91Clock_processEvent();
+    samples[n] = host_nowNs() - begin;
+
+    panel.transfers = i2cSim_stats.transfers - before.transfers;
+    panel.bytes = i2cSim_stats.bytes - before.bytes;
+    CHECK(panel.bytes > 0);
+    if (i2cSim_busUs(&panel) > busUs) {
+      busUs = i2cSim_busUs(&panel);
+      bytes = panel.bytes;
+    }
+  }
+  p99 = host_percentile(samples, UPDATES, 99);
+
+  printf("  %u updates, host ns p50 %llu p99 %llu, panel %u bytes on I2C, %u us\n", UPDATES,
+         (unsigned long long)host_percentile(samples, UPDATES, 50), (unsigned long long)p99,
+         bytes, busUs);
+  printf("  worst wait of a message behind an update:\n");
+  printf("    clock task   %6u us if it updates the panel, 0 otherwise\n", busUs);
+  printf("    event loop   %6u us + %llu host ns, any message\n", busUs, (unsigned long long)p99);
+}
+
+int main(void)
+{
+  snvSim_reset();
+  F91Log_init();
+  F91Clock_init();
+
+  testDisplayOff();
+  benchmark();
+
+  return host_done("test_clock");
+}
@@ -0,0 +1,240 @@
+/*
+ * Host micro-benchmark of the notification fan-out (f91_service.c and
+ * f91_att_queue.c) against the stack's, GATTServApp_ProcessCharCfg from
+ * PROFILES/gattservapp_util.c.
+ *
+ * One service of CHARS notifying characteristics, built by
+ * F91Service_init, with up to HOST_NUM_CONNS links subscribed. A value is
+ * set either through F91Service_setValue, which goes to the subscribed
+ * slots from the index and sends through the ATT queue, or the way a TI
+ * profile does it, GATTServApp_ProcessCharCfg over the configuration
+ * table, which searches the attribute table for every subscriber and
+ * sends straight to the stack. Host ns per value set, p50 over SAMPLES,
+ * for the first and the last characteristic of the table.
+ *
+ * Then a burst the controller can't take at once: the direct path loses
+ * what is turned down, the queue holds it for the next events.
+ */
+#include <string.h>
+
+#include "host.h"
+#include "host_gatt.h"
+
+#include "gattservapp.h"
+#include "linkdb.h"
+
+#include "f91_att_queue.h"
+#include "f91_kepler.h"
+#include "f91_service.h"
+
+#define CHARS                   16
+#define VALUE_LEN               20
+#define SAMPLES                 2000
+#define BATCH                   16
+
+// Burst: values set at once, and notifications the controller takes per
+// connection event.
+#define BURST                   3
+#define TX_PER_EVENT            4
+
+// Service
+static const uint8_t serviceUUID[ATT_UUID_SIZE] =
+  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00, 0xF0, 0xB2, 0x00, 0x00 };
+static const gattAttrType_t serviceDecl = { ATT_UUID_SIZE, serviceUUID };
+
+// Characteristics
+static uint8_t          props = GATT_PROP_READ | GATT_PROP_NOTIFY;
+static uint8_t          uuids[CHARS][ATT_UUID_SIZE];
+static uint8_t          values[CHARS][VALUE_LEN];
+static gattCharCfg_t    *cfgs[CHARS];
+static uint8_t          desc[] = "Bench";
+static f91ServiceChar_t chars[CHARS];
+static f91ServiceIndex_t charIndex[CHARS];
+
+static bStatus_t readAttrCB(uint16_t connHandle, gattAttribute_t *pAttr, uint8_t *pValue,
+                            uint16_t *pLen, uint16_t offset, uint16_t maxLen, uint8_t method);
+static bStatus_t writeAttrCB(uint16_t connHandle, gattAttribute_t *pAttr, uint8_t *pValue,
+                             uint16_t len, uint16_t offset, uint8_t method);
+
+static const gattServiceCBs_t serviceCBs = { readAttrCB, writeAttrCB, NULL };
+
+static f91Service_t service = { &serviceDecl, chars, CHARS, charIndex, &serviceCBs };
+
+/*********************************************************************
+ * The service's callbacks and the F91Kepler task.
+ */
+static bStatus_t readAttrCB(uint16_t connHandle, gattAttribute_t *pAttr, uint8_t *pValue,
+                            uint16_t *pLen, uint16_t offset, uint16_t maxLen, uint8_t method)
+{
+  return F91Service_read(&service, pAttr, pValue, pLen, offset, maxLen);
+}
+
+static bStatus_t writeAttrCB(uint16_t connHandle, gattAttribute_t *pAttr, uint8_t *pValue,
+                             uint16_t len, uint16_t offset, uint8_t method)
+{
+  uint8_t param;
+
+  return F91Service_write(&service, connHandle, pAttr, pValue, len, offset, &param);
+}
+
+void F91Kepler_attQueueCB(void)                         { }
+
+/*********************************************************************
+ * Helpers
+ */
+static void setUp(void)
+{
+  uint8_t c;
+
+  for (c = 0; c < CHARS; c++) {
+    memcpy(uuids[c], serviceUUID, ATT_UUID_SIZE);
+    uuids[c][12] = 0xF1 + c;
+
+    chars[c].pProps = &props;
+    chars[c].pUUID = uuids[c];
+    chars[c].permit = GATT_PERMIT_READ;
+    chars[c].pDesc = desc;
+    chars[c].pValue = values[c];
+    chars[c].maxLen = VALUE_LEN;
+    chars[c].ppCfg = &cfgs[c];
+  }
+
+  CHECK(F91Service_init(&service) == SUCCESS);
+  F91AttQueue_init();
+}
+
+// The first subs links have notifications on for every characteristic,
+// the others off.
+static void subscribe(uint8_t subs)
+{
+  uint8_t c;
+  uint8_t i;
+
+  for (c = 0; c < CHARS; c++) {
+    for (i = 0; i < linkDBNumConns; i++) {
+      CHECK(hostGatt_writeCfg(uuids[c], i, (i < subs) ? GATT_CLIENT_CFG_NOTIFY
+                                                      : GATT_CFG_NO_OPERATION) == SUCCESS);
+    }
+  }
+}
+
+static bStatus_t setIndexed(uint8_t param, uint8_t *pValue)
+{
+  return F91Service_setValue(&service, param, VALUE_LEN, pValue);
+}
+
+// As a TI profile's SetParameter.
+static bStatus_t setScanned(uint8_t param, uint8_t *pValue)
+{
+  memcpy(values[param], pValue, VALUE_LEN);
+  return GATTServApp_ProcessCharCfg(cfgs[param], values[param], FALSE, service.pAttrTbl,
+                                    service.numAttrs, 0, readAttrCB);
+}
+
+// Host ns per value set, p50.
+static uint64_t timeSet(bStatus_t (*pfnSet)(uint8_t, uint8_t *), uint8_t param, uint8_t subs)
+{
+  static uint64_t samples[SAMPLES];
+  uint8_t  value[VALUE_LEN];
+  uint32_t notifications = hostGatt_stats.notifications;
+  uint64_t begin;
+  uint32_t s;
+  uint8_t  i;
+
+  memset(value, 0x5A, sizeof(value));
+  for (s = 0; s < SAMPLES; s++) {
+    begin = host_nowNs();
+    for (i = 0; i < BATCH; i++) {
+      value[0] = i;
+      CHECK(pfnSet(param, value) == SUCCESS);
+    }
+    samples[s] = (host_nowNs() - begin) / BATCH;
+  }
+
+  // Every subscriber got every value.
+  CHECK(hostGatt_stats.notifications - notifications == (uint32_t)SAMPLES * BATCH * subs);
+  return host_percentile(samples, SAMPLES, 50);
+}
+
+/*********************************************************************
+ * Cases
+ */
+static void benchmark(void)
+{
+  uint8_t subs[] = { 0, 1, 4, linkDBNumConns };
+  uint8_t params[] = { 0, CHARS - 1 };
+  uint8_t s;
+  uint8_t p;
+
+  printf("  %u characteristics, %u attributes, %u links, host ns per value set (p50):\n",
+         CHARS, service.numAttrs, linkDBNumConns);
+  printf("    subscribed  characteristic  indexed   scanned\n");
+  for (s = 0; s < sizeof(subs); s++) {
+    subscribe(subs[s]);
+    for (p = 0; p < sizeof(params); p++) {
+      uint64_t indexed = timeSet(setIndexed, params[p], subs[s]);
+      uint64_t scanned = timeSet(setScanned, params[p], subs[s]);
+
+      printf("    %10u  %14s  %7llu   %7llu\n", subs[s], (p == 0) ? "first" : "last",
+             (unsigned long long)indexed, (unsigned long long)scanned);
+    }
+  }
+
+  CHECK(hostGatt_stats.buffers == 0);
+}
+
+// The controller takes TX_PER_EVENT notifications per connection event.
+static void burst(bool queued)
+{
+  uint32_t notifications = hostGatt_stats.notifications;
+  uint8_t  value[VALUE_LEN];
+  uint32_t events = 1;
+  uint8_t  i;
+
+  subscribe(linkDBNumConns);
+  memset(value, 0xA5, sizeof(value));
+
+  hostGatt_txBuffers = TX_PER_EVENT;
+  for (i = 0; i < BURST; i++) {
+    value[0] = i;
+    if (queued) {
+      setIndexed(0, value);
+    } else {
+      setScanned(0, value);
+    }
+  }
+
+  // The queue sends what it holds after every event.
+  if (queued) {
+    do {
+      hostGatt_txBuffers = TX_PER_EVENT;
+      events++;
+    } while (!F91AttQueue_process());
+  }
+  hostGatt_txBuffers = -1;
+
+  printf("    %-6s %2u of %2u sent, connection events: %u\n", queued ? "queued" : "direct",
+         hostGatt_stats.notifications - notifications, BURST * linkDBNumConns, events);
+
+  // Nothing is left allocated either way.
+  CHECK(hostGatt_stats.buffers == 0);
+  if (queued) {
+    CHECK(hostGatt_stats.notifications - notifications == MIN(BURST * linkDBNumConns,
+                                                              TX_PER_EVENT + F91_ATT_QUEUE_LEN));
+  } else {
+    CHECK(hostGatt_stats.notifications - notifications == TX_PER_EVENT);
+  }
+}
+
+int main(void)
+{
+  setUp();
+  benchmark();
+
+  printf("  burst of %u values to %u links, %u notifications per event:\n",
+         BURST, linkDBNumConns, TX_PER_EVENT);
+  burst(false);
+  burst(true);
+
+  return host_done("test_fanout");
+}
@@ -0,0 +1,304 @@
+/*
+ * Host benchmark of an incoming call or text, from the phone's write to
+ * the panel update, through a simulated F91Kepler event loop.
+ *
+ * The service's write callback, Util's message queue, the notification
+ * handler, the history, the log and the display driver run as built for
+ * the watch, with F91_LATENCY_TRACE on. The loop below plays the
+ * F91Kepler task the way F91Kepler_taskFxn does: the queued messages
+ * first, then the notification event. Each stage is timed from the mark
+ * before it, p50 and p99 in host ns over the traces. The time the watch
+ * waits, the coalescing window, is simulated and reported apart, as is
+ * the I2C bus time of the panel update.
+ */
+#include <string.h>
+
+#include "host.h"
+#include "host_gatt.h"
+#include "sim/i2c_sim.h"
+#include "sim/snv_sim.h"
+
+#include <icall.h>
+#include <ti/sysbios/knl/Event.h>
+#include <ti/sysbios/knl/Queue.h>
+
+#include "util.h"
+#include "f91_utils.h"
+#include "ssd1306.h"
+#include "f91_alarm.h"
+#include "f91_att_queue.h"
+#include "f91_bulk.h"
+#include "f91_buttons.h"
+#include "f91_clock.h"
+#include "f91_latency.h"
+#include "f91_link.h"
+#include "f91_log.h"
+#include "f91_notification.h"
+#include "f91_notification_service.h"
+#include "f91_outbound.h"
+#include "f91_stopwatch.h"
+#include "f91_timers.h"
+
+#define TRACES                  200
+
+// As in f91_kepler.c.
+#define F91_NOTIFICATION_CHAR_CHANGE_EVT  (1 << 1)
+#define F91_QUEUE_EVT                     UTIL_QUEUE_EVENT_ID
+#define F91_NOTIFICATION_EVT              Event_Id_04
+
+typedef struct
+{
+  appEvtHdr_t hdr;
+  uint8_t *pData;
+  uint32_t timestamp;
+} hostEvt_t;
+
+extern const uint8_t f91_notification_serviceChar2UUID[];
+extern const uint8_t f91_notification_serviceChar3UUID[];
+extern const uint8_t f91_notification_serviceChar4UUID[];
+
+static const char *stageNames[F91_LATENCY_STAGES] =
+{
+  "total", "queue", "wake", "handle", "coalesce", "render", "panel"
+};
+
+// F91Kepler task.
+static Event_Struct syncEvent;
+static Queue_Struct appMsg;
+static Queue_Handle appMsgQueue;
+
+// Display lock, from f91_kepler.c.
+Semaphore_Struct semStruct;
+Semaphore_Handle semHandle = &semStruct;
+
+// Trace in progress, as F91Latency_mark on the watch.
+static uint8_t       nextStage = F91_LATENCY_STAGES;
+static uint64_t      stampNs[F91_LATENCY_STAGES];
+static uint32_t      stampTicks[F91_LATENCY_STAGES];
+static i2cSimStats_t panelStart;
+
+// Finished traces, row 0 is the total.
+static uint64_t samples[F91_LATENCY_STAGES][TRACES];
+static uint32_t waitTicks[F91_LATENCY_STAGES][TRACES];
+static uint32_t panelBytes;
+static uint32_t panelUs;
+static uint32_t traces;
+
+/*********************************************************************
+ * The trace, timed on the host clock.
+ */
+void F91Latency_mark(uint8_t stage)
+{
+  uint64_t now = host_nowNs();
+  uint8_t i;
+
+  if (stage == F91_LATENCY_WRITE) {
+    nextStage = F91_LATENCY_WRITE;
+  }
+  if ((stage != nextStage) || (traces == TRACES)) {
+    return;
+  }
+
+  stampNs[stage] = now;
+  stampTicks[stage] = Clock_getTicks();
+  nextStage++;
+
+  if (stage == F91_LATENCY_RENDERED) {
+    panelStart = i2cSim_stats;
+  } else if (stage == F91_LATENCY_PANEL) {
+    i2cSimStats_t panel = { i2cSim_stats.transfers - panelStart.transfers,
+                            i2cSim_stats.bytes - panelStart.bytes };
+
+    panelBytes = panel.bytes;
+    panelUs = i2cSim_busUs(&panel);
+
+    samples[0][traces] = stampNs[F91_LATENCY_PANEL] - stampNs[F91_LATENCY_WRITE];
+    waitTicks[0][traces] = stampTicks[F91_LATENCY_PANEL] - stampTicks[F91_LATENCY_WRITE];
+    for (i = F91_LATENCY_QUEUED; i < F91_LATENCY_STAGES; i++) {
+      samples[i][traces] = stampNs[i] - stampNs[i - 1];
+      waitTicks[i][traces] = stampTicks[i] - stampTicks[i - 1];
+    }
+    traces++;
+  }
+}
+
+/*********************************************************************
+ * The F91Kepler task and the modules off the path.
+ */
+void F91Kepler_notificationCharValueChangeCB(uint8_t paramID)
+{
+  hostEvt_t *pMsg = ICall_malloc(sizeof(hostEvt_t));
+
+  pMsg->hdr.event = F91_NOTIFICATION_CHAR_CHANGE_EVT;
+  pMsg->hdr.state = paramID;
+  pMsg->pData = NULL;
+  pMsg->timestamp = Clock_getTicks();
+  Util_enqueueMsg(appMsgQueue, &syncEvent, (uint8_t *)pMsg);
+  F91_LATENCY_MARK(F91_LATENCY_QUEUED);
+}
+
+void F91Kepler_notificationFlushCB(void)
+{
+  Event_post(&syncEvent, F91_NOTIFICATION_EVT);
+}
+
+// Until nothing is left to do. The watch sleeps through a wait, the ticks
+// jump to the next clock.
+static void runTask(void)
+{
+  hostEvt_t *pMsg;
+  uint32_t events;
+  uint32_t wait;
+
+  for (;;) {
+    events = host_eventTake(&syncEvent);
+    if (events == 0) {
+      if (!host_nextClock(&wait)) {
+        return;
+      }
+      host_advanceTicks(wait);
+      continue;
+    }
+
+    if (events & F91_QUEUE_EVT) {
+      while (!Queue_empty(appMsgQueue)) {
+        pMsg = (hostEvt_t *)Util_dequeueMsg(appMsgQueue);
+        if (pMsg->hdr.event == F91_NOTIFICATION_CHAR_CHANGE_EVT) {
+          F91_LATENCY_MARK(F91_LATENCY_DEQUEUED);
+          F91Notification_processCharChangeEvt(pMsg->hdr.state);
+        }
+        ICall_free(pMsg);
+      }
+    }
+
+    if (events & F91_NOTIFICATION_EVT) {
+      F91Notification_processEvent();
+    }
+  }
+}
+
+void F91Timers_construct(f91Timer_t *pTimer, f91TimerCB_t pfnExpire, UArg arg)
+{
+  memset(pTimer, 0, sizeof(*pTimer));
+}
+
+void F91Timers_start(f91Timer_t *pTimer, uint32_t expires)
+{
+}
+
+void F91Timers_stop(f91Timer_t *pTimer)
+{
+}
+
+bool F91Timers_isActive(f91Timer_t *pTimer)
+{
+  return false;
+}
+
+bStatus_t F91AttQueue_sendNoti(uint16_t connHandle, attHandleValueNoti_t *pNoti)
+{
+  return GATT_Notification(connHandle, pNoti, FALSE);
+}
+
+void F91Link_countRx(uint16_t len)                      { }
+void F91Bulk_register(uint8_t type, f91BulkConsumer_t pfnConsumer) { }
+void F91Buttons_resetOneShot(void)                      { }
+void F91Buttons_startDisplayTimeout(void)               { }
+void F91Outbound_statusChanged(void)                    { }
+void F91Clock_refresh(void)                             { }
+bool F91Clock_is24Hour(void)                            { return false; }
+int32_t F91Clock_getUtcOffset(void)                     { return 0; }
+bool F91Alarm_isAlerting(void)                          { return false; }
+bool F91Stopwatch_isActive(void)                        { return false; }
+
+/*********************************************************************
+ * Helpers
+ */
+static void setUp(void)
+{
+  snvSim_reset();
+  F91Log_init();
+
+  appMsgQueue = Util_constructQueue(&appMsg);
+  ssd1306_init();
+  F91Notification_init();
+}
+
+// The phone writes a call, or a text with its body.
+static void write(bool call, uint32_t n)
+{
+  char sender[CONTACT_STREAM_LEN];
+  char body[MESSAGE_STREAM_LEN];
+  int len;
+
+  // A new sender every time, so no alert is folded into the one before.
+  len = snprintf(sender, sizeof(sender), "Contact %u", n);
+  if (call) {
+    CHECK(hostGatt_write(f91_notification_serviceChar2UUID, (uint8_t *)sender, len, 0) == SUCCESS);
+  } else {
+    CHECK(hostGatt_write(f91_notification_serviceChar4UUID, (uint8_t *)body,
+                         snprintf(body, sizeof(body), "Message %u, about this and that", n), 0) == SUCCESS);
+    CHECK(hostGatt_write(f91_notification_serviceChar3UUID, (uint8_t *)sender, len, 0) == SUCCESS);
+  }
+}
+
+// The alert times out, and the wake budget refills before the next one.
+static void dismiss(void)
+{
+  F91Notification_resetNotificationState();
+  host_advanceTicks(60000 * (1000 / Clock_tickPeriod) / F91_NOTIFICATION_WAKES_PER_MIN);
+}
+
+static void report(const char *name)
+{
+  uint8_t stage;
+
+  printf("  %s, %u traces, host ns:\n", name, traces);
+  for (stage = 0; stage < F91_LATENCY_STAGES; stage++) {
+    printf("    %-9s p50 %7llu  p99 %7llu", stageNames[stage],
+           (unsigned long long)host_percentile(samples[stage], traces, 50),
+           (unsigned long long)host_percentile(samples[stage], traces, 99));
+
+    // Every trace waits the same, the first one stands for all.
+    if (waitTicks[stage][0] > 0) {
+      printf("  + %u ms waited on the watch", waitTicks[stage][0] * Clock_tickPeriod / 1000);
+    }
+    if (stage == F91_LATENCY_PANEL) {
+      printf("  + %u bytes on I2C, %u us", panelBytes, panelUs);
+    }
+    printf("\n");
+  }
+}
+
+/*********************************************************************
+ * Cases
+ */
+static void traceAll(bool call)
+{
+  uint32_t n;
+
+  traces = 0;
+  for (n = 0; n < TRACES; n++) {
+    write(call, n);
+    runTask();
+    dismiss();
+  }
+
+  // Every write made it to the panel, through every stage in order.
+  CHECK(traces == TRACES);
+  CHECK(waitTicks[F91_LATENCY_FLUSHED][0] == F91_NOTIFICATION_COALESCE_MS * (1000 / Clock_tickPeriod));
+  CHECK(panelBytes > 0);
+}
+
+int main(void)
+{
+  setUp();
+
+  traceAll(true);
+  report("call");
+
+  traceAll(false);
+  report("text");
+
+  return host_done("test_latency");
+}
@@ -0,0 +1,302 @@
+/*
+ * Host test of the persistent log (f91_log.c) on the in-memory SNV.
+ *
+ * Covers the boot scan with and without a checkpoint, replay order across
+ * segment rotation, and power lost in the middle of a segment or checkpoint
+ * write. Reports the write amplification and the SNV reads the boot scan
+ * takes.
+ */
+#include <string.h>
+
+#include "host.h"
+#include "sim/snv_sim.h"
+
+#include "f91_log.h"
+#include "f91_timers.h"
+
+#define REC_LEN                 20
+
+// Records seen by the last replay.
+static uint8_t  replayed[64][REC_LEN];
+static uint8_t  replayedCount;
+
+/*********************************************************************
+ * The log only arms and stops its flush timer, the tests flush by hand.
+ */
+void F91Timers_construct(f91Timer_t *pTimer, f91TimerCB_t pfnExpire, UArg arg)
+{
+  memset(pTimer, 0, sizeof(*pTimer));
+  pTimer->pfnExpire = pfnExpire;
+  pTimer->arg = arg;
+}
+
+void F91Timers_start(f91Timer_t *pTimer, uint32_t expires)
+{
+  pTimer->expires = expires;
+  pTimer->pprev = &pTimer->next;
+}
+
+void F91Timers_stop(f91Timer_t *pTimer)
+{
+  pTimer->pprev = NULL;
+}
+
+bool F91Timers_isActive(f91Timer_t *pTimer)
+{
+  return pTimer->pprev != NULL;
+}
+
+/*********************************************************************
+ * Helpers
+ */
+static void record(uint8_t *pRec, uint32_t n)
+{
+  memset(pRec, (uint8_t)n, REC_LEN);
+  memcpy(pRec, &n, sizeof(n));
+}
+
+static uint32_t recordId(const uint8_t *pRec)
+{
+  uint32_t n;
+
+  memcpy(&n, pRec, sizeof(n));
+  return n;
+}
+
+static void replayCB(uint8_t type, uint8_t *pData, uint8_t len)
+{
+  CHECK(type == F91_LOG_NOTIFICATION);
+  CHECK(len == REC_LEN);
+  if (replayedCount < 64) {
+    memcpy(replayed[replayedCount++], pData, REC_LEN);
+  }
+}
+
+// Reboot: scan and replay, returns the SNV reads the scan took.
+static uint32_t reboot(void)
+{
+  uint32_t reads = snvSim_stats.reads;
+
+  F91Log_init();
+  reads = snvSim_stats.reads - reads;
+
+  replayedCount = 0;
+  F91Log_replay(replayCB);
+  return reads;
+}
+
+static void append(uint32_t first, uint32_t count)
+{
+  uint8_t rec[REC_LEN];
+  uint32_t n;
+
+  for (n = first; n < first + count; n++) {
+    record(rec, n);
+    F91Log_append(F91_LOG_NOTIFICATION, rec, REC_LEN);
+  }
+}
+
+// The replay holds exactly first..last, in order.
+static void expectRange(uint32_t first, uint32_t last)
+{
+  uint32_t i;
+
+  CHECK(replayedCount == last - first + 1);
+  for (i = 0; (i < replayedCount) && (i <= last - first); i++) {
+    CHECK(recordId(replayed[i]) == first + i);
+  }
+}
+
+/*********************************************************************
+ * Cases
+ */
+static void testEmpty(void)
+{
+  snvSim_reset();
+  reboot();
+  CHECK(replayedCount == 0);
+}
+
+static void testReplayAfterReboot(void)
+{
+  snvSim_reset();
+  reboot();
+
+  append(1, F91_LOG_BATCH * 2);
+  reboot();
+  expectRange(1, F91_LOG_BATCH * 2);
+
+  // Appending goes on after the replayed segments.
+  append(100, F91_LOG_BATCH);
+  reboot();
+  CHECK(replayedCount == F91_LOG_BATCH * 3);
+  CHECK(recordId(replayed[replayedCount - 1]) == 100 + F91_LOG_BATCH - 1);
+}
+
+static void testRotation(void)
+{
+  uint32_t segments = F91_LOG_SEGMENT_COUNT + 3;
+
+  snvSim_reset();
+  reboot();
+
+  append(1, F91_LOG_BATCH * segments);
+  reboot();
+
+  // Only the newest F91_LOG_SEGMENT_COUNT segments are left.
+  expectRange(F91_LOG_BATCH * (segments - F91_LOG_SEGMENT_COUNT) + 1, F91_LOG_BATCH * segments);
+}
+
+static void testCheckpointBoundsScan(void)
+{
+  uint32_t reads;
+
+  snvSim_reset();
+  reboot();
+
+  append(1, F91_LOG_BATCH * (F91_LOG_SEGMENT_COUNT * 3 + 1));
+  reads = reboot();
+
+  // Checkpoint, at most F91_LOG_CHECKPOINT_INTERVAL segments rolled
+  // forward and the read that ends the roll.
+  CHECK(reads <= 1 + F91_LOG_CHECKPOINT_INTERVAL + 1);
+  printf("  boot scan with checkpoint: %u SNV reads\n", reads);
+}
+
+static void testNoCheckpoint(void)
+{
+  uint8_t  junk[sizeof(uint32_t)] = { 0 };
+  uint32_t reads;
+
+  snvSim_reset();
+  reboot();
+
+  append(1, F91_LOG_BATCH * 3);
+
+  // A checkpoint that doesn't check out, every segment is read.
+  osal_snv_write(F91_LOG_NVID_CHECKPOINT, sizeof(junk), junk);
+  reads = reboot();
+  expectRange(1, F91_LOG_BATCH * 3);
+  CHECK(reads == 1 + F91_LOG_SEGMENT_COUNT);
+  printf("  boot scan without checkpoint: %u SNV reads\n", reads);
+}
+
+static void testTornSegmentLost(void)
+{
+  snvSim_reset();
+  reboot();
+
+  append(1, F91_LOG_BATCH * 2);
+
+  // Power goes during the third flush, that batch never lands.
+  snvSim_tear(SNV_SIM_TEAR_LOST, 0, 0);
+  append(50, F91_LOG_BATCH);
+  reboot();
+  expectRange(1, F91_LOG_BATCH * 2);
+
+  // The log carries on with the next sequence number.
+  append(200, F91_LOG_BATCH);
+  reboot();
+  CHECK(replayedCount == F91_LOG_BATCH * 3);
+  CHECK(recordId(replayed[replayedCount - 1]) == 200 + F91_LOG_BATCH - 1);
+}
+
+static void testTornSegmentPartial(void)
+{
+  uint32_t segments = F91_LOG_SEGMENT_COUNT + 1;
+
+  snvSim_reset();
+  reboot();
+
+  // Every slot holds a segment, the torn one lands over an old one.
+  append(1, F91_LOG_BATCH * segments);
+
+  snvSim_tear(SNV_SIM_TEAR_PARTIAL, 0, 30);
+  append(500, F91_LOG_BATCH);
+  reboot();
+
+  // The half written segment fails its CRC, nothing of it is replayed and
+  // the head is the segment before it.
+  expectRange(F91_LOG_BATCH * (segments - F91_LOG_SEGMENT_COUNT + 1) + 1, F91_LOG_BATCH * segments);
+}
+
+static void testTornCheckpoint(void)
+{
+  uint32_t flushes = F91_LOG_CHECKPOINT_INTERVAL;
+  uint32_t i;
+
+  snvSim_reset();
+  reboot();
+
+  // Tear the write that follows the F91_LOG_CHECKPOINT_INTERVAL-th
+  // segment, the checkpoint.
+  append(1, F91_LOG_BATCH * (flushes - 1));
+  snvSim_tear(SNV_SIM_TEAR_PARTIAL, 1, 5);
+  append(F91_LOG_BATCH * (flushes - 1) + 1, F91_LOG_BATCH);
+  for (i = 0; i < 2; i++) {
+    append(F91_LOG_BATCH * (flushes + i) + 1, F91_LOG_BATCH);
+  }
+  reboot();
+
+  // Fallback scan over every segment.
+  expectRange(1, F91_LOG_BATCH * (flushes + 2));
+}
+
+static void testFailedWrite(void)
+{
+  snvSim_reset();
+  reboot();
+
+  append(1, F91_LOG_BATCH);
+  snvSim_failWrites(true);
+  append(10, F91_LOG_BATCH);
+  snvSim_failWrites(false);
+  append(20, F91_LOG_BATCH);
+  reboot();
+
+  // The failed batch is dropped, the others are there in order.
+  CHECK(replayedCount == F91_LOG_BATCH * 2);
+  CHECK(recordId(replayed[0]) == 1);
+  CHECK(recordId(replayed[F91_LOG_BATCH]) == 20);
+}
+
+static void reportAmplification(void)
+{
+  uint32_t records = 1000;
+  uint32_t bytes;
+  uint64_t start;
+  uint64_t ns;
+
+  snvSim_reset();
+  reboot();
+
+  bytes = snvSim_stats.bytesWritten;
+  append(1, records);
+  F91Log_flush();
+  bytes = snvSim_stats.bytesWritten - bytes;
+
+  start = host_nowNs();
+  reboot();
+  ns = host_nowNs() - start;
+
+  printf("  %u records of %u bytes: %u SNV writes, %u bytes, amplification %u.%02u\n",
+         records, REC_LEN, snvSim_stats.writes, bytes,
+         bytes / (records * REC_LEN), (bytes * 100 / (records * REC_LEN)) % 100);
+  printf("  boot scan and replay: %u ns on the host\n", (unsigned)ns);
+}
+
+int main(void)
+{
+  testEmpty();
+  testReplayAfterReboot();
+  testRotation();
+  testCheckpointBoundsScan();
+  testNoCheckpoint();
+  testTornSegmentLost();
+  testTornSegmentPartial();
+  testTornCheckpoint();
+  testFailedWrite();
+  reportAmplification();
+
+  return host_done("test_log");
+}
@@ -0,0 +1,466 @@
+/*
+ * Host test of the over the air update (f91_oad.c) writing to the
+ * simulated flash.
+ *
+ * The control and block writes go through the OAD service as the stack
+ * would hand them over, OAD_BLOCK_QUEUE_LEN blocks per connection event,
+ * and the F91Kepler task's part is played by draining the service after
+ * each event. Covers a whole image, resume after a disconnect, blocks out
+ * of order, a bad CRC, a failed flash operation and abort, and checks that
+ * nothing outside the slot is touched and no bit is programmed back to 1.
+ * Reports the flash time of a full slot from the datasheet figures in
+ * sim/flash_sim.h.
+ *
+ * Built twice: with an image slot given on the command line (test_oad),
+ * and with the default of none (test_oad_noslot), where start is refused.
+ */
+#include <string.h>
+
+#include "host.h"
+#include "host_gatt.h"
+#include "sim/flash_sim.h"
+
+#include "f91_att_queue.h"
+#include "f91_bulk.h"
+#include "f91_kepler.h"
+#include "f91_link.h"
+#include "f91_oad.h"
+#include "f91_oad_service.h"
+
+// Connection interval the link time is modelled with.
+#define CONN_INTERVAL_US        7500
+
+#define IMAGE_VERSION           7
+
+extern const uint8_t f91_oad_serviceChar1UUID[];
+extern const uint8_t f91_oad_serviceChar2UUID[];
+
+// Characteristics written since the last drain, bit per F91_OAD_SERVICE_CHARx.
+static uint8_t  pending;
+
+// Consumer the module gave the bulk channel.
+static f91BulkConsumer_t bulkConsumer;
+
+static uint8_t  image[FLASH_SIM_SIZE];
+
+/*********************************************************************
+ * What the module talks to besides the service and the flash.
+ */
+void F91Kepler_oadCharValueChangeCB(uint8_t paramID)
+{
+  pending |= 1 << paramID;
+}
+
+void F91Bulk_register(uint8_t type, f91BulkConsumer_t pfnConsumer)
+{
+  if (type == F91_BULK_TYPE_OAD_BLOCK) {
+    bulkConsumer = pfnConsumer;
+  }
+}
+
+bStatus_t F91AttQueue_sendNoti(uint16_t connHandle, attHandleValueNoti_t *pNoti)
+{
+  return GATT_Notification(connHandle, pNoti, FALSE);
+}
+
+void F91Link_countRx(uint16_t len)                      { }
+void F91Link_setBulkHint(bool bulk)                     { }
+
+/*********************************************************************
+ * Helpers
+ */
+static uint32_t crc32(const uint8_t *pData, uint32_t len)
+{
+  uint32_t crc = 0xFFFFFFFF;
+  uint8_t bit;
+
+  while (len--) {
+    crc ^= *pData++;
+    for (bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+    }
+  }
+
+  return ~crc;
+}
+
+static void makeImage(uint32_t len, uint32_t seed)
+{
+  uint32_t i;
+
+  for (i = 0; i < len; i++) {
+    seed = seed * 1103515245 + 12345;
+    image[i] = (uint8_t)(seed >> 16);
+  }
+}
+
+// The F91Kepler task takes what was written during the event.
+static void drain(void)
+{
+  uint8_t param;
+
+  while (pending) {
+    for (param = F91_OAD_SERVICE_CHAR1; param <= F91_OAD_SERVICE_CHAR2; param++) {
+      if (pending & (1 << param)) {
+        pending &= ~(1 << param);
+        F91Oad_processCharChangeEvt(param);
+      }
+    }
+  }
+}
+
+// The last response is exactly [op][status][next block].
+static bool response(uint8_t op, uint8_t status, uint16_t next)
+{
+  f91_oad_serviceControl_t rsp;
+
+  F91_oad_service_GetParameter(F91_OAD_SERVICE_CHAR1, &rsp);
+  return (rsp.len == OAD_RSP_LEN) && (rsp.data[0] == op) && (rsp.data[1] == status) &&
+         (BUILD_UINT16(rsp.data[2], rsp.data[3]) == next);
+}
+
+static void command(uint8_t op)
+{
+  CHECK(hostGatt_write(f91_oad_serviceChar1UUID, &op, 1, 0) == SUCCESS);
+  drain();
+}
+
+static void start(uint32_t len, uint32_t crc)
+{
+  uint8_t cmd[OAD_CONTROL_LEN] =
+  {
+    F91_OAD_CMD_START, LO_UINT16(IMAGE_VERSION), HI_UINT16(IMAGE_VERSION),
+    BREAK_UINT32(len, 0), BREAK_UINT32(len, 1), BREAK_UINT32(len, 2), BREAK_UINT32(len, 3),
+    BREAK_UINT32(crc, 0), BREAK_UINT32(crc, 1), BREAK_UINT32(crc, 2), BREAK_UINT32(crc, 3)
+  };
+
+  CHECK(hostGatt_write(f91_oad_serviceChar1UUID, cmd, sizeof(cmd), 0) == SUCCESS);
+  drain();
+}
+
+static uint32_t blocks(uint32_t len)
+{
+  return (len + OAD_BLOCK_LEN - 1) / OAD_BLOCK_LEN;
+}
+
+static uint16_t block(uint8_t *pBlock, uint16_t n, uint32_t len)
+{
+  uint32_t offset = (uint32_t)n * OAD_BLOCK_LEN;
+  uint16_t blockLen = MIN(OAD_BLOCK_LEN, len - offset);
+
+  pBlock[0] = LO_UINT16(n);
+  pBlock[1] = HI_UINT16(n);
+  memcpy(&pBlock[OAD_BLOCK_HDR_LEN], &image[offset], blockLen);
+  return OAD_BLOCK_HDR_LEN + blockLen;
+}
+
+// Blocks first..last-1 as writes without response, a queue full per event.
+static void send(uint16_t first, uint16_t last, uint32_t len)
+{
+  uint8_t  value[OAD_BLOCK_HDR_LEN + OAD_BLOCK_LEN];
+  uint16_t n;
+
+  for (n = first; n < last; n++) {
+    CHECK(hostGatt_write(f91_oad_serviceChar2UUID, value, block(value, n, len), 0) == SUCCESS);
+    if (((n - first + 1) % OAD_BLOCK_QUEUE_LEN) == 0) {
+      drain();
+    }
+  }
+  drain();
+}
+
+static bool outside(uint32_t addr)
+{
+  return (addr < F91_OAD_IMAGE_ADDR) ||
+         (addr >= F91_OAD_IMAGE_ADDR + F91_OAD_IMAGE_PAGES * F91_OAD_PAGE_SIZE);
+}
+
+// Flash outside the slot gets a pattern the update must leave alone.
+static void fillOutside(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < FLASH_SIM_SIZE; i++) {
+    if (outside(i)) {
+      flashSim_mem[i] = 0x5A;
+    }
+  }
+}
+
+static bool outsideUntouched(void)
+{
+  uint32_t i;
+
+  for (i = 0; i < FLASH_SIM_SIZE; i++) {
+    if (outside(i) && (flashSim_mem[i] != 0x5A)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The slot holds the image and its header, waiting for a boot image manager.
+static void expectReceived(uint32_t len)
+{
+  f91OadHeader_t hdr;
+
+  memcpy(&hdr, &flashSim_mem[F91_OAD_HDR_ADDR], sizeof(hdr));
+  CHECK(memcmp(&flashSim_mem[F91_OAD_IMAGE_ADDR], image, len) == 0);
+  CHECK(hdr.magic == F91_OAD_MAGIC);
+  CHECK(hdr.version == IMAGE_VERSION);
+  CHECK(hdr.state == F91_OAD_STATE_RECEIVED);
+  CHECK(hdr.len == len);
+  CHECK(hdr.crc == crc32(image, len));
+}
+
+static void expectNoHeader(void)
+{
+  f91OadHeader_t hdr;
+
+  memcpy(&hdr, &flashSim_mem[F91_OAD_HDR_ADDR], sizeof(hdr));
+  CHECK(hdr.magic == 0xFFFFFFFF);
+}
+
+static void setUp(void)
+{
+  flashSim_reset();
+  command(F91_OAD_CMD_ABORT);
+  flashSim_reset();
+  fillOutside();
+}
+
+/*********************************************************************
+ * Cases
+ */
+#if F91_OAD_IMAGE_PAGES > 0
+static void testWholeImage(void)
+{
+  uint32_t len = 3 * F91_OAD_PAGE_SIZE + 1000;
+
+  setUp();
+  makeImage(len, 1);
+
+  start(len, crc32(image, len));
+  CHECK(response(F91_OAD_CMD_START, F91_OAD_SUCCESS, 0));
+
+  send(0, blocks(len), len);
+  CHECK(response(F91_OAD_RSP_COMPLETE, F91_OAD_SUCCESS, blocks(len)));
+  expectReceived(len);
+
+  // One erase for the header page, one per page of image.
+  CHECK(flashSim_stats.erases == 1 + (len + F91_OAD_PAGE_SIZE - 1) / F91_OAD_PAGE_SIZE);
+  CHECK(flashSim_stats.bytesProgrammed == len + sizeof(f91OadHeader_t));
+  CHECK(flashSim_stats.bitsSet == 0);
+  CHECK(flashSim_stats.cacheOn == 0);
+  CHECK(outsideUntouched());
+
+  command(F91_OAD_CMD_STATUS);
+  CHECK(response(F91_OAD_CMD_STATUS, F91_OAD_SUCCESS, blocks(len)));
+}
+
+static void testBulkChannel(void)
+{
+  uint8_t  value[OAD_BLOCK_HDR_LEN + OAD_BLOCK_LEN];
+  uint32_t len = 2 * OAD_BLOCK_LEN + 5;
+  uint16_t n;
+
+  setUp();
+  makeImage(len, 2);
+
+  // SDUs of the bulk channel go straight to the module, same layout.
+  start(len, crc32(image, len));
+  CHECK(bulkConsumer != NULL);
+  for (n = 0; n < blocks(len); n++) {
+    bulkConsumer(value, block(value, n, len));
+  }
+  CHECK(response(F91_OAD_RSP_COMPLETE, F91_OAD_SUCCESS, blocks(len)));
+  expectReceived(len);
+}
+
+static void testResume(void)
+{
+  uint32_t len = 2 * F91_OAD_PAGE_SIZE + 300;
+  uint16_t half = blocks(len) / 2;
+  uint32_t erases;
+
+  setUp();
+  makeImage(len, 3);
+
+  start(len, crc32(image, len));
+  send(0, half, len);
+
+  // The link drops with blocks still queued, they are thrown away.
+  CHECK(hostGatt_write(f91_oad_serviceChar2UUID, image, OAD_BLOCK_HDR_LEN + 1, 0) == SUCCESS);
+  F91Oad_reset();
+  pending = 0;
+
+  // The same image again goes on from the next block, nothing is erased.
+  erases = flashSim_stats.erases;
+  start(len, crc32(image, len));
+  CHECK(response(F91_OAD_CMD_START, F91_OAD_SUCCESS, half));
+  CHECK(flashSim_stats.erases == erases);
+
+  send(half, blocks(len), len);
+  CHECK(response(F91_OAD_RSP_COMPLETE, F91_OAD_SUCCESS, blocks(len)));
+  expectReceived(len);
+  CHECK(flashSim_stats.bitsSet == 0);
+
+  // Another image starts over.
+  makeImage(len, 4);
+  start(len, crc32(image, len));
+  CHECK(response(F91_OAD_CMD_START, F91_OAD_SUCCESS, 0));
+  expectNoHeader();
+}
+
+static void testOutOfOrder(void)
+{
+  uint32_t len = 10 * OAD_BLOCK_LEN;
+
+  setUp();
+  makeImage(len, 5);
+
+  start(len, crc32(image, len));
+  send(0, 3, len);
+
+  // Block 3 is lost, the phone is told once where to pick up.
+  send(4, 8, len);
+  CHECK(response(F91_OAD_RSP_BLOCK, F91_OAD_ERR_SEQUENCE, 3));
+
+  send(3, blocks(len), len);
+  CHECK(response(F91_OAD_RSP_COMPLETE, F91_OAD_SUCCESS, blocks(len)));
+  expectReceived(len);
+  CHECK(flashSim_stats.bitsSet == 0);
+}
+
+static void testBadCrc(void)
+{
+  uint32_t len = 5 * OAD_BLOCK_LEN;
+
+  setUp();
+  makeImage(len, 6);
+
+  start(len, crc32(image, len) ^ 1);
+  send(0, blocks(len), len);
+  CHECK(response(F91_OAD_RSP_COMPLETE, F91_OAD_ERR_CRC, 0));
+  expectNoHeader();
+
+  // Forgotten, the next start is from block 0.
+  command(F91_OAD_CMD_STATUS);
+  CHECK(response(F91_OAD_CMD_STATUS, F91_OAD_ERR_STATE, 0));
+}
+
+static void testFlashFails(void)
+{
+  uint32_t len = 5 * OAD_BLOCK_LEN;
+
+  setUp();
+  makeImage(len, 7);
+
+  start(len, crc32(image, len));
+  flashSim_fail(true);
+  send(0, 1, len);
+  flashSim_fail(false);
+  CHECK(response(F91_OAD_RSP_BLOCK, F91_OAD_ERR_FLASH, 0));
+
+  command(F91_OAD_CMD_STATUS);
+  CHECK(response(F91_OAD_CMD_STATUS, F91_OAD_ERR_STATE, 0));
+}
+
+static void testAbort(void)
+{
+  uint32_t len = 3 * OAD_BLOCK_LEN;
+
+  setUp();
+  makeImage(len, 8);
+
+  start(len, crc32(image, len));
+  send(0, blocks(len), len);
+  expectReceived(len);
+
+  // A received image loses its header, no boot image manager can take it.
+  command(F91_OAD_CMD_ABORT);
+  CHECK(response(F91_OAD_CMD_ABORT, F91_OAD_SUCCESS, 0));
+  expectNoHeader();
+  CHECK(outsideUntouched());
+}
+
+static void testTooLong(void)
+{
+  setUp();
+
+  start(F91_OAD_IMAGE_MAX + 1, 0);
+  CHECK(response(F91_OAD_CMD_START, F91_OAD_ERR_LENGTH, 0));
+  CHECK(flashSim_stats.erases == 0);
+}
+
+static void reportFullSlot(void)
+{
+  uint32_t len = F91_OAD_IMAGE_MAX;
+  uint32_t flashUs;
+  uint32_t linkUs;
+  uint64_t begin;
+  uint64_t ns;
+
+  setUp();
+  makeImage(len, 9);
+
+  begin = host_nowNs();
+  start(len, crc32(image, len));
+  send(0, blocks(len), len);
+  ns = host_nowNs() - begin;
+
+  CHECK(response(F91_OAD_RSP_COMPLETE, F91_OAD_SUCCESS, blocks(len)));
+  expectReceived(len);
+
+  // The link can't go faster than a full queue per connection event.
+  flashUs = flashSim_busyUs(&flashSim_stats);
+  linkUs = (blocks(len) + OAD_BLOCK_QUEUE_LEN - 1) / OAD_BLOCK_QUEUE_LEN * CONN_INTERVAL_US;
+
+  printf("  %u byte image, %u blocks: %u erases, %u bytes programmed\n",
+         len, blocks(len), flashSim_stats.erases, flashSim_stats.bytesProgrammed);
+  printf("  modelled: flash %u ms, link %u ms at %u blocks per %u us event\n",
+         flashUs / 1000, linkUs / 1000, OAD_BLOCK_QUEUE_LEN, CONN_INTERVAL_US);
+  printf("  module and service on the host: %u us\n", (unsigned)(ns / 1000));
+}
+#else
+static void testNoSlot(void)
+{
+  uint32_t len = 3 * OAD_BLOCK_LEN;
+
+  setUp();
+  makeImage(len, 10);
+
+  // Nothing is erased, blocks are ignored.
+  start(len, crc32(image, len));
+  CHECK(response(F91_OAD_CMD_START, F91_OAD_ERR_NO_SLOT, 0));
+  send(0, blocks(len), len);
+  CHECK(flashSim_stats.erases == 0);
+  CHECK(flashSim_stats.bytesProgrammed == 0);
+
+  command(F91_OAD_CMD_STATUS);
+  CHECK(response(F91_OAD_CMD_STATUS, F91_OAD_ERR_STATE, 0));
+}
+#endif
+
+int main(void)
+{
+  F91Oad_init();
+
+#if F91_OAD_IMAGE_PAGES > 0
+  testWholeImage();
+  testBulkChannel();
+  testResume();
+  testOutOfOrder();
+  testBadCrc();
+  testFlashFails();
+  testAbort();
+  testTooLong();
+  reportFullSlot();
+
+  return host_done("test_oad");
+#else
+  testNoSlot();
+
+  return host_done("test_oad_noslot");
+#endif
+}